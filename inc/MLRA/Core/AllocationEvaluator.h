@@ -0,0 +1,55 @@
+#pragma once
+
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/Solution.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef enum
+{
+    MLRA_AllocationError_None,
+    MLRA_AllocationError_InstructionCount,
+    MLRA_AllocationError_Location,
+    MLRA_AllocationError_OutOfMemory
+} MLRA_AllocationError;
+
+/*
+ * Outcome of evaluating an allocation. The cost is only set when there is no error; otherwise instruction is the
+ * first instruction with an invalid location, or the instruction count of the scenario for count mismatches.
+ */
+typedef struct
+{
+    MLRA_AllocationError error;
+    size_t instruction;
+    int64_t cost;
+} MLRA_AllocationEvaluation;
+
+/*
+ * Checks that locations assigns every instruction of the scenario either a register below the register count or
+ * MLRA_SolutionLocation_Memory, and computes the total cost of the allocation under the same cost model the solvers
+ * use. Allocations from any source can be scored, not only solutions built by this library.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1), gnu::access(read_only, 2, 3)]]
+MLRA_AllocationEvaluation MLRA_EvaluateAllocation(
+    MLRA_Scenario const *scenario,
+    int32_t const *locations,
+    size_t count
+);
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_only, 2)]]
+MLRA_AllocationEvaluation MLRA_EvaluateSolution(
+    MLRA_Scenario const *scenario,
+    MLRA_Solution const *solution
+);
+
+#ifdef __cplusplus
+}
+#endif
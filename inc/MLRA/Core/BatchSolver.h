@@ -0,0 +1,46 @@
+#pragma once
+
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/Solution.h"
+#include "MLRA/Core/SolverWorkspace.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * The context is the one given to MLRA_SolveScenarioBatch, passed along unchanged to every call.
+ */
+typedef MLRA_Solution *(*MLRA_BatchSolveFunction)(
+    MLRA_Scenario const *scenario,
+    MLRA_SolverWorkspace *workspace,
+    void *context
+);
+
+typedef struct
+{
+    size_t scenarioCount;
+    size_t solvedCount;
+    size_t threadCount;
+    size_t stealCount;
+    double seconds;
+} MLRA_BatchSolveReport;
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3, 6), gnu::access(read_only, 1, 2), gnu::access(write_only, 6, 2)]]
+bool MLRA_SolveScenarioBatch(
+    MLRA_Scenario const *const *scenarios,
+    size_t count,
+    MLRA_BatchSolveFunction solve,
+    void *context,
+    size_t threadCount,
+    MLRA_Solution **solutions,
+    MLRA_BatchSolveReport *report
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/Solution.h"
+#include "MLRA/Core/SolverWorkspace.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_Solution *MLRA_SolveScenarioWithBelady(
+    MLRA_Scenario const *scenario
+);
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_write, 2)]]
+MLRA_Solution *MLRA_SolveScenarioWithBeladyInWorkspace(
+    MLRA_Scenario const *scenario,
+    MLRA_SolverWorkspace *workspace
+);
+
+#ifdef __cplusplus
+}
+#endif
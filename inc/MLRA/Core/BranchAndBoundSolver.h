@@ -0,0 +1,54 @@
+#pragma once
+
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/Solution.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * A thread count of zero uses every hardware thread. A time limit of zero or less lets the search run to the end.
+ */
+typedef struct
+{
+    size_t threadCount;
+    double timeLimit;
+} MLRA_BranchAndBoundOptions;
+
+/*
+ * lowerBound is proven for every allocation of the scenario. It equals the solution cost when the search ran to the
+ * end, which sets optimal; a search stopped by the time limit reports the smallest bound of the subtrees left open.
+ */
+typedef struct
+{
+    int64_t lowerBound;
+    double gap;
+    bool optimal;
+    size_t nodeCount;
+    size_t stealCount;
+    size_t threadCount;
+    double seconds;
+} MLRA_BranchAndBoundReport;
+
+/*
+ * Searches the allocations depth first under the cost model of MLRA_SolveScenarioExactly, starting from the Belady
+ * allocation and dropping every subtree whose lower bound reaches the best cost found so far. Workers steal the
+ * shallowest open subtrees from each other and share the best cost. Returns the best allocation found, which is
+ * optimal unless the time limit stopped the search. The report is optional.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_only, 2)]]
+MLRA_Solution *MLRA_SolveScenarioWithBranchAndBound(
+    MLRA_Scenario const *scenario,
+    MLRA_BranchAndBoundOptions const *options,
+    MLRA_BranchAndBoundReport *report
+);
+
+#ifdef __cplusplus
+}
+#endif
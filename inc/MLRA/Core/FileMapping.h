@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct MLRA_FileMapping_ MLRA_FileMapping;
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroyFileMapping(
+    MLRA_FileMapping *mapping
+);
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyFileMapping, 1)]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_FileMapping *MLRA_CreateFileMapping(
+    char const *path
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+void *MLRA_GetFileMappingData(
+    MLRA_FileMapping const *mapping
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetFileMappingSize(
+    MLRA_FileMapping const *mapping
+);
+
+#ifdef __cplusplus
+}
+#endif
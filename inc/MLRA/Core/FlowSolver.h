@@ -0,0 +1,25 @@
+#pragma once
+
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/Solution.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * A heuristic under the cost model of MLRA_SolveScenarioExactly. Registers are handed out as units of a min-cost flow
+ * over the instructions, which is optimal only when every register has the same costs. Registers with distinct costs
+ * would need a flow per cost class, so the classes are filled one after another, cheapest first, and the result can
+ * cost more than the optimum. The solution cost is always the exact cost of the returned assignment.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_Solution *MLRA_SolveScenarioWithMinCostFlow(
+    MLRA_Scenario const *scenario
+);
+
+#ifdef __cplusplus
+}
+#endif
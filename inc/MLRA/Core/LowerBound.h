@@ -0,0 +1,90 @@
+#pragma once
+
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/SolverTrace.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Lower bounds on the cost of every allocation of a scenario, each computed in a single pass over the trace:
+ * - firstLoadCost charges a memory load for every virtual register that is loaded before it is ever stored.
+ * - relaxedCost drops the register limit and stands every register in for one with the cheapest load and the cheapest
+ *   store cost, then places each virtual register optimally on its own.
+ * - intervalCost charges every instruction its cheapest cost, plus the memory load that a value loses to register
+ *   pressure: at points where more values wait for a load than there are registers, the surplus ones must be reloaded
+ *   from memory.
+ * cost is the largest of the three. All bounds assume non-negative costs.
+ */
+typedef struct
+{
+    int64_t firstLoadCost;
+    int64_t relaxedCost;
+    int64_t intervalCost;
+    int64_t cost;
+} MLRA_LowerBound;
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(write_only, 2)]]
+bool MLRA_ComputeLowerBoundOfScenario(
+    MLRA_Scenario const *scenario,
+    MLRA_LowerBound *bound
+);
+
+/*
+ * Same as MLRA_ComputeLowerBoundOfScenario, for solvers that already built the trace of the scenario.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 2, 3), gnu::access(read_only, 1), gnu::access(read_only, 2), gnu::access(write_only, 3)]]
+bool MLRA_ComputeLowerBoundOfSolverTrace(
+    MLRA_Scenario const *scenario,
+    MLRA_SolverTrace const *trace,
+    MLRA_LowerBound *bound
+);
+
+/*
+ * Fills the instruction count plus one bounds, where bounds[i] is a lower bound on the cost of instructions i onwards
+ * from any register state reachable before instruction i. A search holding an allocation of cost c can drop every
+ * state whose cost plus the bound of the remaining instructions exceeds c.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 2, 3), gnu::access(read_only, 1), gnu::access(read_only, 2)]]
+bool MLRA_ComputeRemainingLowerBoundsOfSolverTrace(
+    MLRA_Scenario const *scenario,
+    MLRA_SolverTrace const *trace,
+    int64_t *bounds
+);
+
+/*
+ * Fills the instruction count entries of both arrays: fromMemory[i] and fromRegister[i] bound the cost of instruction
+ * i and the later references of its value, when the value lives in memory or in a register before instruction i.
+ * They use the relaxation of relaxedCost, so a value held in a register loading for more than the cheapest one pays at
+ * least the difference on top of fromRegister[i]. Searches can sum them over the values of a state for a bound that
+ * depends on where each value is.
+ */
+[[gnu::nonnull(1, 2, 3, 4), gnu::access(read_only, 1), gnu::access(read_only, 2)]]
+void MLRA_ComputeReferenceLowerBoundsOfSolverTrace(
+    MLRA_Scenario const *scenario,
+    MLRA_SolverTrace const *trace,
+    int64_t *fromMemory,
+    int64_t *fromRegister
+);
+
+/*
+ * Relative distance of cost above the lower bound, zero when the cost reaches the bound. A gap of zero proves the cost
+ * optimal.
+ */
+[[nodiscard, gnu::const]]
+double MLRA_GetOptimalityGap(
+    int64_t cost,
+    int64_t lowerBound
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "MLRA/Core/RegisterInstruction.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+static constexpr size_t MLRA_NextUseIndex_None = SIZE_MAX;
+
+/*
+ * Links every position of an instruction list to the previous and next position using the same virtual register.
+ * Inserting or removing a position costs O(log n) plus the distance to the nearest use of the same register, and
+ * queries cost O(log n). Readers may share an index as long as nobody edits it.
+ */
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroyNextUseIndex(
+    MLRA_NextUseIndex *index
+);
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyNextUseIndex, 1)]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_NextUseIndex *MLRA_CreateNextUseIndex(
+    MLRA_RegisterInstructionList *list
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetPositionCountInNextUseIndex(
+    MLRA_NextUseIndex const *index
+);
+
+/*
+ * Every virtual register the index has seen gets a dense value below this count, in no particular order. Values stay
+ * assigned after their last use is removed.
+ */
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetValueCountInNextUseIndex(
+    MLRA_NextUseIndex const *index
+);
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_only, 1), gnu::access(write_only, 3)]]
+size_t const *MLRA_GetValueSpanInNextUseIndex(
+    MLRA_NextUseIndex const *index,
+    size_t position,
+    size_t *length
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetNextUseInIndex(
+    MLRA_NextUseIndex const *index,
+    size_t position
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetPreviousUseInIndex(
+    MLRA_NextUseIndex const *index,
+    size_t position
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetFirstUseOfVirtualRegisterInIndex(
+    MLRA_NextUseIndex const *index,
+    int virtualRegisterId
+);
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_InsertPositionIntoNextUseIndex(
+    MLRA_NextUseIndex *index,
+    size_t position,
+    int virtualRegisterId
+);
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void MLRA_RemovePositionFromNextUseIndex(
+    MLRA_NextUseIndex *index,
+    size_t position
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef void (*MLRA_ParallelJob)(
+    void *context,
+    size_t worker,
+    size_t index
+);
+
+[[nodiscard]]
+size_t MLRA_GetHardwareThreadCount(void);
+
+[[nodiscard]]
+double MLRA_GetMonotonicTime(void);
+
+[[nodiscard]]
+size_t MLRA_GetPeakResidentMemory(void);
+
+/*
+ * Lowers the peak resident memory to the current resident memory, so that the next MLRA_GetPeakResidentMemory covers
+ * only what ran in between. Returns false where the platform cannot, which leaves the peak of the whole process.
+ */
+[[nodiscard]]
+bool MLRA_ResetPeakResidentMemory(void);
+
+[[gnu::nonnull(3)]]
+void MLRA_RunParallelJobs(
+    size_t jobCount,
+    size_t workerCount,
+    MLRA_ParallelJob job,
+    void *context
+);
+
+#ifdef __cplusplus
+}
+#endif
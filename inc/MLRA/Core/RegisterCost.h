@@ -13,6 +13,11 @@ typedef struct
     int store;
 } MLRA_RegisterCost;
 
+/*
+ * Costs of a register file, stored as runs of neighbouring registers with equal cost. Registers start out at a cost
+ * of one to load and one to store, so creating and resizing take constant time and memory no matter how many
+ * registers there are, and lookups take logarithmic time in the number of runs.
+ */
 typedef struct MLRA_RegisterCostArray_ MLRA_RegisterCostArray;
 
 [[gnu::access(read_write, 1)]]
@@ -26,6 +31,49 @@ MLRA_RegisterCostArray *MLRA_CreateRegisterCostArray(
     size_t registerCount
 );
 
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyRegisterCostArray, 1)]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_RegisterCostArray *MLRA_CloneRegisterCostArray(
+    MLRA_RegisterCostArray const *array
+);
+
+/*
+ * Bytes needed to hold an array of at most runCapacity runs, or zero when runCapacity is zero or the size does not
+ * fit into a size_t.
+ */
+[[nodiscard, gnu::const]]
+size_t MLRA_GetRegisterCostArrayFootprint(
+    size_t runCapacity
+);
+
+/*
+ * Builds an array in caller owned memory that is at least the footprint of runCapacity runs large and aligned for a
+ * size_t. Such an array must neither be resized nor destroyed; it lives as long as the memory does. Setting costs
+ * fails once an edit needs more runs than it has room for.
+ */
+[[nodiscard, gnu::returns_nonnull]]
+[[gnu::nonnull(1), gnu::access(write_only, 1)]]
+MLRA_RegisterCostArray *MLRA_CreateRegisterCostArrayInBuffer(
+    void *buffer,
+    size_t registerCount,
+    size_t runCapacity
+);
+
+/*
+ * Builds a copy of source in caller owned memory like MLRA_CreateRegisterCostArrayInBuffer, cut down or padded with
+ * default costs to registerCount registers. Returns null when the copy needs more runs than runCapacity; one more
+ * than the run count of source always suffices.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(write_only, 1), gnu::access(read_only, 3)]]
+MLRA_RegisterCostArray *MLRA_CopyRegisterCostArrayToBuffer(
+    void *buffer,
+    size_t runCapacity,
+    MLRA_RegisterCostArray const *source,
+    size_t registerCount
+);
+
 [[nodiscard]]
 MLRA_RegisterCostArray *MLRA_ResizeRegisterCostArray(
     MLRA_RegisterCostArray *array,
@@ -38,6 +86,12 @@ size_t MLRA_GetRegisterCostArraySize(
     MLRA_RegisterCostArray const *array
 );
 
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetRegisterCostRunCountInArray(
+    MLRA_RegisterCostArray const *array
+);
+
 [[nodiscard, gnu::pure]]
 [[gnu::nonnull(1), gnu::access(read_only, 1)]]
 MLRA_RegisterCost MLRA_GetRegisterCostInArray(
@@ -45,13 +99,70 @@ MLRA_RegisterCost MLRA_GetRegisterCostInArray(
     size_t index
 );
 
+/*
+ * Setting costs splits runs, so it fails when the run table cannot grow; a range may then be set only in part.
+ */
+[[nodiscard]]
 [[gnu::nonnull(1), gnu::access(read_write, 1)]]
-void MLRA_SetRegisterCostInArray(
+bool MLRA_SetRegisterCostInArray(
     MLRA_RegisterCostArray *array,
     size_t index,
     MLRA_RegisterCost registerCost
 );
 
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1), gnu::access(read_only, 3, 4)]]
+bool MLRA_SetRegisterCostRangeInArray(
+    MLRA_RegisterCostArray *array,
+    size_t index,
+    MLRA_RegisterCost const *registerCosts,
+    size_t count
+);
+
+/*
+ * Registers with identical load and store costs share a cost class, kept up to date as costs are set. Class numbers
+ * stay below the class count; a class whose registers all moved to other costs stays empty until a new cost reuses
+ * its number.
+ */
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetRegisterCostClassCountInArray(
+    MLRA_RegisterCostArray const *array
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetRegisterCostClassInArray(
+    MLRA_RegisterCostArray const *array,
+    size_t index
+);
+
+/*
+ * Returns the cost class of the register at index and stores how many registers from index on share it without a
+ * break, so walking the registers span by span takes one step per run rather than per register.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_only, 1), gnu::access(write_only, 3)]]
+size_t MLRA_GetRegisterCostClassSpanInArray(
+    MLRA_RegisterCostArray const *array,
+    size_t index,
+    size_t *length
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_RegisterCost MLRA_GetRegisterCostOfCostClassInArray(
+    MLRA_RegisterCostArray const *array,
+    size_t costClass
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetRegisterCountInCostClassOfArray(
+    MLRA_RegisterCostArray const *array,
+    size_t costClass
+);
+
 #ifdef __cplusplus
 }
 #endif
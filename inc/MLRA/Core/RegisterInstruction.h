@@ -1,6 +1,9 @@
 #pragma once
 
+#include "MLRA/Core/FileMapping.h"
+
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" 
@@ -22,6 +25,8 @@ typedef struct
 
 typedef struct MLRA_RegisterInstructionList_ MLRA_RegisterInstructionList;
 
+typedef struct MLRA_NextUseIndex_ MLRA_NextUseIndex;
+
 [[gnu::access(read_write, 1)]]
 void MLRA_DestroyRegisterInstructionList(
     MLRA_RegisterInstructionList *list
@@ -31,6 +36,59 @@ void MLRA_DestroyRegisterInstructionList(
 [[gnu::malloc, gnu::malloc(MLRA_DestroyRegisterInstructionList)]]
 MLRA_RegisterInstructionList *MLRA_CreateRegisterInstructionList(void);
 
+/*
+ * Stores the instructions in a balanced tree of fixed-size chunks instead of one array, so inserting, removing and
+ * looking up an instruction anywhere takes O(log n). The span getters then return at most one chunk at a time.
+ * Array backed lists switch to this storage by themselves once they are large and edited away from their end.
+ */
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyRegisterInstructionList)]]
+MLRA_RegisterInstructionList *MLRA_CreateChunkedRegisterInstructionList(void);
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyRegisterInstructionList)]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+MLRA_RegisterInstructionList *MLRA_CreateRegisterInstructionListInFileMapping(
+    MLRA_FileMapping *mapping,
+    size_t virtualRegisterIdOffset,
+    size_t storeBitOffset,
+    size_t count
+);
+
+/*
+ * Copies the instructions into a list of the same storage kind. Lists backed by a file mapping are copied to the heap.
+ * Chunked lists only copy their tree; the chunks are shared until either list writes to one of them, which then
+ * copies just that chunk.
+ */
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyRegisterInstructionList)]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_RegisterInstructionList *MLRA_CopyRegisterInstructionList(
+    MLRA_RegisterInstructionList const *list
+);
+
+/*
+ * Adds an owner to the list; every owner releases it with MLRA_DestroyRegisterInstructionList and the last one frees
+ * it. Owners must treat a shared list as read-only and copy it before editing.
+ */
+[[nodiscard, gnu::returns_nonnull]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+MLRA_RegisterInstructionList *MLRA_RetainRegisterInstructionList(
+    MLRA_RegisterInstructionList *list
+);
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+bool MLRA_IsRegisterInstructionListShared(
+    MLRA_RegisterInstructionList const *list
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+bool MLRA_IsRegisterInstructionListChunked(
+    MLRA_RegisterInstructionList const *list
+);
+
 [[nodiscard, gnu::pure]]
 [[gnu::nonnull(1), gnu::access(read_only, 1)]]
 size_t MLRA_GetRegisterInstructionCountInList(
@@ -44,12 +102,88 @@ MLRA_RegisterInstruction MLRA_GetRegisterInstructionInList(
     size_t index
 );
 
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_only, 1), gnu::access(write_only, 3)]]
+int32_t const *MLRA_GetVirtualRegisterIdSpanInList(
+    MLRA_RegisterInstructionList *list,
+    size_t index,
+    size_t *length
+);
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3, 4), gnu::access(read_only, 1), gnu::access(write_only, 3), gnu::access(write_only, 4)]]
+uint64_t const *MLRA_GetStoreBitSpanInList(
+    MLRA_RegisterInstructionList *list,
+    size_t index,
+    size_t *length,
+    size_t *bitOffset
+);
+
+/*
+ * Builds the next-use index of the list, which single edits keep up to date from then on. Span edits, range removals
+ * and failed updates drop it, and copies of the list start without one. Returns false when the index could not be
+ * built.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_BuildNextUseIndexInList(
+    MLRA_RegisterInstructionList *list
+);
+
+/*
+ * Returns the next-use index of the list, or nullptr unless MLRA_BuildNextUseIndexInList built one.
+ */
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_NextUseIndex const *MLRA_GetNextUseIndexInList(
+    MLRA_RegisterInstructionList const *list
+);
+
 [[gnu::nonnull(1), gnu::access(read_write, 1)]]
 void MLRA_AppendRegisterInstructionToList(
     MLRA_RegisterInstructionList *list,
     MLRA_RegisterInstruction instruction
 );
 
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_ReserveRegisterInstructionsInList(
+    MLRA_RegisterInstructionList *list,
+    size_t capacity
+);
+
+/*
+ * Moves an array backed list into chunked storage. Does nothing for lists that are chunked already.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_ConvertRegisterInstructionListToChunks(
+    MLRA_RegisterInstructionList *list
+);
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_AppendRegisterInstructionSpanToList(
+    MLRA_RegisterInstructionList *list,
+    int32_t const *virtualRegisterIds,
+    uint64_t const *storeBits,
+    size_t count
+);
+
+/*
+ * Inserts count instructions in front of index, moving the ones behind it only once. Bit i of storeBits is set when
+ * the i-th inserted instruction is a store.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_InsertRegisterInstructionSpanAtList(
+    MLRA_RegisterInstructionList *list,
+    size_t index,
+    int32_t const *virtualRegisterIds,
+    uint64_t const *storeBits,
+    size_t count
+);
+
 [[gnu::nonnull(1), gnu::access(read_write, 1)]]
 void MLRA_InsertRegisterInstructionAtList(
     MLRA_RegisterInstructionList *list,
@@ -68,6 +202,13 @@ void MLRA_RemoveRegisterInstructionAtList(
     size_t index
 );
 
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void MLRA_RemoveRegisterInstructionRangeAtList(
+    MLRA_RegisterInstructionList *list,
+    size_t index,
+    size_t count
+);
+
 #ifdef __cplusplus
 }
 #endif
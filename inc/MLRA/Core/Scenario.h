@@ -4,6 +4,7 @@
 #include "MLRA/Core/RegisterInstruction.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -12,6 +13,55 @@ extern "C"
 
 typedef struct MLRA_Scenario_ MLRA_Scenario;
 
+/*
+ * Region that scenarios and their cost arrays are carved from, so that many short lived variants cost no heap traffic
+ * of their own. An arena is not thread-safe.
+ */
+typedef struct MLRA_ScenarioArena_ MLRA_ScenarioArena;
+
+/*
+ * Immutable view of a scenario that several threads can read without locks while the scenario itself keeps being
+ * edited. Snapshots are reference counted; every owner releases its reference with MLRA_DestroyScenarioSnapshot.
+ */
+typedef struct MLRA_ScenarioSnapshot_ MLRA_ScenarioSnapshot;
+
+/*
+ * Instructions or registers that changed since some generation. Positions below begin are untouched, and every
+ * position p at or past end holds what was at p - shift before the edits.
+ */
+typedef struct
+{
+    size_t begin;
+    size_t end;
+    ptrdiff_t shift;
+} MLRA_ScenarioDirtyRange;
+
+/*
+ * Frees the arena together with every scenario placed in it, whether or not they were destroyed before.
+ */
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroyScenarioArena(
+    MLRA_ScenarioArena *arena
+);
+
+/*
+ * A block size of zero selects a default suited to a few hundred scenarios per block.
+ */
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyScenarioArena, 1)]]
+MLRA_ScenarioArena *MLRA_CreateScenarioArena(
+    size_t blockSize
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetUsedSizeInScenarioArena(
+    MLRA_ScenarioArena const *arena
+);
+
+/*
+ * Scenarios placed in an arena only release their instructions here; their memory is returned with the arena.
+ */
 void MLRA_DestroyScenario(
     MLRA_Scenario *scenario
 );
@@ -23,6 +73,37 @@ MLRA_Scenario *MLRA_CreateScenario(
     MLRA_RegisterCost memorySpillCost
 );
 
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyScenario, 1)]]
+[[gnu::nonnull(3), gnu::access(read_write, 3)]]
+MLRA_Scenario *MLRA_CreateScenarioWithRegisterInstructionList(
+    size_t registerCount,
+    MLRA_RegisterCost memorySpillCost,
+    MLRA_RegisterInstructionList *registerInstructions
+);
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyScenario, 1)]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+MLRA_Scenario *MLRA_CreateScenarioInArena(
+    MLRA_ScenarioArena *arena,
+    size_t registerCount,
+    MLRA_RegisterCost memorySpillCost
+);
+
+/*
+ * Copies the costs and shares the instructions with the original until either of them edits its instructions, so
+ * cloning takes time in the number of registers only. The clone is placed in the arena when one is given, otherwise
+ * on the heap. Clones sharing instructions must not build their next use index concurrently.
+ */
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyScenario, 1)]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_Scenario *MLRA_CloneScenario(
+    MLRA_Scenario const *scenario,
+    MLRA_ScenarioArena *arena
+);
+
 [[nodiscard, gnu::pure]]
 [[gnu::nonnull(1), gnu::access(read_only, 1)]]
 MLRA_RegisterCost MLRA_GetMemorySpillCostInScenario(
@@ -61,6 +142,56 @@ void MLRA_SetRegisterCostInScenario(
     MLRA_RegisterCost registerCost
 );
 
+[[gnu::nonnull(1), gnu::access(read_write, 1), gnu::access(read_only, 3, 4)]]
+void MLRA_SetRegisterCostRangeInScenario(
+    MLRA_Scenario *scenario,
+    size_t index,
+    MLRA_RegisterCost const *registerCosts,
+    size_t count
+);
+
+/*
+ * Registers of the same cost class have identical costs and are interchangeable for every solver.
+ */
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetRegisterCostClassCountInScenario(
+    MLRA_Scenario const *scenario
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetRegisterCostClassInScenario(
+    MLRA_Scenario const *scenario,
+    size_t index
+);
+
+/*
+ * Returns the cost class of the register at index and stores how many registers from index on share it without a
+ * break.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_only, 1), gnu::access(write_only, 3)]]
+size_t MLRA_GetRegisterCostClassSpanInScenario(
+    MLRA_Scenario const *scenario,
+    size_t index,
+    size_t *length
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_RegisterCost MLRA_GetRegisterCostOfCostClassInScenario(
+    MLRA_Scenario const *scenario,
+    size_t costClass
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetRegisterCountInCostClassOfScenario(
+    MLRA_Scenario const *scenario,
+    size_t costClass
+);
+
 [[nodiscard, gnu::pure]]
 [[gnu::nonnull(1), gnu::access(read_only, 1)]]
 size_t MLRA_GetRegisterInstructionCountInScenario(
@@ -74,6 +205,106 @@ MLRA_RegisterInstruction MLRA_GetRegisterInstructionInScenario(
     size_t index
 );
 
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_only, 1), gnu::access(write_only, 3)]]
+int32_t const *MLRA_GetVirtualRegisterIdSpanInScenario(
+    MLRA_Scenario const *scenario,
+    size_t index,
+    size_t *length
+);
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3, 4), gnu::access(read_only, 1), gnu::access(write_only, 3), gnu::access(write_only, 4)]]
+uint64_t const *MLRA_GetStoreBitSpanInScenario(
+    MLRA_Scenario const *scenario,
+    size_t index,
+    size_t *length,
+    size_t *bitOffset
+);
+
+/*
+ * Builds the next-use index of the instructions, which later edits keep up to date as described for
+ * MLRA_BuildNextUseIndexInList. Clones and snapshots share the index with the instructions; the first edit after
+ * taking one copies the instructions without it.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_BuildNextUseIndexInScenario(
+    MLRA_Scenario *scenario
+);
+
+/*
+ * Returns the next-use index of the instructions, or nullptr unless MLRA_BuildNextUseIndexInScenario built one.
+ */
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_NextUseIndex const *MLRA_GetNextUseIndexInScenario(
+    MLRA_Scenario const *scenario
+);
+
+/*
+ * Unique for every scenario created during the lifetime of the process, unlike its address.
+ */
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+uint64_t MLRA_GetScenarioIdentity(
+    MLRA_Scenario const *scenario
+);
+
+/*
+ * Advances by one for every edit that inserts or removes instructions, whether it touches one or a whole span.
+ */
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+uint64_t MLRA_GetInstructionGenerationInScenario(
+    MLRA_Scenario const *scenario
+);
+
+/*
+ * Summarizes the instruction edits made since the given generation. Only the most recent edits are remembered;
+ * returns false when older ones would be needed, in which case everything has to be treated as changed.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_only, 1), gnu::access(write_only, 3)]]
+bool MLRA_GetInstructionDirtyRangeInScenario(
+    MLRA_Scenario const *scenario,
+    uint64_t generation,
+    MLRA_ScenarioDirtyRange *range
+);
+
+/*
+ * Advances whenever register costs change, including when a new register count adds or drops registers.
+ */
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+uint64_t MLRA_GetRegisterCostGenerationInScenario(
+    MLRA_Scenario const *scenario
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+uint64_t MLRA_GetRegisterCountGenerationInScenario(
+    MLRA_Scenario const *scenario
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+uint64_t MLRA_GetMemorySpillCostGenerationInScenario(
+    MLRA_Scenario const *scenario
+);
+
+/*
+ * Summarizes the registers whose costs changed since the given cost generation, with a shift of zero. Like the
+ * instruction journal, only the most recent edits are remembered.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_only, 1), gnu::access(write_only, 3)]]
+bool MLRA_GetRegisterCostDirtyRangeInScenario(
+    MLRA_Scenario const *scenario,
+    uint64_t generation,
+    MLRA_ScenarioDirtyRange *range
+);
+
 [[gnu::nonnull(1), gnu::access(read_write, 1)]]
 void MLRA_AppendRegisterInstructionToScenario(
     MLRA_Scenario *scenario,
@@ -98,6 +329,76 @@ void MLRA_RemoveRegisterInstructionAtScenario(
     size_t index
 );
 
+/*
+ * The span functions below move the instructions behind the edit at most once, so loaders and generators should
+ * prefer them over editing one instruction at a time.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_ReserveRegisterInstructionsInScenario(
+    MLRA_Scenario *scenario,
+    size_t capacity
+);
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_AppendRegisterInstructionSpanToScenario(
+    MLRA_Scenario *scenario,
+    int32_t const *virtualRegisterIds,
+    uint64_t const *storeBits,
+    size_t count
+);
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_InsertRegisterInstructionSpanToScenario(
+    MLRA_Scenario *scenario,
+    size_t index,
+    int32_t const *virtualRegisterIds,
+    uint64_t const *storeBits,
+    size_t count
+);
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void MLRA_RemoveRegisterInstructionRangeAtScenario(
+    MLRA_Scenario *scenario,
+    size_t index,
+    size_t count
+);
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroyScenarioSnapshot(
+    MLRA_ScenarioSnapshot *snapshot
+);
+
+/*
+ * Shares the instructions with the scenario and copies only its costs, so taking a snapshot does not depend on the
+ * trace length. Edits made to the scenario afterwards copy the chunk index once and then only the chunks they touch.
+ * The first snapshot moves array backed instructions into chunked storage. The snapshot keeps the identity and the
+ * edit history of the scenario, so incremental solvers fed successive snapshots only re-solve what changed.
+ */
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyScenarioSnapshot, 1)]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+MLRA_ScenarioSnapshot *MLRA_CreateScenarioSnapshot(
+    MLRA_Scenario *scenario
+);
+
+[[nodiscard, gnu::returns_nonnull]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+MLRA_ScenarioSnapshot *MLRA_RetainScenarioSnapshot(
+    MLRA_ScenarioSnapshot *snapshot
+);
+
+/*
+ * Readers may share the returned scenario across threads, except for building its next use index.
+ */
+[[nodiscard, gnu::pure, gnu::returns_nonnull]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_Scenario const *MLRA_GetScenarioInSnapshot(
+    MLRA_ScenarioSnapshot const *snapshot
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "MLRA/Core/Scenario.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyScenario, 1)]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_Scenario *MLRA_LoadScenarioFromFile(
+    char const *path
+);
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_only, 2)]]
+bool MLRA_SaveScenarioToFile(
+    MLRA_Scenario const *scenario,
+    char const *path
+);
+
+#ifdef __cplusplus
+}
+#endif
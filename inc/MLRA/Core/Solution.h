@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef enum
+{
+    MLRA_SolutionLocation_Memory = -1
+} MLRA_SolutionLocation;
+
+typedef struct MLRA_Solution_ MLRA_Solution;
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroySolution(
+    MLRA_Solution *solution
+);
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroySolution, 1)]]
+MLRA_Solution *MLRA_CreateSolution(
+    size_t instructionCount
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+int64_t MLRA_GetSolutionCost(
+    MLRA_Solution const *solution
+);
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void MLRA_SetSolutionCost(
+    MLRA_Solution *solution,
+    int64_t cost
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetInstructionCountInSolution(
+    MLRA_Solution const *solution
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+int32_t MLRA_GetInstructionLocationInSolution(
+    MLRA_Solution const *solution,
+    size_t index
+);
+
+/*
+ * Locations of all instructions, in order.
+ */
+[[nodiscard, gnu::pure, gnu::returns_nonnull]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+int32_t const *MLRA_GetInstructionLocationSpanInSolution(
+    MLRA_Solution const *solution
+);
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void MLRA_SetInstructionLocationInSolution(
+    MLRA_Solution *solution,
+    size_t index,
+    int32_t location
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+bool MLRA_IsInstructionSpilledInSolution(
+    MLRA_Solution const *solution,
+    size_t index
+);
+
+#ifdef __cplusplus
+}
+#endif
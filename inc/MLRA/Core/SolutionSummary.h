@@ -0,0 +1,67 @@
+#pragma once
+
+#include "MLRA/Core/Solution.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Multi-resolution summary of the locations in a solution, for drawing timelines far wider than the screen. Level zero
+ * aggregates buckets of a fixed number of instructions and every further level merges pairs of buckets, so any zoom
+ * level is summarized from a handful of buckets per column. The summary reads finer zoom levels directly from the
+ * solution, which must outlive it.
+ */
+typedef struct MLRA_SolutionSummary_ MLRA_SolutionSummary;
+
+/*
+ * Aggregate over a range of instructions. The register bounds cover the instructions kept in registers; the minimum
+ * exceeds the maximum when every instruction of the range was spilled, or the range is empty.
+ */
+typedef struct
+{
+    int32_t minimumRegister;
+    int32_t maximumRegister;
+    uint32_t instructionCount;
+    uint32_t spilledCount;
+} MLRA_SolutionSummaryColumn;
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroySolutionSummary(
+    MLRA_SolutionSummary *summary
+);
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroySolutionSummary, 1)]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_SolutionSummary *MLRA_CreateSolutionSummary(
+    MLRA_Solution const *solution
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetInstructionCountInSolutionSummary(
+    MLRA_SolutionSummary const *summary
+);
+
+/*
+ * Fills columnCount columns, column c covering the instructions from firstInstruction + c * instructionsPerColumn up
+ * to the start of the next column. Column bounds are rounded to the coarsest buckets that still fit at least twice
+ * into a column, so the work per column stays constant at every zoom level.
+ */
+[[gnu::nonnull(1, 4), gnu::access(read_only, 1), gnu::access(write_only, 4, 5)]]
+void MLRA_SummarizeSolutionColumns(
+    MLRA_SolutionSummary const *summary,
+    double firstInstruction,
+    double instructionsPerColumn,
+    MLRA_SolutionSummaryColumn *columns,
+    size_t columnCount
+);
+
+#ifdef __cplusplus
+}
+#endif
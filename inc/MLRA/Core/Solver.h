@@ -0,0 +1,107 @@
+#pragma once
+
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/Solution.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Cost model shared by every solver:
+ * - Each virtual register lives in exactly one location, a physical register or memory. Every value starts in memory.
+ * - Reading from a location costs its load cost, writing to a location costs its store cost.
+ * - A store instruction writes its value to the chosen location. A load instruction reads its value from the chosen
+ *   location, moving it there first (load from the old location, store to the new one) if it lives elsewhere.
+ * - Overwriting a register whose occupant is still going to be loaded spills the occupant to memory.
+ *
+ * The search tracks which values every cost class of registers holds, with no more registers per class than values
+ * are ever held at once, so its work follows the cost classes and live values rather than the register count.
+ *
+ * The work per instruction still grows with the number of ways to choose the values each class holds, up to
+ * C(v + s, s) states for v live values and s slots. A state is only dropped when one of a few cheaper states turns into
+ * it for no more than the cost difference, which prunes little when many values compete for few registers, and one
+ * step per state and instruction is kept to trace the allocation back, so time and memory grow alike. As a guide, 20000
+ * instructions over 20 values and 4 registers keep some 300 states per instruction and take one to two seconds;
+ * 200 values over 4 registers keep some 80000 and take over a minute for just 2000 instructions, and 24 values over
+ * 16 registers keep some 15000 and take minutes for 20000. Past that, use MLRA_SolveScenarioWithBranchAndBound with
+ * a time limit, or MLRA_SolveScenarioWithBelady.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_Solution *MLRA_SolveScenarioExactly(
+    MLRA_Scenario const *scenario
+);
+
+/*
+ * Splits the trace at points with few live values and solves the segments on separate threads. Each segment yields a
+ * (min,+) transfer matrix between the register states possible at its boundaries; the matrices are combined in a
+ * parallel reduction tree. The result has the same cost as MLRA_SolveScenarioExactly. A thread count of zero uses
+ * every hardware thread. Falls back to the sequential solver when no cheap cut points exist.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_Solution *MLRA_SolveScenarioExactlyInParallel(
+    MLRA_Scenario const *scenario,
+    size_t threadCount
+);
+
+typedef struct MLRA_IncrementalSolver_ MLRA_IncrementalSolver;
+
+/*
+ * Reports that the search has passed completed of total instructions. Returning false cancels the solve.
+ */
+typedef bool (*MLRA_SolverProgress)(
+    void *context,
+    size_t completed,
+    size_t total
+);
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroyIncrementalSolver(
+    MLRA_IncrementalSolver *solver
+);
+
+/*
+ * The incremental solver keeps the exact search of its last scenario in segments of checkpointInterval instructions,
+ * each starting from a saved frontier. A checkpoint interval of zero picks a default. Memory use matches a full run of
+ * MLRA_SolveScenarioExactly, since the search history of every segment is kept.
+ */
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyIncrementalSolver, 1)]]
+MLRA_IncrementalSolver *MLRA_CreateIncrementalSolver(
+    size_t checkpointInterval
+);
+
+/*
+ * Calls progress at every checkpoint the search passes, or stops reporting when progress is null. A cancelled solve
+ * returns null but keeps the segments it completed, so the next solve resumes from the last of them, or from in front
+ * of the edits made in the meantime, whichever comes first.
+ */
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void MLRA_SetIncrementalSolverProgress(
+    MLRA_IncrementalSolver *solver,
+    MLRA_SolverProgress progress,
+    void *context
+);
+
+/*
+ * Solves the scenario exactly like MLRA_SolveScenarioExactly. When called again for the same scenario after a few
+ * instructions were inserted or removed, the search resumes from the last checkpoint in front of the edits and stops
+ * at the first cached checkpoint behind them whose frontier it reproduces up to a constant cost. Register cost or
+ * memory spill cost changes that alter the tracked registers' costs, edits that push the most values held at once past
+ * a power of two, or too many edits in between, trigger a full solve.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(read_only, 2)]]
+MLRA_Solution *MLRA_SolveScenarioIncrementally(
+    MLRA_IncrementalSolver *solver,
+    MLRA_Scenario const *scenario
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/SolverWorkspace.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+static constexpr uint32_t MLRA_SolverTrace_NoReference = UINT32_MAX;
+
+typedef struct MLRA_SolverTrace_ MLRA_SolverTrace;
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroySolverTrace(
+    MLRA_SolverTrace *trace
+);
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroySolverTrace, 1)]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_SolverTrace *MLRA_CreateSolverTrace(
+    MLRA_Scenario const *scenario
+);
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroySolverTrace, 1)]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_write, 2)]]
+MLRA_SolverTrace *MLRA_CreateSolverTraceInWorkspace(
+    MLRA_Scenario const *scenario,
+    MLRA_SolverWorkspace *workspace
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetInstructionCountInSolverTrace(
+    MLRA_SolverTrace const *trace
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetValueCountInSolverTrace(
+    MLRA_SolverTrace const *trace
+);
+
+[[nodiscard, gnu::pure, gnu::returns_nonnull]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+int32_t const *MLRA_GetValuesInSolverTrace(
+    MLRA_SolverTrace const *trace
+);
+
+[[nodiscard, gnu::pure, gnu::returns_nonnull]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+uint32_t const *MLRA_GetNextReferencesInSolverTrace(
+    MLRA_SolverTrace const *trace
+);
+
+[[nodiscard, gnu::pure, gnu::returns_nonnull]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+bool const *MLRA_GetStoreFlagsInSolverTrace(
+    MLRA_SolverTrace const *trace
+);
+
+[[nodiscard, gnu::pure, gnu::returns_nonnull]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+bool const *MLRA_GetLiveAfterFlagsInSolverTrace(
+    MLRA_SolverTrace const *trace
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "MLRA/Core/LowerBound.h"
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/Solution.h"
+#include "MLRA/Core/SolutionSummary.h"
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Background thread that solves submitted scenario snapshots. Submitting a snapshot cancels the job in flight. The
+ * worker first publishes the Belady heuristic as the best solution so far, then the exact solution, each with its
+ * summary and the lower bound of the scenario. Progress and solutions are read with atomics only, so polling them every frame never blocks on
+ * the solve.
+ */
+typedef struct MLRA_SolverWorker_ MLRA_SolverWorker;
+
+typedef enum
+{
+    MLRA_SolverWorkerState_Idle,
+    MLRA_SolverWorkerState_Running,
+    MLRA_SolverWorkerState_Finished,
+    MLRA_SolverWorkerState_Failed
+} MLRA_SolverWorkerState;
+
+typedef struct
+{
+    uint64_t job;
+    MLRA_SolverWorkerState state;
+    double progress;
+} MLRA_SolverWorkerProgress;
+
+/*
+ * final is set when solution is the exact solution that ends the job. summary reads solution and is null if it could
+ * not be built. lowerBound is only meaningful when lowerBoundKnown is set.
+ */
+typedef struct
+{
+    MLRA_Solution *solution;
+    MLRA_SolutionSummary *summary;
+    MLRA_LowerBound lowerBound;
+    bool lowerBoundKnown;
+    bool final;
+} MLRA_SolverWorkerSolution;
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroySolverWorker(
+    MLRA_SolverWorker *worker
+);
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroySolverWorker, 1)]]
+MLRA_SolverWorker *MLRA_CreateSolverWorker(void);
+
+/*
+ * Takes over the reference to snapshot and returns the number of the new job, which later progress and solutions
+ * carry. Jobs are numbered from one.
+ */
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(read_write, 2)]]
+uint64_t MLRA_SubmitScenarioToSolverWorker(
+    MLRA_SolverWorker *worker,
+    MLRA_ScenarioSnapshot *snapshot
+);
+
+/*
+ * Cancels the job in flight and any submitted job the worker has not started yet, leaving the worker idle.
+ */
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void MLRA_CancelSolverWorker(
+    MLRA_SolverWorker *worker
+);
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_SolverWorkerProgress MLRA_GetProgressInSolverWorker(
+    MLRA_SolverWorker const *worker
+);
+
+/*
+ * Moves the newest solution published for the latest job into taken and returns true, or returns false if there is
+ * none since the last call. The caller owns the solution and its summary, and destroys the summary first.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(write_only, 2)]]
+bool MLRA_TakeSolutionFromSolverWorker(
+    MLRA_SolverWorker *worker,
+    MLRA_SolverWorkerSolution *taken
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "MLRA/Core/Solver.h"
+#include "MLRA/Core/VirtualRegisterMap.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef enum
+{
+    MLRA_SolverWorkspaceBuffer_TraceValues,
+    MLRA_SolverWorkspaceBuffer_TraceNextReferences,
+    MLRA_SolverWorkspaceBuffer_TraceStoreFlags,
+    MLRA_SolverWorkspaceBuffer_TraceLiveAfterFlags,
+    MLRA_SolverWorkspaceBuffer_TraceLastReferences,
+    MLRA_SolverWorkspaceBuffer_Solver,
+    MLRA_SolverWorkspaceBuffer_Count = MLRA_SolverWorkspaceBuffer_Solver + 16
+} MLRA_SolverWorkspaceBuffer;
+
+typedef struct MLRA_SolverWorkspace_ MLRA_SolverWorkspace;
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroySolverWorkspace(
+    MLRA_SolverWorkspace *workspace
+);
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroySolverWorkspace, 1)]]
+MLRA_SolverWorkspace *MLRA_CreateSolverWorkspace(void);
+
+/*
+ * Calls progress while a solver runs in the workspace, or stops reporting when progress is null. A solver cancelled
+ * by progress returns null.
+ */
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void MLRA_SetSolverWorkspaceProgress(
+    MLRA_SolverWorkspace *workspace,
+    MLRA_SolverProgress progress,
+    void *context
+);
+
+/*
+ * Reports progress for the solver running in the workspace and returns false if the solve was cancelled.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+bool MLRA_ReportProgressInSolverWorkspace(
+    MLRA_SolverWorkspace const *workspace,
+    size_t completed,
+    size_t total
+);
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void *MLRA_ReserveBufferInSolverWorkspace(
+    MLRA_SolverWorkspace *workspace,
+    size_t buffer,
+    size_t size
+);
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+MLRA_VirtualRegisterMap *MLRA_GetVirtualRegisterMapInSolverWorkspace(
+    MLRA_SolverWorkspace *workspace
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetReservedSizeInSolverWorkspace(
+    MLRA_SolverWorkspace const *workspace
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "MLRA/Core/RegisterInstruction.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct
+{
+    size_t byteCount;
+    size_t instructionCount;
+    size_t threadCount;
+    size_t errorLine;
+    double seconds;
+    double megabytesPerSecond;
+} MLRA_TraceParseReport;
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(read_only, 2, 3)]]
+bool MLRA_ParseTraceTextIntoList(
+    MLRA_RegisterInstructionList *list,
+    char const *text,
+    size_t length,
+    size_t threadCount,
+    MLRA_TraceParseReport *report
+);
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(read_only, 2)]]
+bool MLRA_ParseTraceFileIntoList(
+    MLRA_RegisterInstructionList *list,
+    char const *path,
+    size_t threadCount,
+    MLRA_TraceParseReport *report
+);
+
+#ifdef __cplusplus
+}
+#endif
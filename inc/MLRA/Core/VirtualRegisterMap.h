@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+typedef struct MLRA_VirtualRegisterMap_ MLRA_VirtualRegisterMap;
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroyVirtualRegisterMap(
+    MLRA_VirtualRegisterMap *map
+);
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyVirtualRegisterMap, 1)]]
+MLRA_VirtualRegisterMap *MLRA_CreateVirtualRegisterMap(void);
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void MLRA_ClearVirtualRegisterMap(
+    MLRA_VirtualRegisterMap *map
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetVirtualRegisterCountInMap(
+    MLRA_VirtualRegisterMap const *map
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_FindVirtualRegisterInMap(
+    MLRA_VirtualRegisterMap const *map,
+    int virtualRegisterId
+);
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+size_t MLRA_AddVirtualRegisterToMap(
+    MLRA_VirtualRegisterMap *map,
+    int virtualRegisterId
+);
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+int MLRA_GetVirtualRegisterInMap(
+    MLRA_VirtualRegisterMap const *map,
+    size_t denseIndex
+);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,329 @@
+#include "MLRA/Core/AllocationEvaluator.h"
+#include "MLRA/Core/RegisterCost.h"
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/Solution.h"
+#include "MLRA/Core/VirtualRegisterMap.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/*
+ * Virtual register ids index the value table directly while they span at most this many slots per instruction, plus
+ * a fixed allowance for short scenarios. Sparser ids are numbered through a virtual register map first.
+ */
+static constexpr int64_t DenseValueSlotsPerInstruction = 4;
+static constexpr int64_t DenseValueSlotAllowance = 65536;
+
+typedef struct
+{
+    int32_t minimum;
+    int32_t maximum;
+} Int32Range;
+
+/*
+ * Locations are kept as slots: slot zero stands for memory and slot r + 1 for register r, so that the cost table can
+ * carry the memory spill cost in slot zero. With that, moving a value to memory costs the same as moving it into a
+ * register, and the evaluation runs without branching on the location.
+ *
+ * A value evicted from a register is written back only if it is loaded again before being stored. Rather than
+ * computing liveness up front, the eviction remembers the slot, and the next reference of the value charges the
+ * write back when it turns out to be a load.
+ */
+typedef struct
+{
+    int32_t slot;
+    int32_t evictedFrom;
+} ValueState;
+
+/*
+ * Occupants of empty slots and of the memory slot point at one extra value past the real ones, whose state evictions
+ * are free to overwrite.
+ */
+typedef struct
+{
+    ValueState *values;
+    int32_t *occupants;
+    MLRA_RegisterCost *slotCosts;
+    int32_t vacant;
+    int64_t cost;
+} AllocationState;
+
+/*
+ * Widens range to cover count values. With AVX2 this takes eight values per step.
+ */
+[[gnu::nonnull(1)]]
+static void WidenInt32Range(
+    Int32Range *const range,
+    int32_t const *const values,
+    size_t const count
+)
+{
+    int32_t minimum = range->minimum;
+    int32_t maximum = range->maximum;
+    size_t index = 0;
+
+#if defined(__AVX2__)
+    if (count >= 8) {
+        __m256i minima = _mm256_set1_epi32(minimum);
+        __m256i maxima = _mm256_set1_epi32(maximum);
+        for (; index + 8 <= count; index += 8) {
+            __m256i const block = _mm256_loadu_si256((__m256i const *)&values[index]);
+            minima = _mm256_min_epi32(minima, block);
+            maxima = _mm256_max_epi32(maxima, block);
+        }
+
+        alignas(32) int32_t lanes[2][8];
+        _mm256_store_si256((__m256i *)lanes[0], minima);
+        _mm256_store_si256((__m256i *)lanes[1], maxima);
+        for (size_t lane = 0; lane < 8; ++lane) {
+            minimum = lanes[0][lane] < minimum ? lanes[0][lane] : minimum;
+            maximum = lanes[1][lane] > maximum ? lanes[1][lane] : maximum;
+        }
+    }
+#endif
+
+    for (; index < count; ++index) {
+        minimum = values[index] < minimum ? values[index] : minimum;
+        maximum = values[index] > maximum ? values[index] : maximum;
+    }
+
+    range->minimum = minimum;
+    range->maximum = maximum;
+}
+
+[[gnu::pure]]
+static size_t FindInvalidLocation(
+    int32_t const *const locations,
+    size_t const count,
+    size_t const registerCount
+)
+{
+    for (size_t index = 0; index < count; ++index) {
+        int32_t const location = locations[index];
+        if (location < MLRA_SolutionLocation_Memory || (location >= 0 && (size_t)location >= registerCount)) {
+            return index;
+        }
+    }
+
+    return count;
+}
+
+/*
+ * Charges the instructions of one span. Value numbers are the virtual register ids minus base.
+ */
+[[gnu::nonnull(1, 2, 4, 6)]]
+static void EvaluateInstructionSpan(
+    AllocationState *const state,
+    int32_t const *const virtualRegisterIds,
+    int64_t const base,
+    uint64_t const *const storeBits,
+    size_t const bitOffset,
+    int32_t const *const locations,
+    size_t const length
+)
+{
+    ValueState *const values = state->values;
+    int32_t *const occupants = state->occupants;
+    MLRA_RegisterCost const *const slotCosts = state->slotCosts;
+    int32_t const vacant = state->vacant;
+    int64_t const memoryStore = slotCosts[0].store;
+    int64_t cost = state->cost;
+
+    for (size_t offset = 0; offset < length; ++offset) {
+        size_t const bit = bitOffset + offset;
+        bool const isStore = (storeBits[bit / 64] >> (bit % 64)) & 1;
+        int32_t const value = (int32_t)((int64_t)virtualRegisterIds[offset] - base);
+        int32_t const slot = locations[offset] + 1;
+        /* The fields are read one by one, as a wider load could not be forwarded from the recent narrow stores. */
+        int32_t const previousSlot = values[value].slot;
+        int32_t const evictedFrom = values[value].evictedFrom;
+
+        /*
+         * Charges are selected with masks rather than conditionals, which compilers tend to turn into branches that
+         * mispredict on every other instruction of an irregular allocation.
+         */
+        int64_t const loadMask = (int64_t)isStore - 1;
+        int64_t const writeBack = slotCosts[evictedFrom].load + memoryStore;
+        cost += writeBack & loadMask & -(int64_t)(evictedFrom != 0);
+
+        /* Leaving the previous slot first means a value staying in its register never evicts itself. */
+        occupants[previousSlot] = vacant;
+        int32_t const occupant = occupants[slot];
+        values[occupant] = (ValueState){0, slot};
+
+        /* Stores write the new slot; loads read it, and first move the value there unless it stayed in place. */
+        int64_t const movedMask = -(int64_t)(slot != previousSlot);
+        cost += ((int64_t)slotCosts[slot].store & (~loadMask | movedMask))
+            + ((int64_t)slotCosts[slot].load & loadMask)
+            + ((int64_t)slotCosts[previousSlot].load & loadMask & movedMask);
+
+        occupants[slot] = value;
+        occupants[0] = vacant;
+        values[value] = (ValueState){slot, 0};
+    }
+
+    state->cost = cost;
+}
+
+/*
+ * Numbers the virtual registers of the scenario densely, for ids too sparse to index the value table directly.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 2, 3)]]
+static bool NumberVirtualRegisters(
+    MLRA_Scenario const *const scenario,
+    int32_t *const values,
+    size_t *const valueCount,
+    size_t const count
+)
+{
+    MLRA_VirtualRegisterMap *const map = MLRA_CreateVirtualRegisterMap();
+    if (map == nullptr) {
+        return false;
+    }
+
+    bool succeeded = true;
+    for (size_t index = 0; succeeded && index < count;) {
+        size_t length;
+        int32_t const *const virtualRegisterIds = MLRA_GetVirtualRegisterIdSpanInScenario(scenario, index, &length);
+        for (size_t offset = 0; succeeded && offset < length; ++offset) {
+            size_t const denseIndex = MLRA_AddVirtualRegisterToMap(map, virtualRegisterIds[offset]);
+            succeeded = denseIndex < INT32_MAX;
+            values[index + offset] = (int32_t)denseIndex;
+        }
+        index += length;
+    }
+
+    *valueCount = MLRA_GetVirtualRegisterCountInMap(map);
+    MLRA_DestroyVirtualRegisterMap(map);
+
+    return succeeded;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1), gnu::access(read_only, 2, 3)]]
+MLRA_AllocationEvaluation MLRA_EvaluateAllocation(
+    MLRA_Scenario const *const scenario,
+    int32_t const *const locations,
+    size_t const count
+)
+{
+    size_t const instructionCount = MLRA_GetRegisterInstructionCountInScenario(scenario);
+    if (count != instructionCount) {
+        return (MLRA_AllocationEvaluation){
+            .error = MLRA_AllocationError_InstructionCount,
+            .instruction = instructionCount
+        };
+    }
+    if (count == 0) {
+        return (MLRA_AllocationEvaluation){};
+    }
+
+    size_t const registerCount = MLRA_GetRegisterCountInScenario(scenario);
+    Int32Range locationRange = {INT32_MAX, INT32_MIN};
+    WidenInt32Range(&locationRange, locations, count);
+    if (
+        locationRange.minimum < MLRA_SolutionLocation_Memory
+        || (locationRange.maximum >= 0 && (size_t)locationRange.maximum >= registerCount)
+    ) {
+        return (MLRA_AllocationEvaluation){
+            .error = MLRA_AllocationError_Location,
+            .instruction = FindInvalidLocation(locations, count, registerCount)
+        };
+    }
+
+    Int32Range idRange = {INT32_MAX, INT32_MIN};
+    for (size_t index = 0; index < count;) {
+        size_t length;
+        int32_t const *const virtualRegisterIds = MLRA_GetVirtualRegisterIdSpanInScenario(scenario, index, &length);
+        WidenInt32Range(&idRange, virtualRegisterIds, length);
+        index += length;
+    }
+
+    int64_t const idSpan = (int64_t)idRange.maximum - idRange.minimum + 1;
+    bool const dense = idSpan < INT32_MAX
+        && idSpan <= DenseValueSlotsPerInstruction * (int64_t)(count < INT32_MAX ? count : INT32_MAX)
+            + DenseValueSlotAllowance;
+
+    int32_t *numbered = nullptr;
+    size_t valueCount = (size_t)idSpan;
+    if (!dense) {
+        numbered = malloc(count * sizeof(int32_t));
+        if (numbered == nullptr || !NumberVirtualRegisters(scenario, numbered, &valueCount, count)) {
+            free(numbered);
+            return (MLRA_AllocationEvaluation){.error = MLRA_AllocationError_OutOfMemory};
+        }
+    }
+
+    size_t const slotCount = locationRange.maximum < 0 ? 1 : (size_t)locationRange.maximum + 2;
+    AllocationState state = {
+        .values = malloc((valueCount + 1) * sizeof(ValueState)),
+        .occupants = malloc(slotCount * sizeof(int32_t)),
+        .slotCosts = malloc(slotCount * sizeof(MLRA_RegisterCost)),
+        .vacant = (int32_t)valueCount
+    };
+
+    if (state.values == nullptr || state.occupants == nullptr || state.slotCosts == nullptr) {
+        free(state.slotCosts);
+        free(state.occupants);
+        free(state.values);
+        free(numbered);
+        return (MLRA_AllocationEvaluation){.error = MLRA_AllocationError_OutOfMemory};
+    }
+
+    for (size_t value = 0; value <= valueCount; ++value) {
+        state.values[value] = (ValueState){0, 0};
+    }
+    state.occupants[0] = state.vacant;
+    state.slotCosts[0] = MLRA_GetMemorySpillCostInScenario(scenario);
+    for (size_t slot = 1; slot < slotCount; ++slot) {
+        state.occupants[slot] = state.vacant;
+        state.slotCosts[slot] = MLRA_GetRegisterCostInScenario(scenario, slot - 1);
+    }
+
+    for (size_t index = 0; index < count;) {
+        size_t idLength;
+        size_t bitLength;
+        size_t bitOffset;
+        int32_t const *const virtualRegisterIds = MLRA_GetVirtualRegisterIdSpanInScenario(scenario, index, &idLength);
+        uint64_t const *const storeBits = MLRA_GetStoreBitSpanInScenario(scenario, index, &bitLength, &bitOffset);
+        size_t const length = idLength < bitLength ? idLength : bitLength;
+
+        EvaluateInstructionSpan(
+            &state,
+            dense ? virtualRegisterIds : &numbered[index],
+            dense ? idRange.minimum : 0,
+            storeBits,
+            bitOffset,
+            &locations[index],
+            length
+        );
+        index += length;
+    }
+
+    free(state.slotCosts);
+    free(state.occupants);
+    free(state.values);
+    free(numbered);
+
+    return (MLRA_AllocationEvaluation){.cost = state.cost};
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_only, 2)]]
+MLRA_AllocationEvaluation MLRA_EvaluateSolution(
+    MLRA_Scenario const *const scenario,
+    MLRA_Solution const *const solution
+)
+{
+    return MLRA_EvaluateAllocation(
+        scenario,
+        MLRA_GetInstructionLocationSpanInSolution(solution),
+        MLRA_GetInstructionCountInSolution(solution)
+    );
+}
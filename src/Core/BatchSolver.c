@@ -0,0 +1,247 @@
+#include "MLRA/Core/BatchSolver.h"
+#include "MLRA/Core/Platform.h"
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/Solution.h"
+#include "MLRA/Core/SolverWorkspace.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef struct
+{
+    _Atomic uint64_t range;
+    char padding[64 - sizeof(uint64_t)];
+} WorkQueue;
+
+typedef struct
+{
+    MLRA_Scenario const *const *scenarios;
+    MLRA_Solution **solutions;
+    MLRA_BatchSolveFunction solve;
+    void *context;
+    WorkQueue *queues;
+    size_t queueCount;
+    _Atomic size_t solvedCount;
+    _Atomic size_t stealCount;
+} BatchState;
+
+typedef struct
+{
+    BatchState *state;
+    size_t index;
+} BatchWorker;
+
+[[nodiscard, gnu::const]]
+static uint64_t PackWorkRange(
+    uint32_t const head,
+    uint32_t const tail
+)
+{
+    return (uint64_t)tail << 32 | head;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(write_only, 2)]]
+static bool TakeOwnJob(
+    WorkQueue *const queue,
+    uint32_t *const job
+)
+{
+    uint64_t range = atomic_load_explicit(&queue->range, memory_order_acquire);
+    for (;;) {
+        uint32_t const head = (uint32_t)range;
+        uint32_t const tail = (uint32_t)(range >> 32);
+        if (head >= tail) {
+            return false;
+        }
+
+        if (atomic_compare_exchange_weak_explicit(
+            &queue->range, &range, PackWorkRange(head + 1, tail), memory_order_acq_rel, memory_order_acquire
+        )) {
+            *job = head;
+            return true;
+        }
+    }
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2, 3), gnu::access(read_write, 1), gnu::access(read_write, 2), gnu::access(write_only, 3)]]
+static bool StealJobs(
+    WorkQueue *const victim,
+    WorkQueue *const own,
+    uint32_t *const job
+)
+{
+    uint64_t range = atomic_load_explicit(&victim->range, memory_order_acquire);
+    for (;;) {
+        uint32_t const head = (uint32_t)range;
+        uint32_t const tail = (uint32_t)(range >> 32);
+        if (head >= tail) {
+            return false;
+        }
+
+        uint32_t const stolen = (tail - head + 1) / 2;
+        uint32_t const begin = tail - stolen;
+        if (atomic_compare_exchange_weak_explicit(
+            &victim->range, &range, PackWorkRange(head, begin), memory_order_acq_rel, memory_order_acquire
+        )) {
+            atomic_store_explicit(&own->range, PackWorkRange(begin + 1, tail), memory_order_release);
+            *job = begin;
+            return true;
+        }
+    }
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_write, 1), gnu::access(write_only, 3)]]
+static bool FindJob(
+    BatchState *const state,
+    size_t const index,
+    uint32_t *const job
+)
+{
+    WorkQueue *const own = &state->queues[index];
+    if (TakeOwnJob(own, job)) {
+        return true;
+    }
+
+    for (size_t offset = 1; offset < state->queueCount; ++offset) {
+        WorkQueue *const victim = &state->queues[(index + offset) % state->queueCount];
+        if (StealJobs(victim, own, job)) {
+            atomic_fetch_add_explicit(&state->stealCount, 1, memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+[[gnu::nonnull(1)]]
+static void *RunBatchWorker(
+    void *const argument
+)
+{
+    BatchWorker const *const worker = argument;
+    BatchState *const state = worker->state;
+
+    MLRA_SolverWorkspace *workspace = MLRA_CreateSolverWorkspace();
+    if (workspace == nullptr) {
+        return nullptr;
+    }
+
+    size_t solvedCount = 0;
+    uint32_t job;
+    while (FindJob(state, worker->index, &job)) {
+        MLRA_Solution *solution = state->solve(state->scenarios[job], workspace, state->context);
+        state->solutions[job] = solution;
+        solvedCount += solution != nullptr;
+    }
+
+    atomic_fetch_add_explicit(&state->solvedCount, solvedCount, memory_order_relaxed);
+    MLRA_DestroySolverWorkspace(workspace);
+
+    return nullptr;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3, 6), gnu::access(read_only, 1, 2), gnu::access(write_only, 6, 2)]]
+bool MLRA_SolveScenarioBatch(
+    MLRA_Scenario const *const *const scenarios,
+    size_t const count,
+    MLRA_BatchSolveFunction const solve,
+    void *const context,
+    size_t const threadCount,
+    MLRA_Solution **const solutions,
+    MLRA_BatchSolveReport *const report
+)
+{
+    double const startTime = MLRA_GetMonotonicTime();
+    if (count > UINT32_MAX) {
+        return false;
+    }
+
+    size_t workerCount = threadCount == 0 ? MLRA_GetHardwareThreadCount() : threadCount;
+    if (workerCount > count) {
+        workerCount = count;
+    }
+    if (workerCount == 0) {
+        workerCount = 1;
+    }
+
+    WorkQueue *queues = malloc(workerCount * sizeof(WorkQueue));
+    BatchWorker *workers = malloc(workerCount * sizeof(BatchWorker));
+    pthread_t *threads = malloc(workerCount * sizeof(pthread_t));
+    bool *started = calloc(workerCount, sizeof(bool));
+    if (queues == nullptr || workers == nullptr || threads == nullptr || started == nullptr) {
+        free(started);
+        free(threads);
+        free(workers);
+        free(queues);
+        return false;
+    }
+
+    size_t totalWeight = 0;
+    for (size_t index = 0; index < count; ++index) {
+        solutions[index] = nullptr;
+        totalWeight += MLRA_GetRegisterInstructionCountInScenario(scenarios[index]) + 1;
+    }
+
+    size_t begin = 0;
+    size_t weight = 0;
+    for (size_t worker = 0; worker < workerCount; ++worker) {
+        size_t end = begin;
+        size_t const target = totalWeight / workerCount * (worker + 1);
+        while (end < count && (worker + 1 == workerCount || weight < target)) {
+            weight += MLRA_GetRegisterInstructionCountInScenario(scenarios[end]) + 1;
+            ++end;
+        }
+
+        atomic_init(&queues[worker].range, PackWorkRange((uint32_t)begin, (uint32_t)end));
+        begin = end;
+    }
+
+    BatchState state = {
+        .scenarios = scenarios,
+        .solutions = solutions,
+        .solve = solve,
+        .context = context,
+        .queues = queues,
+        .queueCount = workerCount
+    };
+    atomic_init(&state.solvedCount, 0);
+    atomic_init(&state.stealCount, 0);
+
+    for (size_t worker = 0; worker < workerCount; ++worker) {
+        workers[worker] = (BatchWorker){&state, worker};
+    }
+    for (size_t worker = 1; worker < workerCount; ++worker) {
+        started[worker] = pthread_create(&threads[worker], nullptr, RunBatchWorker, &workers[worker]) == 0;
+    }
+    RunBatchWorker(&workers[0]);
+    for (size_t worker = 1; worker < workerCount; ++worker) {
+        if (started[worker]) {
+            pthread_join(threads[worker], nullptr);
+        }
+    }
+
+    size_t const solvedCount = atomic_load_explicit(&state.solvedCount, memory_order_relaxed);
+    if (report != nullptr) {
+        *report = (MLRA_BatchSolveReport){
+            .scenarioCount = count,
+            .solvedCount = solvedCount,
+            .threadCount = workerCount,
+            .stealCount = atomic_load_explicit(&state.stealCount, memory_order_relaxed),
+            .seconds = MLRA_GetMonotonicTime() - startTime
+        };
+    }
+
+    free(started);
+    free(threads);
+    free(workers);
+    free(queues);
+
+    return solvedCount == count;
+}
@@ -0,0 +1,453 @@
+#include "MLRA/Core/BeladySolver.h"
+#include "MLRA/Core/RegisterCost.h"
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/Solution.h"
+#include "MLRA/Core/SolverTrace.h"
+#include "MLRA/Core/SolverWorkspace.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+ * Instructions between two progress reports, a power of two.
+ */
+static constexpr size_t BeladyProgressInterval = 1 << 16;
+
+typedef enum
+{
+    BeladyBuffer_RankedRegisters = MLRA_SolverWorkspaceBuffer_Solver,
+    BeladyBuffer_RankedClasses,
+    BeladyBuffer_ClassRanks,
+    BeladyBuffer_Occupants,
+    BeladyBuffer_ValueLocations,
+    BeladyBuffer_UsesAfter,
+    BeladyBuffer_OccupiedRegisters,
+    BeladyBuffer_OccupiedPositions,
+    BeladyBuffer_OccupiedNextUses,
+    BeladyBuffer_FreeRanks
+} BeladyBuffer;
+
+typedef struct
+{
+    MLRA_RegisterCost cost;
+    size_t index;
+} RankedRegister;
+
+typedef struct
+{
+    size_t next;
+    size_t end;
+} ClassRanks;
+
+typedef struct
+{
+    uint32_t *registers;
+    uint32_t *positions;
+    uint32_t *nextUses;
+    size_t count;
+} OccupiedHeap;
+
+typedef struct
+{
+    uint32_t *ranks;
+    size_t count;
+} FreeHeap;
+
+[[gnu::pure]]
+static int CompareRankedRegisters(
+    void const *const left,
+    void const *const right
+)
+{
+    RankedRegister const *const a = left;
+    RankedRegister const *const b = right;
+    int64_t const aTotal = (int64_t)a->cost.load + a->cost.store;
+    int64_t const bTotal = (int64_t)b->cost.load + b->cost.store;
+
+    if (aTotal != bTotal) {
+        return aTotal < bTotal ? -1 : 1;
+    }
+    if (a->cost.load != b->cost.load) {
+        return a->cost.load < b->cost.load ? -1 : 1;
+    }
+    if (a->cost.store != b->cost.store) {
+        return a->cost.store < b->cost.store ? -1 : 1;
+    }
+    return a->index < b->index ? -1 : (a->index > b->index ? 1 : 0);
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void SwapOccupiedEntries(
+    OccupiedHeap *const heap,
+    size_t const first,
+    size_t const second
+)
+{
+    uint32_t const reg = heap->registers[first];
+    heap->registers[first] = heap->registers[second];
+    heap->registers[second] = reg;
+    heap->positions[heap->registers[first]] = (uint32_t)first;
+    heap->positions[heap->registers[second]] = (uint32_t)second;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void SiftOccupiedEntry(
+    OccupiedHeap *const heap,
+    size_t position
+)
+{
+    while (position > 0) {
+        size_t const parent = (position - 1) / 2;
+        if (heap->nextUses[heap->registers[parent]] >= heap->nextUses[heap->registers[position]]) {
+            break;
+        }
+        SwapOccupiedEntries(heap, parent, position);
+        position = parent;
+    }
+
+    for (;;) {
+        size_t const left = 2 * position + 1;
+        size_t largest = position;
+        if (left < heap->count && heap->nextUses[heap->registers[left]] > heap->nextUses[heap->registers[largest]]) {
+            largest = left;
+        }
+        if (
+            left + 1 < heap->count
+            && heap->nextUses[heap->registers[left + 1]] > heap->nextUses[heap->registers[largest]]
+        ) {
+            largest = left + 1;
+        }
+        if (largest == position) {
+            break;
+        }
+        SwapOccupiedEntries(heap, position, largest);
+        position = largest;
+    }
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void PushOccupiedRegister(
+    OccupiedHeap *const heap,
+    uint32_t const reg,
+    uint32_t const nextUse
+)
+{
+    heap->nextUses[reg] = nextUse;
+    heap->registers[heap->count] = reg;
+    heap->positions[reg] = (uint32_t)heap->count;
+    SiftOccupiedEntry(heap, heap->count++);
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void UpdateOccupiedRegister(
+    OccupiedHeap *const heap,
+    uint32_t const reg,
+    uint32_t const nextUse
+)
+{
+    heap->nextUses[reg] = nextUse;
+    SiftOccupiedEntry(heap, heap->positions[reg]);
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void RemoveOccupiedRegister(
+    OccupiedHeap *const heap,
+    uint32_t const reg
+)
+{
+    assert(heap->count > 0);
+
+    size_t const position = heap->positions[reg];
+    size_t const last = --heap->count;
+    if (position != last) {
+        heap->registers[position] = heap->registers[last];
+        heap->positions[heap->registers[position]] = (uint32_t)position;
+        SiftOccupiedEntry(heap, position);
+    }
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void PushFreeRank(
+    FreeHeap *const heap,
+    uint32_t const rank
+)
+{
+    size_t position = heap->count++;
+    while (position > 0 && heap->ranks[(position - 1) / 2] > rank) {
+        heap->ranks[position] = heap->ranks[(position - 1) / 2];
+        position = (position - 1) / 2;
+    }
+    heap->ranks[position] = rank;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static uint32_t PopFreeRank(
+    FreeHeap *const heap
+)
+{
+    assert(heap->count > 0);
+
+    uint32_t const top = heap->ranks[0];
+    uint32_t const rank = heap->ranks[--heap->count];
+    size_t position = 0;
+    for (;;) {
+        size_t child = 2 * position + 1;
+        if (child >= heap->count) {
+            break;
+        }
+        if (child + 1 < heap->count && heap->ranks[child + 1] < heap->ranks[child]) {
+            ++child;
+        }
+        if (heap->ranks[child] >= rank) {
+            break;
+        }
+        heap->ranks[position] = heap->ranks[child];
+        position = child;
+    }
+    heap->ranks[position] = rank;
+
+    return top;
+}
+
+[[gnu::const]]
+static int64_t GetRegisterBenefit(
+    MLRA_RegisterCost const cost,
+    MLRA_RegisterCost const memorySpillCost,
+    bool const isStore,
+    uint32_t const usesAfter
+)
+{
+    int64_t const entry = isStore
+        ? (int64_t)memorySpillCost.store - cost.store
+        : -((int64_t)cost.store + cost.load);
+    return entry + (int64_t)usesAfter * ((int64_t)memorySpillCost.load - cost.load);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_write, 2)]]
+MLRA_Solution *MLRA_SolveScenarioWithBeladyInWorkspace(
+    MLRA_Scenario const *const scenario,
+    MLRA_SolverWorkspace *const workspace
+)
+{
+    size_t const registerCount = MLRA_GetRegisterCountInScenario(scenario);
+    if (registerCount > INT32_MAX) {
+        return nullptr;
+    }
+
+    MLRA_SolverTrace *trace = MLRA_CreateSolverTraceInWorkspace(scenario, workspace);
+    if (trace == nullptr) {
+        return nullptr;
+    }
+
+    size_t const instructionCount = MLRA_GetInstructionCountInSolverTrace(trace);
+    size_t const valueCount = MLRA_GetValueCountInSolverTrace(trace);
+    int32_t const *const values = MLRA_GetValuesInSolverTrace(trace);
+    uint32_t const *const nextReferences = MLRA_GetNextReferencesInSolverTrace(trace);
+    bool const *const isStore = MLRA_GetStoreFlagsInSolverTrace(trace);
+    bool const *const liveAfter = MLRA_GetLiveAfterFlagsInSolverTrace(trace);
+
+    /* No more registers than values are ever taken, so only that many of the cheapest ones are ranked. */
+    size_t const rankCount = registerCount < valueCount ? registerCount : valueCount;
+    size_t const costClassCount = MLRA_GetRegisterCostClassCountInScenario(scenario);
+    size_t const rankAllocation = rankCount == 0 ? 1 : rankCount;
+    size_t const classAllocation = costClassCount == 0 ? 1 : costClassCount;
+    size_t const valueAllocation = valueCount == 0 ? 1 : valueCount;
+    size_t const instructionAllocation = instructionCount == 0 ? 1 : instructionCount;
+
+    MLRA_Solution *solution = MLRA_CreateSolution(instructionCount);
+    RankedRegister *rankedRegisters = MLRA_ReserveBufferInSolverWorkspace(
+        workspace, BeladyBuffer_RankedRegisters, rankAllocation * sizeof(RankedRegister)
+    );
+    RankedRegister *rankedClasses = MLRA_ReserveBufferInSolverWorkspace(
+        workspace, BeladyBuffer_RankedClasses, classAllocation * sizeof(RankedRegister)
+    );
+    ClassRanks *classRanks = MLRA_ReserveBufferInSolverWorkspace(
+        workspace, BeladyBuffer_ClassRanks, classAllocation * sizeof(ClassRanks)
+    );
+    int32_t *occupants = MLRA_ReserveBufferInSolverWorkspace(
+        workspace, BeladyBuffer_Occupants, rankAllocation * sizeof(int32_t)
+    );
+    int32_t *valueLocations = MLRA_ReserveBufferInSolverWorkspace(
+        workspace, BeladyBuffer_ValueLocations, valueAllocation * sizeof(int32_t)
+    );
+    uint32_t *usesAfter = MLRA_ReserveBufferInSolverWorkspace(
+        workspace, BeladyBuffer_UsesAfter, instructionAllocation * sizeof(uint32_t)
+    );
+    OccupiedHeap occupied = {
+        MLRA_ReserveBufferInSolverWorkspace(
+            workspace, BeladyBuffer_OccupiedRegisters, rankAllocation * sizeof(uint32_t)
+        ),
+        MLRA_ReserveBufferInSolverWorkspace(
+            workspace, BeladyBuffer_OccupiedPositions, rankAllocation * sizeof(uint32_t)
+        ),
+        MLRA_ReserveBufferInSolverWorkspace(
+            workspace, BeladyBuffer_OccupiedNextUses, rankAllocation * sizeof(uint32_t)
+        ),
+        0
+    };
+    FreeHeap freeRegisters = {
+        MLRA_ReserveBufferInSolverWorkspace(workspace, BeladyBuffer_FreeRanks, rankAllocation * sizeof(uint32_t)),
+        0
+    };
+
+    if (
+        solution == nullptr || rankedRegisters == nullptr || rankedClasses == nullptr || classRanks == nullptr
+        || occupants == nullptr || valueLocations == nullptr || usesAfter == nullptr || occupied.registers == nullptr
+        || occupied.positions == nullptr || occupied.nextUses == nullptr || freeRegisters.ranks == nullptr
+    ) {
+        MLRA_DestroySolution(solution);
+        MLRA_DestroySolverTrace(trace);
+        return nullptr;
+    }
+
+    MLRA_RegisterCost const memorySpillCost = MLRA_GetMemorySpillCostInScenario(scenario);
+
+    /*
+     * Ranking the classes and then the registers of each class by index gives the order of ranking every register,
+     * since classes differ in cost. The registers are read off the run table one span at a time.
+     */
+    for (size_t costClass = 0; costClass < costClassCount; ++costClass) {
+        MLRA_RegisterCost const cost = MLRA_GetRegisterCostOfCostClassInScenario(scenario, costClass);
+        rankedClasses[costClass] = (RankedRegister){cost, costClass};
+    }
+    qsort(rankedClasses, costClassCount, sizeof(RankedRegister), CompareRankedRegisters);
+
+    size_t ranked = 0;
+    for (size_t order = 0; order < costClassCount; ++order) {
+        size_t const costClass = rankedClasses[order].index;
+        size_t const count = MLRA_GetRegisterCountInCostClassOfScenario(scenario, costClass);
+        size_t const taken = count < rankCount - ranked ? count : rankCount - ranked;
+        classRanks[costClass] = (ClassRanks){ranked, ranked + taken};
+        ranked += taken;
+    }
+
+    for (size_t reg = 0, length = 0; ranked != 0 && reg < registerCount; reg += length) {
+        size_t const costClass = MLRA_GetRegisterCostClassSpanInScenario(scenario, reg, &length);
+        MLRA_RegisterCost const cost = MLRA_GetRegisterCostOfCostClassInScenario(scenario, costClass);
+        ClassRanks *const ranks = &classRanks[costClass];
+        for (size_t offset = 0; offset < length && ranks->next < ranks->end; ++offset) {
+            rankedRegisters[ranks->next++] = (RankedRegister){cost, reg + offset};
+            --ranked;
+        }
+    }
+
+    for (size_t rank = 0; rank < rankCount; ++rank) {
+        occupants[rank] = -1;
+        freeRegisters.ranks[rank] = (uint32_t)rank;
+    }
+    freeRegisters.count = rankCount;
+
+    for (size_t value = 0; value < valueCount; ++value) {
+        valueLocations[value] = MLRA_SolutionLocation_Memory;
+    }
+
+    for (size_t index = instructionCount; index-- > 0;) {
+        usesAfter[index] = liveAfter[index] ? usesAfter[nextReferences[index]] + 1 : 0;
+    }
+
+    /* Registers are tracked by rank; only the solution names them by index. */
+    int64_t cost = 0;
+    for (size_t index = 0; index < instructionCount; ++index) {
+        if (
+            index % BeladyProgressInterval == 0
+            && !MLRA_ReportProgressInSolverWorkspace(workspace, index, instructionCount)
+        ) {
+            MLRA_DestroySolution(solution);
+            MLRA_DestroySolverTrace(trace);
+            return nullptr;
+        }
+
+        int32_t const value = values[index];
+        int32_t const current = valueLocations[value];
+
+        if (!isStore[index] && current != MLRA_SolutionLocation_Memory) {
+            cost += rankedRegisters[current].cost.load;
+            MLRA_SetInstructionLocationInSolution(solution, index, (int32_t)rankedRegisters[current].index);
+
+            if (liveAfter[index]) {
+                UpdateOccupiedRegister(&occupied, (uint32_t)current, nextReferences[index]);
+            }
+            else {
+                RemoveOccupiedRegister(&occupied, (uint32_t)current);
+                PushFreeRank(&freeRegisters, (uint32_t)current);
+                occupants[current] = -1;
+                valueLocations[value] = MLRA_SolutionLocation_Memory;
+            }
+            continue;
+        }
+
+        if (!isStore[index]) {
+            cost += memorySpillCost.load;
+        }
+
+        int32_t location = MLRA_SolutionLocation_Memory;
+        if (freeRegisters.count > 0 && (isStore[index] || liveAfter[index])) {
+            RankedRegister const candidate = rankedRegisters[freeRegisters.ranks[0]];
+            if (GetRegisterBenefit(candidate.cost, memorySpillCost, isStore[index], usesAfter[index]) > 0) {
+                location = (int32_t)PopFreeRank(&freeRegisters);
+                if (liveAfter[index]) {
+                    PushOccupiedRegister(&occupied, (uint32_t)location, nextReferences[index]);
+                }
+                else {
+                    PushFreeRank(&freeRegisters, (uint32_t)location);
+                }
+            }
+        }
+        else if (occupied.count > 0 && liveAfter[index]) {
+            uint32_t const rank = occupied.registers[0];
+            MLRA_RegisterCost const candidate = rankedRegisters[rank].cost;
+            int64_t const spill = (int64_t)candidate.load + memorySpillCost.store;
+            if (
+                occupied.nextUses[rank] > nextReferences[index]
+                && GetRegisterBenefit(candidate, memorySpillCost, isStore[index], usesAfter[index]) > spill
+            ) {
+                cost += spill;
+                valueLocations[occupants[rank]] = MLRA_SolutionLocation_Memory;
+                UpdateOccupiedRegister(&occupied, rank, nextReferences[index]);
+                location = (int32_t)rank;
+            }
+        }
+
+        if (location == MLRA_SolutionLocation_Memory) {
+            if (isStore[index]) {
+                cost += memorySpillCost.store;
+            }
+            MLRA_SetInstructionLocationInSolution(solution, index, location);
+            continue;
+        }
+
+        MLRA_RegisterCost const registerCost = rankedRegisters[location].cost;
+        cost += isStore[index] ? registerCost.store : (int64_t)registerCost.store + registerCost.load;
+        if (liveAfter[index]) {
+            occupants[location] = value;
+            valueLocations[value] = location;
+        }
+
+        MLRA_SetInstructionLocationInSolution(solution, index, (int32_t)rankedRegisters[location].index);
+    }
+
+    MLRA_SetSolutionCost(solution, cost);
+    MLRA_DestroySolverTrace(trace);
+
+    return solution;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_Solution *MLRA_SolveScenarioWithBelady(
+    MLRA_Scenario const *const scenario
+)
+{
+    MLRA_SolverWorkspace *workspace = MLRA_CreateSolverWorkspace();
+    if (workspace == nullptr) {
+        return nullptr;
+    }
+
+    MLRA_Solution *solution = MLRA_SolveScenarioWithBeladyInWorkspace(scenario, workspace);
+    MLRA_DestroySolverWorkspace(workspace);
+
+    return solution;
+}
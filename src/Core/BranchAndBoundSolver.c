@@ -0,0 +1,900 @@
+#include "MLRA/Core/BranchAndBoundSolver.h"
+#include "MLRA/Core/AllocationEvaluator.h"
+#include "MLRA/Core/BeladySolver.h"
+#include "MLRA/Core/LowerBound.h"
+#include "MLRA/Core/Platform.h"
+#include "MLRA/Core/RegisterCost.h"
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/Solution.h"
+#include "MLRA/Core/SolverTrace.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static constexpr int32_t EmptyRegister = -1;
+static constexpr size_t TimeCheckInterval = 1024;
+
+typedef struct
+{
+    int64_t load;
+    int64_t store;
+    size_t costClass;
+} SearchRegister;
+
+/*
+ * Read-only tables shared by the workers. The bound of a state before instruction i is its cost plus memoryBounds[i],
+ * the reference bounds of every value as if it lived in memory, plus the register bound of the state: for each
+ * occupied register, how much the bound of its occupant changes for living there. remainingBounds[i] raises that
+ * with the register pressure of the instructions left, which the reference bounds ignore. Levels are laid out back to
+ * back in the candidate stack of each worker, from candidateOffsets[i] to candidateOffsets[i + 1].
+ */
+typedef struct
+{
+    int32_t const *values;
+    uint32_t const *nextReferences;
+    bool const *isStore;
+    bool const *liveAfter;
+    int64_t *fromMemory;
+    int64_t *fromRegister;
+    int64_t *memoryBounds;
+    int64_t *remainingBounds;
+    size_t *candidateOffsets;
+    SearchRegister *registers;
+    size_t count;
+    size_t valueCount;
+    size_t registerCount;
+    size_t costClassCount;
+    int64_t memoryLoad;
+    int64_t memoryStore;
+    int64_t cheapestRegisterLoad;
+} SearchProblem;
+
+typedef struct
+{
+    int64_t bound;
+    int32_t location;
+} SearchCandidate;
+
+/*
+ * What applying an instruction overwrote, so that backtracking restores the state in constant time.
+ */
+typedef struct
+{
+    int64_t cost;
+    int64_t registerBound;
+    int32_t previous;
+    int32_t location;
+    int32_t evicted;
+    uint32_t evictedNext;
+} SearchStep;
+
+typedef struct SearchState_ SearchState;
+
+/*
+ * Every worker runs a depth-first search below its base level. The open candidates of each level, the path leading to
+ * the current state, busy, base and depth are guarded by lock, as thieves read them to take over the shallowest open
+ * candidate. Everything else belongs to the worker alone.
+ */
+typedef struct
+{
+    pthread_mutex_t lock;
+    bool busy;
+    size_t base;
+    size_t depth;
+    size_t *candidateBegins;
+    size_t *candidateEnds;
+    SearchCandidate *candidates;
+    int32_t *path;
+
+    SearchState *state;
+    SearchStep *steps;
+    int32_t *stolenPath;
+    int32_t *occupants;
+    uint32_t *occupantNexts;
+    int32_t *valueLocations;
+    uint64_t *classStamps;
+    uint64_t stamp;
+    int64_t cost;
+    int64_t registerBound;
+    size_t nodeCount;
+    size_t index;
+} SearchWorker;
+
+struct SearchState_
+{
+    SearchProblem const *problem;
+    SearchWorker *workers;
+    size_t workerCount;
+    pthread_mutex_t bestLock;
+    int32_t *bestPath;
+    int64_t openBound;
+    _Atomic int64_t bestCost;
+    _Atomic size_t activeCount;
+    _Atomic size_t stealCount;
+    _Atomic bool stopped;
+    bool timeLimited;
+    double deadline;
+};
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static int64_t GetRegisterDelta(
+    SearchProblem const *const problem,
+    int32_t const reg,
+    uint32_t const next
+)
+{
+    return problem->fromRegister[next] + problem->registers[reg].load - problem->cheapestRegisterLoad
+        - problem->fromMemory[next];
+}
+
+/*
+ * Cost of an instruction at location for a value living at previous, leaving out the write back of an evicted value.
+ */
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static int64_t GetInstructionCost(
+    SearchProblem const *const problem,
+    size_t const index,
+    int32_t const previous,
+    int32_t const location
+)
+{
+    int64_t const load = location >= 0 ? problem->registers[location].load : problem->memoryLoad;
+    int64_t const store = location >= 0 ? problem->registers[location].store : problem->memoryStore;
+
+    if (problem->isStore[index]) {
+        return store;
+    }
+    if (location == previous) {
+        return load;
+    }
+
+    return store + load + (previous >= 0 ? problem->registers[previous].load : problem->memoryLoad);
+}
+
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(read_only, 2)]]
+static void ApplyInstruction(
+    SearchWorker *const worker,
+    SearchProblem const *const problem,
+    size_t const index,
+    int32_t const location
+)
+{
+    int32_t const value = problem->values[index];
+    int32_t const previous = worker->valueLocations[value];
+    SearchStep *const step = &worker->steps[index];
+    *step = (SearchStep){worker->cost, worker->registerBound, previous, location, EmptyRegister, 0};
+
+    int64_t cost = worker->cost + GetInstructionCost(problem, index, previous, location);
+    int64_t registerBound = worker->registerBound;
+    if (previous >= 0) {
+        worker->occupants[previous] = EmptyRegister;
+        registerBound -= GetRegisterDelta(problem, previous, (uint32_t)index);
+    }
+
+    if (location >= 0 && worker->occupants[location] != EmptyRegister) {
+        step->evicted = worker->occupants[location];
+        step->evictedNext = worker->occupantNexts[location];
+        worker->occupants[location] = EmptyRegister;
+        worker->valueLocations[step->evicted] = MLRA_SolutionLocation_Memory;
+        cost += problem->registers[location].load + problem->memoryStore;
+        registerBound -= GetRegisterDelta(problem, location, step->evictedNext);
+    }
+
+    /* Registers only hold values that are loaded again; anything else might as well live in memory. */
+    worker->valueLocations[value] = MLRA_SolutionLocation_Memory;
+    if (location >= 0 && problem->liveAfter[index]) {
+        uint32_t const next = problem->nextReferences[index];
+        worker->occupants[location] = value;
+        worker->occupantNexts[location] = next;
+        worker->valueLocations[value] = location;
+        registerBound += GetRegisterDelta(problem, location, next);
+    }
+
+    worker->cost = cost;
+    worker->registerBound = registerBound;
+}
+
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(read_only, 2)]]
+static void UndoInstruction(
+    SearchWorker *const worker,
+    SearchProblem const *const problem,
+    size_t const index
+)
+{
+    int32_t const value = problem->values[index];
+    SearchStep const *const step = &worker->steps[index];
+
+    if (step->location >= 0) {
+        worker->occupants[step->location] = step->evicted;
+        worker->occupantNexts[step->location] = step->evictedNext;
+        if (step->evicted != EmptyRegister) {
+            worker->valueLocations[step->evicted] = step->location;
+        }
+    }
+    if (step->previous >= 0) {
+        worker->occupants[step->previous] = value;
+        worker->occupantNexts[step->previous] = (uint32_t)index;
+    }
+
+    worker->valueLocations[value] = step->previous;
+    worker->cost = step->cost;
+    worker->registerBound = step->registerBound;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void InsertCandidate(
+    SearchCandidate *const candidates,
+    size_t const count,
+    SearchCandidate const candidate
+)
+{
+    size_t position = count;
+    while (position > 0 && candidates[position - 1].bound > candidate.bound) {
+        candidates[position] = candidates[position - 1];
+        --position;
+    }
+    candidates[position] = candidate;
+}
+
+/*
+ * Bound of a candidate that charges the instruction charge and changes the register bound by registerChange. The
+ * remaining bounds hold from any state, so the larger of the two bounds applies.
+ */
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_only, 2)]]
+static int64_t GetCandidateBound(
+    SearchWorker const *const worker,
+    SearchProblem const *const problem,
+    size_t const index,
+    int64_t const charge,
+    int64_t const registerBound
+)
+{
+    int64_t const valueBound = problem->memoryBounds[index + 1] + registerBound;
+    int64_t const remainingBound = problem->remainingBounds[index + 1];
+
+    return worker->cost + charge + (valueBound > remainingBound ? valueBound : remainingBound);
+}
+
+/*
+ * Lists the locations worth trying for instruction index with a bound below best, cheapest bound first. Empty
+ * registers of one cost class lead to equivalent states, so only the first of each class is tried, and none of the
+ * class the value already lives in. When the value is not loaded again, memory and the empty registers all leave the
+ * same state, so only the cheapest of them is tried, while each occupied register stays a candidate of its own.
+ */
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(read_only, 2)]]
+static void ExpandInstruction(
+    SearchWorker *const worker,
+    SearchProblem const *const problem,
+    size_t const index,
+    int64_t const best
+)
+{
+    int32_t const value = problem->values[index];
+    int32_t const previous = worker->valueLocations[value];
+    bool const live = problem->liveAfter[index];
+    uint32_t const next = problem->nextReferences[index];
+    int64_t const registerBound = worker->registerBound
+        - (previous >= 0 ? GetRegisterDelta(problem, previous, (uint32_t)index) : 0);
+
+    SearchCandidate *const candidates = &worker->candidates[problem->candidateOffsets[index]];
+    int64_t cheapestCharge = GetInstructionCost(problem, index, previous, MLRA_SolutionLocation_Memory);
+    int32_t cheapestLocation = MLRA_SolutionLocation_Memory;
+    size_t count = 0;
+    if (live) {
+        int64_t const bound = GetCandidateBound(worker, problem, index, cheapestCharge, registerBound);
+        if (bound < best) {
+            candidates[count++] = (SearchCandidate){bound, MLRA_SolutionLocation_Memory};
+        }
+    }
+
+    uint64_t const stamp = ++worker->stamp;
+    if (previous >= 0) {
+        worker->classStamps[problem->registers[previous].costClass] = stamp;
+    }
+
+    for (size_t reg = 0; reg < problem->registerCount; ++reg) {
+        int32_t const occupant = worker->occupants[reg];
+        int64_t charge = GetInstructionCost(problem, index, previous, (int32_t)reg);
+        int64_t registerChange = 0;
+
+        if (occupant == EmptyRegister) {
+            size_t const costClass = problem->registers[reg].costClass;
+            if (worker->classStamps[costClass] == stamp) {
+                continue;
+            }
+            worker->classStamps[costClass] = stamp;
+        }
+        else if (occupant != value) {
+            charge += problem->registers[reg].load + problem->memoryStore;
+            registerChange -= GetRegisterDelta(problem, (int32_t)reg, worker->occupantNexts[reg]);
+        }
+
+        if (!live && (occupant == EmptyRegister || occupant == value)) {
+            cheapestLocation = charge < cheapestCharge ? (int32_t)reg : cheapestLocation;
+            cheapestCharge = charge < cheapestCharge ? charge : cheapestCharge;
+            continue;
+        }
+
+        registerChange += live ? GetRegisterDelta(problem, (int32_t)reg, next) : 0;
+        int64_t const bound = GetCandidateBound(worker, problem, index, charge, registerBound + registerChange);
+        if (bound < best) {
+            InsertCandidate(candidates, count++, (SearchCandidate){bound, (int32_t)reg});
+        }
+    }
+
+    if (!live) {
+        int64_t const bound = GetCandidateBound(worker, problem, index, cheapestCharge, registerBound);
+        if (bound < best) {
+            InsertCandidate(candidates, count++, (SearchCandidate){bound, cheapestLocation});
+        }
+    }
+
+    worker->candidateBegins[index] = problem->candidateOffsets[index];
+    worker->candidateEnds[index] = problem->candidateOffsets[index] + count;
+}
+
+/*
+ * Keeps the complete allocation the worker reached if it beats the best one so far.
+ */
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(read_only, 2)]]
+static void RecordAllocation(
+    SearchState *const state,
+    SearchWorker const *const worker
+)
+{
+    if (worker->cost >= atomic_load_explicit(&state->bestCost, memory_order_relaxed)) {
+        return;
+    }
+
+    pthread_mutex_lock(&state->bestLock);
+    if (worker->cost < atomic_load_explicit(&state->bestCost, memory_order_relaxed)) {
+        memcpy(state->bestPath, worker->path, state->problem->count * sizeof(int32_t));
+        atomic_store_explicit(&state->bestCost, worker->cost, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&state->bestLock);
+}
+
+/*
+ * Opens the level below the instruction just applied, or records the allocation once every instruction has one.
+ */
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void OpenLevel(
+    SearchWorker *const worker,
+    size_t const depth
+)
+{
+    SearchState *const state = worker->state;
+    SearchProblem const *const problem = state->problem;
+
+    ++worker->nodeCount;
+    if (depth < problem->count) {
+        ExpandInstruction(worker, problem, depth, atomic_load_explicit(&state->bestCost, memory_order_relaxed));
+        return;
+    }
+
+    RecordAllocation(state, worker);
+    worker->candidateBegins[depth] = problem->candidateOffsets[depth];
+    worker->candidateEnds[depth] = problem->candidateOffsets[depth];
+}
+
+/*
+ * Drops the open candidates of a stopped search. The smallest of their bounds is a bound for everything left
+ * unexplored, since every subtree pruned earlier had a bound of at least the best cost.
+ */
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void CloseSubtree(
+    SearchWorker *const worker
+)
+{
+    SearchState *const state = worker->state;
+    int64_t openBound = INT64_MAX;
+
+    pthread_mutex_lock(&worker->lock);
+    for (size_t level = worker->base; level <= worker->depth; ++level) {
+        for (size_t position = worker->candidateBegins[level]; position < worker->candidateEnds[level]; ++position) {
+            int64_t const bound = worker->candidates[position].bound;
+            openBound = bound < openBound ? bound : openBound;
+        }
+        worker->candidateBegins[level] = worker->candidateEnds[level];
+    }
+    worker->busy = false;
+    pthread_mutex_unlock(&worker->lock);
+    atomic_fetch_sub_explicit(&state->activeCount, 1, memory_order_acq_rel);
+
+    pthread_mutex_lock(&state->bestLock);
+    state->openBound = openBound < state->openBound ? openBound : state->openBound;
+    pthread_mutex_unlock(&state->bestLock);
+}
+
+/*
+ * Searches the subtree the worker owns until it runs out of open candidates or the search stops. Taking a candidate
+ * and publishing the new depth share one critical section, so an uncontended worker locks once per node.
+ */
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void SearchSubtree(
+    SearchWorker *const worker
+)
+{
+    SearchState *const state = worker->state;
+    SearchProblem const *const problem = state->problem;
+    size_t depth = worker->depth;
+    size_t untimedCount = 0;
+
+    for (;;) {
+        if (atomic_load_explicit(&state->stopped, memory_order_relaxed)) {
+            CloseSubtree(worker);
+            return;
+        }
+        if (state->timeLimited && ++untimedCount == TimeCheckInterval) {
+            untimedCount = 0;
+            if (MLRA_GetMonotonicTime() >= state->deadline) {
+                atomic_store_explicit(&state->stopped, true, memory_order_relaxed);
+                continue;
+            }
+        }
+
+        pthread_mutex_lock(&worker->lock);
+        while (depth > worker->base && worker->candidateBegins[depth] == worker->candidateEnds[depth]) {
+            UndoInstruction(worker, problem, --depth);
+        }
+        worker->depth = depth;
+
+        if (worker->candidateBegins[depth] == worker->candidateEnds[depth]) {
+            worker->busy = false;
+            pthread_mutex_unlock(&worker->lock);
+            atomic_fetch_sub_explicit(&state->activeCount, 1, memory_order_acq_rel);
+            return;
+        }
+
+        SearchCandidate const candidate = worker->candidates[worker->candidateBegins[depth]++];
+        worker->path[depth] = candidate.location;
+        pthread_mutex_unlock(&worker->lock);
+
+        if (candidate.bound >= atomic_load_explicit(&state->bestCost, memory_order_relaxed)) {
+            continue;
+        }
+
+        ApplyInstruction(worker, problem, depth, candidate.location);
+        OpenLevel(worker, ++depth);
+    }
+}
+
+/*
+ * Takes the shallowest open candidate of another worker, which tends to carry the largest subtree, and moves the state
+ * of the thief onto it: back to the longest prefix both paths share, then forward along the path of the victim.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static bool StealSubtree(
+    SearchWorker *const worker
+)
+{
+    SearchState *const state = worker->state;
+    SearchProblem const *const problem = state->problem;
+
+    for (size_t offset = 1; offset < state->workerCount; ++offset) {
+        SearchWorker *const victim = &state->workers[(worker->index + offset) % state->workerCount];
+
+        pthread_mutex_lock(&victim->lock);
+        size_t level = victim->base;
+        while (
+            victim->busy
+            && level <= victim->depth
+            && victim->candidateBegins[level] == victim->candidateEnds[level]
+        ) {
+            ++level;
+        }
+        if (!victim->busy || level > victim->depth) {
+            pthread_mutex_unlock(&victim->lock);
+            continue;
+        }
+
+        SearchCandidate const candidate = victim->candidates[--victim->candidateEnds[level]];
+        memcpy(worker->stolenPath, victim->path, level * sizeof(int32_t));
+        atomic_fetch_add_explicit(&state->activeCount, 1, memory_order_acq_rel);
+        pthread_mutex_unlock(&victim->lock);
+
+        if (candidate.bound >= atomic_load_explicit(&state->bestCost, memory_order_relaxed)) {
+            atomic_fetch_sub_explicit(&state->activeCount, 1, memory_order_acq_rel);
+            continue;
+        }
+
+        size_t depth = worker->depth;
+        size_t shared = 0;
+        while (shared < depth && shared < level && worker->path[shared] == worker->stolenPath[shared]) {
+            ++shared;
+        }
+        while (depth > shared) {
+            UndoInstruction(worker, problem, --depth);
+        }
+        for (; depth < level; ++depth) {
+            worker->path[depth] = worker->stolenPath[depth];
+            ApplyInstruction(worker, problem, depth, worker->path[depth]);
+        }
+        worker->path[level] = candidate.location;
+        ApplyInstruction(worker, problem, level, candidate.location);
+        OpenLevel(worker, level + 1);
+
+        pthread_mutex_lock(&worker->lock);
+        worker->busy = true;
+        worker->base = level + 1;
+        worker->depth = level + 1;
+        pthread_mutex_unlock(&worker->lock);
+        atomic_fetch_add_explicit(&state->stealCount, 1, memory_order_relaxed);
+
+        return true;
+    }
+
+    return false;
+}
+
+[[gnu::nonnull(1)]]
+static void *RunSearchWorker(
+    void *const argument
+)
+{
+    SearchWorker *const worker = argument;
+    SearchState *const state = worker->state;
+
+    if (worker->busy) {
+        SearchSubtree(worker);
+    }
+
+    while (!atomic_load_explicit(&state->stopped, memory_order_relaxed)) {
+        if (StealSubtree(worker)) {
+            SearchSubtree(worker);
+        }
+        else if (atomic_load_explicit(&state->activeCount, memory_order_acquire) == 0) {
+            break;
+        }
+        else {
+            sched_yield();
+        }
+    }
+
+    return nullptr;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void DestroySearchProblem(
+    SearchProblem *const problem
+)
+{
+    free(problem->registers);
+    free(problem->candidateOffsets);
+    free(problem->remainingBounds);
+    free(problem->memoryBounds);
+    free(problem->fromRegister);
+    free(problem->fromMemory);
+}
+
+/*
+ * A level holds the memory candidate, one candidate per occupied register and one per cost class of empty registers.
+ * Occupants are values waiting for a load across the instruction, so the values waiting there cap the occupied ones.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 2, 3), gnu::access(read_write, 1), gnu::access(read_only, 2), gnu::access(read_only, 3)]]
+static bool InitializeSearchProblem(
+    SearchProblem *const problem,
+    MLRA_Scenario const *const scenario,
+    MLRA_SolverTrace const *const trace
+)
+{
+    size_t const count = MLRA_GetInstructionCountInSolverTrace(trace);
+    size_t const valueCount = MLRA_GetValueCountInSolverTrace(trace);
+    size_t const registerCount = MLRA_GetRegisterCountInScenario(scenario);
+    MLRA_RegisterCost const memorySpillCost = MLRA_GetMemorySpillCostInScenario(scenario);
+
+    *problem = (SearchProblem){
+        .values = MLRA_GetValuesInSolverTrace(trace),
+        .nextReferences = MLRA_GetNextReferencesInSolverTrace(trace),
+        .isStore = MLRA_GetStoreFlagsInSolverTrace(trace),
+        .liveAfter = MLRA_GetLiveAfterFlagsInSolverTrace(trace),
+        .fromMemory = malloc((count + 1) * sizeof(int64_t)),
+        .fromRegister = malloc((count + 1) * sizeof(int64_t)),
+        .memoryBounds = malloc((count + 1) * sizeof(int64_t)),
+        .remainingBounds = malloc((count + 1) * sizeof(int64_t)),
+        .candidateOffsets = malloc((count + 1) * sizeof(size_t)),
+        .registers = malloc((registerCount == 0 ? 1 : registerCount) * sizeof(SearchRegister)),
+        .count = count,
+        .valueCount = valueCount,
+        .registerCount = registerCount,
+        .costClassCount = MLRA_GetRegisterCostClassCountInScenario(scenario),
+        .memoryLoad = memorySpillCost.load,
+        .memoryStore = memorySpillCost.store,
+        .cheapestRegisterLoad = INT64_MAX
+    };
+    bool *const referenced = calloc(valueCount == 0 ? 1 : valueCount, sizeof(bool));
+
+    if (
+        problem->fromMemory == nullptr || problem->fromRegister == nullptr || problem->memoryBounds == nullptr
+        || problem->remainingBounds == nullptr || problem->candidateOffsets == nullptr || problem->registers == nullptr
+        || referenced == nullptr
+        || !MLRA_ComputeRemainingLowerBoundsOfSolverTrace(scenario, trace, problem->remainingBounds)
+    ) {
+        free(referenced);
+        DestroySearchProblem(problem);
+        return false;
+    }
+
+    for (size_t reg = 0; reg < registerCount; ++reg) {
+        MLRA_RegisterCost const registerCost = MLRA_GetRegisterCostInScenario(scenario, reg);
+        problem->registers[reg] = (SearchRegister){
+            .load = registerCost.load,
+            .store = registerCost.store,
+            .costClass = MLRA_GetRegisterCostClassInScenario(scenario, reg)
+        };
+        if (registerCost.load < problem->cheapestRegisterLoad) {
+            problem->cheapestRegisterLoad = registerCost.load;
+        }
+    }
+
+    MLRA_ComputeReferenceLowerBoundsOfSolverTrace(scenario, trace, problem->fromMemory, problem->fromRegister);
+    problem->memoryBounds[count] = 0;
+    for (size_t index = count; index-- > 0;) {
+        uint32_t const next = problem->nextReferences[index];
+        problem->memoryBounds[index] = problem->memoryBounds[index + 1] + problem->fromMemory[index]
+            - (next == MLRA_SolverTrace_NoReference ? 0 : problem->fromMemory[next]);
+    }
+
+    size_t const emptyCandidateCount = problem->costClassCount;
+    size_t waitingCount = 0;
+    size_t offset = 0;
+    for (size_t index = 0; index < count; ++index) {
+        size_t const width = waitingCount + emptyCandidateCount < registerCount
+            ? waitingCount + emptyCandidateCount
+            : registerCount;
+        problem->candidateOffsets[index] = offset;
+        offset += width + 1;
+
+        bool *const seen = &referenced[problem->values[index]];
+        waitingCount -= !problem->isStore[index] && *seen;
+        waitingCount += problem->liveAfter[index];
+        *seen = true;
+    }
+    problem->candidateOffsets[count] = offset;
+    free(referenced);
+
+    return true;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void DestroySearchWorker(
+    SearchWorker *const worker
+)
+{
+    pthread_mutex_destroy(&worker->lock);
+    free(worker->classStamps);
+    free(worker->valueLocations);
+    free(worker->occupantNexts);
+    free(worker->occupants);
+    free(worker->stolenPath);
+    free(worker->steps);
+    free(worker->path);
+    free(worker->candidates);
+    free(worker->candidateEnds);
+    free(worker->candidateBegins);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(write_only, 1), gnu::access(read_write, 2)]]
+static bool InitializeSearchWorker(
+    SearchWorker *const worker,
+    SearchState *const state,
+    size_t const index
+)
+{
+    SearchProblem const *const problem = state->problem;
+    size_t const count = problem->count;
+    size_t const registerWidth = problem->registerCount == 0 ? 1 : problem->registerCount;
+
+    *worker = (SearchWorker){
+        .candidateBegins = calloc(count + 1, sizeof(size_t)),
+        .candidateEnds = calloc(count + 1, sizeof(size_t)),
+        .candidates = malloc((problem->candidateOffsets[count] + 1) * sizeof(SearchCandidate)),
+        .path = malloc((count + 1) * sizeof(int32_t)),
+        .state = state,
+        .steps = malloc((count + 1) * sizeof(SearchStep)),
+        .stolenPath = malloc((count + 1) * sizeof(int32_t)),
+        .occupants = malloc(registerWidth * sizeof(int32_t)),
+        .occupantNexts = malloc(registerWidth * sizeof(uint32_t)),
+        .valueLocations = malloc((problem->valueCount == 0 ? 1 : problem->valueCount) * sizeof(int32_t)),
+        .classStamps = calloc(problem->costClassCount == 0 ? 1 : problem->costClassCount, sizeof(uint64_t)),
+        .index = index
+    };
+
+    if (
+        worker->candidateBegins == nullptr || worker->candidateEnds == nullptr || worker->candidates == nullptr
+        || worker->path == nullptr || worker->steps == nullptr || worker->stolenPath == nullptr
+        || worker->occupants == nullptr || worker->occupantNexts == nullptr || worker->valueLocations == nullptr
+        || worker->classStamps == nullptr || pthread_mutex_init(&worker->lock, nullptr) != 0
+    ) {
+        free(worker->classStamps);
+        free(worker->valueLocations);
+        free(worker->occupantNexts);
+        free(worker->occupants);
+        free(worker->stolenPath);
+        free(worker->steps);
+        free(worker->path);
+        free(worker->candidates);
+        free(worker->candidateEnds);
+        free(worker->candidateBegins);
+        return false;
+    }
+
+    for (size_t reg = 0; reg < problem->registerCount; ++reg) {
+        worker->occupants[reg] = EmptyRegister;
+    }
+    for (size_t value = 0; value < problem->valueCount; ++value) {
+        worker->valueLocations[value] = MLRA_SolutionLocation_Memory;
+    }
+
+    return true;
+}
+
+/*
+ * Runs the search from the root on workerCount workers. The first worker owns the root and runs on the calling thread.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_write, 1), gnu::access(write_only, 3)]]
+static bool RunSearch(
+    SearchState *const state,
+    size_t const workerCount,
+    size_t *const nodeCount
+)
+{
+    SearchWorker *const workers = malloc(workerCount * sizeof(SearchWorker));
+    pthread_t *const threads = malloc(workerCount * sizeof(pthread_t));
+    bool *const started = calloc(workerCount, sizeof(bool));
+    size_t initializedCount = 0;
+
+    if (workers != nullptr && threads != nullptr && started != nullptr) {
+        while (
+            initializedCount < workerCount
+            && InitializeSearchWorker(&workers[initializedCount], state, initializedCount)
+        ) {
+            ++initializedCount;
+        }
+    }
+    if (initializedCount < workerCount) {
+        for (size_t worker = 0; worker < initializedCount; ++worker) {
+            DestroySearchWorker(&workers[worker]);
+        }
+        free(started);
+        free(threads);
+        free(workers);
+        return false;
+    }
+
+    state->workers = workers;
+    state->workerCount = workerCount;
+    atomic_init(&state->activeCount, 1);
+    workers[0].busy = true;
+    OpenLevel(&workers[0], 0);
+
+    for (size_t worker = 1; worker < workerCount; ++worker) {
+        started[worker] = pthread_create(&threads[worker], nullptr, RunSearchWorker, &workers[worker]) == 0;
+    }
+    RunSearchWorker(&workers[0]);
+    for (size_t worker = 1; worker < workerCount; ++worker) {
+        if (started[worker]) {
+            pthread_join(threads[worker], nullptr);
+        }
+    }
+
+    *nodeCount = 0;
+    for (size_t worker = 0; worker < workerCount; ++worker) {
+        *nodeCount += workers[worker].nodeCount;
+        DestroySearchWorker(&workers[worker]);
+    }
+    free(started);
+    free(threads);
+    free(workers);
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_only, 2)]]
+MLRA_Solution *MLRA_SolveScenarioWithBranchAndBound(
+    MLRA_Scenario const *const scenario,
+    MLRA_BranchAndBoundOptions const *const options,
+    MLRA_BranchAndBoundReport *const report
+)
+{
+    double const startTime = MLRA_GetMonotonicTime();
+    size_t const count = MLRA_GetRegisterInstructionCountInScenario(scenario);
+    if (MLRA_GetRegisterCountInScenario(scenario) > INT32_MAX || count >= MLRA_SolverTrace_NoReference) {
+        return nullptr;
+    }
+
+    MLRA_SolverTrace *const trace = MLRA_CreateSolverTrace(scenario);
+    int32_t *const bestPath = malloc((count == 0 ? 1 : count) * sizeof(int32_t));
+    MLRA_LowerBound rootBound;
+    SearchProblem problem;
+
+    if (
+        trace == nullptr || bestPath == nullptr || !MLRA_ComputeLowerBoundOfSolverTrace(scenario, trace, &rootBound)
+        || !InitializeSearchProblem(&problem, scenario, trace)
+    ) {
+        free(bestPath);
+        MLRA_DestroySolverTrace(trace);
+        return nullptr;
+    }
+
+    SearchState state = {
+        .problem = &problem,
+        .bestPath = bestPath,
+        .openBound = INT64_MAX,
+        .timeLimited = options->timeLimit > 0.0,
+        .deadline = startTime + options->timeLimit
+    };
+    atomic_init(&state.bestCost, INT64_MAX);
+    atomic_init(&state.activeCount, 0);
+    atomic_init(&state.stealCount, 0);
+    atomic_init(&state.stopped, false);
+
+    /* The Belady allocation gives the search a bound to prune with from the first node. */
+    MLRA_Solution *const incumbent = MLRA_SolveScenarioWithBelady(scenario);
+    if (incumbent != nullptr) {
+        MLRA_AllocationEvaluation const evaluation = MLRA_EvaluateSolution(scenario, incumbent);
+        if (evaluation.error == MLRA_AllocationError_None) {
+            memcpy(bestPath, MLRA_GetInstructionLocationSpanInSolution(incumbent), count * sizeof(int32_t));
+            atomic_init(&state.bestCost, evaluation.cost);
+        }
+        MLRA_DestroySolution(incumbent);
+    }
+
+    size_t workerCount = options->threadCount == 0 ? MLRA_GetHardwareThreadCount() : options->threadCount;
+    workerCount = workerCount == 0 ? 1 : workerCount;
+    size_t nodeCount = 0;
+    bool searched = true;
+    if (atomic_load_explicit(&state.bestCost, memory_order_relaxed) > rootBound.cost) {
+        searched = pthread_mutex_init(&state.bestLock, nullptr) == 0;
+        if (searched) {
+            searched = RunSearch(&state, workerCount, &nodeCount);
+            pthread_mutex_destroy(&state.bestLock);
+        }
+    }
+
+    DestroySearchProblem(&problem);
+    MLRA_DestroySolverTrace(trace);
+
+    int64_t const bestCost = atomic_load_explicit(&state.bestCost, memory_order_relaxed);
+    MLRA_Solution *const solution = searched && bestCost != INT64_MAX ? MLRA_CreateSolution(count) : nullptr;
+    if (solution == nullptr) {
+        free(bestPath);
+        return nullptr;
+    }
+
+    for (size_t index = 0; index < count; ++index) {
+        MLRA_SetInstructionLocationInSolution(solution, index, bestPath[index]);
+    }
+    MLRA_SetSolutionCost(solution, bestCost);
+    free(bestPath);
+
+    if (report != nullptr) {
+        bool const stopped = atomic_load_explicit(&state.stopped, memory_order_relaxed);
+        int64_t lowerBound = stopped && state.openBound < bestCost ? state.openBound : bestCost;
+        lowerBound = rootBound.cost > lowerBound ? rootBound.cost : lowerBound;
+        *report = (MLRA_BranchAndBoundReport){
+            .lowerBound = lowerBound,
+            .gap = MLRA_GetOptimalityGap(bestCost, lowerBound),
+            .optimal = lowerBound >= bestCost,
+            .nodeCount = nodeCount,
+            .stealCount = atomic_load_explicit(&state.stealCount, memory_order_relaxed),
+            .threadCount = workerCount,
+            .seconds = MLRA_GetMonotonicTime() - startTime
+        };
+    }
+
+    return solution;
+}
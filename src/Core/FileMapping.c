@@ -0,0 +1,163 @@
+#include "MLRA/Core/FileMapping.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct MLRA_FileMapping_
+{
+    void *data;
+    size_t size;
+};
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroyFileMapping(
+    MLRA_FileMapping *const mapping
+)
+{
+    if (mapping == nullptr) {
+        return;
+    }
+
+    if (mapping->data != nullptr) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping->data);
+#else
+        munmap(mapping->data, mapping->size);
+#endif
+    }
+
+    free(mapping);
+}
+
+#ifdef _WIN32
+[[nodiscard]]
+[[gnu::nonnull(1, 2, 3), gnu::access(read_only, 1), gnu::access(write_only, 2), gnu::access(write_only, 3)]]
+static bool MapFileIntoMemory(
+    char const *const path,
+    void **const data,
+    size_t *const size
+)
+{
+    HANDLE const file = CreateFileA(
+        path,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || (uint64_t)fileSize.QuadPart > SIZE_MAX) {
+        CloseHandle(file);
+        return false;
+    }
+
+    *size = (size_t)fileSize.QuadPart;
+    *data = nullptr;
+    if (*size == 0) {
+        CloseHandle(file);
+        return true;
+    }
+
+    HANDLE const view = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (view == nullptr) {
+        return false;
+    }
+
+    *data = MapViewOfFile(view, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(view);
+
+    return *data != nullptr;
+}
+#else
+[[nodiscard]]
+[[gnu::nonnull(1, 2, 3), gnu::access(read_only, 1), gnu::access(write_only, 2), gnu::access(write_only, 3)]]
+static bool MapFileIntoMemory(
+    char const *const path,
+    void **const data,
+    size_t *const size
+)
+{
+    int const file = open(path, O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size < 0 || (uint64_t)status.st_size > SIZE_MAX) {
+        close(file);
+        return false;
+    }
+
+    *size = (size_t)status.st_size;
+    *data = nullptr;
+    if (*size == 0) {
+        close(file);
+        return true;
+    }
+
+    void *const mapped = mmap(nullptr, *size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+    close(file);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+
+    *data = mapped;
+
+    return true;
+}
+#endif
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyFileMapping, 1)]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_FileMapping *MLRA_CreateFileMapping(
+    char const *const path
+)
+{
+    MLRA_FileMapping *mapping = malloc(sizeof(MLRA_FileMapping));
+    if (mapping == nullptr) {
+        return nullptr;
+    }
+
+    if (!MapFileIntoMemory(path, &mapping->data, &mapping->size)) {
+        free(mapping);
+        return nullptr;
+    }
+
+    return mapping;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+void *MLRA_GetFileMappingData(
+    MLRA_FileMapping const *const mapping
+)
+{
+    return mapping->data;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetFileMappingSize(
+    MLRA_FileMapping const *const mapping
+)
+{
+    return mapping->size;
+}
@@ -0,0 +1,798 @@
+#include "MLRA/Core/FlowSolver.h"
+#include "MLRA/Core/RegisterCost.h"
+#include "MLRA/Core/RegisterInstruction.h"
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/Solution.h"
+#include "MLRA/Core/SolverTrace.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static constexpr uint32_t NoArc = UINT32_MAX;
+static constexpr int64_t UnreachedDistance = INT64_MAX;
+
+typedef struct
+{
+    int32_t const *values;
+    uint32_t const *nextReferences;
+    bool const *isStore;
+    bool const *liveAfter;
+    size_t valueCount;
+    size_t count;
+} FlowTrace;
+
+typedef struct
+{
+    MLRA_RegisterCost cost;
+    size_t index;
+} RegisterEntry;
+
+typedef struct
+{
+    uint32_t *edgeSources;
+    uint32_t *edgeTargets;
+    int32_t *edgeCapacities;
+    int64_t *edgeCosts;
+    uint32_t *edgePositions;
+    uint32_t *offsets;
+    uint32_t *targets;
+    uint32_t *reverses;
+    int32_t *capacities;
+    int64_t *costs;
+    size_t nodeCount;
+    size_t edgeCount;
+    size_t edgeCapacity;
+} FlowNetwork;
+
+typedef struct
+{
+    uint64_t distance;
+    uint32_t node;
+} HeapEntry;
+
+typedef struct
+{
+    HeapEntry *entries;
+    size_t count;
+    size_t capacity;
+} RadixBucket;
+
+typedef struct
+{
+    RadixBucket buckets[65];
+    uint64_t last;
+    size_t count;
+} RadixHeap;
+
+typedef struct
+{
+    int64_t *potentials;
+    int64_t *distances;
+    uint32_t *parentArcs;
+    RadixHeap heap;
+} FlowWorkspace;
+
+typedef struct
+{
+    uint32_t *entryArcs;
+    uint32_t *useArcs;
+    uint32_t *exitArcs;
+    uint32_t *gapArcs;
+} InstructionArcs;
+
+[[gnu::pure]]
+static int CompareRegisterEntries(
+    void const *const left,
+    void const *const right
+)
+{
+    RegisterEntry const *const a = left;
+    RegisterEntry const *const b = right;
+    int64_t const aTotal = (int64_t)a->cost.load + a->cost.store;
+    int64_t const bTotal = (int64_t)b->cost.load + b->cost.store;
+
+    if (aTotal != bTotal) {
+        return aTotal < bTotal ? -1 : 1;
+    }
+    if (a->cost.load != b->cost.load) {
+        return a->cost.load < b->cost.load ? -1 : 1;
+    }
+    if (a->cost.store != b->cost.store) {
+        return a->cost.store < b->cost.store ? -1 : 1;
+    }
+    return a->index < b->index ? -1 : (a->index > b->index ? 1 : 0);
+}
+
+static void DestroyFlowNetwork(
+    FlowNetwork *const network
+)
+{
+    free(network->edgeSources);
+    free(network->edgeTargets);
+    free(network->edgeCapacities);
+    free(network->edgeCosts);
+    free(network->edgePositions);
+    free(network->offsets);
+    free(network->targets);
+    free(network->reverses);
+    free(network->capacities);
+    free(network->costs);
+}
+
+[[nodiscard]]
+static bool InitializeFlowNetwork(
+    FlowNetwork *const network,
+    size_t const nodeCount,
+    size_t const edgeCapacity
+)
+{
+    network->nodeCount = nodeCount;
+    network->edgeCount = 0;
+    network->edgeCapacity = edgeCapacity;
+    network->edgeSources = malloc(edgeCapacity * sizeof(uint32_t));
+    network->edgeTargets = malloc(edgeCapacity * sizeof(uint32_t));
+    network->edgeCapacities = malloc(edgeCapacity * sizeof(int32_t));
+    network->edgeCosts = malloc(edgeCapacity * sizeof(int64_t));
+    network->edgePositions = malloc(edgeCapacity * sizeof(uint32_t));
+    network->offsets = malloc((nodeCount + 1) * sizeof(uint32_t));
+    network->targets = malloc(edgeCapacity * 2 * sizeof(uint32_t));
+    network->reverses = malloc(edgeCapacity * 2 * sizeof(uint32_t));
+    network->capacities = malloc(edgeCapacity * 2 * sizeof(int32_t));
+    network->costs = malloc(edgeCapacity * 2 * sizeof(int64_t));
+
+    if (
+        network->edgeSources == nullptr || network->edgeTargets == nullptr || network->edgeCapacities == nullptr
+        || network->edgeCosts == nullptr || network->edgePositions == nullptr || network->offsets == nullptr
+        || network->targets == nullptr || network->reverses == nullptr || network->capacities == nullptr
+        || network->costs == nullptr
+    ) {
+        DestroyFlowNetwork(network);
+        return false;
+    }
+
+    return true;
+}
+
+static uint32_t AddFlowEdge(
+    FlowNetwork *const network,
+    uint32_t const from,
+    uint32_t const to,
+    int32_t const capacity,
+    int64_t const cost
+)
+{
+    assert(network->edgeCount < network->edgeCapacity);
+
+    uint32_t const edge = (uint32_t)network->edgeCount++;
+    network->edgeSources[edge] = from;
+    network->edgeTargets[edge] = to;
+    network->edgeCapacities[edge] = capacity;
+    network->edgeCosts[edge] = cost;
+
+    return edge;
+}
+
+static void FinalizeFlowNetwork(
+    FlowNetwork *const network
+)
+{
+    uint32_t *const offsets = network->offsets;
+    for (size_t node = 0; node <= network->nodeCount; ++node) {
+        offsets[node] = 0;
+    }
+    for (size_t edge = 0; edge < network->edgeCount; ++edge) {
+        ++offsets[network->edgeSources[edge] + 1];
+        ++offsets[network->edgeTargets[edge] + 1];
+    }
+    for (size_t node = 0; node < network->nodeCount; ++node) {
+        offsets[node + 1] += offsets[node];
+    }
+
+    for (size_t edge = 0; edge < network->edgeCount; ++edge) {
+        uint32_t const from = network->edgeSources[edge];
+        uint32_t const to = network->edgeTargets[edge];
+        uint32_t const forward = offsets[from]++;
+        uint32_t const backward = offsets[to]++;
+
+        network->targets[forward] = to;
+        network->reverses[forward] = backward;
+        network->capacities[forward] = network->edgeCapacities[edge];
+        network->costs[forward] = network->edgeCosts[edge];
+
+        network->targets[backward] = from;
+        network->reverses[backward] = forward;
+        network->capacities[backward] = 0;
+        network->costs[backward] = -network->edgeCosts[edge];
+
+        network->edgePositions[edge] = forward;
+    }
+
+    for (size_t node = network->nodeCount; node > 0; --node) {
+        offsets[node] = offsets[node - 1];
+    }
+    offsets[0] = 0;
+}
+
+static void DestroyRadixHeap(
+    RadixHeap *const heap
+)
+{
+    for (size_t bucket = 0; bucket < 65; ++bucket) {
+        free(heap->buckets[bucket].entries);
+    }
+}
+
+static void ClearRadixHeap(
+    RadixHeap *const heap
+)
+{
+    for (size_t bucket = 0; bucket < 65; ++bucket) {
+        heap->buckets[bucket].count = 0;
+    }
+    heap->last = 0;
+    heap->count = 0;
+}
+
+[[nodiscard]]
+static bool PushRadixBucket(
+    RadixBucket *const bucket,
+    HeapEntry const entry
+)
+{
+    if (bucket->count == bucket->capacity) {
+        size_t const newCapacity = bucket->capacity == 0 ? 64 : bucket->capacity * 2;
+        size_t totalSize;
+        if (__builtin_mul_overflow(newCapacity, sizeof(HeapEntry), &totalSize)) {
+            return false;
+        }
+
+        HeapEntry *entries = realloc(bucket->entries, totalSize);
+        if (entries == nullptr) {
+            return false;
+        }
+
+        bucket->entries = entries;
+        bucket->capacity = newCapacity;
+    }
+
+    bucket->entries[bucket->count++] = entry;
+
+    return true;
+}
+
+[[gnu::const]]
+static size_t GetRadixBucketIndex(
+    uint64_t const key,
+    uint64_t const last
+)
+{
+    return key == last ? 0 : 64 - (size_t)__builtin_clzll(key ^ last);
+}
+
+[[nodiscard]]
+static bool PushHeapEntry(
+    RadixHeap *const heap,
+    HeapEntry const entry
+)
+{
+    assert(entry.distance >= heap->last);
+
+    if (!PushRadixBucket(&heap->buckets[GetRadixBucketIndex(entry.distance, heap->last)], entry)) {
+        return false;
+    }
+    ++heap->count;
+
+    return true;
+}
+
+[[nodiscard]]
+static bool PopHeapEntry(
+    RadixHeap *const heap,
+    HeapEntry *const entry
+)
+{
+    assert(heap->count > 0);
+
+    if (heap->buckets[0].count == 0) {
+        size_t bucket = 1;
+        while (heap->buckets[bucket].count == 0) {
+            ++bucket;
+        }
+
+        RadixBucket *const source = &heap->buckets[bucket];
+        uint64_t minimum = source->entries[0].distance;
+        for (size_t index = 1; index < source->count; ++index) {
+            if (source->entries[index].distance < minimum) {
+                minimum = source->entries[index].distance;
+            }
+        }
+
+        heap->last = minimum;
+        for (size_t index = 0; index < source->count; ++index) {
+            HeapEntry const moved = source->entries[index];
+            if (!PushRadixBucket(&heap->buckets[GetRadixBucketIndex(moved.distance, minimum)], moved)) {
+                return false;
+            }
+        }
+        source->count = 0;
+    }
+
+    *entry = heap->buckets[0].entries[--heap->buckets[0].count];
+    --heap->count;
+
+    return true;
+}
+
+static void DestroyFlowWorkspace(
+    FlowWorkspace *const workspace
+)
+{
+    free(workspace->potentials);
+    free(workspace->distances);
+    free(workspace->parentArcs);
+    DestroyRadixHeap(&workspace->heap);
+}
+
+[[nodiscard]]
+static bool InitializeFlowWorkspace(
+    FlowWorkspace *const workspace,
+    size_t const nodeCount
+)
+{
+    workspace->potentials = malloc(nodeCount * sizeof(int64_t));
+    workspace->distances = malloc(nodeCount * sizeof(int64_t));
+    workspace->parentArcs = malloc(nodeCount * sizeof(uint32_t));
+    memset(&workspace->heap, 0, sizeof(RadixHeap));
+
+    if (workspace->potentials == nullptr || workspace->distances == nullptr || workspace->parentArcs == nullptr) {
+        DestroyFlowWorkspace(workspace);
+        return false;
+    }
+
+    return true;
+}
+
+static void InitializePotentials(
+    FlowNetwork const *const network,
+    FlowWorkspace *const workspace
+)
+{
+    int64_t *const potentials = workspace->potentials;
+    for (size_t node = 0; node < network->nodeCount; ++node) {
+        potentials[node] = UnreachedDistance;
+    }
+    potentials[0] = 0;
+
+    for (size_t node = 0; node < network->nodeCount; ++node) {
+        if (potentials[node] == UnreachedDistance) {
+            continue;
+        }
+        for (uint32_t arc = network->offsets[node]; arc < network->offsets[node + 1]; ++arc) {
+            if (network->capacities[arc] <= 0) {
+                continue;
+            }
+            uint32_t const target = network->targets[arc];
+            int64_t const distance = potentials[node] + network->costs[arc];
+            if (distance < potentials[target]) {
+                potentials[target] = distance;
+            }
+        }
+    }
+
+    for (size_t node = 0; node < network->nodeCount; ++node) {
+        if (potentials[node] == UnreachedDistance) {
+            potentials[node] = 0;
+        }
+    }
+}
+
+[[nodiscard]]
+static bool UpdatePotentials(
+    FlowNetwork const *const network,
+    FlowWorkspace *const workspace,
+    uint32_t const sink,
+    bool *const reachedSink
+)
+{
+    int64_t *const distances = workspace->distances;
+    int64_t const *const potentials = workspace->potentials;
+
+    for (size_t node = 0; node < network->nodeCount; ++node) {
+        distances[node] = UnreachedDistance;
+    }
+    distances[0] = 0;
+    ClearRadixHeap(&workspace->heap);
+    if (!PushHeapEntry(&workspace->heap, (HeapEntry){0, 0})) {
+        return false;
+    }
+
+    *reachedSink = false;
+    while (workspace->heap.count > 0) {
+        HeapEntry entry;
+        if (!PopHeapEntry(&workspace->heap, &entry)) {
+            return false;
+        }
+        if ((int64_t)entry.distance != distances[entry.node]) {
+            continue;
+        }
+        if (entry.node == sink) {
+            *reachedSink = true;
+            break;
+        }
+
+        int64_t const base = (int64_t)entry.distance + potentials[entry.node];
+        for (uint32_t arc = network->offsets[entry.node]; arc < network->offsets[entry.node + 1]; ++arc) {
+            if (network->capacities[arc] <= 0) {
+                continue;
+            }
+            uint32_t const target = network->targets[arc];
+            int64_t const distance = base + network->costs[arc] - potentials[target];
+            if (distance < distances[target]) {
+                distances[target] = distance;
+                workspace->parentArcs[target] = arc;
+                if (!PushHeapEntry(&workspace->heap, (HeapEntry){(uint64_t)distance, target})) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    if (*reachedSink) {
+        int64_t const sinkDistance = distances[sink];
+        for (size_t node = 0; node < network->nodeCount; ++node) {
+            workspace->potentials[node] += distances[node] < sinkDistance ? distances[node] : sinkDistance;
+        }
+    }
+
+    return true;
+}
+
+static void AugmentShortestPath(
+    FlowNetwork *const network,
+    FlowWorkspace const *const workspace,
+    uint32_t const sink
+)
+{
+    for (uint32_t node = sink; node != 0;) {
+        uint32_t const arc = workspace->parentArcs[node];
+        uint32_t const reverse = network->reverses[arc];
+        network->capacities[arc] -= 1;
+        network->capacities[reverse] += 1;
+        node = network->targets[reverse];
+    }
+}
+
+[[nodiscard]]
+static bool SolveRegisterClass(
+    FlowNetwork *const network,
+    FlowWorkspace *const workspace,
+    InstructionArcs const *const arcs,
+    FlowTrace const *const trace,
+    bool const *const covered,
+    MLRA_RegisterCost const registerCost,
+    MLRA_RegisterCost const memorySpillCost,
+    size_t const registerCount
+)
+{
+    size_t const count = trace->count;
+    uint32_t const sink = (uint32_t)(3 * count);
+    int32_t const timelineCapacity = registerCount > INT32_MAX ? INT32_MAX : (int32_t)registerCount;
+
+    network->edgeCount = 0;
+
+    for (size_t index = 0; index < count; ++index) {
+        uint32_t const timeline = (uint32_t)(3 * index);
+        uint32_t const in = timeline + 1;
+        uint32_t const out = timeline + 2;
+
+        arcs->entryArcs[index] = NoArc;
+        arcs->useArcs[index] = NoArc;
+        arcs->exitArcs[index] = NoArc;
+        arcs->gapArcs[index] = NoArc;
+
+        AddFlowEdge(network, timeline, timeline + 3, timelineCapacity, 0);
+        if (covered[index]) {
+            continue;
+        }
+
+        if (trace->isStore[index]) {
+            arcs->entryArcs[index] = AddFlowEdge(network, timeline, in, 1, 0);
+            arcs->useArcs[index] = AddFlowEdge(
+                network, in, out, 1, (int64_t)registerCost.store - memorySpillCost.store
+            );
+        }
+        else {
+            arcs->entryArcs[index] = AddFlowEdge(
+                network, timeline, in, 1, (int64_t)memorySpillCost.load + registerCost.store
+            );
+            arcs->useArcs[index] = AddFlowEdge(
+                network, in, out, 1, (int64_t)registerCost.load - memorySpillCost.load
+            );
+        }
+
+        arcs->exitArcs[index] = AddFlowEdge(
+            network,
+            out,
+            timeline + 3,
+            1,
+            trace->liveAfter[index] ? (int64_t)registerCost.load + memorySpillCost.store : 0
+        );
+
+        uint32_t const next = trace->nextReferences[index];
+        if (next != MLRA_SolverTrace_NoReference && !trace->isStore[next] && !covered[next]) {
+            arcs->gapArcs[index] = AddFlowEdge(network, out, 3 * next + 1, 1, 0);
+        }
+    }
+
+    FinalizeFlowNetwork(network);
+    for (size_t index = 0; index < count; ++index) {
+        if (arcs->useArcs[index] == NoArc) {
+            continue;
+        }
+        arcs->entryArcs[index] = network->edgePositions[arcs->entryArcs[index]];
+        arcs->useArcs[index] = network->edgePositions[arcs->useArcs[index]];
+        arcs->exitArcs[index] = network->edgePositions[arcs->exitArcs[index]];
+        if (arcs->gapArcs[index] != NoArc) {
+            arcs->gapArcs[index] = network->edgePositions[arcs->gapArcs[index]];
+        }
+    }
+
+    InitializePotentials(network, workspace);
+
+    for (size_t flow = 0; flow < registerCount; ++flow) {
+        bool reachedSink;
+        if (!UpdatePotentials(network, workspace, sink, &reachedSink)) {
+            return false;
+        }
+        if (!reachedSink || workspace->potentials[sink] - workspace->potentials[0] >= 0) {
+            break;
+        }
+
+        AugmentShortestPath(network, workspace, sink);
+    }
+
+    return true;
+}
+
+static void AssignRegisterClass(
+    FlowNetwork const *const network,
+    InstructionArcs const *const arcs,
+    FlowTrace const *const trace,
+    bool *const covered,
+    int32_t *const carried,
+    RegisterEntry const *const registers,
+    size_t const registerCount,
+    int32_t *const pool,
+    MLRA_Solution *const solution
+)
+{
+    size_t poolCount = registerCount;
+    for (size_t reg = 0; reg < registerCount; ++reg) {
+        pool[reg] = (int32_t)registers[registerCount - reg - 1].index;
+    }
+
+    for (size_t index = 0; index < trace->count; ++index) {
+        uint32_t const useArc = arcs->useArcs[index];
+        if (useArc == NoArc || network->capacities[network->reverses[useArc]] == 0) {
+            continue;
+        }
+
+        int32_t const value = trace->values[index];
+        int32_t reg;
+        if (network->capacities[network->reverses[arcs->entryArcs[index]]] != 0) {
+            assert(poolCount > 0);
+            reg = pool[--poolCount];
+        }
+        else {
+            reg = carried[value];
+        }
+
+        covered[index] = true;
+        MLRA_SetInstructionLocationInSolution(solution, index, reg);
+
+        uint32_t const gapArc = arcs->gapArcs[index];
+        if (gapArc != NoArc && network->capacities[network->reverses[gapArc]] != 0) {
+            carried[value] = reg;
+        }
+        else {
+            pool[poolCount++] = reg;
+        }
+    }
+}
+
+static int64_t EvaluateFlowSolution(
+    FlowTrace const *const trace,
+    MLRA_Solution const *const solution,
+    MLRA_RegisterCost const *const registerCosts,
+    size_t const registerCount,
+    MLRA_RegisterCost const memorySpillCost,
+    int32_t *const occupants,
+    int32_t *const valueLocations,
+    bool *const valueLive
+)
+{
+    for (size_t reg = 0; reg < registerCount; ++reg) {
+        occupants[reg] = -1;
+    }
+    for (size_t value = 0; value < trace->valueCount; ++value) {
+        valueLocations[value] = MLRA_SolutionLocation_Memory;
+        valueLive[value] = false;
+    }
+
+    int64_t cost = 0;
+    for (size_t index = 0; index < trace->count; ++index) {
+        int32_t const value = trace->values[index];
+        int32_t const location = MLRA_GetInstructionLocationInSolution(solution, index);
+        int32_t const current = valueLocations[value];
+
+        if (location == MLRA_SolutionLocation_Memory) {
+            if (current != MLRA_SolutionLocation_Memory) {
+                occupants[current] = -1;
+                if (!trace->isStore[index]) {
+                    cost += (int64_t)registerCosts[current].load + memorySpillCost.store;
+                }
+            }
+            cost += trace->isStore[index] ? memorySpillCost.store : memorySpillCost.load;
+        }
+        else if (!trace->isStore[index] && location == current) {
+            cost += registerCosts[location].load;
+        }
+        else {
+            if (current != MLRA_SolutionLocation_Memory) {
+                occupants[current] = -1;
+            }
+
+            int32_t const occupant = occupants[location];
+            if (occupant != -1) {
+                valueLocations[occupant] = MLRA_SolutionLocation_Memory;
+                if (valueLive[occupant]) {
+                    cost += (int64_t)registerCosts[location].load + memorySpillCost.store;
+                }
+            }
+
+            if (trace->isStore[index]) {
+                cost += registerCosts[location].store;
+            }
+            else {
+                int64_t const sourceLoad = current == MLRA_SolutionLocation_Memory
+                    ? memorySpillCost.load
+                    : registerCosts[current].load;
+                cost += sourceLoad + registerCosts[location].store + registerCosts[location].load;
+            }
+
+            occupants[location] = value;
+        }
+
+        valueLocations[value] = location;
+        valueLive[value] = trace->liveAfter[index];
+    }
+
+    return cost;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_Solution *MLRA_SolveScenarioWithMinCostFlow(
+    MLRA_Scenario const *const scenario
+)
+{
+    size_t const registerCount = MLRA_GetRegisterCountInScenario(scenario);
+    size_t const instructionCount = MLRA_GetRegisterInstructionCountInScenario(scenario);
+    if (registerCount > INT32_MAX || instructionCount >= (UINT32_MAX - 1) / 10) {
+        return nullptr;
+    }
+
+    MLRA_SolverTrace *solverTrace = MLRA_CreateSolverTrace(scenario);
+    if (solverTrace == nullptr) {
+        return nullptr;
+    }
+
+    FlowTrace const trace = {
+        MLRA_GetValuesInSolverTrace(solverTrace),
+        MLRA_GetNextReferencesInSolverTrace(solverTrace),
+        MLRA_GetStoreFlagsInSolverTrace(solverTrace),
+        MLRA_GetLiveAfterFlagsInSolverTrace(solverTrace),
+        MLRA_GetValueCountInSolverTrace(solverTrace),
+        MLRA_GetInstructionCountInSolverTrace(solverTrace)
+    };
+
+    size_t const nodeCount = 3 * trace.count + 1;
+    size_t const valueAllocation = trace.valueCount == 0 ? 1 : trace.valueCount;
+    size_t const registerAllocation = registerCount == 0 ? 1 : registerCount;
+    size_t const instructionAllocation = trace.count == 0 ? 1 : trace.count;
+
+    MLRA_Solution *solution = MLRA_CreateSolution(trace.count);
+    RegisterEntry *registers = malloc(registerAllocation * sizeof(RegisterEntry));
+    MLRA_RegisterCost *registerCosts = malloc(registerAllocation * sizeof(MLRA_RegisterCost));
+    int32_t *pool = malloc(registerAllocation * sizeof(int32_t));
+    int32_t *carried = malloc(valueAllocation * sizeof(int32_t));
+    bool *valueLive = malloc(valueAllocation * sizeof(bool));
+    bool *covered = calloc(instructionAllocation, sizeof(bool));
+    InstructionArcs arcs = {
+        malloc(instructionAllocation * sizeof(uint32_t)),
+        malloc(instructionAllocation * sizeof(uint32_t)),
+        malloc(instructionAllocation * sizeof(uint32_t)),
+        malloc(instructionAllocation * sizeof(uint32_t))
+    };
+    FlowNetwork network;
+    FlowWorkspace workspace;
+    bool const networkReady = InitializeFlowNetwork(&network, nodeCount, 5 * trace.count + 1);
+    bool const workspaceReady = networkReady && InitializeFlowWorkspace(&workspace, nodeCount);
+
+    bool succeeded = solution != nullptr && registers != nullptr && registerCosts != nullptr && pool != nullptr
+        && carried != nullptr && valueLive != nullptr && covered != nullptr && arcs.entryArcs != nullptr
+        && arcs.useArcs != nullptr && arcs.exitArcs != nullptr && arcs.gapArcs != nullptr && workspaceReady;
+
+    MLRA_RegisterCost const memorySpillCost = MLRA_GetMemorySpillCostInScenario(scenario);
+
+    if (succeeded) {
+        for (size_t reg = 0; reg < registerCount; ++reg) {
+            registerCosts[reg] = MLRA_GetRegisterCostInScenario(scenario, reg);
+            registers[reg] = (RegisterEntry){registerCosts[reg], reg};
+        }
+        qsort(registers, registerCount, sizeof(RegisterEntry), CompareRegisterEntries);
+    }
+
+    for (size_t first = 0; succeeded && first < registerCount && trace.count > 0;) {
+        size_t last = first + 1;
+        while (
+            last < registerCount
+            && registers[last].cost.load == registers[first].cost.load
+            && registers[last].cost.store == registers[first].cost.store
+        ) {
+            ++last;
+        }
+
+        succeeded = SolveRegisterClass(
+            &network,
+            &workspace,
+            &arcs,
+            &trace,
+            covered,
+            registers[first].cost,
+            memorySpillCost,
+            last - first
+        );
+
+        if (succeeded) {
+            AssignRegisterClass(&network, &arcs, &trace, covered, carried, registers + first, last - first, pool, solution);
+        }
+
+        first = last;
+    }
+
+    if (succeeded) {
+        MLRA_SetSolutionCost(
+            solution,
+            EvaluateFlowSolution(&trace, solution, registerCosts, registerCount, memorySpillCost, pool, carried, valueLive)
+        );
+    }
+
+    if (workspaceReady) {
+        DestroyFlowWorkspace(&workspace);
+    }
+    if (networkReady) {
+        DestroyFlowNetwork(&network);
+    }
+    free(arcs.gapArcs);
+    free(arcs.exitArcs);
+    free(arcs.useArcs);
+    free(arcs.entryArcs);
+    free(covered);
+    free(valueLive);
+    free(carried);
+    free(pool);
+    free(registerCosts);
+    free(registers);
+    MLRA_DestroySolverTrace(solverTrace);
+
+    if (!succeeded) {
+        MLRA_DestroySolution(solution);
+        return nullptr;
+    }
+
+    return solution;
+}
@@ -0,0 +1,452 @@
+#include "MLRA/Core/LowerBound.h"
+#include "MLRA/Core/RegisterCost.h"
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/SolverTrace.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+ * Stands in for the register state of a value that was never referenced, which still lives in memory. Far enough from
+ * INT64_MAX that adding a cost to it cannot overflow.
+ */
+static constexpr int64_t UnreachableCost = INT64_MAX / 4;
+static constexpr size_t MaximumLoadTierCount = 8;
+
+/*
+ * Costs of memory and of an ideal register that loads as cheaply as the cheapest loading register and stores as
+ * cheaply as the cheapest storing one. Without registers the ideal register costs as much as memory, which adds no
+ * cheaper option.
+ */
+typedef struct
+{
+    int64_t memoryLoad;
+    int64_t memoryStore;
+    int64_t registerLoad;
+    int64_t registerStore;
+    size_t registerCount;
+} BoundCosts;
+
+/*
+ * Cheapest cost of a value in memory and in the ideal register after its references so far.
+ */
+typedef struct
+{
+    int64_t memory;
+    int64_t reg;
+} RelaxedValue;
+
+/*
+ * Values waiting for a load beyond the capacity, the number of registers loading for at most some price, pay at least
+ * step more than that price. Every tier keeps its own chain of charged points.
+ */
+typedef struct
+{
+    int64_t step;
+    size_t capacity;
+    int64_t lastSurplus;
+    size_t barrier;
+} LoadTier;
+
+[[gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static BoundCosts GetBoundCosts(
+    MLRA_Scenario const *const scenario
+)
+{
+    MLRA_RegisterCost const memorySpillCost = MLRA_GetMemorySpillCostInScenario(scenario);
+    BoundCosts costs = {
+        .memoryLoad = memorySpillCost.load,
+        .memoryStore = memorySpillCost.store,
+        .registerLoad = INT64_MAX,
+        .registerStore = INT64_MAX,
+        .registerCount = MLRA_GetRegisterCountInScenario(scenario)
+    };
+
+    /* Cost classes cover every register, so this stays cheap for huge register counts. */
+    size_t const costClassCount = MLRA_GetRegisterCostClassCountInScenario(scenario);
+    for (size_t costClass = 0; costClass < costClassCount; ++costClass) {
+        if (MLRA_GetRegisterCountInCostClassOfScenario(scenario, costClass) == 0) {
+            continue;
+        }
+
+        MLRA_RegisterCost const registerCost = MLRA_GetRegisterCostOfCostClassInScenario(scenario, costClass);
+        costs.registerLoad = registerCost.load < costs.registerLoad ? registerCost.load : costs.registerLoad;
+        costs.registerStore = registerCost.store < costs.registerStore ? registerCost.store : costs.registerStore;
+    }
+
+    if (costs.registerCount == 0) {
+        costs.registerLoad = costs.memoryLoad;
+        costs.registerStore = costs.memoryStore;
+    }
+
+    return costs;
+}
+
+[[gnu::const]]
+static int64_t MinimumCost(
+    int64_t const first,
+    int64_t const second
+)
+{
+    return first < second ? first : second;
+}
+
+/*
+ * Builds a tier for each of the cheapest distinct register load costs below the memory load cost. When there are more,
+ * the tiers above the last one are left out, which only weakens the bound.
+ */
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(write_only, 2)]]
+static size_t BuildLoadTiers(
+    MLRA_Scenario const *const scenario,
+    LoadTier *const tiers,
+    int64_t const memoryLoad
+)
+{
+    size_t const costClassCount = MLRA_GetRegisterCostClassCountInScenario(scenario);
+    int64_t prices[MaximumLoadTierCount + 1];
+    size_t priceCount = 0;
+    size_t capacity = 0;
+
+    while (priceCount <= MaximumLoadTierCount) {
+        int64_t const floor = priceCount == 0 ? INT64_MIN : prices[priceCount - 1];
+        int64_t price = memoryLoad;
+        size_t registerCount = 0;
+
+        for (size_t costClass = 0; costClass < costClassCount; ++costClass) {
+            size_t const classRegisterCount = MLRA_GetRegisterCountInCostClassOfScenario(scenario, costClass);
+            int64_t const load = MLRA_GetRegisterCostOfCostClassInScenario(scenario, costClass).load;
+            if (classRegisterCount == 0 || load <= floor || load > price) {
+                continue;
+            }
+
+            registerCount = load < price ? 0 : registerCount;
+            price = load;
+            registerCount += classRegisterCount;
+        }
+
+        if (price >= memoryLoad) {
+            break;
+        }
+
+        capacity += registerCount;
+        prices[priceCount] = price;
+        if (priceCount < MaximumLoadTierCount) {
+            tiers[priceCount] = (LoadTier){.capacity = capacity};
+        }
+        ++priceCount;
+    }
+
+    size_t const tierCount = priceCount <= MaximumLoadTierCount ? priceCount : MaximumLoadTierCount;
+    for (size_t tier = 0; tier < tierCount; ++tier) {
+        tiers[tier].step = (tier + 1 < priceCount ? prices[tier + 1] : memoryLoad) - prices[tier];
+    }
+
+    return tierCount;
+}
+
+/*
+ * Charges the surplus of waiting values at one point to the chain of the tier. Returns how many surplus values the
+ * point adds to the chain.
+ */
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static int64_t ChargeLoadTier(
+    LoadTier *const tier,
+    size_t const index,
+    size_t const waitingCount,
+    size_t const reach
+)
+{
+    int64_t const surplus = (int64_t)(waitingCount - tier->capacity);
+    int64_t const added = index >= tier->barrier ? surplus : surplus - tier->lastSurplus;
+    if (added <= 0) {
+        return 0;
+    }
+
+    tier->lastSurplus = surplus;
+    tier->barrier = reach;
+
+    return added;
+}
+
+/*
+ * Moves the value through one reference under the relaxation. Between references the value may also be spilled, which
+ * costs its ideal register load and the memory store.
+ */
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void RelaxValueReference(
+    RelaxedValue *const value,
+    BoundCosts const *const costs,
+    bool const isStore
+)
+{
+    if (isStore) {
+        int64_t const cheapest = MinimumCost(value->memory, value->reg);
+        value->memory = cheapest + costs->memoryStore;
+        value->reg = cheapest + costs->registerStore;
+        return;
+    }
+
+    int64_t const memory = MinimumCost(value->memory, value->reg + costs->registerLoad + costs->memoryStore);
+    int64_t const reg = value->reg;
+    value->memory = memory + costs->memoryLoad;
+    value->reg = MinimumCost(
+        reg + costs->registerLoad,
+        memory + costs->memoryLoad + costs->registerStore + costs->registerLoad
+    );
+}
+
+/*
+ * Computes the bounds, and when charges is not null also what the interval bound charges each instruction.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 2, 3), gnu::access(read_only, 1), gnu::access(read_only, 2), gnu::access(write_only, 3)]]
+static bool ComputeLowerBound(
+    MLRA_Scenario const *const scenario,
+    MLRA_SolverTrace const *const trace,
+    MLRA_LowerBound *const bound,
+    int64_t *const charges
+)
+{
+    size_t const count = MLRA_GetInstructionCountInSolverTrace(trace);
+    size_t const valueCount = MLRA_GetValueCountInSolverTrace(trace);
+    RelaxedValue *const relaxed = malloc((valueCount == 0 ? 1 : valueCount) * sizeof(RelaxedValue));
+    if (relaxed == nullptr) {
+        return false;
+    }
+
+    for (size_t value = 0; value < valueCount; ++value) {
+        relaxed[value] = (RelaxedValue){0, UnreachableCost};
+    }
+
+    BoundCosts const costs = GetBoundCosts(scenario);
+    int64_t const cheapestLoad = MinimumCost(costs.memoryLoad, costs.registerLoad);
+    int64_t const cheapestStore = MinimumCost(costs.memoryStore, costs.registerStore);
+    int32_t const *const values = MLRA_GetValuesInSolverTrace(trace);
+    uint32_t const *const nextReferences = MLRA_GetNextReferencesInSolverTrace(trace);
+    bool const *const isStore = MLRA_GetStoreFlagsInSolverTrace(trace);
+    bool const *const liveAfter = MLRA_GetLiveAfterFlagsInSolverTrace(trace);
+
+    /*
+     * A value waits for a load from each reference up to the load that follows it. It stays in one register all along
+     * or is loaded from memory, so it pays at least the load cost of where it waits. The points charged are chosen
+     * such that no wait spans two of them, so every surplus value at each point is a separate load. A later point may
+     * replace the last one when it has a larger surplus, since no wait spanned the last point and the one before.
+     */
+    LoadTier tiers[MaximumLoadTierCount];
+    size_t const tierCount = BuildLoadTiers(scenario, tiers, costs.memoryLoad);
+    int64_t firstLoadCost = 0;
+    int64_t intervalCost = 0;
+    size_t waitingCount = 0;
+    size_t reach = 0;
+
+    for (size_t index = 0; index < count; ++index) {
+        RelaxedValue *const value = &relaxed[values[index]];
+        bool const referenced = value->reg != UnreachableCost;
+        int64_t charge;
+
+        if (isStore[index]) {
+            charge = cheapestStore;
+        }
+        else if (!referenced) {
+            firstLoadCost += costs.memoryLoad;
+            charge = costs.memoryLoad;
+        }
+        else {
+            charge = cheapestLoad;
+            --waitingCount;
+        }
+        RelaxValueReference(value, &costs, isStore[index]);
+
+        if (liveAfter[index]) {
+            ++waitingCount;
+            reach = nextReferences[index] > reach ? nextReferences[index] : reach;
+        }
+
+        for (size_t tier = 0; tier < tierCount && waitingCount > tiers[tier].capacity; ++tier) {
+            charge += ChargeLoadTier(&tiers[tier], index, waitingCount, reach) * tiers[tier].step;
+        }
+
+        intervalCost += charge;
+        if (charges != nullptr) {
+            charges[index] = charge;
+        }
+    }
+
+    int64_t relaxedCost = 0;
+    for (size_t value = 0; value < valueCount; ++value) {
+        relaxedCost += MinimumCost(relaxed[value].memory, relaxed[value].reg);
+    }
+    free(relaxed);
+
+    int64_t cost = firstLoadCost > relaxedCost ? firstLoadCost : relaxedCost;
+    cost = intervalCost > cost ? intervalCost : cost;
+
+    *bound = (MLRA_LowerBound){
+        .firstLoadCost = firstLoadCost,
+        .relaxedCost = relaxedCost,
+        .intervalCost = intervalCost,
+        .cost = cost
+    };
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2, 3), gnu::access(read_only, 1), gnu::access(read_only, 2), gnu::access(write_only, 3)]]
+bool MLRA_ComputeLowerBoundOfSolverTrace(
+    MLRA_Scenario const *const scenario,
+    MLRA_SolverTrace const *const trace,
+    MLRA_LowerBound *const bound
+)
+{
+    return ComputeLowerBound(scenario, trace, bound, nullptr);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(write_only, 2)]]
+bool MLRA_ComputeLowerBoundOfScenario(
+    MLRA_Scenario const *const scenario,
+    MLRA_LowerBound *const bound
+)
+{
+    MLRA_SolverTrace *const trace = MLRA_CreateSolverTrace(scenario);
+    if (trace == nullptr) {
+        return false;
+    }
+
+    bool const succeeded = MLRA_ComputeLowerBoundOfSolverTrace(scenario, trace, bound);
+    MLRA_DestroySolverTrace(trace);
+
+    return succeeded;
+}
+
+/*
+ * Turns the cheapest cost of the references after one of the value into the cheapest cost from that reference on,
+ * under the same relaxation as RelaxValueReference run backwards.
+ */
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void RelaxValueReferenceBackwards(
+    RelaxedValue *const value,
+    BoundCosts const *const costs,
+    bool const isStore
+)
+{
+    if (isStore) {
+        int64_t const cheapest = MinimumCost(
+            costs->memoryStore + value->memory,
+            costs->registerStore + value->reg
+        );
+        *value = (RelaxedValue){cheapest, cheapest};
+        return;
+    }
+
+    int64_t const memory = MinimumCost(
+        costs->memoryLoad + value->memory,
+        costs->memoryLoad + costs->registerStore + costs->registerLoad + value->reg
+    );
+    int64_t const reg = MinimumCost(
+        costs->registerLoad + value->reg,
+        costs->registerLoad + costs->memoryStore + memory
+    );
+    *value = (RelaxedValue){memory, reg};
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2, 3), gnu::access(read_only, 1), gnu::access(read_only, 2)]]
+bool MLRA_ComputeRemainingLowerBoundsOfSolverTrace(
+    MLRA_Scenario const *const scenario,
+    MLRA_SolverTrace const *const trace,
+    int64_t *const bounds
+)
+{
+    size_t const count = MLRA_GetInstructionCountInSolverTrace(trace);
+    size_t const valueCount = MLRA_GetValueCountInSolverTrace(trace);
+    RelaxedValue *const remaining = calloc(valueCount == 0 ? 1 : valueCount, sizeof(RelaxedValue));
+    int64_t *const charges = malloc((count == 0 ? 1 : count) * sizeof(int64_t));
+    MLRA_LowerBound bound;
+    if (remaining == nullptr || charges == nullptr || !ComputeLowerBound(scenario, trace, &bound, charges)) {
+        free(charges);
+        free(remaining);
+        return false;
+    }
+
+    BoundCosts const costs = GetBoundCosts(scenario);
+    int32_t const *const values = MLRA_GetValuesInSolverTrace(trace);
+    uint32_t const *const nextReferences = MLRA_GetNextReferencesInSolverTrace(trace);
+    bool const *const isStore = MLRA_GetStoreFlagsInSolverTrace(trace);
+
+    /* The bounds first flag the first reference of every value, which is still in memory in every state. */
+    for (size_t index = 0; index < count; ++index) {
+        RelaxedValue *const value = &remaining[values[index]];
+        bounds[index] = value->memory == 0;
+        value->memory = 1;
+    }
+
+    /*
+     * Each value contributes the cheapest cost of its references from the next one on. Before its first reference
+     * that cost starts from memory, afterwards from the cheapest location, as the state may hold the value anywhere.
+     * The interval charges of the instructions left hold from any state as well: the points they charge from i on
+     * still share no wait, whatever happened before.
+     */
+    int64_t total = 0;
+    int64_t intervalTotal = 0;
+    for (size_t index = count; index-- > 0;) {
+        RelaxedValue *const value = &remaining[values[index]];
+        if (nextReferences[index] == MLRA_SolverTrace_NoReference) {
+            *value = (RelaxedValue){0, 0};
+        }
+        else {
+            total -= MinimumCost(value->memory, value->reg);
+        }
+
+        bool const first = bounds[index] != 0;
+        RelaxValueReferenceBackwards(value, &costs, isStore[index]);
+        total += first ? value->memory : MinimumCost(value->memory, value->reg);
+        intervalTotal += charges[index];
+        bounds[index] = total > intervalTotal ? total : intervalTotal;
+    }
+    bounds[count] = 0;
+    free(charges);
+    free(remaining);
+
+    return true;
+}
+
+[[gnu::nonnull(1, 2, 3, 4), gnu::access(read_only, 1), gnu::access(read_only, 2)]]
+void MLRA_ComputeReferenceLowerBoundsOfSolverTrace(
+    MLRA_Scenario const *const scenario,
+    MLRA_SolverTrace const *const trace,
+    int64_t *const fromMemory,
+    int64_t *const fromRegister
+)
+{
+    size_t const count = MLRA_GetInstructionCountInSolverTrace(trace);
+    BoundCosts const costs = GetBoundCosts(scenario);
+    uint32_t const *const nextReferences = MLRA_GetNextReferencesInSolverTrace(trace);
+    bool const *const isStore = MLRA_GetStoreFlagsInSolverTrace(trace);
+
+    for (size_t index = count; index-- > 0;) {
+        uint32_t const next = nextReferences[index];
+        RelaxedValue value = next == MLRA_SolverTrace_NoReference
+            ? (RelaxedValue){0, 0}
+            : (RelaxedValue){fromMemory[next], fromRegister[next]};
+        RelaxValueReferenceBackwards(&value, &costs, isStore[index]);
+        fromMemory[index] = value.memory;
+        fromRegister[index] = value.reg;
+    }
+}
+
+[[nodiscard, gnu::const]]
+double MLRA_GetOptimalityGap(
+    int64_t const cost,
+    int64_t const lowerBound
+)
+{
+    if (cost <= lowerBound || cost <= 0) {
+        return 0.0;
+    }
+
+    return (double)(cost - lowerBound) / (double)cost;
+}
@@ -0,0 +1,966 @@
+#include "MLRA/Core/NextUseIndex.h"
+#include "MLRA/Core/RegisterInstruction.h"
+#include "MLRA/Core/VirtualRegisterMap.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static constexpr size_t NextUseChunkCapacity = 1024;
+static constexpr size_t NextUseChunkFill = NextUseChunkCapacity / 4 * 3;
+static constexpr size_t NextUseChunkMinimum = NextUseChunkCapacity / 4;
+static constexpr size_t NextUseChunkMaximumDepth = 96;
+static constexpr size_t NoEntry = SIZE_MAX;
+
+/*
+ * The index stores no positions. Every use is an entry that links to the entries of the previous and next use of its
+ * virtual register, and the entries sit in chunks of an AVL tree ordered like the instruction list, where every chunk
+ * knows how many uses its subtree holds. An edit moves entries inside one chunk and relinks the two neighbours of the
+ * edited use; a position is recovered by walking from the chunk of an entry up to the root.
+ */
+typedef struct NextUseChunk_ NextUseChunk;
+
+struct NextUseChunk_
+{
+    NextUseChunk *left;
+    NextUseChunk *right;
+    NextUseChunk *parent;
+    size_t subtreeCount;
+    size_t count;
+    size_t height;
+    size_t values[NextUseChunkCapacity];
+    size_t entries[NextUseChunkCapacity];
+};
+
+typedef struct
+{
+    NextUseChunk *chunk;
+    size_t offset;
+    size_t previous;
+    size_t next;
+} NextUseEntry;
+
+struct MLRA_NextUseIndex_
+{
+    MLRA_VirtualRegisterMap *map;
+    NextUseChunk *chunks;
+    NextUseEntry *entries;
+    size_t *firstUses;
+    size_t *lastUses;
+    size_t entryCount;
+    size_t entryCapacity;
+    size_t freeEntry;
+    size_t valueCapacity;
+};
+
+[[gnu::pure]]
+static size_t GetNextUseChunkHeight(
+    NextUseChunk const *const chunk
+)
+{
+    return chunk == nullptr ? 0 : chunk->height;
+}
+
+[[gnu::pure]]
+static size_t GetNextUseChunkSubtreeCount(
+    NextUseChunk const *const chunk
+)
+{
+    return chunk == nullptr ? 0 : chunk->subtreeCount;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void UpdateNextUseChunk(
+    NextUseChunk *const chunk
+)
+{
+    size_t const leftHeight = GetNextUseChunkHeight(chunk->left);
+    size_t const rightHeight = GetNextUseChunkHeight(chunk->right);
+    chunk->height = 1 + (leftHeight > rightHeight ? leftHeight : rightHeight);
+    chunk->subtreeCount = GetNextUseChunkSubtreeCount(chunk->left) + chunk->count
+        + GetNextUseChunkSubtreeCount(chunk->right);
+    if (chunk->left != nullptr) {
+        chunk->left->parent = chunk;
+    }
+    if (chunk->right != nullptr) {
+        chunk->right->parent = chunk;
+    }
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static NextUseChunk *RotateNextUseChunkLeft(
+    NextUseChunk *const chunk
+)
+{
+    NextUseChunk *const right = chunk->right;
+    chunk->right = right->left;
+    right->left = chunk;
+    UpdateNextUseChunk(chunk);
+    UpdateNextUseChunk(right);
+
+    return right;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static NextUseChunk *RotateNextUseChunkRight(
+    NextUseChunk *const chunk
+)
+{
+    NextUseChunk *const left = chunk->left;
+    chunk->left = left->right;
+    left->right = chunk;
+    UpdateNextUseChunk(chunk);
+    UpdateNextUseChunk(left);
+
+    return left;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static NextUseChunk *BalanceNextUseChunk(
+    NextUseChunk *const chunk
+)
+{
+    UpdateNextUseChunk(chunk);
+
+    size_t const leftHeight = GetNextUseChunkHeight(chunk->left);
+    size_t const rightHeight = GetNextUseChunkHeight(chunk->right);
+    if (leftHeight > rightHeight + 1) {
+        if (GetNextUseChunkHeight(chunk->left->right) > GetNextUseChunkHeight(chunk->left->left)) {
+            chunk->left = RotateNextUseChunkLeft(chunk->left);
+        }
+        return RotateNextUseChunkRight(chunk);
+    }
+    if (rightHeight > leftHeight + 1) {
+        if (GetNextUseChunkHeight(chunk->right->left) > GetNextUseChunkHeight(chunk->right->right)) {
+            chunk->right = RotateNextUseChunkRight(chunk->right);
+        }
+        return RotateNextUseChunkLeft(chunk);
+    }
+
+    return chunk;
+}
+
+/*
+ * Inserts chunk so that its first use lands at position, which has to be a chunk boundary.
+ */
+[[nodiscard]]
+[[gnu::nonnull(2), gnu::access(read_write, 2)]]
+static NextUseChunk *InsertNextUseChunk(
+    NextUseChunk *const root,
+    NextUseChunk *const chunk,
+    size_t const position
+)
+{
+    if (root == nullptr) {
+        chunk->left = nullptr;
+        chunk->right = nullptr;
+        UpdateNextUseChunk(chunk);
+        return chunk;
+    }
+
+    size_t const leftCount = GetNextUseChunkSubtreeCount(root->left);
+    if (position <= leftCount) {
+        root->left = InsertNextUseChunk(root->left, chunk, position);
+    }
+    else {
+        assert(position >= leftCount + root->count);
+        root->right = InsertNextUseChunk(root->right, chunk, position - leftCount - root->count);
+    }
+
+    return BalanceNextUseChunk(root);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(write_only, 2)]]
+static NextUseChunk *DetachFirstNextUseChunk(
+    NextUseChunk *const root,
+    NextUseChunk **const first
+)
+{
+    if (root->left == nullptr) {
+        *first = root;
+        return root->right;
+    }
+
+    root->left = DetachFirstNextUseChunk(root->left, first);
+
+    return BalanceNextUseChunk(root);
+}
+
+/*
+ * Unlinks the chunk holding the use at position without freeing it.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_write, 1), gnu::access(write_only, 3)]]
+static NextUseChunk *RemoveNextUseChunk(
+    NextUseChunk *const root,
+    size_t const position,
+    NextUseChunk **const removed
+)
+{
+    size_t const leftCount = GetNextUseChunkSubtreeCount(root->left);
+    if (position < leftCount) {
+        root->left = RemoveNextUseChunk(root->left, position, removed);
+        return BalanceNextUseChunk(root);
+    }
+    if (position >= leftCount + root->count) {
+        root->right = RemoveNextUseChunk(root->right, position - leftCount - root->count, removed);
+        return BalanceNextUseChunk(root);
+    }
+
+    *removed = root;
+    if (root->left == nullptr) {
+        return root->right;
+    }
+    if (root->right == nullptr) {
+        return root->left;
+    }
+
+    NextUseChunk *successor;
+    NextUseChunk *const right = DetachFirstNextUseChunk(root->right, &successor);
+    successor->left = root->left;
+    successor->right = right;
+
+    return BalanceNextUseChunk(successor);
+}
+
+/*
+ * Finds the chunk holding the use at position and turns position into an offset inside it. Positions past the end
+ * resolve to the last chunk.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_write, 2)]]
+static NextUseChunk *FindNextUseChunk(
+    NextUseChunk *chunk,
+    size_t *const position
+)
+{
+    for (;;) {
+        size_t const leftCount = GetNextUseChunkSubtreeCount(chunk->left);
+        if (*position < leftCount) {
+            chunk = chunk->left;
+            continue;
+        }
+
+        *position -= leftCount;
+        if (*position < chunk->count || chunk->right == nullptr) {
+            return chunk;
+        }
+
+        *position -= chunk->count;
+        chunk = chunk->right;
+    }
+}
+
+/*
+ * Like FindNextUseChunk, but records every chunk from the root down so that subtree counts can be adjusted after an
+ * edit inside the found chunk. Returns the path length.
+ */
+[[gnu::nonnull(1, 2, 3), gnu::access(read_write, 1), gnu::access(read_write, 2), gnu::access(write_only, 3)]]
+static size_t FindNextUseChunkPath(
+    NextUseChunk *chunk,
+    size_t *const position,
+    NextUseChunk **const path
+)
+{
+    size_t depth = 0;
+    for (;;) {
+        assert(depth < NextUseChunkMaximumDepth);
+        path[depth++] = chunk;
+
+        size_t const leftCount = GetNextUseChunkSubtreeCount(chunk->left);
+        if (*position < leftCount) {
+            chunk = chunk->left;
+            continue;
+        }
+
+        *position -= leftCount;
+        if (*position < chunk->count || chunk->right == nullptr) {
+            return depth;
+        }
+
+        *position -= chunk->count;
+        chunk = chunk->right;
+    }
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void AdjustNextUseChunkPath(
+    NextUseChunk **const path,
+    size_t const depth,
+    size_t const added,
+    size_t const removed
+)
+{
+    for (size_t level = 0; level < depth; ++level) {
+        path[level]->subtreeCount = path[level]->subtreeCount + added - removed;
+    }
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static NextUseChunk *BuildNextUseChunkTree(
+    NextUseChunk **const chunks,
+    size_t const count
+)
+{
+    if (count == 0) {
+        return nullptr;
+    }
+
+    size_t const middle = count / 2;
+    NextUseChunk *const root = chunks[middle];
+    root->left = BuildNextUseChunkTree(chunks, middle);
+    root->right = BuildNextUseChunkTree(chunks + middle + 1, count - middle - 1);
+    UpdateNextUseChunk(root);
+
+    return root;
+}
+
+static void DestroyNextUseChunks(
+    NextUseChunk *const chunk
+)
+{
+    if (chunk == nullptr) {
+        return;
+    }
+
+    DestroyNextUseChunks(chunk->left);
+    DestroyNextUseChunks(chunk->right);
+    free(chunk);
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void SetNextUseChunkRoot(
+    MLRA_NextUseIndex *const index,
+    NextUseChunk *const root
+)
+{
+    index->chunks = root;
+    if (root != nullptr) {
+        root->parent = nullptr;
+    }
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static size_t GetNextUseEntryPosition(
+    MLRA_NextUseIndex const *const index,
+    size_t const entry
+)
+{
+    if (entry == NoEntry) {
+        return MLRA_NextUseIndex_None;
+    }
+
+    NextUseChunk const *chunk = index->entries[entry].chunk;
+    size_t position = index->entries[entry].offset + GetNextUseChunkSubtreeCount(chunk->left);
+    for (; chunk->parent != nullptr; chunk = chunk->parent) {
+        if (chunk == chunk->parent->right) {
+            position += GetNextUseChunkSubtreeCount(chunk->parent->left) + chunk->parent->count;
+        }
+    }
+
+    return position;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static bool ReserveNextUseEntries(
+    MLRA_NextUseIndex *const index,
+    size_t const capacity
+)
+{
+    if (capacity <= index->entryCapacity) {
+        return true;
+    }
+
+    size_t totalSize;
+    if (__builtin_mul_overflow(capacity, sizeof(NextUseEntry), &totalSize)) {
+        return false;
+    }
+
+    NextUseEntry *entries = realloc(index->entries, totalSize);
+    if (entries == nullptr) {
+        return false;
+    }
+    index->entries = entries;
+    index->entryCapacity = capacity;
+
+    return true;
+}
+
+/*
+ * Entries of removed uses are chained through their next link and handed out again before the array grows.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static size_t AllocateNextUseEntry(
+    MLRA_NextUseIndex *const index
+)
+{
+    if (index->freeEntry != NoEntry) {
+        size_t const entry = index->freeEntry;
+        index->freeEntry = index->entries[entry].next;
+        return entry;
+    }
+
+    if (index->entryCount == index->entryCapacity && !ReserveNextUseEntries(index, index->entryCapacity * 2)) {
+        return NoEntry;
+    }
+
+    return index->entryCount++;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void FreeNextUseEntry(
+    MLRA_NextUseIndex *const index,
+    size_t const entry
+)
+{
+    index->entries[entry].next = index->freeEntry;
+    index->freeEntry = entry;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static size_t AddNextUseValue(
+    MLRA_NextUseIndex *const index,
+    int const virtualRegisterId
+)
+{
+    size_t const valueCount = MLRA_GetVirtualRegisterCountInMap(index->map);
+    size_t const value = MLRA_AddVirtualRegisterToMap(index->map, virtualRegisterId);
+    if (value == SIZE_MAX || value < valueCount) {
+        return value;
+    }
+
+    if (value == index->valueCapacity) {
+        size_t const capacity = index->valueCapacity == 0 ? 64 : index->valueCapacity * 2;
+        size_t totalSize;
+        if (__builtin_mul_overflow(capacity, sizeof(size_t), &totalSize)) {
+            return SIZE_MAX;
+        }
+
+        size_t *firstUses = realloc(index->firstUses, totalSize);
+        if (firstUses == nullptr) {
+            return SIZE_MAX;
+        }
+        index->firstUses = firstUses;
+
+        size_t *lastUses = realloc(index->lastUses, totalSize);
+        if (lastUses == nullptr) {
+            return SIZE_MAX;
+        }
+        index->lastUses = lastUses;
+
+        index->valueCapacity = capacity;
+    }
+
+    index->firstUses[value] = NoEntry;
+    index->lastUses[value] = NoEntry;
+
+    return value;
+}
+
+/*
+ * Renumbers the entries of chunk from offset onwards after they moved inside it.
+ */
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1)]]
+static void RenumberNextUseEntries(
+    MLRA_NextUseIndex *const index,
+    NextUseChunk *const chunk,
+    size_t const offset
+)
+{
+    for (size_t current = offset; current < chunk->count; ++current) {
+        index->entries[chunk->entries[current]].offset = current;
+    }
+}
+
+/*
+ * Moves count uses from the start of source to the end of destination. Subtree counts are left to the caller.
+ */
+[[gnu::nonnull(1, 2, 3), gnu::access(read_write, 1)]]
+static void MoveNextUseEntries(
+    MLRA_NextUseIndex *const index,
+    NextUseChunk *const destination,
+    NextUseChunk *const source,
+    size_t const sourceOffset,
+    size_t const count
+)
+{
+    memcpy(destination->values + destination->count, source->values + sourceOffset, count * sizeof(size_t));
+    memcpy(destination->entries + destination->count, source->entries + sourceOffset, count * sizeof(size_t));
+    for (size_t moved = 0; moved < count; ++moved) {
+        NextUseEntry *const entry = &index->entries[destination->entries[destination->count + moved]];
+        entry->chunk = destination;
+        entry->offset = destination->count + moved;
+    }
+    destination->count += count;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void ReleaseNextUseIndexArrays(
+    MLRA_NextUseIndex *const index
+)
+{
+    MLRA_DestroyVirtualRegisterMap(index->map);
+    DestroyNextUseChunks(index->chunks);
+    free(index->entries);
+    free(index->firstUses);
+    free(index->lastUses);
+}
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroyNextUseIndex(
+    MLRA_NextUseIndex *const index
+)
+{
+    if (index == nullptr) {
+        return;
+    }
+
+    ReleaseNextUseIndexArrays(index);
+    free(index);
+}
+
+/*
+ * Fills chunks to three quarters with the uses of the list in order, leaving room for insertions.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 2, 3), gnu::access(read_write, 1), gnu::access(read_write, 2), gnu::access(write_only, 3)]]
+static bool FillNextUseChunks(
+    MLRA_NextUseIndex *const index,
+    MLRA_RegisterInstructionList *const list,
+    NextUseChunk **const chunks,
+    size_t const chunkCount
+)
+{
+    size_t const count = MLRA_GetRegisterInstructionCountInList(list);
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        chunks[chunk] = calloc(1, sizeof(NextUseChunk));
+        if (chunks[chunk] == nullptr) {
+            for (size_t created = 0; created < chunk; ++created) {
+                free(chunks[created]);
+            }
+            return false;
+        }
+    }
+
+    for (size_t position = 0; position < count;) {
+        size_t length;
+        int32_t const *const virtualRegisterIds = MLRA_GetVirtualRegisterIdSpanInList(list, position, &length);
+        for (size_t offset = 0; offset < length; ++offset) {
+            size_t const value = AddNextUseValue(index, virtualRegisterIds[offset]);
+            if (value == SIZE_MAX) {
+                for (size_t created = 0; created < chunkCount; ++created) {
+                    free(chunks[created]);
+                }
+                return false;
+            }
+
+            NextUseChunk *const chunk = chunks[(position + offset) / NextUseChunkFill];
+            chunk->values[chunk->count] = value;
+            chunk->entries[chunk->count] = position + offset;
+            index->entries[position + offset] = (NextUseEntry){chunk, chunk->count, NoEntry, NoEntry};
+            ++chunk->count;
+        }
+
+        position += length;
+    }
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyNextUseIndex, 1)]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_NextUseIndex *MLRA_CreateNextUseIndex(
+    MLRA_RegisterInstructionList *const list
+)
+{
+    MLRA_NextUseIndex *index = calloc(1, sizeof(MLRA_NextUseIndex));
+    if (index == nullptr) {
+        return nullptr;
+    }
+
+    size_t const count = MLRA_GetRegisterInstructionCountInList(list);
+    size_t const chunkCount = count / NextUseChunkFill + (count % NextUseChunkFill != 0);
+    NextUseChunk **chunks = malloc((chunkCount == 0 ? 1 : chunkCount) * sizeof(NextUseChunk *));
+    index->map = MLRA_CreateVirtualRegisterMap();
+    index->freeEntry = NoEntry;
+    if (
+        chunks == nullptr || index->map == nullptr || !ReserveNextUseEntries(index, count < 64 ? 64 : count)
+        || !FillNextUseChunks(index, list, chunks, chunkCount)
+    ) {
+        free(chunks);
+        ReleaseNextUseIndexArrays(index);
+        free(index);
+        return nullptr;
+    }
+
+    /* The entry of every use starts out numbered like its position, which makes linking one reverse pass. */
+    for (size_t position = count; position-- > 0;) {
+        NextUseChunk const *const chunk = index->entries[position].chunk;
+        size_t const value = chunk->values[index->entries[position].offset];
+        size_t const next = index->firstUses[value];
+        index->entries[position].next = next;
+        if (next != NoEntry) {
+            index->entries[next].previous = position;
+        }
+        else {
+            index->lastUses[value] = position;
+        }
+        index->firstUses[value] = position;
+    }
+
+    SetNextUseChunkRoot(index, BuildNextUseChunkTree(chunks, chunkCount));
+    index->entryCount = count;
+    free(chunks);
+
+    return index;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetPositionCountInNextUseIndex(
+    MLRA_NextUseIndex const *const index
+)
+{
+    return GetNextUseChunkSubtreeCount(index->chunks);
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetValueCountInNextUseIndex(
+    MLRA_NextUseIndex const *const index
+)
+{
+    return MLRA_GetVirtualRegisterCountInMap(index->map);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_only, 1), gnu::access(write_only, 3)]]
+size_t const *MLRA_GetValueSpanInNextUseIndex(
+    MLRA_NextUseIndex const *const index,
+    size_t const position,
+    size_t *const length
+)
+{
+    assert(position < MLRA_GetPositionCountInNextUseIndex(index));
+
+    size_t offset = position;
+    NextUseChunk const *const chunk = FindNextUseChunk(index->chunks, &offset);
+    *length = chunk->count - offset;
+
+    return chunk->values + offset;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetNextUseInIndex(
+    MLRA_NextUseIndex const *const index,
+    size_t const position
+)
+{
+    assert(position < MLRA_GetPositionCountInNextUseIndex(index));
+
+    size_t offset = position;
+    NextUseChunk const *const chunk = FindNextUseChunk(index->chunks, &offset);
+
+    return GetNextUseEntryPosition(index, index->entries[chunk->entries[offset]].next);
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetPreviousUseInIndex(
+    MLRA_NextUseIndex const *const index,
+    size_t const position
+)
+{
+    assert(position < MLRA_GetPositionCountInNextUseIndex(index));
+
+    size_t offset = position;
+    NextUseChunk const *const chunk = FindNextUseChunk(index->chunks, &offset);
+
+    return GetNextUseEntryPosition(index, index->entries[chunk->entries[offset]].previous);
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetFirstUseOfVirtualRegisterInIndex(
+    MLRA_NextUseIndex const *const index,
+    int const virtualRegisterId
+)
+{
+    size_t const value = MLRA_FindVirtualRegisterInMap(index->map, virtualRegisterId);
+    if (value == SIZE_MAX) {
+        return MLRA_NextUseIndex_None;
+    }
+
+    return GetNextUseEntryPosition(index, index->firstUses[value]);
+}
+
+/*
+ * Finds the uses of value around a new use at position. When uses lie on both sides, the scan walks outwards from
+ * position in both directions and stops at the nearer one, so it never passes the first or last use of the value.
+ */
+[[gnu::nonnull(1, 4, 5), gnu::access(read_only, 1), gnu::access(write_only, 4), gnu::access(write_only, 5)]]
+static void FindNextUseNeighbours(
+    MLRA_NextUseIndex const *const index,
+    size_t const position,
+    size_t const value,
+    size_t *const previous,
+    size_t *const next
+)
+{
+    *previous = NoEntry;
+    *next = NoEntry;
+
+    size_t const first = index->firstUses[value];
+    if (first == NoEntry) {
+        return;
+    }
+    size_t const firstPosition = GetNextUseEntryPosition(index, first);
+    if (firstPosition >= position) {
+        *next = first;
+        return;
+    }
+    size_t const last = index->lastUses[value];
+    size_t const lastPosition = GetNextUseEntryPosition(index, last);
+    if (lastPosition < position) {
+        *previous = last;
+        return;
+    }
+
+    NextUseChunk const *before = nullptr;
+    NextUseChunk const *after = nullptr;
+    size_t beforePosition = position;
+    size_t afterPosition = position;
+    size_t beforeOffset = 0;
+    size_t afterOffset = 0;
+    for (;;) {
+        if (beforePosition > firstPosition) {
+            if (beforeOffset == 0) {
+                beforeOffset = beforePosition - 1;
+                before = FindNextUseChunk(index->chunks, &beforeOffset);
+                ++beforeOffset;
+            }
+            --beforePosition;
+            --beforeOffset;
+            if (before->values[beforeOffset] == value) {
+                *previous = before->entries[beforeOffset];
+                *next = index->entries[*previous].next;
+                return;
+            }
+        }
+
+        if (afterPosition <= lastPosition) {
+            if (after == nullptr || afterOffset == after->count) {
+                afterOffset = afterPosition;
+                after = FindNextUseChunk(index->chunks, &afterOffset);
+            }
+            if (after->values[afterOffset] == value) {
+                *next = after->entries[afterOffset];
+                *previous = index->entries[*next].previous;
+                return;
+            }
+            ++afterPosition;
+            ++afterOffset;
+        }
+    }
+}
+
+/*
+ * Puts entry into the chunk that holds position, splitting the chunk first when it is full.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static bool PlaceNextUseEntry(
+    MLRA_NextUseIndex *const index,
+    size_t const position,
+    size_t const value,
+    size_t const entry
+)
+{
+    if (index->chunks == nullptr) {
+        NextUseChunk *const chunk = calloc(1, sizeof(NextUseChunk));
+        if (chunk == nullptr) {
+            return false;
+        }
+        SetNextUseChunkRoot(index, InsertNextUseChunk(nullptr, chunk, 0));
+    }
+
+    NextUseChunk *path[NextUseChunkMaximumDepth];
+    size_t offset = position == 0 ? 0 : position - 1;
+    size_t const depth = FindNextUseChunkPath(index->chunks, &offset, path);
+    NextUseChunk *const chunk = path[depth - 1];
+    offset += position == 0 ? 0 : 1;
+
+    if (chunk->count == NextUseChunkCapacity) {
+        NextUseChunk *const upper = calloc(1, sizeof(NextUseChunk));
+        if (upper == nullptr) {
+            return false;
+        }
+
+        size_t const half = NextUseChunkCapacity / 2;
+        MoveNextUseEntries(index, upper, chunk, half, NextUseChunkCapacity - half);
+        chunk->count = half;
+        AdjustNextUseChunkPath(path, depth, 0, upper->count);
+
+        SetNextUseChunkRoot(index, InsertNextUseChunk(index->chunks, upper, position - offset + half));
+
+        return PlaceNextUseEntry(index, position, value, entry);
+    }
+
+    memmove(chunk->values + offset + 1, chunk->values + offset, (chunk->count - offset) * sizeof(size_t));
+    memmove(chunk->entries + offset + 1, chunk->entries + offset, (chunk->count - offset) * sizeof(size_t));
+    chunk->values[offset] = value;
+    chunk->entries[offset] = entry;
+    index->entries[entry].chunk = chunk;
+    ++chunk->count;
+    RenumberNextUseEntries(index, chunk, offset);
+    AdjustNextUseChunkPath(path, depth, 1, 0);
+
+    return true;
+}
+
+/*
+ * Appends the chunk starting at position to the chunk in front of it when both fit into one.
+ */
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void MergeNextUseChunks(
+    MLRA_NextUseIndex *const index,
+    size_t const position
+)
+{
+    size_t leftOffset = position - 1;
+    size_t rightOffset = position;
+    NextUseChunk *const left = FindNextUseChunk(index->chunks, &leftOffset);
+    NextUseChunk *const right = FindNextUseChunk(index->chunks, &rightOffset);
+    if (left == right || left->count + right->count > NextUseChunkFill) {
+        return;
+    }
+
+    NextUseChunk *removed;
+    SetNextUseChunkRoot(index, RemoveNextUseChunk(index->chunks, position, &removed));
+    assert(removed == right);
+
+    MoveNextUseEntries(index, left, right, 0, right->count);
+
+    NextUseChunk *path[NextUseChunkMaximumDepth];
+    size_t offset = position - 1;
+    size_t const depth = FindNextUseChunkPath(index->chunks, &offset, path);
+    AdjustNextUseChunkPath(path, depth, right->count, 0);
+
+    free(right);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_InsertPositionIntoNextUseIndex(
+    MLRA_NextUseIndex *const index,
+    size_t const position,
+    int const virtualRegisterId
+)
+{
+    assert(position <= MLRA_GetPositionCountInNextUseIndex(index));
+
+    size_t const value = AddNextUseValue(index, virtualRegisterId);
+    if (value == SIZE_MAX) {
+        return false;
+    }
+
+    size_t const entry = AllocateNextUseEntry(index);
+    if (entry == NoEntry) {
+        return false;
+    }
+
+    size_t previous;
+    size_t next;
+    FindNextUseNeighbours(index, position, value, &previous, &next);
+    if (!PlaceNextUseEntry(index, position, value, entry)) {
+        FreeNextUseEntry(index, entry);
+        return false;
+    }
+
+    index->entries[entry].previous = previous;
+    index->entries[entry].next = next;
+    if (previous != NoEntry) {
+        index->entries[previous].next = entry;
+    }
+    else {
+        index->firstUses[value] = entry;
+    }
+    if (next != NoEntry) {
+        index->entries[next].previous = entry;
+    }
+    else {
+        index->lastUses[value] = entry;
+    }
+
+    return true;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void MLRA_RemovePositionFromNextUseIndex(
+    MLRA_NextUseIndex *const index,
+    size_t const position
+)
+{
+    assert(position < MLRA_GetPositionCountInNextUseIndex(index));
+
+    NextUseChunk *path[NextUseChunkMaximumDepth];
+    size_t offset = position;
+    size_t const depth = FindNextUseChunkPath(index->chunks, &offset, path);
+    NextUseChunk *const chunk = path[depth - 1];
+
+    size_t const value = chunk->values[offset];
+    size_t const entry = chunk->entries[offset];
+    size_t const previous = index->entries[entry].previous;
+    size_t const next = index->entries[entry].next;
+    if (previous != NoEntry) {
+        index->entries[previous].next = next;
+    }
+    else {
+        index->firstUses[value] = next;
+    }
+    if (next != NoEntry) {
+        index->entries[next].previous = previous;
+    }
+    else {
+        index->lastUses[value] = previous;
+    }
+    FreeNextUseEntry(index, entry);
+
+    if (chunk->count == 1) {
+        NextUseChunk *removed;
+        SetNextUseChunkRoot(index, RemoveNextUseChunk(index->chunks, position, &removed));
+        free(removed);
+        return;
+    }
+
+    memmove(chunk->values + offset, chunk->values + offset + 1, (chunk->count - offset - 1) * sizeof(size_t));
+    memmove(chunk->entries + offset, chunk->entries + offset + 1, (chunk->count - offset - 1) * sizeof(size_t));
+    --chunk->count;
+    RenumberNextUseEntries(index, chunk, offset);
+    AdjustNextUseChunkPath(path, depth, 0, 1);
+
+    /* Merges the chunk into one of its neighbours once it has fallen below the minimum fill. */
+    size_t const begin = position - offset;
+    if (chunk->count >= NextUseChunkMinimum) {
+        return;
+    }
+    if (begin + chunk->count < GetNextUseChunkSubtreeCount(index->chunks)) {
+        MergeNextUseChunks(index, begin + chunk->count);
+    }
+    else if (begin > 0) {
+        MergeNextUseChunks(index, begin);
+    }
+}
@@ -0,0 +1,189 @@
+#include "MLRA/Core/Platform.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+typedef struct
+{
+    MLRA_ParallelJob job;
+    void *context;
+    size_t jobCount;
+    _Atomic size_t nextJob;
+} ParallelJobQueue;
+
+typedef struct
+{
+    ParallelJobQueue *queue;
+    size_t worker;
+} ParallelWorker;
+
+[[nodiscard]]
+size_t MLRA_GetHardwareThreadCount(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors == 0 ? 1 : (size_t)info.dwNumberOfProcessors;
+#else
+    long const count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count < 1 ? 1 : (size_t)count;
+#endif
+}
+
+[[nodiscard]]
+double MLRA_GetMonotonicTime(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+#endif
+}
+
+#ifdef __linux__
+/*
+ * VmHWM follows MLRA_ResetPeakResidentMemory, which ru_maxrss never goes below. Returns zero if it cannot be read.
+ */
+[[nodiscard]]
+static size_t ReadLinuxPeakResidentMemory(void)
+{
+    FILE *const status = fopen("/proc/self/status", "r");
+    if (status == nullptr) {
+        return 0;
+    }
+
+    char line[256];
+    size_t kilobytes = 0;
+    while (kilobytes == 0 && fgets(line, sizeof(line), status) != nullptr) {
+        if (strncmp(line, "VmHWM:", 6) == 0) {
+            kilobytes = strtoull(line + 6, nullptr, 10);
+        }
+    }
+    fclose(status);
+
+    return kilobytes * 1024;
+}
+#endif
+
+[[nodiscard]]
+size_t MLRA_GetPeakResidentMemory(void)
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return (size_t)counters.PeakWorkingSetSize;
+#else
+#ifdef __linux__
+    size_t const peak = ReadLinuxPeakResidentMemory();
+    if (peak != 0) {
+        return peak;
+    }
+#endif
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0 || usage.ru_maxrss < 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return (size_t)usage.ru_maxrss;
+#else
+    return (size_t)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+[[nodiscard]]
+bool MLRA_ResetPeakResidentMemory(void)
+{
+#ifdef __linux__
+    FILE *const clearRefs = fopen("/proc/self/clear_refs", "w");
+    if (clearRefs == nullptr) {
+        return false;
+    }
+    bool const written = fputs("5", clearRefs) >= 0;
+    return fclose(clearRefs) == 0 && written;
+#else
+    return false;
+#endif
+}
+
+[[gnu::nonnull(1)]]
+static void *RunParallelWorker(
+    void *const argument
+)
+{
+    ParallelWorker const *const worker = argument;
+    ParallelJobQueue *const queue = worker->queue;
+
+    for (;;) {
+        size_t const index = atomic_fetch_add_explicit(&queue->nextJob, 1, memory_order_relaxed);
+        if (index >= queue->jobCount) {
+            return nullptr;
+        }
+
+        queue->job(queue->context, worker->worker, index);
+    }
+}
+
+[[gnu::nonnull(3)]]
+void MLRA_RunParallelJobs(
+    size_t const jobCount,
+    size_t const workerCount,
+    MLRA_ParallelJob const job,
+    void *const context
+)
+{
+    ParallelJobQueue queue = {
+        .job = job,
+        .context = context,
+        .jobCount = jobCount
+    };
+    atomic_init(&queue.nextJob, 0);
+
+    size_t threadCount = workerCount < jobCount ? workerCount : jobCount;
+    ParallelWorker *workers = threadCount > 1 ? malloc(threadCount * sizeof(ParallelWorker)) : nullptr;
+    pthread_t *threads = threadCount > 1 ? malloc(threadCount * sizeof(pthread_t)) : nullptr;
+    if (workers == nullptr || threads == nullptr) {
+        free(threads);
+        free(workers);
+        ParallelWorker worker = {&queue, 0};
+        RunParallelWorker(&worker);
+        return;
+    }
+
+    size_t started = 1;
+    for (size_t index = 0; index < threadCount; ++index) {
+        workers[index] = (ParallelWorker){&queue, index};
+    }
+    while (started < threadCount && pthread_create(&threads[started], nullptr, RunParallelWorker, &workers[started]) == 0) {
+        ++started;
+    }
+
+    RunParallelWorker(&workers[0]);
+    for (size_t index = 1; index < started; ++index) {
+        pthread_join(threads[index], nullptr);
+    }
+
+    free(threads);
+    free(workers);
+}
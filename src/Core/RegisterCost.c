@@ -2,14 +2,243 @@
 
 #include <assert.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
+static constexpr size_t InitialRegisterCostRunCapacity = 4;
+static constexpr MLRA_RegisterCost DefaultRegisterCost = {1, 1};
+
+/*
+ * A run covers the registers from its first one up to the first register of the next run, or the end of the array.
+ */
+typedef struct
+{
+    size_t begin;
+    MLRA_RegisterCost cost;
+    uint32_t costClass;
+} RegisterCostRun;
+
+typedef struct
+{
+    MLRA_RegisterCost cost;
+    size_t registerCount;
+} RegisterCostClass;
+
+/*
+ * Costs are kept as a sorted table of runs of registers with the same cost, neighbouring runs always differing in
+ * cost. Stretches at the default cost are runs like any other, so a fresh array of any size is a single run. Every
+ * run carries its cost class; there are never more classes than the run table has room for, so both tables share
+ * one capacity. Arrays on the heap grow their tables, arrays in caller owned buffers are limited to the capacity
+ * they were built with.
+ */
 struct MLRA_RegisterCostArray_
 {
     size_t count;
-    [[gnu::counted_by(count)]] MLRA_RegisterCost costs[];
+    size_t runCount;
+    size_t runCapacity;
+    size_t classCount;
+    bool ownsRuns;
+    RegisterCostRun *runs;
+    RegisterCostClass *classes;
 };
 
+[[gnu::pure]]
+static bool AreRegisterCostsEqual(
+    MLRA_RegisterCost const first,
+    MLRA_RegisterCost const second
+)
+{
+    return first.load == second.load && first.store == second.store;
+}
+
+/*
+ * Returns the run holding the register, by binary search over the first registers of the runs.
+ */
+[[gnu::pure]]
+[[gnu::nonnull(1)]]
+static size_t FindRegisterCostRun(
+    MLRA_RegisterCostArray const *const array,
+    size_t const index
+)
+{
+    assert(index < array->count);
+
+    size_t low = 0;
+    size_t high = array->runCount;
+    while (high - low > 1) {
+        size_t const middle = low + (high - low) / 2;
+        if (array->runs[middle].begin <= index) {
+            low = middle;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+[[gnu::pure]]
+[[gnu::nonnull(1)]]
+static size_t GetRegisterCostRunEnd(
+    MLRA_RegisterCostArray const *const array,
+    size_t const run
+)
+{
+    return run + 1 < array->runCount ? array->runs[run + 1].begin : array->count;
+}
+
+/*
+ * Adds registers to the class of their cost, reusing the number of an emptied class before adding one.
+ */
+[[gnu::nonnull(1)]]
+static uint32_t AddToRegisterCostClass(
+    MLRA_RegisterCostArray *const array,
+    MLRA_RegisterCost const registerCost,
+    size_t const registerCount
+)
+{
+    RegisterCostClass *const classes = array->classes;
+
+    size_t target = array->classCount;
+    size_t empty = array->classCount;
+    for (size_t costClass = 0; costClass < array->classCount; ++costClass) {
+        if (classes[costClass].registerCount == 0) {
+            empty = empty < costClass ? empty : costClass;
+        }
+        else if (AreRegisterCostsEqual(classes[costClass].cost, registerCost)) {
+            target = costClass;
+            break;
+        }
+    }
+
+    if (target == array->classCount) {
+        target = empty;
+        if (target == array->classCount) {
+            assert(array->classCount < array->runCapacity);
+            ++array->classCount;
+        }
+        classes[target] = (RegisterCostClass){registerCost, 0};
+    }
+
+    classes[target].registerCount += registerCount;
+
+    return (uint32_t)target;
+}
+
+/*
+ * Makes room for additional runs, growing the tables of heap arrays. Fails for arrays in caller owned buffers that
+ * are out of room.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1)]]
+static bool ReserveRegisterCostRuns(
+    MLRA_RegisterCostArray *const array,
+    size_t const additional
+)
+{
+    if (array->runCount + additional <= array->runCapacity) {
+        return true;
+    }
+    if (!array->ownsRuns) {
+        return false;
+    }
+
+    size_t capacity = array->runCapacity * 2;
+    capacity = capacity < array->runCount + additional ? array->runCount + additional : capacity;
+
+    RegisterCostRun *const runs = realloc(array->runs, capacity * sizeof(RegisterCostRun));
+    if (runs == nullptr) {
+        return false;
+    }
+    array->runs = runs;
+
+    RegisterCostClass *const classes = realloc(array->classes, capacity * sizeof(RegisterCostClass));
+    if (classes == nullptr) {
+        return false;
+    }
+    array->classes = classes;
+    array->runCapacity = capacity;
+
+    return true;
+}
+
+/*
+ * Merges neighbouring runs of equal cost between the runs first and last. Runs of equal cost share their class, so
+ * the class counts stay as they are.
+ */
+[[gnu::nonnull(1)]]
+static void CoalesceRegisterCostRuns(
+    MLRA_RegisterCostArray *const array,
+    size_t const first,
+    size_t const last
+)
+{
+    size_t limit = last < array->runCount ? last + 1 : array->runCount;
+    size_t run = first + 1;
+    while (run < limit) {
+        if (!AreRegisterCostsEqual(array->runs[run - 1].cost, array->runs[run].cost)) {
+            ++run;
+            continue;
+        }
+
+        memmove(&array->runs[run], &array->runs[run + 1], (array->runCount - run - 1) * sizeof(RegisterCostRun));
+        --array->runCount;
+        --limit;
+    }
+}
+
+/*
+ * Drops the registers from newCount on, or appends registers at the default cost up to it.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1)]]
+static bool ResizeRegisterCostRuns(
+    MLRA_RegisterCostArray *const array,
+    size_t const newCount
+)
+{
+    size_t end = array->count;
+    while (array->runCount != 0 && array->runs[array->runCount - 1].begin >= newCount) {
+        RegisterCostRun const *const run = &array->runs[array->runCount - 1];
+        array->classes[run->costClass].registerCount -= end - run->begin;
+        end = run->begin;
+        --array->runCount;
+    }
+
+    if (newCount < array->count) {
+        if (array->runCount != 0) {
+            array->classes[array->runs[array->runCount - 1].costClass].registerCount -= end - newCount;
+        }
+        array->count = newCount;
+        return true;
+    }
+
+    size_t const added = newCount - array->count;
+    if (added == 0) {
+        return true;
+    }
+
+    if (array->runCount != 0 && AreRegisterCostsEqual(array->runs[array->runCount - 1].cost, DefaultRegisterCost)) {
+        array->classes[array->runs[array->runCount - 1].costClass].registerCount += added;
+    }
+    else {
+        if (!ReserveRegisterCostRuns(array, 1)) {
+            return false;
+        }
+
+        array->runs[array->runCount++] = (RegisterCostRun){
+            .begin = array->count,
+            .cost = DefaultRegisterCost,
+            .costClass = AddToRegisterCostClass(array, DefaultRegisterCost, added)
+        };
+    }
+    array->count = newCount;
+
+    return true;
+}
+
 [[gnu::access(read_write, 1)]]
 void MLRA_DestroyRegisterCostArray(
     MLRA_RegisterCostArray *const array
@@ -19,68 +248,174 @@ void MLRA_DestroyRegisterCostArray(
         return;
     }
 
+    if (array->ownsRuns) {
+        free(array->classes);
+        free(array->runs);
+    }
     free(array);
 }
 
+[[nodiscard, gnu::const]]
+size_t MLRA_GetRegisterCostArrayFootprint(
+    size_t const runCapacity
+)
+{
+    if (runCapacity == 0 || runCapacity > UINT32_MAX) {
+        return 0;
+    }
+
+    size_t entriesSize;
+    if (__builtin_mul_overflow(runCapacity, sizeof(RegisterCostRun) + sizeof(RegisterCostClass), &entriesSize)) {
+        return 0;
+    }
+
+    size_t totalSize;
+    if (__builtin_add_overflow(sizeof(MLRA_RegisterCostArray), entriesSize, &totalSize)) {
+        return 0;
+    }
+
+    return totalSize;
+}
+
+[[nodiscard, gnu::returns_nonnull]]
+[[gnu::nonnull(1), gnu::access(write_only, 1)]]
+MLRA_RegisterCostArray *MLRA_CreateRegisterCostArrayInBuffer(
+    void *const buffer,
+    size_t const registerCount,
+    size_t const runCapacity
+)
+{
+    assert(runCapacity > 0);
+
+    MLRA_RegisterCostArray *const array = buffer;
+    RegisterCostRun *const runs = (void *)((unsigned char *)buffer + sizeof(MLRA_RegisterCostArray));
+    *array = (MLRA_RegisterCostArray){
+        .runCapacity = runCapacity,
+        .runs = runs,
+        .classes = (void *)(runs + runCapacity)
+    };
+
+    bool const resized = ResizeRegisterCostRuns(array, registerCount);
+    assert(resized);
+    (void)resized;
+
+    return array;
+}
+
 [[nodiscard]]
-[[gnu::malloc, gnu::malloc(MLRA_DestroyRegisterCostArray, 1)]]
-MLRA_RegisterCostArray *MLRA_CreateRegisterCostArray(
+[[gnu::nonnull(1, 3), gnu::access(write_only, 1), gnu::access(read_only, 3)]]
+MLRA_RegisterCostArray *MLRA_CopyRegisterCostArrayToBuffer(
+    void *const buffer,
+    size_t const runCapacity,
+    MLRA_RegisterCostArray const *const source,
     size_t const registerCount
 )
 {
-    size_t costsSize;
-    if (__builtin_mul_overflow(registerCount, sizeof(MLRA_RegisterCost), &costsSize)) {
+    size_t const keptCount = registerCount < source->count ? registerCount : source->count;
+    size_t const keptRunCount = keptCount == 0 ? 0 : FindRegisterCostRun(source, keptCount - 1) + 1;
+    if (keptRunCount + 1 > runCapacity) {
         return nullptr;
     }
 
-    size_t totalSize;
-    if (__builtin_add_overflow(sizeof(MLRA_RegisterCostArray), costsSize, &totalSize)) {
-        return nullptr;
+    MLRA_RegisterCostArray *const array = MLRA_CreateRegisterCostArrayInBuffer(buffer, 0, runCapacity);
+    array->count = keptCount;
+    array->runCount = keptRunCount;
+    for (size_t run = 0; run < keptRunCount; ++run) {
+        size_t const end = GetRegisterCostRunEnd(source, run);
+        array->runs[run] = source->runs[run];
+        array->runs[run].costClass = AddToRegisterCostClass(
+            array, source->runs[run].cost, (end < keptCount ? end : keptCount) - source->runs[run].begin
+        );
     }
 
-    MLRA_RegisterCostArray *array = malloc(totalSize);
+    bool const resized = ResizeRegisterCostRuns(array, registerCount);
+    assert(resized);
+    (void)resized;
+
+    return array;
+}
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyRegisterCostArray, 1)]]
+MLRA_RegisterCostArray *MLRA_CreateRegisterCostArray(
+    size_t const registerCount
+)
+{
+    MLRA_RegisterCostArray *const array = malloc(sizeof(MLRA_RegisterCostArray));
     if (array == nullptr) {
         return nullptr;
     }
 
-    array->count = registerCount;
-    for (size_t index = 0; index < registerCount; ++index) {
-        array->costs[index] = (MLRA_RegisterCost){1, 1};
+    *array = (MLRA_RegisterCostArray){
+        .runCapacity = InitialRegisterCostRunCapacity,
+        .ownsRuns = true,
+        .runs = malloc(InitialRegisterCostRunCapacity * sizeof(RegisterCostRun)),
+        .classes = malloc(InitialRegisterCostRunCapacity * sizeof(RegisterCostClass))
+    };
+
+    if (array->runs == nullptr || array->classes == nullptr || !ResizeRegisterCostRuns(array, registerCount)) {
+        free(array->classes);
+        free(array->runs);
+        free(array);
+        return nullptr;
     }
 
     return array;
 }
 
 [[nodiscard]]
-MLRA_RegisterCostArray *MLRA_ResizeRegisterCostArray(
-    MLRA_RegisterCostArray *const array,
-    size_t const newRegisterCount
+[[gnu::malloc, gnu::malloc(MLRA_DestroyRegisterCostArray, 1)]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_RegisterCostArray *MLRA_CloneRegisterCostArray(
+    MLRA_RegisterCostArray const *const array
 )
 {
-    size_t costsSize;
-    if (__builtin_mul_overflow(newRegisterCount, sizeof(MLRA_RegisterCost), &costsSize)) {
+    MLRA_RegisterCostArray *const clone = malloc(sizeof(MLRA_RegisterCostArray));
+    if (clone == nullptr) {
         return nullptr;
     }
 
-    size_t totalSize;
-    if (__builtin_add_overflow(sizeof(MLRA_RegisterCostArray), costsSize, &totalSize)) {
+    /* Emptied classes keep their numbers, so there may be more classes than runs. */
+    size_t capacity = array->runCount < array->classCount ? array->classCount : array->runCount;
+    capacity = capacity < InitialRegisterCostRunCapacity ? InitialRegisterCostRunCapacity : capacity;
+    *clone = (MLRA_RegisterCostArray){
+        .count = array->count,
+        .runCount = array->runCount,
+        .runCapacity = capacity,
+        .classCount = array->classCount,
+        .ownsRuns = true,
+        .runs = malloc(capacity * sizeof(RegisterCostRun)),
+        .classes = malloc(capacity * sizeof(RegisterCostClass))
+    };
+
+    if (clone->runs == nullptr || clone->classes == nullptr) {
+        free(clone->classes);
+        free(clone->runs);
+        free(clone);
         return nullptr;
     }
 
-    size_t oldCount = array == nullptr ? 0 : array->count;
-    MLRA_RegisterCostArray *newArray = realloc(array, totalSize);
-    if (newArray == nullptr) {
-        return nullptr;
+    memcpy(clone->runs, array->runs, array->runCount * sizeof(RegisterCostRun));
+    memcpy(clone->classes, array->classes, array->classCount * sizeof(RegisterCostClass));
+
+    return clone;
+}
+
+[[nodiscard]]
+MLRA_RegisterCostArray *MLRA_ResizeRegisterCostArray(
+    MLRA_RegisterCostArray *const array,
+    size_t const newRegisterCount
+)
+{
+    if (array == nullptr) {
+        return MLRA_CreateRegisterCostArray(newRegisterCount);
     }
 
-    newArray->count = newRegisterCount;
-    if (newRegisterCount > oldCount) {
-        for (size_t index = oldCount; index < newRegisterCount; ++index) {
-            newArray->costs[index] = (MLRA_RegisterCost){1, 1};
-        }
+    if (!ResizeRegisterCostRuns(array, newRegisterCount)) {
+        return nullptr;
     }
 
-    return newArray;
+    return array;
 }
 
 [[nodiscard, gnu::pure]]
@@ -92,6 +427,15 @@ size_t MLRA_GetRegisterCostArraySize(
     return array->count;
 }
 
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetRegisterCostRunCountInArray(
+    MLRA_RegisterCostArray const *const array
+)
+{
+    return array->runCount;
+}
+
 [[nodiscard, gnu::pure]]
 [[gnu::nonnull(1), gnu::access(read_only, 1)]]
 MLRA_RegisterCost MLRA_GetRegisterCostInArray(
@@ -100,12 +444,13 @@ MLRA_RegisterCost MLRA_GetRegisterCostInArray(
 )
 {
     assert(index < array->count);
-    
-    return array->costs[index];
+
+    return array->runs[FindRegisterCostRun(array, index)].cost;
 }
 
+[[nodiscard]]
 [[gnu::nonnull(1), gnu::access(read_write, 1)]]
-void MLRA_SetRegisterCostInArray(
+bool MLRA_SetRegisterCostInArray(
     MLRA_RegisterCostArray *const array,
     size_t const index,
     MLRA_RegisterCost const registerCost
@@ -115,5 +460,127 @@ void MLRA_SetRegisterCostInArray(
     assert(registerCost.load > 0);
     assert(registerCost.store > 0);
 
-    array->costs[index] = registerCost;
+    size_t const run = FindRegisterCostRun(array, index);
+    if (AreRegisterCostsEqual(array->runs[run].cost, registerCost)) {
+        return true;
+    }
+    if (!ReserveRegisterCostRuns(array, 2)) {
+        return false;
+    }
+
+    RegisterCostRun const previous = array->runs[run];
+    size_t const end = GetRegisterCostRunEnd(array, run);
+    --array->classes[previous.costClass].registerCount;
+
+    RegisterCostRun pieces[3];
+    size_t pieceCount = 0;
+    if (previous.begin < index) {
+        pieces[pieceCount++] = previous;
+    }
+    pieces[pieceCount++] = (RegisterCostRun){
+        .begin = index,
+        .cost = registerCost,
+        .costClass = AddToRegisterCostClass(array, registerCost, 1)
+    };
+    if (index + 1 < end) {
+        pieces[pieceCount++] = (RegisterCostRun){
+            .begin = index + 1,
+            .cost = previous.cost,
+            .costClass = previous.costClass
+        };
+    }
+
+    memmove(
+        &array->runs[run + pieceCount],
+        &array->runs[run + 1],
+        (array->runCount - run - 1) * sizeof(RegisterCostRun)
+    );
+    memcpy(&array->runs[run], pieces, pieceCount * sizeof(RegisterCostRun));
+    array->runCount += pieceCount - 1;
+
+    CoalesceRegisterCostRuns(array, run == 0 ? 0 : run - 1, run + pieceCount);
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1), gnu::access(read_only, 3, 4)]]
+bool MLRA_SetRegisterCostRangeInArray(
+    MLRA_RegisterCostArray *const array,
+    size_t const index,
+    MLRA_RegisterCost const *const registerCosts,
+    size_t const count
+)
+{
+    assert(index <= array->count);
+    assert(count <= array->count - index);
+
+    for (size_t offset = 0; offset < count; ++offset) {
+        if (!MLRA_SetRegisterCostInArray(array, index + offset, registerCosts[offset])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetRegisterCostClassCountInArray(
+    MLRA_RegisterCostArray const *const array
+)
+{
+    return array->classCount;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetRegisterCostClassInArray(
+    MLRA_RegisterCostArray const *const array,
+    size_t const index
+)
+{
+    assert(index < array->count);
+
+    return array->runs[FindRegisterCostRun(array, index)].costClass;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_only, 1), gnu::access(write_only, 3)]]
+size_t MLRA_GetRegisterCostClassSpanInArray(
+    MLRA_RegisterCostArray const *const array,
+    size_t const index,
+    size_t *const length
+)
+{
+    assert(index < array->count);
+
+    size_t const run = FindRegisterCostRun(array, index);
+    *length = GetRegisterCostRunEnd(array, run) - index;
+
+    return array->runs[run].costClass;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_RegisterCost MLRA_GetRegisterCostOfCostClassInArray(
+    MLRA_RegisterCostArray const *const array,
+    size_t const costClass
+)
+{
+    assert(costClass < array->classCount);
+
+    return array->classes[costClass].cost;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetRegisterCountInCostClassOfArray(
+    MLRA_RegisterCostArray const *const array,
+    size_t const costClass
+)
+{
+    assert(costClass < array->classCount);
+
+    return array->classes[costClass].registerCount;
 }
@@ -1,32 +1,1111 @@
 #include "MLRA/Core/RegisterInstruction.h"
+#include "MLRA/Core/FileMapping.h"
+#include "MLRA/Core/NextUseIndex.h"
 
 #include <assert.h>
 #include <limits.h>
+#include <stdatomic.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+static_assert(sizeof(int) == sizeof(int32_t));
+
+static constexpr size_t InstructionChunkCapacity = 4096;
+static constexpr size_t InstructionChunkFill = InstructionChunkCapacity / 4 * 3;
+static constexpr size_t InstructionChunkMinimum = InstructionChunkCapacity / 4;
+static constexpr size_t InstructionChunkMaximumDepth = 96;
+static constexpr size_t ChunkedConversionThreshold = 65536;
+
+static_assert(InstructionChunkCapacity % 64 == 0);
+
+/*
+ * Chunked lists keep their instructions in an AVL tree of chunks ordered by position. Every chunk knows how many
+ * instructions its subtree holds, so positions are found in O(log n) and edits only move data inside one chunk.
+ * The instructions themselves live in reference counted blocks that copies of a list share until one of them writes
+ * to a block, so copying a list only copies the tree.
+ */
+typedef struct
+{
+    _Atomic size_t references;
+    int32_t virtualRegisterIds[InstructionChunkCapacity];
+    uint64_t storeBits[InstructionChunkCapacity / 64];
+} InstructionChunkData;
+
+typedef struct InstructionChunk_ InstructionChunk;
+
+struct InstructionChunk_
+{
+    InstructionChunk *left;
+    InstructionChunk *right;
+    InstructionChunkData *data;
+    size_t subtreeCount;
+    size_t count;
+    size_t height;
+};
+
 struct MLRA_RegisterInstructionList_
 {
-    MLRA_RegisterInstruction *instructions;
-    size_t count;
-    size_t capacity;
-};
+    int32_t *virtualRegisterIds;
+    uint64_t *storeBits;
+    MLRA_FileMapping *mapping;
+    MLRA_NextUseIndex *nextUseIndex;
+    InstructionChunk *chunks;
+    size_t count;
+    size_t capacity;
+    _Atomic size_t references;
+    bool chunked;
+};
+
+[[gnu::const]]
+static size_t GetStoreWordCount(
+    size_t const count
+)
+{
+    return count / 64 + (count % 64 != 0);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static bool DetachRegisterInstructionList(
+    MLRA_RegisterInstructionList *const list,
+    size_t const capacity
+)
+{
+    size_t idsSize;
+    if (__builtin_mul_overflow(capacity, sizeof(int32_t), &idsSize)) {
+        return false;
+    }
+
+    int32_t *virtualRegisterIds = malloc(idsSize);
+    uint64_t *storeBits = malloc(GetStoreWordCount(capacity) * sizeof(uint64_t));
+    if (virtualRegisterIds == nullptr || storeBits == nullptr) {
+        free(storeBits);
+        free(virtualRegisterIds);
+        return false;
+    }
+
+    if (list->count > 0) {
+        memcpy(virtualRegisterIds, list->virtualRegisterIds, list->count * sizeof(int32_t));
+        memcpy(storeBits, list->storeBits, GetStoreWordCount(list->count) * sizeof(uint64_t));
+    }
+
+    MLRA_DestroyFileMapping(list->mapping);
+    list->mapping = nullptr;
+    list->virtualRegisterIds = virtualRegisterIds;
+    list->storeBits = storeBits;
+    list->capacity = capacity;
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static bool ResizeRegisterInstructionList(
+    MLRA_RegisterInstructionList *const list,
+    size_t const capacity
+)
+{
+    if (list->mapping != nullptr) {
+        return DetachRegisterInstructionList(list, capacity);
+    }
+
+    size_t idsSize;
+    if (__builtin_mul_overflow(capacity, sizeof(int32_t), &idsSize)) {
+        return false;
+    }
+
+    int32_t *virtualRegisterIds = realloc(list->virtualRegisterIds, idsSize);
+    if (virtualRegisterIds == nullptr) {
+        return false;
+    }
+    list->virtualRegisterIds = virtualRegisterIds;
+
+    uint64_t *storeBits = realloc(list->storeBits, GetStoreWordCount(capacity) * sizeof(uint64_t));
+    if (storeBits == nullptr) {
+        return false;
+    }
+    list->storeBits = storeBits;
+
+    list->capacity = capacity;
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static bool GrowRegisterInstructionList(
+    MLRA_RegisterInstructionList *const list
+)
+{
+    if (list->count < list->capacity) {
+        return true;
+    }
+
+    if (list->capacity == 0) {
+        return ResizeRegisterInstructionList(list, 64);
+    }
+
+    if (list->capacity > SIZE_MAX / 2) {
+        return false;
+    }
+
+    return ResizeRegisterInstructionList(list, list->capacity * 2);
+}
+
+/*
+ * Grows the capacity geometrically until it holds required instructions, so repeated span appends stay amortized.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static bool ReserveRegisterInstructionList(
+    MLRA_RegisterInstructionList *const list,
+    size_t const required
+)
+{
+    if (required <= list->capacity) {
+        return true;
+    }
+
+    size_t capacity = list->capacity < 64 ? 64 : list->capacity;
+    while (capacity < required) {
+        capacity = capacity > SIZE_MAX / 2 ? required : capacity * 2;
+    }
+
+    return ResizeRegisterInstructionList(list, capacity);
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void ShrinkRegisterInstructionList(
+    MLRA_RegisterInstructionList *const list
+)
+{
+    size_t spaceThreshold;
+    if (
+        list->mapping != nullptr
+        || __builtin_mul_overflow(list->count, 3, &spaceThreshold)
+        || spaceThreshold >= list->capacity
+    ) {
+        return;
+    }
+
+    size_t const capacity = list->count * 2 < 64 ? 64 : list->count * 2;
+    if (capacity < list->capacity) {
+        (void)ResizeRegisterInstructionList(list, capacity);
+    }
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void SetStoreBit(
+    uint64_t *const storeBits,
+    size_t const index,
+    bool const isStore
+)
+{
+    uint64_t const mask = UINT64_C(1) << (index % 64);
+    if (isStore) {
+        storeBits[index / 64] |= mask;
+    }
+    else {
+        storeBits[index / 64] &= ~mask;
+    }
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void ShiftStoreBitsUp(
+    uint64_t *const storeBits,
+    size_t const index,
+    size_t const count
+)
+{
+    size_t const first = index / 64;
+    size_t const last = count / 64;
+    for (size_t word = last; word > first; --word) {
+        storeBits[word] = (storeBits[word] << 1) | (storeBits[word - 1] >> 63);
+    }
+
+    uint64_t const kept = (UINT64_C(1) << (index % 64)) - 1;
+    storeBits[first] = (storeBits[first] & kept) | ((storeBits[first] & ~kept) << 1);
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void ShiftStoreBitsDown(
+    uint64_t *const storeBits,
+    size_t const index,
+    size_t const count
+)
+{
+    size_t const first = index / 64;
+    size_t const last = (count - 1) / 64;
+    uint64_t const kept = (UINT64_C(1) << (index % 64)) - 1;
+    uint64_t const carried = first < last ? storeBits[first + 1] << 63 : 0;
+    storeBits[first] = (storeBits[first] & kept) | (((storeBits[first] >> 1) | carried) & ~kept);
+
+    for (size_t word = first + 1; word <= last; ++word) {
+        uint64_t const next = word < last ? storeBits[word + 1] << 63 : 0;
+        storeBits[word] = (storeBits[word] >> 1) | next;
+    }
+}
+
+[[gnu::nonnull(1, 3), gnu::access(read_write, 1), gnu::access(read_only, 3)]]
+static void CopyStoreBits(
+    uint64_t *const destination,
+    size_t destinationOffset,
+    uint64_t const *const source,
+    size_t sourceOffset,
+    size_t count
+)
+{
+    while (count > 0) {
+        size_t const sourceShift = sourceOffset % 64;
+        size_t const destinationShift = destinationOffset % 64;
+        size_t length = 64 - (sourceShift > destinationShift ? sourceShift : destinationShift);
+        length = length < count ? length : count;
+
+        uint64_t const mask = length == 64 ? UINT64_MAX : (UINT64_C(1) << length) - 1;
+        uint64_t const bits = (source[sourceOffset / 64] >> sourceShift) & mask;
+        uint64_t *const word = &destination[destinationOffset / 64];
+        *word = (*word & ~(mask << destinationShift)) | (bits << destinationShift);
+
+        sourceOffset += length;
+        destinationOffset += length;
+        count -= length;
+    }
+}
+
+/*
+ * Like CopyStoreBits inside one bit array, but the ranges may overlap.
+ */
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void MoveStoreBits(
+    uint64_t *const storeBits,
+    size_t const destinationOffset,
+    size_t const sourceOffset,
+    size_t count
+)
+{
+    if (destinationOffset <= sourceOffset) {
+        CopyStoreBits(storeBits, destinationOffset, storeBits, sourceOffset, count);
+        return;
+    }
+
+    while (count > 0) {
+        size_t const sourceEnd = sourceOffset + count;
+        size_t const destinationEnd = destinationOffset + count;
+        size_t const sourceRoom = (sourceEnd - 1) % 64 + 1;
+        size_t const destinationRoom = (destinationEnd - 1) % 64 + 1;
+        size_t length = sourceRoom < destinationRoom ? sourceRoom : destinationRoom;
+        length = length < count ? length : count;
+
+        size_t const sourceShift = (sourceEnd - length) % 64;
+        size_t const destinationShift = (destinationEnd - length) % 64;
+        uint64_t const mask = length == 64 ? UINT64_MAX : (UINT64_C(1) << length) - 1;
+        uint64_t const bits = (storeBits[(sourceEnd - length) / 64] >> sourceShift) & mask;
+        uint64_t *const word = &storeBits[(destinationEnd - length) / 64];
+        *word = (*word & ~(mask << destinationShift)) | (bits << destinationShift);
+
+        count -= length;
+    }
+}
+
+[[gnu::pure]]
+static size_t GetInstructionChunkHeight(
+    InstructionChunk const *const chunk
+)
+{
+    return chunk == nullptr ? 0 : chunk->height;
+}
+
+[[gnu::pure]]
+static size_t GetInstructionChunkSubtreeCount(
+    InstructionChunk const *const chunk
+)
+{
+    return chunk == nullptr ? 0 : chunk->subtreeCount;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void UpdateInstructionChunk(
+    InstructionChunk *const chunk
+)
+{
+    size_t const leftHeight = GetInstructionChunkHeight(chunk->left);
+    size_t const rightHeight = GetInstructionChunkHeight(chunk->right);
+    chunk->height = 1 + (leftHeight > rightHeight ? leftHeight : rightHeight);
+    chunk->subtreeCount = GetInstructionChunkSubtreeCount(chunk->left) + chunk->count
+        + GetInstructionChunkSubtreeCount(chunk->right);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static InstructionChunk *RotateInstructionChunkLeft(
+    InstructionChunk *const chunk
+)
+{
+    InstructionChunk *const right = chunk->right;
+    chunk->right = right->left;
+    right->left = chunk;
+    UpdateInstructionChunk(chunk);
+    UpdateInstructionChunk(right);
+
+    return right;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static InstructionChunk *RotateInstructionChunkRight(
+    InstructionChunk *const chunk
+)
+{
+    InstructionChunk *const left = chunk->left;
+    chunk->left = left->right;
+    left->right = chunk;
+    UpdateInstructionChunk(chunk);
+    UpdateInstructionChunk(left);
+
+    return left;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static InstructionChunk *BalanceInstructionChunk(
+    InstructionChunk *const chunk
+)
+{
+    UpdateInstructionChunk(chunk);
+
+    size_t const leftHeight = GetInstructionChunkHeight(chunk->left);
+    size_t const rightHeight = GetInstructionChunkHeight(chunk->right);
+    if (leftHeight > rightHeight + 1) {
+        if (GetInstructionChunkHeight(chunk->left->right) > GetInstructionChunkHeight(chunk->left->left)) {
+            chunk->left = RotateInstructionChunkLeft(chunk->left);
+        }
+        return RotateInstructionChunkRight(chunk);
+    }
+    if (rightHeight > leftHeight + 1) {
+        if (GetInstructionChunkHeight(chunk->right->left) > GetInstructionChunkHeight(chunk->right->right)) {
+            chunk->right = RotateInstructionChunkRight(chunk->right);
+        }
+        return RotateInstructionChunkLeft(chunk);
+    }
+
+    return chunk;
+}
+
+/*
+ * Inserts chunk so that its first instruction lands at position, which has to be a chunk boundary.
+ */
+[[nodiscard]]
+[[gnu::nonnull(2), gnu::access(read_write, 2)]]
+static InstructionChunk *InsertInstructionChunk(
+    InstructionChunk *const root,
+    InstructionChunk *const chunk,
+    size_t const position
+)
+{
+    if (root == nullptr) {
+        chunk->left = nullptr;
+        chunk->right = nullptr;
+        UpdateInstructionChunk(chunk);
+        return chunk;
+    }
+
+    size_t const leftCount = GetInstructionChunkSubtreeCount(root->left);
+    if (position <= leftCount) {
+        root->left = InsertInstructionChunk(root->left, chunk, position);
+    }
+    else {
+        assert(position >= leftCount + root->count);
+        root->right = InsertInstructionChunk(root->right, chunk, position - leftCount - root->count);
+    }
+
+    return BalanceInstructionChunk(root);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(write_only, 2)]]
+static InstructionChunk *DetachFirstInstructionChunk(
+    InstructionChunk *const root,
+    InstructionChunk **const first
+)
+{
+    if (root->left == nullptr) {
+        *first = root;
+        return root->right;
+    }
+
+    root->left = DetachFirstInstructionChunk(root->left, first);
+
+    return BalanceInstructionChunk(root);
+}
+
+/*
+ * Unlinks the chunk holding the instruction at position without freeing it.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_write, 1), gnu::access(write_only, 3)]]
+static InstructionChunk *RemoveInstructionChunk(
+    InstructionChunk *const root,
+    size_t const position,
+    InstructionChunk **const removed
+)
+{
+    size_t const leftCount = GetInstructionChunkSubtreeCount(root->left);
+    if (position < leftCount) {
+        root->left = RemoveInstructionChunk(root->left, position, removed);
+        return BalanceInstructionChunk(root);
+    }
+    if (position >= leftCount + root->count) {
+        root->right = RemoveInstructionChunk(root->right, position - leftCount - root->count, removed);
+        return BalanceInstructionChunk(root);
+    }
+
+    *removed = root;
+    if (root->left == nullptr) {
+        return root->right;
+    }
+    if (root->right == nullptr) {
+        return root->left;
+    }
+
+    InstructionChunk *successor;
+    InstructionChunk *const right = DetachFirstInstructionChunk(root->right, &successor);
+    successor->left = root->left;
+    successor->right = right;
+
+    return BalanceInstructionChunk(successor);
+}
+
+/*
+ * Finds the chunk holding the instruction at position and turns position into an offset inside it. Positions past
+ * the end resolve to the last chunk.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_write, 2)]]
+static InstructionChunk *FindInstructionChunk(
+    InstructionChunk *chunk,
+    size_t *const position
+)
+{
+    for (;;) {
+        size_t const leftCount = GetInstructionChunkSubtreeCount(chunk->left);
+        if (*position < leftCount) {
+            chunk = chunk->left;
+            continue;
+        }
+
+        *position -= leftCount;
+        if (*position < chunk->count || chunk->right == nullptr) {
+            return chunk;
+        }
+
+        *position -= chunk->count;
+        chunk = chunk->right;
+    }
+}
+
+/*
+ * Like FindInstructionChunk, but records every chunk from the root down so that subtree counts can be adjusted after
+ * an edit inside the found chunk. Returns the path length.
+ */
+[[gnu::nonnull(1, 2, 3), gnu::access(read_write, 1), gnu::access(read_write, 2), gnu::access(write_only, 3)]]
+static size_t FindInstructionChunkPath(
+    InstructionChunk *chunk,
+    size_t *const position,
+    InstructionChunk **const path
+)
+{
+    size_t depth = 0;
+    for (;;) {
+        assert(depth < InstructionChunkMaximumDepth);
+        path[depth++] = chunk;
+
+        size_t const leftCount = GetInstructionChunkSubtreeCount(chunk->left);
+        if (*position < leftCount) {
+            chunk = chunk->left;
+            continue;
+        }
+
+        *position -= leftCount;
+        if (*position < chunk->count || chunk->right == nullptr) {
+            return depth;
+        }
+
+        *position -= chunk->count;
+        chunk = chunk->right;
+    }
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void AdjustInstructionChunkPath(
+    InstructionChunk **const path,
+    size_t const depth,
+    size_t const added,
+    size_t const removed
+)
+{
+    for (size_t level = 0; level < depth; ++level) {
+        path[level]->subtreeCount = path[level]->subtreeCount + added - removed;
+    }
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void FreeInstructionChunk(
+    InstructionChunk *const chunk
+)
+{
+    if (atomic_fetch_sub_explicit(&chunk->data->references, 1, memory_order_acq_rel) == 1) {
+        free(chunk->data);
+    }
+    free(chunk);
+}
+
+static void DestroyInstructionChunks(
+    InstructionChunk *const chunk
+)
+{
+    if (chunk == nullptr) {
+        return;
+    }
+
+    DestroyInstructionChunks(chunk->left);
+    DestroyInstructionChunks(chunk->right);
+    FreeInstructionChunk(chunk);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(2), gnu::access(read_only, 1), gnu::access(write_only, 2)]]
+static bool CopyInstructionChunks(
+    InstructionChunk const *const source,
+    InstructionChunk **const copy
+)
+{
+    if (source == nullptr) {
+        *copy = nullptr;
+        return true;
+    }
+
+    InstructionChunk *chunk = malloc(sizeof(InstructionChunk));
+    if (chunk == nullptr) {
+        return false;
+    }
+
+    *chunk = *source;
+    chunk->left = nullptr;
+    chunk->right = nullptr;
+    atomic_fetch_add_explicit(&chunk->data->references, 1, memory_order_relaxed);
+    if (!CopyInstructionChunks(source->left, &chunk->left) || !CopyInstructionChunks(source->right, &chunk->right)) {
+        DestroyInstructionChunks(chunk);
+        return false;
+    }
+
+    *copy = chunk;
+
+    return true;
+}
+
+[[nodiscard]]
+static InstructionChunk *CreateInstructionChunk(void)
+{
+    InstructionChunk *chunk = malloc(sizeof(InstructionChunk));
+    InstructionChunkData *data = malloc(sizeof(InstructionChunkData));
+    if (chunk == nullptr || data == nullptr) {
+        free(data);
+        free(chunk);
+        return nullptr;
+    }
+
+    atomic_init(&data->references, 1);
+    chunk->data = data;
+    chunk->left = nullptr;
+    chunk->right = nullptr;
+    chunk->subtreeCount = 0;
+    chunk->count = 0;
+    chunk->height = 1;
+
+    return chunk;
+}
+
+/*
+ * Gives the chunk its own copy of instructions it shares with copies of the list, ahead of writing to them.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static bool UnshareInstructionChunk(
+    InstructionChunk *const chunk
+)
+{
+    if (atomic_load_explicit(&chunk->data->references, memory_order_acquire) == 1) {
+        return true;
+    }
+
+    InstructionChunkData *data = malloc(sizeof(InstructionChunkData));
+    if (data == nullptr) {
+        return false;
+    }
+
+    atomic_init(&data->references, 1);
+    memcpy(data->virtualRegisterIds, chunk->data->virtualRegisterIds, chunk->count * sizeof(int32_t));
+    memcpy(data->storeBits, chunk->data->storeBits, GetStoreWordCount(chunk->count) * sizeof(uint64_t));
+    if (atomic_fetch_sub_explicit(&chunk->data->references, 1, memory_order_acq_rel) == 1) {
+        free(chunk->data);
+    }
+    chunk->data = data;
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static InstructionChunk *BuildInstructionChunkTree(
+    InstructionChunk **const chunks,
+    size_t const count
+)
+{
+    if (count == 0) {
+        return nullptr;
+    }
+
+    size_t const middle = count / 2;
+    InstructionChunk *const root = chunks[middle];
+    root->left = BuildInstructionChunkTree(chunks, middle);
+    root->right = BuildInstructionChunkTree(chunks + middle + 1, count - middle - 1);
+    UpdateInstructionChunk(root);
+
+    return root;
+}
+
+/*
+ * Moves the instructions of a flat list into chunks filled to three quarters, leaving room for insertions.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static bool ConvertRegisterInstructionListToChunks(
+    MLRA_RegisterInstructionList *const list
+)
+{
+    size_t const chunkCount = list->count / InstructionChunkFill + (list->count % InstructionChunkFill != 0);
+    InstructionChunk **chunks = malloc((chunkCount == 0 ? 1 : chunkCount) * sizeof(InstructionChunk *));
+    if (chunks == nullptr) {
+        return false;
+    }
+
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk) {
+        chunks[chunk] = CreateInstructionChunk();
+        if (chunks[chunk] == nullptr) {
+            for (size_t created = 0; created < chunk; ++created) {
+                FreeInstructionChunk(chunks[created]);
+            }
+            free(chunks);
+            return false;
+        }
+
+        size_t const begin = chunk * InstructionChunkFill;
+        size_t const length = list->count - begin < InstructionChunkFill ? list->count - begin : InstructionChunkFill;
+        memcpy(chunks[chunk]->data->virtualRegisterIds, list->virtualRegisterIds + begin, length * sizeof(int32_t));
+        CopyStoreBits(chunks[chunk]->data->storeBits, 0, list->storeBits, begin, length);
+        chunks[chunk]->count = length;
+    }
+
+    list->chunks = BuildInstructionChunkTree(chunks, chunkCount);
+    free(chunks);
+
+    if (list->mapping != nullptr) {
+        MLRA_DestroyFileMapping(list->mapping);
+        list->mapping = nullptr;
+    }
+    else {
+        free(list->virtualRegisterIds);
+        free(list->storeBits);
+    }
+    list->virtualRegisterIds = nullptr;
+    list->storeBits = nullptr;
+    list->capacity = 0;
+    list->chunked = true;
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static bool InsertInstructionIntoChunks(
+    MLRA_RegisterInstructionList *const list,
+    size_t const index,
+    MLRA_RegisterInstruction const instruction
+)
+{
+    if (list->chunks == nullptr) {
+        list->chunks = CreateInstructionChunk();
+        if (list->chunks == nullptr) {
+            return false;
+        }
+    }
+
+    InstructionChunk *path[InstructionChunkMaximumDepth];
+    size_t offset = index == 0 ? 0 : index - 1;
+    size_t const depth = FindInstructionChunkPath(list->chunks, &offset, path);
+    InstructionChunk *const chunk = path[depth - 1];
+    offset += index == 0 ? 0 : 1;
+
+    if (chunk->count == InstructionChunkCapacity) {
+        InstructionChunk *const upper = CreateInstructionChunk();
+        if (upper == nullptr) {
+            return false;
+        }
+
+        size_t const half = InstructionChunkCapacity / 2;
+        upper->count = InstructionChunkCapacity - half;
+        memcpy(upper->data->virtualRegisterIds, chunk->data->virtualRegisterIds + half, upper->count * sizeof(int32_t));
+        CopyStoreBits(upper->data->storeBits, 0, chunk->data->storeBits, half, upper->count);
+        chunk->count = half;
+        AdjustInstructionChunkPath(path, depth, 0, upper->count);
+
+        list->chunks = InsertInstructionChunk(list->chunks, upper, index - offset + half);
+
+        return InsertInstructionIntoChunks(list, index, instruction);
+    }
+
+    if (!UnshareInstructionChunk(chunk)) {
+        return false;
+    }
+
+    if (offset != chunk->count) {
+        memmove(
+            chunk->data->virtualRegisterIds + offset + 1,
+            chunk->data->virtualRegisterIds + offset,
+            (chunk->count - offset) * sizeof(int32_t)
+        );
+        ShiftStoreBitsUp(chunk->data->storeBits, offset, chunk->count);
+    }
+
+    chunk->data->virtualRegisterIds[offset] = instruction.virtualRegisterId;
+    SetStoreBit(chunk->data->storeBits, offset, instruction.type == MLRA_RegisterInstructionType_Store);
+    ++chunk->count;
+    AdjustInstructionChunkPath(path, depth, 1, 0);
+
+    return true;
+}
+
+/*
+ * Appends the chunk starting at position to the chunk in front of it when both fit into one.
+ */
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void MergeInstructionChunks(
+    MLRA_RegisterInstructionList *const list,
+    size_t const position
+)
+{
+    size_t leftOffset = position - 1;
+    size_t rightOffset = position;
+    InstructionChunk *const left = FindInstructionChunk(list->chunks, &leftOffset);
+    InstructionChunk *const right = FindInstructionChunk(list->chunks, &rightOffset);
+    if (left == right || left->count + right->count > InstructionChunkFill || !UnshareInstructionChunk(left)) {
+        return;
+    }
+
+    InstructionChunk *removed;
+    list->chunks = RemoveInstructionChunk(list->chunks, position, &removed);
+    assert(removed == right);
+
+    memcpy(left->data->virtualRegisterIds + left->count, right->data->virtualRegisterIds, right->count * sizeof(int32_t));
+    CopyStoreBits(left->data->storeBits, left->count, right->data->storeBits, 0, right->count);
+    left->count += right->count;
+
+    InstructionChunk *path[InstructionChunkMaximumDepth];
+    size_t offset = position - 1;
+    size_t const depth = FindInstructionChunkPath(list->chunks, &offset, path);
+    AdjustInstructionChunkPath(path, depth, right->count, 0);
+
+    FreeInstructionChunk(right);
+}
+
+/*
+ * Merges the chunk starting at begin into one of its neighbours once it has fallen below the minimum fill.
+ */
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void MergeSparseInstructionChunk(
+    MLRA_RegisterInstructionList *const list,
+    size_t const begin,
+    size_t const count
+)
+{
+    if (count >= InstructionChunkMinimum) {
+        return;
+    }
+
+    if (begin + count < list->chunks->subtreeCount) {
+        MergeInstructionChunks(list, begin + count);
+    }
+    else if (begin > 0) {
+        MergeInstructionChunks(list, begin);
+    }
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static bool RemoveInstructionFromChunks(
+    MLRA_RegisterInstructionList *const list,
+    size_t const index
+)
+{
+    InstructionChunk *path[InstructionChunkMaximumDepth];
+    size_t offset = index;
+    size_t const depth = FindInstructionChunkPath(list->chunks, &offset, path);
+    InstructionChunk *const chunk = path[depth - 1];
+
+    if (chunk->count == 1) {
+        InstructionChunk *removed;
+        list->chunks = RemoveInstructionChunk(list->chunks, index, &removed);
+        FreeInstructionChunk(removed);
+        return true;
+    }
+
+    if (offset != chunk->count - 1) {
+        if (!UnshareInstructionChunk(chunk)) {
+            return false;
+        }
+
+        memmove(
+            chunk->data->virtualRegisterIds + offset,
+            chunk->data->virtualRegisterIds + offset + 1,
+            (chunk->count - offset - 1) * sizeof(int32_t)
+        );
+        ShiftStoreBitsDown(chunk->data->storeBits, offset, chunk->count);
+    }
+
+    --chunk->count;
+    AdjustInstructionChunkPath(path, depth, 0, 1);
+
+    MergeSparseInstructionChunk(list, index - offset, chunk->count);
+
+    return true;
+}
+
+/*
+ * Removes whole chunks covered by the range and trims the partially covered ones at either end, then merges what is
+ * left around the gap.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static bool RemoveInstructionRangeFromChunks(
+    MLRA_RegisterInstructionList *const list,
+    size_t const index,
+    size_t const count
+)
+{
+    for (size_t remaining = count; remaining > 0;) {
+        InstructionChunk *path[InstructionChunkMaximumDepth];
+        size_t offset = index;
+        size_t const depth = FindInstructionChunkPath(list->chunks, &offset, path);
+        InstructionChunk *const chunk = path[depth - 1];
+
+        size_t const available = chunk->count - offset;
+        size_t const length = remaining < available ? remaining : available;
+        if (length == chunk->count) {
+            InstructionChunk *removed;
+            list->chunks = RemoveInstructionChunk(list->chunks, index, &removed);
+            FreeInstructionChunk(removed);
+        }
+        else {
+            if (length != available) {
+                if (!UnshareInstructionChunk(chunk)) {
+                    return false;
+                }
+
+                memmove(
+                    chunk->data->virtualRegisterIds + offset,
+                    chunk->data->virtualRegisterIds + offset + length,
+                    (available - length) * sizeof(int32_t)
+                );
+                MoveStoreBits(chunk->data->storeBits, offset, offset + length, available - length);
+            }
+
+            chunk->count -= length;
+            AdjustInstructionChunkPath(path, depth, 0, length);
+        }
+
+        remaining -= length;
+    }
+
+    if (list->chunks == nullptr) {
+        return true;
+    }
+
+    size_t const total = list->chunks->subtreeCount;
+    if (index > 0 && index < total) {
+        MergeInstructionChunks(list, index);
+    }
+
+    size_t offset = index < total ? index : total - 1;
+    InstructionChunk const *const chunk = FindInstructionChunk(list->chunks, &offset);
+    MergeSparseInstructionChunk(list, (index < total ? index : total - 1) - offset, chunk->count);
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(read_only, 2)]]
+static bool AppendInstructionSpanToChunks(
+    MLRA_RegisterInstructionList *const list,
+    int32_t const *const virtualRegisterIds,
+    uint64_t const *const storeBits,
+    size_t const count
+)
+{
+    for (size_t appended = 0; appended < count;) {
+        size_t const total = GetInstructionChunkSubtreeCount(list->chunks);
+        InstructionChunk *path[InstructionChunkMaximumDepth];
+        size_t offset = total == 0 ? 0 : total - 1;
+        size_t const depth = list->chunks == nullptr ? 0 : FindInstructionChunkPath(list->chunks, &offset, path);
+
+        InstructionChunk *chunk = depth == 0 ? nullptr : path[depth - 1];
+        bool const created = chunk == nullptr || chunk->count == InstructionChunkCapacity;
+        if (created) {
+            chunk = CreateInstructionChunk();
+            if (chunk == nullptr) {
+                return false;
+            }
+        }
+        else if (!UnshareInstructionChunk(chunk)) {
+            return false;
+        }
+
+        size_t const room = (created ? InstructionChunkFill : InstructionChunkCapacity) - chunk->count;
+        size_t const length = count - appended < room ? count - appended : room;
+        memcpy(chunk->data->virtualRegisterIds + chunk->count, virtualRegisterIds + appended, length * sizeof(int32_t));
+        CopyStoreBits(chunk->data->storeBits, chunk->count, storeBits, appended, length);
+        chunk->count += length;
+
+        if (created) {
+            list->chunks = InsertInstructionChunk(list->chunks, chunk, total);
+        }
+        else {
+            AdjustInstructionChunkPath(path, depth, length, 0);
+        }
+
+        appended += length;
+    }
+
+    return true;
+}
+
+/*
+ * Spans that fit into the chunk at index are inserted in place. Longer ones split that chunk at index and go into
+ * fresh chunks between the halves, which are merged back into their neighbours where they fit.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_write, 1), gnu::access(read_only, 3)]]
+static bool InsertInstructionSpanIntoChunks(
+    MLRA_RegisterInstructionList *const list,
+    size_t const index,
+    int32_t const *const virtualRegisterIds,
+    uint64_t const *const storeBits,
+    size_t const count
+)
+{
+    if (index == GetInstructionChunkSubtreeCount(list->chunks)) {
+        return AppendInstructionSpanToChunks(list, virtualRegisterIds, storeBits, count);
+    }
+
+    InstructionChunk *path[InstructionChunkMaximumDepth];
+    size_t offset = index;
+    size_t const depth = FindInstructionChunkPath(list->chunks, &offset, path);
+    InstructionChunk *const chunk = path[depth - 1];
+
+    if (count <= InstructionChunkCapacity - chunk->count) {
+        if (!UnshareInstructionChunk(chunk)) {
+            return false;
+        }
+
+        memmove(
+            chunk->data->virtualRegisterIds + offset + count,
+            chunk->data->virtualRegisterIds + offset,
+            (chunk->count - offset) * sizeof(int32_t)
+        );
+        MoveStoreBits(chunk->data->storeBits, offset + count, offset, chunk->count - offset);
+        memcpy(chunk->data->virtualRegisterIds + offset, virtualRegisterIds, count * sizeof(int32_t));
+        CopyStoreBits(chunk->data->storeBits, offset, storeBits, 0, count);
+        chunk->count += count;
+        AdjustInstructionChunkPath(path, depth, count, 0);
+
+        return true;
+    }
+
+    if (offset > 0) {
+        InstructionChunk *const upper = CreateInstructionChunk();
+        if (upper == nullptr) {
+            return false;
+        }
+
+        upper->count = chunk->count - offset;
+        memcpy(upper->data->virtualRegisterIds, chunk->data->virtualRegisterIds + offset, upper->count * sizeof(int32_t));
+        CopyStoreBits(upper->data->storeBits, 0, chunk->data->storeBits, offset, upper->count);
+        chunk->count = offset;
+        AdjustInstructionChunkPath(path, depth, 0, upper->count);
+
+        list->chunks = InsertInstructionChunk(list->chunks, upper, index);
+    }
+
+    for (size_t inserted = 0; inserted < count;) {
+        InstructionChunk *const created = CreateInstructionChunk();
+        if (created == nullptr) {
+            return false;
+        }
+
+        size_t const length = count - inserted < InstructionChunkFill ? count - inserted : InstructionChunkFill;
+        memcpy(created->data->virtualRegisterIds, virtualRegisterIds + inserted, length * sizeof(int32_t));
+        CopyStoreBits(created->data->storeBits, 0, storeBits, inserted, length);
+        created->count = length;
+
+        list->chunks = InsertInstructionChunk(list->chunks, created, index + inserted);
+        inserted += length;
+    }
+
+    MergeInstructionChunks(list, index + count);
+    if (index > 0) {
+        MergeInstructionChunks(list, index);
+    }
+
+    return true;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void InsertNextUsePositionInList(
+    MLRA_RegisterInstructionList *const list,
+    size_t const index,
+    int const virtualRegisterId
+)
+{
+    if (
+        list->nextUseIndex != nullptr
+        && !MLRA_InsertPositionIntoNextUseIndex(list->nextUseIndex, index, virtualRegisterId)
+    ) {
+        MLRA_DestroyNextUseIndex(list->nextUseIndex);
+        list->nextUseIndex = nullptr;
+    }
+}
 
 [[gnu::access(read_write, 1)]]
 void MLRA_DestroyRegisterInstructionList(
     MLRA_RegisterInstructionList *const list
 )
 {
-    if (list == nullptr) {
+    if (list == nullptr || atomic_fetch_sub_explicit(&list->references, 1, memory_order_acq_rel) != 1) {
         return;
     }
 
-    if (list->instructions != nullptr) {
-        free(list->instructions);
+    if (list->chunked) {
+        DestroyInstructionChunks(list->chunks);
     }
-
+    else if (list->mapping != nullptr) {
+        MLRA_DestroyFileMapping(list->mapping);
+    }
+    else {
+        free(list->virtualRegisterIds);
+        free(list->storeBits);
+    }
+    MLRA_DestroyNextUseIndex(list->nextUseIndex);
     free(list);
 }
 
@@ -39,13 +1118,128 @@ MLRA_RegisterInstructionList *MLRA_CreateRegisterInstructionList(void)
         return nullptr;
     }
 
-    list->instructions = nullptr;
+    list->virtualRegisterIds = nullptr;
+    list->storeBits = nullptr;
+    list->mapping = nullptr;
+    list->nextUseIndex = nullptr;
+    list->chunks = nullptr;
     list->count = 0;
     list->capacity = 0;
+    atomic_init(&list->references, 1);
+    list->chunked = false;
+
+    return list;
+}
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyRegisterInstructionList)]]
+MLRA_RegisterInstructionList *MLRA_CreateChunkedRegisterInstructionList(void)
+{
+    MLRA_RegisterInstructionList *list = MLRA_CreateRegisterInstructionList();
+    if (list == nullptr) {
+        return nullptr;
+    }
+
+    list->chunked = true;
+
+    return list;
+}
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyRegisterInstructionList)]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+MLRA_RegisterInstructionList *MLRA_CreateRegisterInstructionListInFileMapping(
+    MLRA_FileMapping *const mapping,
+    size_t const virtualRegisterIdOffset,
+    size_t const storeBitOffset,
+    size_t const count
+)
+{
+    assert(virtualRegisterIdOffset % alignof(int32_t) == 0);
+    assert(storeBitOffset % alignof(uint64_t) == 0);
+
+    MLRA_RegisterInstructionList *list = malloc(sizeof(MLRA_RegisterInstructionList));
+    if (list == nullptr) {
+        return nullptr;
+    }
+
+    unsigned char *const data = MLRA_GetFileMappingData(mapping);
+    list->virtualRegisterIds = count == 0 ? nullptr : (int32_t *)(void *)(data + virtualRegisterIdOffset);
+    list->storeBits = count == 0 ? nullptr : (uint64_t *)(void *)(data + storeBitOffset);
+    list->mapping = mapping;
+    list->nextUseIndex = nullptr;
+    list->chunks = nullptr;
+    list->count = count;
+    list->capacity = count;
+    atomic_init(&list->references, 1);
+    list->chunked = false;
+
+    return list;
+}
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyRegisterInstructionList)]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_RegisterInstructionList *MLRA_CopyRegisterInstructionList(
+    MLRA_RegisterInstructionList const *const list
+)
+{
+    MLRA_RegisterInstructionList *copy = list->chunked
+        ? MLRA_CreateChunkedRegisterInstructionList()
+        : MLRA_CreateRegisterInstructionList();
+    if (copy == nullptr) {
+        return nullptr;
+    }
+
+    if (list->chunked) {
+        if (!CopyInstructionChunks(list->chunks, &copy->chunks)) {
+            MLRA_DestroyRegisterInstructionList(copy);
+            return nullptr;
+        }
+    }
+    else if (list->count > 0) {
+        if (!ReserveRegisterInstructionList(copy, list->count)) {
+            MLRA_DestroyRegisterInstructionList(copy);
+            return nullptr;
+        }
+
+        memcpy(copy->virtualRegisterIds, list->virtualRegisterIds, list->count * sizeof(int32_t));
+        memcpy(copy->storeBits, list->storeBits, GetStoreWordCount(list->count) * sizeof(uint64_t));
+    }
+    copy->count = list->count;
+
+    return copy;
+}
+
+[[nodiscard, gnu::returns_nonnull]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+MLRA_RegisterInstructionList *MLRA_RetainRegisterInstructionList(
+    MLRA_RegisterInstructionList *const list
+)
+{
+    atomic_fetch_add_explicit(&list->references, 1, memory_order_relaxed);
 
     return list;
 }
 
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+bool MLRA_IsRegisterInstructionListShared(
+    MLRA_RegisterInstructionList const *const list
+)
+{
+    return atomic_load_explicit(&list->references, memory_order_acquire) > 1;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+bool MLRA_IsRegisterInstructionListChunked(
+    MLRA_RegisterInstructionList const *const list
+)
+{
+    return list->chunked;
+}
+
 [[nodiscard, gnu::pure]]
 [[gnu::nonnull(1), gnu::access(read_only, 1)]]
 size_t MLRA_GetRegisterInstructionCountInList(
@@ -64,7 +1258,101 @@ MLRA_RegisterInstruction MLRA_GetRegisterInstructionInList(
 {
     assert(index < list->count);
 
-    return list->instructions[index];
+    int32_t const *virtualRegisterIds = list->virtualRegisterIds;
+    uint64_t const *storeBits = list->storeBits;
+    size_t offset = index;
+    if (list->chunked) {
+        InstructionChunk const *const chunk = FindInstructionChunk(list->chunks, &offset);
+        virtualRegisterIds = chunk->data->virtualRegisterIds;
+        storeBits = chunk->data->storeBits;
+    }
+
+    bool const isStore = (storeBits[offset / 64] >> (offset % 64)) & 1;
+
+    return (MLRA_RegisterInstruction){
+        isStore ? MLRA_RegisterInstructionType_Store : MLRA_RegisterInstructionType_Load,
+        virtualRegisterIds[offset]
+    };
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_only, 1), gnu::access(write_only, 3)]]
+int32_t const *MLRA_GetVirtualRegisterIdSpanInList(
+    MLRA_RegisterInstructionList *const list,
+    size_t const index,
+    size_t *const length
+)
+{
+    assert(index <= list->count);
+
+    if (list->chunked) {
+        if (index == list->count) {
+            *length = 0;
+            return nullptr;
+        }
+
+        size_t offset = index;
+        InstructionChunk const *const chunk = FindInstructionChunk(list->chunks, &offset);
+        *length = chunk->count - offset;
+        return chunk->data->virtualRegisterIds + offset;
+    }
+
+    *length = list->count - index;
+
+    return list->virtualRegisterIds == nullptr ? nullptr : list->virtualRegisterIds + index;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3, 4), gnu::access(read_only, 1), gnu::access(write_only, 3), gnu::access(write_only, 4)]]
+uint64_t const *MLRA_GetStoreBitSpanInList(
+    MLRA_RegisterInstructionList *const list,
+    size_t const index,
+    size_t *const length,
+    size_t *const bitOffset
+)
+{
+    assert(index <= list->count);
+
+    if (list->chunked) {
+        *bitOffset = 0;
+        if (index == list->count) {
+            *length = 0;
+            return nullptr;
+        }
+
+        size_t offset = index;
+        InstructionChunk const *const chunk = FindInstructionChunk(list->chunks, &offset);
+        *length = chunk->count - offset;
+        *bitOffset = offset % 64;
+        return chunk->data->storeBits + offset / 64;
+    }
+
+    *length = list->count - index;
+    *bitOffset = index % 64;
+
+    return list->storeBits == nullptr ? nullptr : list->storeBits + index / 64;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_BuildNextUseIndexInList(
+    MLRA_RegisterInstructionList *const list
+)
+{
+    if (list->nextUseIndex == nullptr) {
+        list->nextUseIndex = MLRA_CreateNextUseIndex(list);
+    }
+
+    return list->nextUseIndex != nullptr;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_NextUseIndex const *MLRA_GetNextUseIndexInList(
+    MLRA_RegisterInstructionList const *const list
+)
+{
+    return list->nextUseIndex;
 }
 
 [[gnu::nonnull(1), gnu::access(read_write, 1)]]
@@ -78,37 +1366,159 @@ void MLRA_AppendRegisterInstructionToList(
         || instruction.type == MLRA_RegisterInstructionType_Store
     );
 
-    if (list->instructions == nullptr) {
-        list->instructions = malloc(8 * sizeof(MLRA_RegisterInstruction));
-        if (list->instructions == nullptr) {
+    if (list->chunked) {
+        if (!InsertInstructionIntoChunks(list, list->count, instruction)) {
             return;
         }
+        list->count++;
 
-        list->capacity = 8;
+        InsertNextUsePositionInList(list, list->count - 1, instruction.virtualRegisterId);
+        return;
     }
-    else if (list->count == list->capacity) {
-        size_t oldCapacity = list->capacity;
-        size_t totalSize;
-        if (__builtin_mul_overflow(list->capacity * 2, sizeof(MLRA_RegisterInstruction), &totalSize)) {
-            totalSize = SIZE_MAX;
-        }
 
-        size_t expectedCapacity = totalSize / sizeof(MLRA_RegisterInstruction);
-        if (oldCapacity == expectedCapacity) {
-            return;
-        }
+    if (!GrowRegisterInstructionList(list)) {
+        return;
+    }
 
-        MLRA_RegisterInstruction *instructions = realloc(list->instructions, totalSize);
-        if (instructions == nullptr) {
-            return;
+    list->virtualRegisterIds[list->count] = instruction.virtualRegisterId;
+    SetStoreBit(list->storeBits, list->count, instruction.type == MLRA_RegisterInstructionType_Store);
+    list->count++;
+
+    InsertNextUsePositionInList(list, list->count - 1, instruction.virtualRegisterId);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_ReserveRegisterInstructionsInList(
+    MLRA_RegisterInstructionList *const list,
+    size_t const capacity
+)
+{
+    if (list->chunked || capacity <= list->capacity) {
+        return true;
+    }
+
+    return ResizeRegisterInstructionList(list, capacity < 64 ? 64 : capacity);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_ConvertRegisterInstructionListToChunks(
+    MLRA_RegisterInstructionList *const list
+)
+{
+    return list->chunked || ConvertRegisterInstructionListToChunks(list);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_AppendRegisterInstructionSpanToList(
+    MLRA_RegisterInstructionList *const list,
+    int32_t const *const virtualRegisterIds,
+    uint64_t const *const storeBits,
+    size_t const count
+)
+{
+    if (count == 0) {
+        return true;
+    }
+
+    size_t required;
+    if (__builtin_add_overflow(list->count, count, &required)) {
+        return false;
+    }
+
+    if (list->chunked) {
+        bool const appended = AppendInstructionSpanToChunks(list, virtualRegisterIds, storeBits, count);
+        list->count = GetInstructionChunkSubtreeCount(list->chunks);
+
+        MLRA_DestroyNextUseIndex(list->nextUseIndex);
+        list->nextUseIndex = nullptr;
+
+        return appended;
+    }
+
+    if (!ReserveRegisterInstructionList(list, required)) {
+        return false;
+    }
+
+    memcpy(list->virtualRegisterIds + list->count, virtualRegisterIds, count * sizeof(int32_t));
+
+    size_t const shift = list->count % 64;
+    size_t const first = list->count / 64;
+    size_t const wordCount = GetStoreWordCount(count);
+    if (shift == 0) {
+        memcpy(list->storeBits + first, storeBits, wordCount * sizeof(uint64_t));
+    }
+    else {
+        uint64_t const kept = (UINT64_C(1) << shift) - 1;
+        list->storeBits[first] = (list->storeBits[first] & kept) | (storeBits[0] << shift);
+        for (size_t word = 1; word < wordCount; ++word) {
+            list->storeBits[first + word] = (storeBits[word - 1] >> (64 - shift)) | (storeBits[word] << shift);
+        }
+        if (first + wordCount < GetStoreWordCount(required)) {
+            list->storeBits[first + wordCount] = storeBits[wordCount - 1] >> (64 - shift);
         }
+    }
+
+    list->count = required;
+
+    MLRA_DestroyNextUseIndex(list->nextUseIndex);
+    list->nextUseIndex = nullptr;
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_InsertRegisterInstructionSpanAtList(
+    MLRA_RegisterInstructionList *const list,
+    size_t const index,
+    int32_t const *const virtualRegisterIds,
+    uint64_t const *const storeBits,
+    size_t const count
+)
+{
+    assert(index <= list->count);
 
-        list->capacity = expectedCapacity;
-        list->instructions = instructions;
+    if (index == list->count) {
+        return MLRA_AppendRegisterInstructionSpanToList(list, virtualRegisterIds, storeBits, count);
     }
 
-    list->instructions[list->count] = instruction;
-    list->count++;
+    if (count == 0) {
+        return true;
+    }
+
+    size_t required;
+    if (__builtin_add_overflow(list->count, count, &required)) {
+        return false;
+    }
+
+    if (list->chunked) {
+        bool const inserted = InsertInstructionSpanIntoChunks(list, index, virtualRegisterIds, storeBits, count);
+        list->count = GetInstructionChunkSubtreeCount(list->chunks);
+
+        MLRA_DestroyNextUseIndex(list->nextUseIndex);
+        list->nextUseIndex = nullptr;
+
+        return inserted;
+    }
+
+    if (!ReserveRegisterInstructionList(list, required)) {
+        return false;
+    }
+
+    memmove(list->virtualRegisterIds + index + count, list->virtualRegisterIds + index, sizeof(int32_t) * (list->count - index));
+    MoveStoreBits(list->storeBits, index + count, index, list->count - index);
+    memcpy(list->virtualRegisterIds + index, virtualRegisterIds, sizeof(int32_t) * count);
+    CopyStoreBits(list->storeBits, index, storeBits, 0, count);
+
+    list->count = required;
+
+    MLRA_DestroyNextUseIndex(list->nextUseIndex);
+    list->nextUseIndex = nullptr;
+
+    return true;
 }
 
 [[gnu::nonnull(1), gnu::access(read_write, 1)]]
@@ -124,44 +1534,34 @@ void MLRA_InsertRegisterInstructionAtList(
     );
     assert(index <= list->count);
 
-    if (list->instructions == nullptr) {
-        list->instructions = calloc(8, sizeof(MLRA_RegisterInstruction));
-        if (list->instructions == nullptr) {
-            return;
-        }
-
-        list->capacity = 8;
+    if (!list->chunked && index != list->count && list->count >= ChunkedConversionThreshold) {
+        (void)ConvertRegisterInstructionListToChunks(list);
     }
-    else if (list->count == list->capacity) {
-        size_t oldCapacity = list->capacity;
-        size_t totalSize;
-        if (__builtin_mul_overflow(list->capacity * 2, sizeof(MLRA_RegisterInstruction), &totalSize)) {
-            totalSize = SIZE_MAX;
-        }
 
-        size_t expectedCapacity = totalSize / sizeof(MLRA_RegisterInstruction);
-        if (oldCapacity == expectedCapacity) {
+    if (list->chunked) {
+        if (!InsertInstructionIntoChunks(list, index, instruction)) {
             return;
         }
+        ++list->count;
 
-        MLRA_RegisterInstruction *instructions = realloc(list->instructions, totalSize);
-        if (instructions == nullptr) {
-            return;
-        }
-
-        list->capacity = expectedCapacity;
-        list->instructions = instructions;
+        InsertNextUsePositionInList(list, index, instruction.virtualRegisterId);
+        return;
     }
 
-    if (index == list->count) {
-        list->instructions[list->count] = instruction;
+    if (!GrowRegisterInstructionList(list)) {
+        return;
     }
-    else {
-        memmove(list->instructions + index, list->instructions + index + 1, sizeof(MLRA_RegisterInstruction) * (list->count - index));
-        list->instructions[index] = instruction;
+
+    if (index != list->count) {
+        memmove(list->virtualRegisterIds + index + 1, list->virtualRegisterIds + index, sizeof(int32_t) * (list->count - index));
+        ShiftStoreBitsUp(list->storeBits, index, list->count);
     }
 
+    list->virtualRegisterIds[index] = instruction.virtualRegisterId;
+    SetStoreBit(list->storeBits, index, instruction.type == MLRA_RegisterInstructionType_Store);
     ++list->count;
+
+    InsertNextUsePositionInList(list, index, instruction.virtualRegisterId);
 }
 
 [[gnu::nonnull(1), gnu::access(read_write, 1)]]
@@ -173,20 +1573,23 @@ void MLRA_RemoveRegisterInstructionBehindList(
         return;
     }
 
-    --list->count;
-
-    size_t spaceThreshold;
-    if (!__builtin_mul_overflow(list->count, 3, &spaceThreshold)) {
-        if (spaceThreshold > list->capacity) {
-            MLRA_RegisterInstruction *instructions = realloc(list->instructions, sizeof(MLRA_RegisterInstruction) * list->count * 2);
-            if (instructions == nullptr) {
-                return;
-            }
+    if (list->nextUseIndex != nullptr) {
+        MLRA_RemovePositionFromNextUseIndex(list->nextUseIndex, list->count - 1);
+    }
 
-            list->instructions = instructions;
-            list->capacity = list->count * 2;
+    if (list->chunked) {
+        if (!RemoveInstructionFromChunks(list, list->count - 1)) {
+            MLRA_DestroyNextUseIndex(list->nextUseIndex);
+            list->nextUseIndex = nullptr;
+            return;
         }
+        --list->count;
+        return;
     }
+
+    --list->count;
+
+    ShrinkRegisterInstructionList(list);
 }
 
 [[gnu::nonnull(1), gnu::access(read_write, 1)]]
@@ -201,22 +1604,64 @@ void MLRA_RemoveRegisterInstructionAtList(
         return;
     }
 
+    if (list->nextUseIndex != nullptr) {
+        MLRA_RemovePositionFromNextUseIndex(list->nextUseIndex, index);
+    }
+
+    if (!list->chunked && index != list->count - 1 && list->count >= ChunkedConversionThreshold) {
+        (void)ConvertRegisterInstructionListToChunks(list);
+    }
+
+    if (list->chunked) {
+        if (!RemoveInstructionFromChunks(list, index)) {
+            MLRA_DestroyNextUseIndex(list->nextUseIndex);
+            list->nextUseIndex = nullptr;
+            return;
+        }
+        --list->count;
+        return;
+    }
+
     if (index != list->count - 1) {
-        memmove(list->instructions + index, list->instructions + index + 1, sizeof(MLRA_RegisterInstruction) * (list->count - index - 1));
+        memmove(list->virtualRegisterIds + index, list->virtualRegisterIds + index + 1, sizeof(int32_t) * (list->count - index - 1));
+        ShiftStoreBitsDown(list->storeBits, index, list->count);
     }
 
     --list->count;
 
-    size_t spaceThreshold;
-    if (!__builtin_mul_overflow(list->count, 3, &spaceThreshold)) {
-        if (spaceThreshold > list->capacity) {
-            MLRA_RegisterInstruction *instructions = realloc(list->instructions, sizeof(MLRA_RegisterInstruction) * list->count * 2);
-            if (instructions == nullptr) {
-                return;
-            }
+    ShrinkRegisterInstructionList(list);
+}
 
-            list->instructions = instructions;
-            list->capacity = list->count * 2;
-        }
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void MLRA_RemoveRegisterInstructionRangeAtList(
+    MLRA_RegisterInstructionList *const list,
+    size_t const index,
+    size_t const count
+)
+{
+    assert(index <= list->count);
+    assert(count <= list->count - index);
+
+    if (count == 0) {
+        return;
     }
+
+    MLRA_DestroyNextUseIndex(list->nextUseIndex);
+    list->nextUseIndex = nullptr;
+
+    if (list->chunked) {
+        (void)RemoveInstructionRangeFromChunks(list, index, count);
+        list->count = GetInstructionChunkSubtreeCount(list->chunks);
+        return;
+    }
+
+    size_t const end = index + count;
+    if (end != list->count) {
+        memmove(list->virtualRegisterIds + index, list->virtualRegisterIds + end, sizeof(int32_t) * (list->count - end));
+        MoveStoreBits(list->storeBits, index, end, list->count - end);
+    }
+
+    list->count -= count;
+
+    ShrinkRegisterInstructionList(list);
 }
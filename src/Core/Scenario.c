@@ -5,17 +5,166 @@
 #include <assert.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <stdatomic.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
+static constexpr size_t InstructionEditJournalLength = 64;
+static constexpr size_t RegisterCostEditJournalLength = 64;
+static constexpr size_t DefaultScenarioArenaBlockSize = 65536;
+static constexpr size_t ArenaRegisterCostRunReserve = 4;
+
+typedef struct
+{
+    size_t index;
+    ptrdiff_t delta;
+} InstructionEdit;
+
+typedef struct
+{
+    size_t begin;
+    size_t end;
+} RegisterCostEdit;
+
 struct MLRA_Scenario_
 {
     MLRA_RegisterCostArray *registerCosts;
     MLRA_RegisterInstructionList *registerInstructions;
+    MLRA_ScenarioArena *arena;
+    MLRA_Scenario *nextInArena;
     MLRA_RegisterCost memorySpillCost;
+    uint64_t identity;
+    uint64_t instructionGeneration;
+    uint64_t registerCostGeneration;
+    uint64_t registerCountGeneration;
+    uint64_t memorySpillCostGeneration;
+    InstructionEdit instructionEdits[InstructionEditJournalLength];
+    RegisterCostEdit registerCostEdits[RegisterCostEditJournalLength];
+};
+
+/*
+ * Arenas hand out memory from a chain of blocks and never free single allocations. Scenarios placed in an arena are
+ * linked together so that destroying the arena can release the instruction lists they still hold.
+ */
+typedef struct ScenarioArenaBlock_ ScenarioArenaBlock;
+
+struct ScenarioArenaBlock_
+{
+    ScenarioArenaBlock *next;
+    size_t size;
+    size_t used;
+    [[gnu::counted_by(size)]] alignas(max_align_t) unsigned char data[];
 };
 
+struct MLRA_ScenarioArena_
+{
+    ScenarioArenaBlock *blocks;
+    MLRA_Scenario *scenarios;
+    size_t blockSize;
+};
+
+struct MLRA_ScenarioSnapshot_
+{
+    _Atomic size_t references;
+    MLRA_Scenario *scenario;
+};
+
+static _Atomic uint64_t NextScenarioIdentity = 1;
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void *AllocateInScenarioArena(
+    MLRA_ScenarioArena *const arena,
+    size_t const size
+)
+{
+    size_t rounded;
+    if (__builtin_add_overflow(size, alignof(max_align_t) - 1, &rounded)) {
+        return nullptr;
+    }
+    rounded -= rounded % alignof(max_align_t);
+
+    ScenarioArenaBlock *block = arena->blocks;
+    if (block == nullptr || block->size - block->used < rounded) {
+        size_t const blockSize = rounded > arena->blockSize ? rounded : arena->blockSize;
+        size_t totalSize;
+        if (__builtin_add_overflow(sizeof(ScenarioArenaBlock), blockSize, &totalSize)) {
+            return nullptr;
+        }
+
+        block = malloc(totalSize);
+        if (block == nullptr) {
+            return nullptr;
+        }
+
+        block->next = arena->blocks;
+        block->size = blockSize;
+        block->used = 0;
+        arena->blocks = block;
+    }
+
+    void *const memory = block->data + block->used;
+    block->used += rounded;
+
+    return memory;
+}
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroyScenarioArena(
+    MLRA_ScenarioArena *const arena
+)
+{
+    if (arena == nullptr) {
+        return;
+    }
+
+    for (MLRA_Scenario *scenario = arena->scenarios; scenario != nullptr; scenario = scenario->nextInArena) {
+        MLRA_DestroyRegisterInstructionList(scenario->registerInstructions);
+    }
+
+    ScenarioArenaBlock *block = arena->blocks;
+    while (block != nullptr) {
+        ScenarioArenaBlock *const next = block->next;
+        free(block);
+        block = next;
+    }
+
+    free(arena);
+}
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyScenarioArena, 1)]]
+MLRA_ScenarioArena *MLRA_CreateScenarioArena(
+    size_t const blockSize
+)
+{
+    MLRA_ScenarioArena *arena = malloc(sizeof(MLRA_ScenarioArena));
+    if (arena == nullptr) {
+        return nullptr;
+    }
+
+    arena->blocks = nullptr;
+    arena->scenarios = nullptr;
+    arena->blockSize = blockSize == 0 ? DefaultScenarioArenaBlockSize : blockSize;
+
+    return arena;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetUsedSizeInScenarioArena(
+    MLRA_ScenarioArena const *const arena
+)
+{
+    size_t used = 0;
+    for (ScenarioArenaBlock const *block = arena->blocks; block != nullptr; block = block->next) {
+        used += block->used;
+    }
+
+    return used;
+}
+
 void MLRA_DestroyScenario(
     MLRA_Scenario *const scenario
 )
@@ -24,11 +173,113 @@ void MLRA_DestroyScenario(
         return;
     }
 
-    MLRA_DestroyRegisterCostArray(scenario->registerCosts);
     MLRA_DestroyRegisterInstructionList(scenario->registerInstructions);
+    if (scenario->arena != nullptr) {
+        scenario->registerInstructions = nullptr;
+        return;
+    }
+
+    MLRA_DestroyRegisterCostArray(scenario->registerCosts);
     free(scenario);
 }
 
+/*
+ * Builds a cost array in arena memory with room for twice the runs of source, copying source when one is given. Arena
+ * cost arrays cannot grow, so edits that run out of room move the costs to a new array and leave the old one to the
+ * arena.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1)]]
+static MLRA_RegisterCostArray *PlaceRegisterCostsInArena(
+    MLRA_ScenarioArena *const arena,
+    MLRA_RegisterCostArray const *const source,
+    size_t const registerCount
+)
+{
+    size_t const runCount = source == nullptr ? 0 : MLRA_GetRegisterCostRunCountInArray(source);
+    size_t const runCapacity = 2 * runCount + ArenaRegisterCostRunReserve;
+    size_t const footprint = MLRA_GetRegisterCostArrayFootprint(runCapacity);
+    void *const buffer = footprint == 0 ? nullptr : AllocateInScenarioArena(arena, footprint);
+    if (buffer == nullptr) {
+        return nullptr;
+    }
+
+    if (source == nullptr) {
+        return MLRA_CreateRegisterCostArrayInBuffer(buffer, registerCount, runCapacity);
+    }
+
+    return MLRA_CopyRegisterCostArrayToBuffer(buffer, runCapacity, source, registerCount);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1)]]
+static bool GrowRegisterCostsInArena(
+    MLRA_Scenario *const scenario
+)
+{
+    MLRA_RegisterCostArray *const registerCosts = PlaceRegisterCostsInArena(
+        scenario->arena, scenario->registerCosts, MLRA_GetRegisterCostArraySize(scenario->registerCosts)
+    );
+    if (registerCosts == nullptr) {
+        return false;
+    }
+
+    scenario->registerCosts = registerCosts;
+
+    return true;
+}
+
+/*
+ * Allocates a scenario and its cost array on the heap, or in the arena when one is given. The costs are copied from
+ * source when one is given. The caller sets the instructions and the memory spill cost.
+ */
+[[nodiscard]]
+static MLRA_Scenario *AllocateScenario(
+    MLRA_ScenarioArena *const arena,
+    MLRA_RegisterCostArray const *const source,
+    size_t const registerCount
+)
+{
+    MLRA_Scenario *scenario;
+    MLRA_RegisterCostArray *registerCosts;
+    if (arena == nullptr) {
+        registerCosts = source == nullptr
+            ? MLRA_CreateRegisterCostArray(registerCount)
+            : MLRA_CloneRegisterCostArray(source);
+        if (registerCosts == nullptr) {
+            return nullptr;
+        }
+
+        scenario = malloc(sizeof(MLRA_Scenario));
+        if (scenario == nullptr) {
+            MLRA_DestroyRegisterCostArray(registerCosts);
+            return nullptr;
+        }
+        scenario->nextInArena = nullptr;
+    }
+    else {
+        registerCosts = PlaceRegisterCostsInArena(arena, source, registerCount);
+        scenario = registerCosts == nullptr ? nullptr : AllocateInScenarioArena(arena, sizeof(MLRA_Scenario));
+        if (scenario == nullptr) {
+            return nullptr;
+        }
+
+        scenario->nextInArena = arena->scenarios;
+        arena->scenarios = scenario;
+    }
+
+    scenario->registerCosts = registerCosts;
+    scenario->registerInstructions = nullptr;
+    scenario->arena = arena;
+    scenario->identity = atomic_fetch_add_explicit(&NextScenarioIdentity, 1, memory_order_relaxed);
+    scenario->instructionGeneration = 0;
+    scenario->registerCostGeneration = 0;
+    scenario->registerCountGeneration = 0;
+    scenario->memorySpillCostGeneration = 0;
+
+    return scenario;
+}
+
 [[nodiscard]]
 [[gnu::malloc, gnu::malloc(MLRA_DestroyScenario, 1)]]
 MLRA_Scenario *MLRA_CreateScenario(
@@ -36,31 +287,90 @@ MLRA_Scenario *MLRA_CreateScenario(
     MLRA_RegisterCost const memorySpillCost
 )
 {
-    MLRA_RegisterCostArray *registerCosts = MLRA_CreateRegisterCostArray(registerCount);
-    if (registerCosts == nullptr) {
+    MLRA_RegisterInstructionList *registerInstructions = MLRA_CreateRegisterInstructionList();
+    if (registerInstructions == nullptr) {
+        return nullptr;
+    }
+
+    MLRA_Scenario *scenario = MLRA_CreateScenarioWithRegisterInstructionList(
+        registerCount,
+        memorySpillCost,
+        registerInstructions
+    );
+    if (scenario == nullptr) {
+        MLRA_DestroyRegisterInstructionList(registerInstructions);
         return nullptr;
     }
 
+    return scenario;
+}
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyScenario, 1)]]
+[[gnu::nonnull(3), gnu::access(read_write, 3)]]
+MLRA_Scenario *MLRA_CreateScenarioWithRegisterInstructionList(
+    size_t const registerCount,
+    MLRA_RegisterCost const memorySpillCost,
+    MLRA_RegisterInstructionList *const registerInstructions
+)
+{
+    MLRA_Scenario *scenario = AllocateScenario(nullptr, nullptr, registerCount);
+    if (scenario == nullptr) {
+        return nullptr;
+    }
+
+    scenario->registerInstructions = registerInstructions;
+    scenario->memorySpillCost = memorySpillCost;
+
+    return scenario;
+}
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyScenario, 1)]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+MLRA_Scenario *MLRA_CreateScenarioInArena(
+    MLRA_ScenarioArena *const arena,
+    size_t const registerCount,
+    MLRA_RegisterCost const memorySpillCost
+)
+{
     MLRA_RegisterInstructionList *registerInstructions = MLRA_CreateRegisterInstructionList();
     if (registerInstructions == nullptr) {
-        MLRA_DestroyRegisterCostArray(registerCosts);
         return nullptr;
     }
 
-    MLRA_Scenario *scenario = malloc(sizeof(MLRA_Scenario));
+    MLRA_Scenario *scenario = AllocateScenario(arena, nullptr, registerCount);
     if (scenario == nullptr) {
         MLRA_DestroyRegisterInstructionList(registerInstructions);
-        MLRA_DestroyRegisterCostArray(registerCosts);
         return nullptr;
     }
-    
-    scenario->registerCosts = registerCosts;
+
     scenario->registerInstructions = registerInstructions;
     scenario->memorySpillCost = memorySpillCost;
 
     return scenario;
 }
 
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyScenario, 1)]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_Scenario *MLRA_CloneScenario(
+    MLRA_Scenario const *const scenario,
+    MLRA_ScenarioArena *const arena
+)
+{
+    size_t const registerCount = MLRA_GetRegisterCostArraySize(scenario->registerCosts);
+    MLRA_Scenario *clone = AllocateScenario(arena, scenario->registerCosts, registerCount);
+    if (clone == nullptr) {
+        return nullptr;
+    }
+
+    clone->registerInstructions = MLRA_RetainRegisterInstructionList(scenario->registerInstructions);
+    clone->memorySpillCost = scenario->memorySpillCost;
+
+    return clone;
+}
+
 [[nodiscard, gnu::pure]]
 [[gnu::nonnull(1), gnu::access(read_only, 1)]]
 MLRA_RegisterCost MLRA_GetMemorySpillCostInScenario(
@@ -79,7 +389,13 @@ void MLRA_SetMemorySpillCostInScenario(
     assert(memorySpillCost.load > 0);
     assert(memorySpillCost.store > 0);
 
-    scenario->memorySpillCost = memorySpillCost;
+    if (
+        memorySpillCost.load != scenario->memorySpillCost.load
+        || memorySpillCost.store != scenario->memorySpillCost.store
+    ) {
+        scenario->memorySpillCost = memorySpillCost;
+        ++scenario->memorySpillCostGeneration;
+    }
 }
 
 [[nodiscard, gnu::pure]]
@@ -91,18 +407,71 @@ size_t MLRA_GetRegisterCountInScenario(
     return MLRA_GetRegisterCostArraySize(scenario->registerCosts);
 }
 
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void RecordRegisterCostEdit(
+    MLRA_Scenario *const scenario,
+    size_t const begin,
+    size_t const end
+)
+{
+    if (begin == end) {
+        return;
+    }
+
+    scenario->registerCostEdits[scenario->registerCostGeneration % RegisterCostEditJournalLength] = (RegisterCostEdit){
+        .begin = begin,
+        .end = end
+    };
+    ++scenario->registerCostGeneration;
+}
+
+/*
+ * A new register count also counts as a cost edit of the registers that were added or dropped.
+ */
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void RecordRegisterCountEdit(
+    MLRA_Scenario *const scenario,
+    size_t const previousCount
+)
+{
+    size_t const count = MLRA_GetRegisterCostArraySize(scenario->registerCosts);
+    if (count == previousCount) {
+        return;
+    }
+
+    size_t const begin = count < previousCount ? count : previousCount;
+    size_t const end = count < previousCount ? previousCount : count;
+    RecordRegisterCostEdit(scenario, begin, end);
+    ++scenario->registerCountGeneration;
+}
+
 [[gnu::nonnull(1), gnu::access(read_write, 1)]]
 void MLRA_SetRegisterCountInScenario(
     MLRA_Scenario *const scenario,
     size_t const count
 )
 {
+    size_t const previousCount = MLRA_GetRegisterCostArraySize(scenario->registerCosts);
+    if (scenario->arena != nullptr) {
+        MLRA_RegisterCostArray *const registerCosts = PlaceRegisterCostsInArena(
+            scenario->arena, scenario->registerCosts, count
+        );
+        if (registerCosts == nullptr) {
+            return;
+        }
+
+        scenario->registerCosts = registerCosts;
+        RecordRegisterCountEdit(scenario, previousCount);
+        return;
+    }
+
     MLRA_RegisterCostArray *registerCosts = MLRA_ResizeRegisterCostArray(scenario->registerCosts, count);
     if (registerCosts == nullptr) {
         return;
     }
 
     scenario->registerCosts = registerCosts;
+    RecordRegisterCountEdit(scenario, previousCount);
 }
 
 [[nodiscard, gnu::pure]]
@@ -125,7 +494,81 @@ void MLRA_SetRegisterCostInScenario(
     assert(registerCost.load > 0);
     assert(registerCost.store > 0);
 
-    MLRA_SetRegisterCostInArray(scenario->registerCosts, index, registerCost);
+    bool set = MLRA_SetRegisterCostInArray(scenario->registerCosts, index, registerCost);
+    while (!set && scenario->arena != nullptr && GrowRegisterCostsInArena(scenario)) {
+        set = MLRA_SetRegisterCostInArray(scenario->registerCosts, index, registerCost);
+    }
+
+    if (set) {
+        RecordRegisterCostEdit(scenario, index, index + 1);
+    }
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1), gnu::access(read_only, 3, 4)]]
+void MLRA_SetRegisterCostRangeInScenario(
+    MLRA_Scenario *const scenario,
+    size_t const index,
+    MLRA_RegisterCost const *const registerCosts,
+    size_t const count
+)
+{
+    bool set = MLRA_SetRegisterCostRangeInArray(scenario->registerCosts, index, registerCosts, count);
+    while (!set && scenario->arena != nullptr && GrowRegisterCostsInArena(scenario)) {
+        set = MLRA_SetRegisterCostRangeInArray(scenario->registerCosts, index, registerCosts, count);
+    }
+
+    /* A range that failed halfway still changed costs, so it is recorded all the same. */
+    RecordRegisterCostEdit(scenario, index, index + count);
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetRegisterCostClassCountInScenario(
+    MLRA_Scenario const *const scenario
+)
+{
+    return MLRA_GetRegisterCostClassCountInArray(scenario->registerCosts);
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetRegisterCostClassInScenario(
+    MLRA_Scenario const *const scenario,
+    size_t const index
+)
+{
+    return MLRA_GetRegisterCostClassInArray(scenario->registerCosts, index);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_only, 1), gnu::access(write_only, 3)]]
+size_t MLRA_GetRegisterCostClassSpanInScenario(
+    MLRA_Scenario const *const scenario,
+    size_t const index,
+    size_t *const length
+)
+{
+    return MLRA_GetRegisterCostClassSpanInArray(scenario->registerCosts, index, length);
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_RegisterCost MLRA_GetRegisterCostOfCostClassInScenario(
+    MLRA_Scenario const *const scenario,
+    size_t const costClass
+)
+{
+    return MLRA_GetRegisterCostOfCostClassInArray(scenario->registerCosts, costClass);
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetRegisterCountInCostClassOfScenario(
+    MLRA_Scenario const *const scenario,
+    size_t const costClass
+)
+{
+    return MLRA_GetRegisterCountInCostClassOfArray(scenario->registerCosts, costClass);
 }
 
 [[nodiscard, gnu::pure]]
@@ -147,13 +590,233 @@ MLRA_RegisterInstruction MLRA_GetRegisterInstructionInScenario(
     return MLRA_GetRegisterInstructionInList(scenario->registerInstructions, index);
 }
 
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_only, 1), gnu::access(write_only, 3)]]
+int32_t const *MLRA_GetVirtualRegisterIdSpanInScenario(
+    MLRA_Scenario const *const scenario,
+    size_t const index,
+    size_t *const length
+)
+{
+    return MLRA_GetVirtualRegisterIdSpanInList(scenario->registerInstructions, index, length);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3, 4), gnu::access(read_only, 1), gnu::access(write_only, 3), gnu::access(write_only, 4)]]
+uint64_t const *MLRA_GetStoreBitSpanInScenario(
+    MLRA_Scenario const *const scenario,
+    size_t const index,
+    size_t *const length,
+    size_t *const bitOffset
+)
+{
+    return MLRA_GetStoreBitSpanInList(scenario->registerInstructions, index, length, bitOffset);
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_NextUseIndex const *MLRA_GetNextUseIndexInScenario(
+    MLRA_Scenario const *const scenario
+)
+{
+    return MLRA_GetNextUseIndexInList(scenario->registerInstructions);
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+uint64_t MLRA_GetScenarioIdentity(
+    MLRA_Scenario const *const scenario
+)
+{
+    return scenario->identity;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+uint64_t MLRA_GetInstructionGenerationInScenario(
+    MLRA_Scenario const *const scenario
+)
+{
+    return scenario->instructionGeneration;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_only, 1), gnu::access(write_only, 3)]]
+bool MLRA_GetInstructionDirtyRangeInScenario(
+    MLRA_Scenario const *const scenario,
+    uint64_t const generation,
+    MLRA_ScenarioDirtyRange *const range
+)
+{
+    if (generation > scenario->instructionGeneration) {
+        return false;
+    }
+    if (scenario->instructionGeneration - generation > InstructionEditJournalLength) {
+        return false;
+    }
+
+    *range = (MLRA_ScenarioDirtyRange){};
+    for (uint64_t edit = generation; edit < scenario->instructionGeneration; ++edit) {
+        InstructionEdit const entry = scenario->instructionEdits[edit % InstructionEditJournalLength];
+
+        size_t end = range->end;
+        size_t editEnd = entry.index;
+        if (entry.delta > 0) {
+            size_t const length = (size_t)entry.delta;
+            end = end > entry.index ? end + length : end;
+            editEnd = entry.index + length;
+        }
+        else {
+            size_t const length = (size_t)-entry.delta;
+            if (end >= entry.index + length) {
+                end -= length;
+            }
+            else if (end > entry.index) {
+                end = entry.index;
+            }
+        }
+
+        if (edit == generation) {
+            range->begin = entry.index;
+            range->end = editEnd;
+        }
+        else {
+            range->begin = entry.index < range->begin ? entry.index : range->begin;
+            range->end = editEnd > end ? editEnd : end;
+        }
+        range->shift += entry.delta;
+    }
+
+    return true;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+uint64_t MLRA_GetRegisterCostGenerationInScenario(
+    MLRA_Scenario const *const scenario
+)
+{
+    return scenario->registerCostGeneration;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+uint64_t MLRA_GetRegisterCountGenerationInScenario(
+    MLRA_Scenario const *const scenario
+)
+{
+    return scenario->registerCountGeneration;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+uint64_t MLRA_GetMemorySpillCostGenerationInScenario(
+    MLRA_Scenario const *const scenario
+)
+{
+    return scenario->memorySpillCostGeneration;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_only, 1), gnu::access(write_only, 3)]]
+bool MLRA_GetRegisterCostDirtyRangeInScenario(
+    MLRA_Scenario const *const scenario,
+    uint64_t const generation,
+    MLRA_ScenarioDirtyRange *const range
+)
+{
+    if (generation > scenario->registerCostGeneration) {
+        return false;
+    }
+    if (scenario->registerCostGeneration - generation > RegisterCostEditJournalLength) {
+        return false;
+    }
+
+    *range = (MLRA_ScenarioDirtyRange){};
+    for (uint64_t edit = generation; edit < scenario->registerCostGeneration; ++edit) {
+        RegisterCostEdit const entry = scenario->registerCostEdits[edit % RegisterCostEditJournalLength];
+        if (edit == generation) {
+            range->begin = entry.begin;
+            range->end = entry.end;
+        }
+        else {
+            range->begin = entry.begin < range->begin ? entry.begin : range->begin;
+            range->end = entry.end > range->end ? entry.end : range->end;
+        }
+    }
+
+    return true;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void RecordInstructionEdit(
+    MLRA_Scenario *const scenario,
+    size_t const index,
+    size_t const previousCount
+)
+{
+    size_t const count = MLRA_GetRegisterInstructionCountInList(scenario->registerInstructions);
+    if (count == previousCount) {
+        return;
+    }
+
+    scenario->instructionEdits[scenario->instructionGeneration % InstructionEditJournalLength] = (InstructionEdit){
+        .index = index,
+        .delta = count > previousCount ? (ptrdiff_t)(count - previousCount) : -(ptrdiff_t)(previousCount - count)
+    };
+    ++scenario->instructionGeneration;
+}
+
+/*
+ * Gives the scenario its own copy of instructions it still shares with clones before they are edited.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static bool UnshareRegisterInstructions(
+    MLRA_Scenario *const scenario
+)
+{
+    if (!MLRA_IsRegisterInstructionListShared(scenario->registerInstructions)) {
+        return true;
+    }
+
+    MLRA_RegisterInstructionList *registerInstructions = MLRA_CopyRegisterInstructionList(scenario->registerInstructions);
+    if (registerInstructions == nullptr) {
+        return false;
+    }
+
+    MLRA_DestroyRegisterInstructionList(scenario->registerInstructions);
+    scenario->registerInstructions = registerInstructions;
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_BuildNextUseIndexInScenario(
+    MLRA_Scenario *const scenario
+)
+{
+    if (MLRA_GetNextUseIndexInList(scenario->registerInstructions) != nullptr) {
+        return true;
+    }
+
+    return UnshareRegisterInstructions(scenario) && MLRA_BuildNextUseIndexInList(scenario->registerInstructions);
+}
+
 [[gnu::nonnull(1), gnu::access(read_write, 1)]]
 void MLRA_AppendRegisterInstructionToScenario(
     MLRA_Scenario *const scenario,
     MLRA_RegisterInstruction const instruction
 )
 {
+    if (!UnshareRegisterInstructions(scenario)) {
+        return;
+    }
+
+    size_t const count = MLRA_GetRegisterInstructionCountInList(scenario->registerInstructions);
     MLRA_AppendRegisterInstructionToList(scenario->registerInstructions, instruction);
+    RecordInstructionEdit(scenario, count, count);
 }
 
 [[gnu::nonnull(1), gnu::access(read_write, 1)]]
@@ -163,7 +826,13 @@ void MLRA_InsertRegisterInstructionToScenario(
     MLRA_RegisterInstruction const instruction
 )
 {
+    if (!UnshareRegisterInstructions(scenario)) {
+        return;
+    }
+
+    size_t const count = MLRA_GetRegisterInstructionCountInList(scenario->registerInstructions);
     MLRA_InsertRegisterInstructionAtList(scenario->registerInstructions, index, instruction);
+    RecordInstructionEdit(scenario, index, count);
 }
 
 [[gnu::nonnull(1), gnu::access(read_write, 1)]]
@@ -171,7 +840,13 @@ void MLRA_RemoveRegisterInstructionBehindScenario(
     MLRA_Scenario *const scenario
 )
 {
+    if (!UnshareRegisterInstructions(scenario)) {
+        return;
+    }
+
+    size_t const count = MLRA_GetRegisterInstructionCountInList(scenario->registerInstructions);
     MLRA_RemoveRegisterInstructionBehindList(scenario->registerInstructions);
+    RecordInstructionEdit(scenario, count - 1, count);
 }
 
 [[gnu::nonnull(1), gnu::access(read_write, 1)]]
@@ -180,5 +855,168 @@ void MLRA_RemoveRegisterInstructionAtScenario(
     size_t const index
 )
 {
+    if (!UnshareRegisterInstructions(scenario)) {
+        return;
+    }
+
+    size_t const count = MLRA_GetRegisterInstructionCountInList(scenario->registerInstructions);
     MLRA_RemoveRegisterInstructionAtList(scenario->registerInstructions, index);
+    RecordInstructionEdit(scenario, index, count);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_ReserveRegisterInstructionsInScenario(
+    MLRA_Scenario *const scenario,
+    size_t const capacity
+)
+{
+    if (!UnshareRegisterInstructions(scenario)) {
+        return false;
+    }
+
+    return MLRA_ReserveRegisterInstructionsInList(scenario->registerInstructions, capacity);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_AppendRegisterInstructionSpanToScenario(
+    MLRA_Scenario *const scenario,
+    int32_t const *const virtualRegisterIds,
+    uint64_t const *const storeBits,
+    size_t const count
+)
+{
+    if (!UnshareRegisterInstructions(scenario)) {
+        return false;
+    }
+
+    size_t const previousCount = MLRA_GetRegisterInstructionCountInList(scenario->registerInstructions);
+    bool const appended = MLRA_AppendRegisterInstructionSpanToList(
+        scenario->registerInstructions,
+        virtualRegisterIds,
+        storeBits,
+        count
+    );
+    RecordInstructionEdit(scenario, previousCount, previousCount);
+
+    return appended;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+bool MLRA_InsertRegisterInstructionSpanToScenario(
+    MLRA_Scenario *const scenario,
+    size_t const index,
+    int32_t const *const virtualRegisterIds,
+    uint64_t const *const storeBits,
+    size_t const count
+)
+{
+    if (!UnshareRegisterInstructions(scenario)) {
+        return false;
+    }
+
+    size_t const previousCount = MLRA_GetRegisterInstructionCountInList(scenario->registerInstructions);
+    bool const inserted = MLRA_InsertRegisterInstructionSpanAtList(
+        scenario->registerInstructions,
+        index,
+        virtualRegisterIds,
+        storeBits,
+        count
+    );
+    RecordInstructionEdit(scenario, index, previousCount);
+
+    return inserted;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void MLRA_RemoveRegisterInstructionRangeAtScenario(
+    MLRA_Scenario *const scenario,
+    size_t const index,
+    size_t const count
+)
+{
+    if (!UnshareRegisterInstructions(scenario)) {
+        return;
+    }
+
+    size_t const previousCount = MLRA_GetRegisterInstructionCountInList(scenario->registerInstructions);
+    MLRA_RemoveRegisterInstructionRangeAtList(scenario->registerInstructions, index, count);
+    RecordInstructionEdit(scenario, index, previousCount);
+}
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroyScenarioSnapshot(
+    MLRA_ScenarioSnapshot *const snapshot
+)
+{
+    if (snapshot == nullptr || atomic_fetch_sub_explicit(&snapshot->references, 1, memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    MLRA_DestroyScenario(snapshot->scenario);
+    free(snapshot);
+}
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyScenarioSnapshot, 1)]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+MLRA_ScenarioSnapshot *MLRA_CreateScenarioSnapshot(
+    MLRA_Scenario *const scenario
+)
+{
+    if (
+        !MLRA_IsRegisterInstructionListChunked(scenario->registerInstructions)
+        && (
+            !UnshareRegisterInstructions(scenario)
+            || !MLRA_ConvertRegisterInstructionListToChunks(scenario->registerInstructions)
+        )
+    ) {
+        return nullptr;
+    }
+
+    MLRA_ScenarioSnapshot *snapshot = malloc(sizeof(MLRA_ScenarioSnapshot));
+    if (snapshot == nullptr) {
+        return nullptr;
+    }
+
+    MLRA_Scenario *frozen = MLRA_CloneScenario(scenario, nullptr);
+    if (frozen == nullptr) {
+        free(snapshot);
+        return nullptr;
+    }
+
+    frozen->identity = scenario->identity;
+    frozen->instructionGeneration = scenario->instructionGeneration;
+    frozen->registerCostGeneration = scenario->registerCostGeneration;
+    frozen->registerCountGeneration = scenario->registerCountGeneration;
+    frozen->memorySpillCostGeneration = scenario->memorySpillCostGeneration;
+    memcpy(frozen->instructionEdits, scenario->instructionEdits, sizeof(scenario->instructionEdits));
+    memcpy(frozen->registerCostEdits, scenario->registerCostEdits, sizeof(scenario->registerCostEdits));
+
+    atomic_init(&snapshot->references, 1);
+    snapshot->scenario = frozen;
+
+    return snapshot;
+}
+
+[[nodiscard, gnu::returns_nonnull]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+MLRA_ScenarioSnapshot *MLRA_RetainScenarioSnapshot(
+    MLRA_ScenarioSnapshot *const snapshot
+)
+{
+    atomic_fetch_add_explicit(&snapshot->references, 1, memory_order_relaxed);
+
+    return snapshot;
+}
+
+[[nodiscard, gnu::pure, gnu::returns_nonnull]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_Scenario const *MLRA_GetScenarioInSnapshot(
+    MLRA_ScenarioSnapshot const *const snapshot
+)
+{
+    return snapshot->scenario;
 }
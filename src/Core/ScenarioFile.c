@@ -0,0 +1,268 @@
+#include "MLRA/Core/ScenarioFile.h"
+#include "MLRA/Core/FileMapping.h"
+#include "MLRA/Core/RegisterCost.h"
+#include "MLRA/Core/RegisterInstruction.h"
+#include "MLRA/Core/Scenario.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+static constexpr char ScenarioFileMagic[8] = "MLRASCN";
+static constexpr uint32_t ScenarioFileVersion = 1;
+static constexpr uint32_t ScenarioFileByteOrder = 0x01020304;
+
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint64_t registerCount;
+    uint64_t instructionCount;
+    int32_t memorySpillLoad;
+    int32_t memorySpillStore;
+    uint64_t registerCostOffset;
+    uint64_t virtualRegisterIdOffset;
+    uint64_t storeBitOffset;
+} ScenarioFileHeader;
+
+typedef struct
+{
+    int32_t load;
+    int32_t store;
+} ScenarioFileRegisterCost;
+
+static_assert(sizeof(ScenarioFileHeader) == 64);
+static_assert(sizeof(ScenarioFileRegisterCost) == 8);
+
+[[gnu::const]]
+static uint64_t AlignScenarioFileOffset(
+    uint64_t const offset
+)
+{
+    return (offset + 7) & ~UINT64_C(7);
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static bool IsScenarioFileSectionValid(
+    ScenarioFileHeader const *const header,
+    uint64_t const offset,
+    uint64_t const count,
+    uint64_t const elementSize,
+    uint64_t const fileSize
+)
+{
+    uint64_t sectionSize;
+    uint64_t sectionEnd;
+
+    return offset >= sizeof(ScenarioFileHeader) && offset % elementSize == 0 && offset <= fileSize
+        && header->instructionCount <= SIZE_MAX && header->registerCount <= SIZE_MAX
+        && !__builtin_mul_overflow(count, elementSize, &sectionSize)
+        && !__builtin_add_overflow(offset, sectionSize, &sectionEnd) && sectionEnd <= fileSize;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static bool AreScenarioFileRegisterCostsValid(
+    unsigned char const *const data,
+    ScenarioFileHeader const *const header
+)
+{
+    for (size_t reg = 0; reg < (size_t)header->registerCount; ++reg) {
+        ScenarioFileRegisterCost cost;
+        memcpy(&cost, data + header->registerCostOffset + reg * sizeof(ScenarioFileRegisterCost), sizeof(cost));
+        if (cost.load <= 0 || cost.store <= 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyScenario, 1)]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_Scenario *MLRA_LoadScenarioFromFile(
+    char const *const path
+)
+{
+    MLRA_FileMapping *mapping = MLRA_CreateFileMapping(path);
+    if (mapping == nullptr) {
+        return nullptr;
+    }
+
+    unsigned char const *const data = MLRA_GetFileMappingData(mapping);
+    size_t const fileSize = MLRA_GetFileMappingSize(mapping);
+    ScenarioFileHeader header;
+    if (fileSize < sizeof(ScenarioFileHeader)) {
+        MLRA_DestroyFileMapping(mapping);
+        return nullptr;
+    }
+    memcpy(&header, data, sizeof(ScenarioFileHeader));
+
+    uint64_t const storeWordCount = header.instructionCount / 64 + (header.instructionCount % 64 != 0);
+    if (
+        memcmp(header.magic, ScenarioFileMagic, sizeof(ScenarioFileMagic)) != 0
+        || header.version != ScenarioFileVersion || header.byteOrder != ScenarioFileByteOrder
+        || header.memorySpillLoad <= 0 || header.memorySpillStore <= 0
+        || !IsScenarioFileSectionValid(&header, header.registerCostOffset, header.registerCount, sizeof(ScenarioFileRegisterCost), fileSize)
+        || !IsScenarioFileSectionValid(&header, header.virtualRegisterIdOffset, header.instructionCount, sizeof(int32_t), fileSize)
+        || !IsScenarioFileSectionValid(&header, header.storeBitOffset, storeWordCount, sizeof(uint64_t), fileSize)
+        || !AreScenarioFileRegisterCostsValid(data, &header)
+    ) {
+        MLRA_DestroyFileMapping(mapping);
+        return nullptr;
+    }
+
+    MLRA_RegisterInstructionList *registerInstructions = MLRA_CreateRegisterInstructionListInFileMapping(
+        mapping,
+        (size_t)header.virtualRegisterIdOffset,
+        (size_t)header.storeBitOffset,
+        (size_t)header.instructionCount
+    );
+    if (registerInstructions == nullptr) {
+        MLRA_DestroyFileMapping(mapping);
+        return nullptr;
+    }
+
+    MLRA_Scenario *scenario = MLRA_CreateScenarioWithRegisterInstructionList(
+        (size_t)header.registerCount,
+        (MLRA_RegisterCost){header.memorySpillLoad, header.memorySpillStore},
+        registerInstructions
+    );
+    if (scenario == nullptr) {
+        MLRA_DestroyRegisterInstructionList(registerInstructions);
+        return nullptr;
+    }
+
+    for (size_t reg = 0; reg < (size_t)header.registerCount; ++reg) {
+        ScenarioFileRegisterCost cost;
+        memcpy(&cost, data + header.registerCostOffset + reg * sizeof(ScenarioFileRegisterCost), sizeof(cost));
+        MLRA_SetRegisterCostInScenario(scenario, reg, (MLRA_RegisterCost){cost.load, cost.store});
+    }
+
+    return scenario;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_write, 2)]]
+static bool WriteScenarioFilePadding(
+    FILE *const file,
+    uint64_t *const offset
+)
+{
+    static constexpr unsigned char padding[8] = {0};
+    uint64_t const aligned = AlignScenarioFileOffset(*offset);
+    size_t const length = (size_t)(aligned - *offset);
+    *offset = aligned;
+
+    return fwrite(padding, 1, length, file) == length;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_write, 2)]]
+static bool WriteScenarioFileStoreBits(
+    MLRA_Scenario const *const scenario,
+    FILE *const file
+)
+{
+    size_t const count = MLRA_GetRegisterInstructionCountInScenario(scenario);
+    uint64_t word = 0;
+    size_t pending = 0;
+
+    for (size_t index = 0; index < count;) {
+        size_t length;
+        size_t bitOffset;
+        uint64_t const *const bits = MLRA_GetStoreBitSpanInScenario(scenario, index, &length, &bitOffset);
+        size_t offset = 0;
+
+        if (bitOffset == 0 && pending == 0 && length >= 64) {
+            size_t const wordCount = length / 64;
+            if (fwrite(bits, sizeof(uint64_t), wordCount, file) != wordCount) {
+                return false;
+            }
+            offset = wordCount * 64;
+        }
+
+        for (; offset < length; ++offset) {
+            size_t const bit = bitOffset + offset;
+            word |= ((bits[bit / 64] >> (bit % 64)) & 1) << pending;
+            if (++pending == 64) {
+                if (fwrite(&word, sizeof(uint64_t), 1, file) != 1) {
+                    return false;
+                }
+                word = 0;
+                pending = 0;
+            }
+        }
+
+        index += length;
+    }
+
+    return pending == 0 || fwrite(&word, sizeof(uint64_t), 1, file) == 1;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_only, 2)]]
+bool MLRA_SaveScenarioToFile(
+    MLRA_Scenario const *const scenario,
+    char const *const path
+)
+{
+    size_t const registerCount = MLRA_GetRegisterCountInScenario(scenario);
+    size_t const instructionCount = MLRA_GetRegisterInstructionCountInScenario(scenario);
+    MLRA_RegisterCost const memorySpillCost = MLRA_GetMemorySpillCostInScenario(scenario);
+
+    ScenarioFileHeader header = {
+        .version = ScenarioFileVersion,
+        .byteOrder = ScenarioFileByteOrder,
+        .registerCount = registerCount,
+        .instructionCount = instructionCount,
+        .memorySpillLoad = memorySpillCost.load,
+        .memorySpillStore = memorySpillCost.store,
+        .registerCostOffset = sizeof(ScenarioFileHeader)
+    };
+    memcpy(header.magic, ScenarioFileMagic, sizeof(ScenarioFileMagic));
+    header.virtualRegisterIdOffset = AlignScenarioFileOffset(
+        header.registerCostOffset + (uint64_t)registerCount * sizeof(ScenarioFileRegisterCost)
+    );
+    header.storeBitOffset = AlignScenarioFileOffset(
+        header.virtualRegisterIdOffset + (uint64_t)instructionCount * sizeof(int32_t)
+    );
+
+    FILE *file = fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    bool succeeded = fwrite(&header, sizeof(ScenarioFileHeader), 1, file) == 1;
+
+    for (size_t reg = 0; succeeded && reg < registerCount; ++reg) {
+        MLRA_RegisterCost const cost = MLRA_GetRegisterCostInScenario(scenario, reg);
+        ScenarioFileRegisterCost const entry = {cost.load, cost.store};
+        succeeded = fwrite(&entry, sizeof(ScenarioFileRegisterCost), 1, file) == 1;
+    }
+
+    for (size_t index = 0; succeeded && index < instructionCount;) {
+        size_t length;
+        int32_t const *const virtualRegisterIds = MLRA_GetVirtualRegisterIdSpanInScenario(scenario, index, &length);
+        succeeded = fwrite(virtualRegisterIds, sizeof(int32_t), length, file) == length;
+        index += length;
+    }
+
+    uint64_t offset = header.virtualRegisterIdOffset + (uint64_t)instructionCount * sizeof(int32_t);
+    succeeded = succeeded && WriteScenarioFilePadding(file, &offset);
+    succeeded = succeeded && WriteScenarioFileStoreBits(scenario, file);
+
+    if (fclose(file) != 0) {
+        succeeded = false;
+    }
+    if (!succeeded) {
+        remove(path);
+    }
+
+    return succeeded;
+}
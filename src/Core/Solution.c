@@ -0,0 +1,128 @@
+#include "MLRA/Core/Solution.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+struct MLRA_Solution_
+{
+    int64_t cost;
+    size_t count;
+    [[gnu::counted_by(count)]] int32_t locations[];
+};
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroySolution(
+    MLRA_Solution *const solution
+)
+{
+    if (solution == nullptr) {
+        return;
+    }
+
+    free(solution);
+}
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroySolution, 1)]]
+MLRA_Solution *MLRA_CreateSolution(
+    size_t const instructionCount
+)
+{
+    size_t locationsSize;
+    if (__builtin_mul_overflow(instructionCount, sizeof(int32_t), &locationsSize)) {
+        return nullptr;
+    }
+
+    size_t totalSize;
+    if (__builtin_add_overflow(sizeof(MLRA_Solution), locationsSize, &totalSize)) {
+        return nullptr;
+    }
+
+    MLRA_Solution *solution = malloc(totalSize);
+    if (solution == nullptr) {
+        return nullptr;
+    }
+
+    solution->cost = 0;
+    solution->count = instructionCount;
+    for (size_t index = 0; index < instructionCount; ++index) {
+        solution->locations[index] = MLRA_SolutionLocation_Memory;
+    }
+
+    return solution;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+int64_t MLRA_GetSolutionCost(
+    MLRA_Solution const *const solution
+)
+{
+    return solution->cost;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void MLRA_SetSolutionCost(
+    MLRA_Solution *const solution,
+    int64_t const cost
+)
+{
+    solution->cost = cost;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetInstructionCountInSolution(
+    MLRA_Solution const *const solution
+)
+{
+    return solution->count;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+int32_t MLRA_GetInstructionLocationInSolution(
+    MLRA_Solution const *const solution,
+    size_t const index
+)
+{
+    assert(index < solution->count);
+
+    return solution->locations[index];
+}
+
+[[nodiscard, gnu::pure, gnu::returns_nonnull]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+int32_t const *MLRA_GetInstructionLocationSpanInSolution(
+    MLRA_Solution const *const solution
+)
+{
+    return solution->locations;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void MLRA_SetInstructionLocationInSolution(
+    MLRA_Solution *const solution,
+    size_t const index,
+    int32_t const location
+)
+{
+    assert(index < solution->count);
+    assert(location >= MLRA_SolutionLocation_Memory);
+
+    solution->locations[index] = location;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+bool MLRA_IsInstructionSpilledInSolution(
+    MLRA_Solution const *const solution,
+    size_t const index
+)
+{
+    assert(index < solution->count);
+
+    return solution->locations[index] == MLRA_SolutionLocation_Memory;
+}
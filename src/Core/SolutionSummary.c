@@ -0,0 +1,211 @@
+#include "MLRA/Core/SolutionSummary.h"
+#include "MLRA/Core/Solution.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+static constexpr size_t BaseBucketLength = 64;
+static constexpr size_t MaximumLevelCount = 64;
+
+struct MLRA_SolutionSummary_
+{
+    MLRA_Solution const *solution;
+    size_t count;
+    size_t levelCount;
+    size_t levelOffsets[MaximumLevelCount + 1];
+    MLRA_SolutionSummaryColumn *buckets;
+};
+
+[[gnu::const]]
+static MLRA_SolutionSummaryColumn CreateEmptySummaryColumn(void)
+{
+    return (MLRA_SolutionSummaryColumn){
+        .minimumRegister = INT32_MAX,
+        .maximumRegister = INT32_MIN
+    };
+}
+
+[[gnu::nonnull(1)]]
+static void AddLocationToSummaryColumn(
+    MLRA_SolutionSummaryColumn *const column,
+    int32_t const location
+)
+{
+    ++column->instructionCount;
+    if (location == MLRA_SolutionLocation_Memory) {
+        ++column->spilledCount;
+        return;
+    }
+
+    column->minimumRegister = location < column->minimumRegister ? location : column->minimumRegister;
+    column->maximumRegister = location > column->maximumRegister ? location : column->maximumRegister;
+}
+
+[[gnu::nonnull(1, 2)]]
+static void MergeSummaryColumn(
+    MLRA_SolutionSummaryColumn *const column,
+    MLRA_SolutionSummaryColumn const *const other
+)
+{
+    column->instructionCount += other->instructionCount;
+    column->spilledCount += other->spilledCount;
+    column->minimumRegister = other->minimumRegister < column->minimumRegister
+        ? other->minimumRegister
+        : column->minimumRegister;
+    column->maximumRegister = other->maximumRegister > column->maximumRegister
+        ? other->maximumRegister
+        : column->maximumRegister;
+}
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroySolutionSummary(
+    MLRA_SolutionSummary *const summary
+)
+{
+    if (summary == nullptr) {
+        return;
+    }
+
+    free(summary->buckets);
+    free(summary);
+}
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroySolutionSummary, 1)]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_SolutionSummary *MLRA_CreateSolutionSummary(
+    MLRA_Solution const *const solution
+)
+{
+    size_t const count = MLRA_GetInstructionCountInSolution(solution);
+    if (count > UINT32_MAX) {
+        return nullptr;
+    }
+
+    MLRA_SolutionSummary *const summary = malloc(sizeof(MLRA_SolutionSummary));
+    if (summary == nullptr) {
+        return nullptr;
+    }
+
+    *summary = (MLRA_SolutionSummary){
+        .solution = solution,
+        .count = count
+    };
+
+    size_t bucketCount = (count + BaseBucketLength - 1) / BaseBucketLength;
+    size_t total = 0;
+    while (bucketCount != 0 && summary->levelCount < MaximumLevelCount) {
+        summary->levelOffsets[summary->levelCount++] = total;
+        total += bucketCount;
+        if (bucketCount == 1) {
+            break;
+        }
+        bucketCount = (bucketCount + 1) / 2;
+    }
+    summary->levelOffsets[summary->levelCount] = total;
+
+    if (total == 0) {
+        return summary;
+    }
+
+    summary->buckets = malloc(total * sizeof(MLRA_SolutionSummaryColumn));
+    if (summary->buckets == nullptr) {
+        free(summary);
+        return nullptr;
+    }
+
+    for (size_t bucket = 0; bucket < summary->levelOffsets[1]; ++bucket) {
+        MLRA_SolutionSummaryColumn column = CreateEmptySummaryColumn();
+        size_t const end = (bucket + 1) * BaseBucketLength < count ? (bucket + 1) * BaseBucketLength : count;
+        for (size_t index = bucket * BaseBucketLength; index < end; ++index) {
+            AddLocationToSummaryColumn(&column, MLRA_GetInstructionLocationInSolution(solution, index));
+        }
+        summary->buckets[bucket] = column;
+    }
+
+    for (size_t level = 1; level < summary->levelCount; ++level) {
+        MLRA_SolutionSummaryColumn const *const source = &summary->buckets[summary->levelOffsets[level - 1]];
+        size_t const sourceCount = summary->levelOffsets[level] - summary->levelOffsets[level - 1];
+        MLRA_SolutionSummaryColumn *const target = &summary->buckets[summary->levelOffsets[level]];
+        size_t const targetCount = summary->levelOffsets[level + 1] - summary->levelOffsets[level];
+
+        for (size_t bucket = 0; bucket < targetCount; ++bucket) {
+            target[bucket] = source[2 * bucket];
+            if (2 * bucket + 1 < sourceCount) {
+                MergeSummaryColumn(&target[bucket], &source[2 * bucket + 1]);
+            }
+        }
+    }
+
+    return summary;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetInstructionCountInSolutionSummary(
+    MLRA_SolutionSummary const *const summary
+)
+{
+    return summary->count;
+}
+
+[[gnu::nonnull(1, 4), gnu::access(read_only, 1), gnu::access(write_only, 4, 5)]]
+void MLRA_SummarizeSolutionColumns(
+    MLRA_SolutionSummary const *const summary,
+    double const firstInstruction,
+    double const instructionsPerColumn,
+    MLRA_SolutionSummaryColumn *const columns,
+    size_t const columnCount
+)
+{
+    double const count = (double)summary->count;
+
+    size_t level = 0;
+    while (
+        level < summary->levelCount
+        && (double)(BaseBucketLength << (level + 1)) <= instructionsPerColumn
+    ) {
+        ++level;
+    }
+
+    for (size_t index = 0; index < columnCount; ++index) {
+        MLRA_SolutionSummaryColumn column = CreateEmptySummaryColumn();
+        double begin = firstInstruction + (double)index * instructionsPerColumn;
+        double end = begin + instructionsPerColumn;
+        begin = begin < 0.0 ? 0.0 : begin > count ? count : begin;
+        end = end < 0.0 ? 0.0 : end > count ? count : end;
+
+        if (!(instructionsPerColumn > 0.0) || begin >= end) {
+            columns[index] = column;
+            continue;
+        }
+
+        if (level == 0) {
+            size_t const first = (size_t)floor(begin);
+            size_t last = (size_t)floor(end);
+            last = last > first ? last : first + 1;
+            last = last < summary->count ? last : summary->count;
+            for (size_t instruction = first; instruction < last; ++instruction) {
+                AddLocationToSummaryColumn(
+                    &column, MLRA_GetInstructionLocationInSolution(summary->solution, instruction)
+                );
+            }
+        }
+        else {
+            double const bucketLength = (double)(BaseBucketLength << (level - 1));
+            size_t const offset = summary->levelOffsets[level - 1];
+            size_t const bucketCount = summary->levelOffsets[level] - offset;
+            size_t first = (size_t)(begin / bucketLength + 0.5);
+            size_t last = end >= count ? bucketCount : (size_t)(end / bucketLength + 0.5);
+            first = first < bucketCount ? first : bucketCount;
+            last = last < bucketCount ? last : bucketCount;
+            for (size_t bucket = first; bucket < last; ++bucket) {
+                MergeSummaryColumn(&column, &summary->buckets[offset + bucket]);
+            }
+        }
+
+        columns[index] = column;
+    }
+}
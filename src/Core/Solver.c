@@ -0,0 +1,2711 @@
+#include "MLRA/Core/Solver.h"
+#include "MLRA/Core/Platform.h"
+#include "MLRA/Core/RegisterCost.h"
+#include "MLRA/Core/RegisterInstruction.h"
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/Solution.h"
+#include "MLRA/Core/SolverTrace.h"
+#include "MLRA/Core/VirtualRegisterMap.h"
+
+#include <assert.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static constexpr size_t StateDominatorCount = 8;
+static constexpr size_t SegmentsPerThread = 4;
+static constexpr size_t MinimumSegmentLength = 256;
+static constexpr size_t MaximumBoundaryStateCount = 128;
+static constexpr int64_t UnreachableCost = INT64_MAX;
+static constexpr size_t DefaultCheckpointInterval = 64;
+
+typedef struct
+{
+    int32_t *slots;
+    int64_t *costs;
+    uint64_t *table;
+    uint32_t generation;
+    size_t count;
+    size_t capacity;
+    size_t tableSize;
+    size_t width;
+} StateFrontier;
+
+typedef struct
+{
+    uint32_t parent;
+    int32_t location;
+} StateStep;
+
+typedef struct
+{
+    StateStep *steps;
+    size_t count;
+    size_t capacity;
+} StateHistory;
+
+/*
+ * Registers of a cost class are interchangeable, and no more of them hold values at once than any instruction needs.
+ * States therefore track at most slotLimit registers of every class, the first ones by index, as slots listed class by
+ * class; a class whose costs another class with at least slotLimit registers undercuts gets no slots at all. Swapping
+ * the values of two slots of a class changes neither the cost so far nor any future cost, so states are kept canonical
+ * by sorting the values within each class, and states that only differ by such swaps coincide.
+ */
+typedef struct
+{
+    MLRA_RegisterCost *slotCosts;
+    int32_t *slotRegisters;
+    uint32_t *previousSlots;
+    uint32_t *classStarts;
+    size_t classCount;
+    size_t slotCount;
+    bool symmetric;
+} StateLayout;
+
+typedef struct
+{
+    int32_t const *values;
+    bool const *isStore;
+    bool const *liveAfter;
+    StateLayout const *symmetry;
+    MLRA_RegisterCost const *slotCosts;
+    MLRA_RegisterCost memorySpillCost;
+    int64_t maximumSourceLoad;
+    size_t slotCount;
+} StateModel;
+
+typedef struct
+{
+    StateFrontier frontiers[2];
+    StateFrontier *current;
+    StateHistory history;
+    size_t *historyBases;
+    int32_t *scratch;
+    int32_t *canonical;
+    int32_t *dominatorSlots;
+    int64_t dominatorCosts[StateDominatorCount];
+} StateSearch;
+
+typedef struct
+{
+    int64_t *costs;
+    uint32_t *middles;
+    size_t rows;
+    size_t columns;
+    size_t left;
+    size_t right;
+    size_t segment;
+} TransferNode;
+
+typedef struct
+{
+    StateModel const *model;
+    StateLayout const *layout;
+    StateFrontier *boundaries;
+    size_t *cuts;
+    size_t segmentCount;
+    size_t *jobOffsets;
+    StateSearch *searches;
+    TransferNode *nodes;
+    size_t *levelNodes;
+    size_t *rowOffsets;
+    size_t *entryRows;
+    size_t *exitColumns;
+    MLRA_Solution *solution;
+    _Atomic bool failed;
+} SegmentSolve;
+
+typedef struct
+{
+    size_t begin;
+    size_t length;
+    size_t entryCount;
+    size_t entryState;
+    int32_t *entrySlots;
+    int64_t *entryCosts;
+    StateStep *steps;
+    size_t *stepBases;
+} CheckpointSegment;
+
+typedef enum
+{
+    ReferenceKind_None,
+    ReferenceKind_Load,
+    ReferenceKind_Store
+} ReferenceKind;
+
+struct MLRA_IncrementalSolver_
+{
+    MLRA_VirtualRegisterMap *map;
+    int32_t *values;
+    bool *isStore;
+    bool *liveAfter;
+    int32_t *locations;
+    uint8_t *nextReferenceKinds;
+    size_t count;
+    size_t capacity;
+    size_t valueCapacity;
+    CheckpointSegment *segments;
+    size_t segmentCount;
+    size_t segmentCapacity;
+    CheckpointSegment *pendingSegments;
+    size_t pendingCount;
+    size_t pendingCapacity;
+    uint32_t *permutation;
+    StateStep *permutedSteps;
+    size_t permutationCapacity;
+    StateLayout layout;
+    MLRA_RegisterCost memorySpillCost;
+    size_t slotLimit;
+    size_t checkpointInterval;
+    MLRA_SolverProgress progress;
+    void *progressContext;
+    StateSearch search;
+    bool searchReady;
+    bool solved;
+    size_t solvedEnd;
+    uint64_t scenarioIdentity;
+    uint64_t generation;
+    uint64_t costIdentity;
+    uint64_t registerCostGeneration;
+    uint64_t memorySpillCostGeneration;
+    int64_t cost;
+};
+
+[[gnu::pure]]
+static size_t HashState(
+    int32_t const *const slots,
+    size_t const width
+)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t index = 0; index < width; ++index) {
+        hash ^= (uint64_t)(uint32_t)slots[index];
+        hash *= 0x100000001B3ULL;
+    }
+
+    return (size_t)(hash ^ (hash >> 32));
+}
+
+static void DestroyStateFrontier(
+    StateFrontier *const frontier
+)
+{
+    free(frontier->slots);
+    free(frontier->costs);
+    free(frontier->table);
+}
+
+[[nodiscard]]
+static bool InitializeStateFrontier(
+    StateFrontier *const frontier,
+    size_t const width
+)
+{
+    frontier->width = width;
+    frontier->count = 0;
+    frontier->capacity = 64;
+    frontier->tableSize = 128;
+    frontier->slots = malloc(frontier->capacity * (width == 0 ? 1 : width) * sizeof(int32_t));
+    frontier->costs = malloc(frontier->capacity * sizeof(int64_t));
+    frontier->generation = 1;
+    frontier->table = calloc(frontier->tableSize, sizeof(uint64_t));
+
+    if (frontier->slots == nullptr || frontier->costs == nullptr || frontier->table == nullptr) {
+        DestroyStateFrontier(frontier);
+        return false;
+    }
+
+    return true;
+}
+
+static void ClearStateFrontier(
+    StateFrontier *const frontier
+)
+{
+    frontier->count = 0;
+    if (++frontier->generation == 0) {
+        memset(frontier->table, 0, frontier->tableSize * sizeof(uint64_t));
+        frontier->generation = 1;
+    }
+}
+
+static void IndexStateFrontier(
+    StateFrontier const *const frontier,
+    uint64_t *const table,
+    size_t const tableSize
+)
+{
+    uint64_t const stamp = (uint64_t)frontier->generation << 32;
+    size_t const mask = tableSize - 1;
+    for (size_t index = 0; index < frontier->count; ++index) {
+        size_t slot = HashState(frontier->slots + index * frontier->width, frontier->width) & mask;
+        while ((table[slot] >> 32) == frontier->generation) {
+            slot = (slot + 1) & mask;
+        }
+        table[slot] = stamp | index;
+    }
+}
+
+/*
+ * Pruning compacts the frontier without updating its hash table; this makes FindFrontierState usable again.
+ */
+static void ReindexStateFrontier(
+    StateFrontier *const frontier
+)
+{
+    size_t const count = frontier->count;
+    ClearStateFrontier(frontier);
+    frontier->count = count;
+    IndexStateFrontier(frontier, frontier->table, frontier->tableSize);
+}
+
+[[nodiscard]]
+static bool GrowStateFrontier(
+    StateFrontier *const frontier
+)
+{
+    size_t const newCapacity = frontier->capacity * 2;
+    size_t const newTableSize = frontier->tableSize * 2;
+    size_t slotsSize;
+    if (
+        newCapacity > UINT32_MAX
+        || __builtin_mul_overflow(newCapacity, (frontier->width == 0 ? 1 : frontier->width) * sizeof(int32_t), &slotsSize)
+    ) {
+        return false;
+    }
+
+    int32_t *slots = realloc(frontier->slots, slotsSize);
+    if (slots == nullptr) {
+        return false;
+    }
+    frontier->slots = slots;
+
+    int64_t *costs = realloc(frontier->costs, newCapacity * sizeof(int64_t));
+    if (costs == nullptr) {
+        return false;
+    }
+    frontier->costs = costs;
+
+    uint64_t *table = calloc(newTableSize, sizeof(uint64_t));
+    if (table == nullptr) {
+        return false;
+    }
+
+    IndexStateFrontier(frontier, table, newTableSize);
+
+    free(frontier->table);
+    frontier->table = table;
+    frontier->tableSize = newTableSize;
+    frontier->capacity = newCapacity;
+
+    return true;
+}
+
+[[nodiscard]]
+static bool AppendStateStep(
+    StateHistory *const history,
+    StateStep const step
+)
+{
+    if (history->count == history->capacity) {
+        size_t const newCapacity = history->capacity == 0 ? 1024 : history->capacity * 2;
+        size_t totalSize;
+        if (__builtin_mul_overflow(newCapacity, sizeof(StateStep), &totalSize)) {
+            return false;
+        }
+
+        StateStep *steps = realloc(history->steps, totalSize);
+        if (steps == nullptr) {
+            return false;
+        }
+
+        history->steps = steps;
+        history->capacity = newCapacity;
+    }
+
+    history->steps[history->count++] = step;
+
+    return true;
+}
+
+[[nodiscard]]
+static bool RelaxState(
+    StateFrontier *const frontier,
+    StateHistory *const history,
+    size_t const historyBase,
+    int32_t const *const slots,
+    int64_t const cost,
+    size_t const parent,
+    int32_t const location
+)
+{
+    size_t const width = frontier->width;
+    size_t const hash = HashState(slots, width);
+    size_t mask = frontier->tableSize - 1;
+    size_t slot = hash & mask;
+
+    while ((frontier->table[slot] >> 32) == frontier->generation) {
+        size_t const index = (size_t)(frontier->table[slot] & UINT32_MAX);
+        if (memcmp(frontier->slots + index * width, slots, width * sizeof(int32_t)) == 0) {
+            if (cost < frontier->costs[index]) {
+                frontier->costs[index] = cost;
+                history->steps[historyBase + index] = (StateStep){(uint32_t)parent, location};
+            }
+            return true;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    if (frontier->count * 2 >= frontier->tableSize || frontier->count == frontier->capacity) {
+        if (!GrowStateFrontier(frontier)) {
+            return false;
+        }
+
+        mask = frontier->tableSize - 1;
+        slot = hash & mask;
+        while ((frontier->table[slot] >> 32) == frontier->generation) {
+            slot = (slot + 1) & mask;
+        }
+    }
+
+    size_t const index = frontier->count++;
+    if (width != 0) {
+        memcpy(frontier->slots + index * width, slots, width * sizeof(int32_t));
+    }
+    frontier->costs[index] = cost;
+    frontier->table[slot] = ((uint64_t)frontier->generation << 32) | index;
+
+    return AppendStateStep(history, (StateStep){(uint32_t)parent, location});
+}
+
+/*
+ * Sorts the values within every class, moving the registers that the slots stand for along when given.
+ */
+static void CanonicalizeStateSlots(
+    StateLayout const *const layout,
+    int32_t *const slots,
+    int32_t *const registers
+)
+{
+    for (size_t costClass = 0; costClass < layout->classCount; ++costClass) {
+        size_t const begin = layout->classStarts[costClass];
+        size_t const end = layout->classStarts[costClass + 1];
+
+        for (size_t slot = begin + 1; slot < end; ++slot) {
+            int32_t const value = slots[slot];
+            int32_t const reg = registers == nullptr ? 0 : registers[slot];
+
+            size_t position = slot;
+            while (position > begin && slots[position - 1] > value) {
+                slots[position] = slots[position - 1];
+                if (registers != nullptr) {
+                    registers[position] = registers[position - 1];
+                }
+                --position;
+            }
+
+            slots[position] = value;
+            if (registers != nullptr) {
+                registers[position] = reg;
+            }
+        }
+    }
+}
+
+[[nodiscard]]
+static int32_t const *CanonicalizeExpandedState(
+    StateLayout const *const symmetry,
+    int32_t *const canonical,
+    int32_t const *const slots,
+    size_t const width
+)
+{
+    if (symmetry == nullptr) {
+        return slots;
+    }
+
+    memcpy(canonical, slots, width * sizeof(int32_t));
+    CanonicalizeStateSlots(symmetry, canonical, nullptr);
+
+    return canonical;
+}
+
+[[nodiscard]]
+static bool ExpandState(
+    StateFrontier *const next,
+    StateHistory *const history,
+    size_t const historyBase,
+    int32_t *const scratch,
+    int32_t *const canonical,
+    StateLayout const *const symmetry,
+    int32_t const *const slots,
+    int64_t const cost,
+    size_t const parent,
+    MLRA_RegisterCost const *const slotCosts,
+    MLRA_RegisterCost const memorySpillCost,
+    int32_t const value,
+    bool const isStore,
+    bool const liveAfter
+)
+{
+    size_t const width = next->width;
+    size_t current = SIZE_MAX;
+    for (size_t slot = 0; slot < width; ++slot) {
+        if (slots[slot] == value) {
+            current = slot;
+            break;
+        }
+    }
+
+    int64_t const sourceLoad = current == SIZE_MAX ? memorySpillCost.load : slotCosts[current].load;
+
+    if (width != 0) {
+        memcpy(scratch, slots, width * sizeof(int32_t));
+    }
+    if (current != SIZE_MAX) {
+        scratch[current] = -1;
+    }
+
+    int64_t memoryCost;
+    if (isStore) {
+        memoryCost = memorySpillCost.store;
+    }
+    else if (current == SIZE_MAX) {
+        memoryCost = memorySpillCost.load;
+    }
+    else {
+        memoryCost = sourceLoad + memorySpillCost.store + memorySpillCost.load;
+    }
+
+    if (
+        !RelaxState(
+            next,
+            history,
+            historyBase,
+            CanonicalizeExpandedState(symmetry, canonical, scratch, width),
+            cost + memoryCost,
+            parent,
+            MLRA_SolutionLocation_Memory
+        )
+    ) {
+        return false;
+    }
+
+    for (size_t slot = 0; slot < width; ++slot) {
+        int32_t const occupant = scratch[slot];
+        int64_t stepCost;
+
+        /* Any empty slot of a class stands for all of them, and the one holding the value is tried anyway. */
+        if (symmetry != nullptr && occupant == -1 && slot != current) {
+            uint32_t const previous = symmetry->previousSlots[slot];
+            if (previous != UINT32_MAX && scratch[previous] == -1) {
+                continue;
+            }
+        }
+
+        if (isStore) {
+            stepCost = slotCosts[slot].store;
+        }
+        else if (slot == current) {
+            stepCost = slotCosts[slot].load;
+        }
+        else {
+            stepCost = sourceLoad + slotCosts[slot].store + slotCosts[slot].load;
+        }
+
+        if (occupant != -1) {
+            stepCost += slotCosts[slot].load + memorySpillCost.store;
+        }
+
+        scratch[slot] = liveAfter ? value : -1;
+        bool const relaxed = RelaxState(
+            next,
+            history,
+            historyBase,
+            CanonicalizeExpandedState(symmetry, canonical, scratch, width),
+            cost + stepCost,
+            parent,
+            (int32_t)slot
+        );
+        scratch[slot] = occupant;
+
+        if (!relaxed) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+[[gnu::pure]]
+static int64_t BoundStateByDominator(
+    int32_t const *const slots,
+    int32_t const *const dominatorSlots,
+    int64_t const dominatorCost,
+    int64_t const limit,
+    size_t const width,
+    MLRA_RegisterCost const *const slotCosts,
+    MLRA_RegisterCost const memorySpillCost,
+    int64_t const maximumSourceLoad
+)
+{
+    int64_t bound = dominatorCost;
+    for (size_t slot = 0; slot < width && bound <= limit; ++slot) {
+        if (slots[slot] == dominatorSlots[slot]) {
+            continue;
+        }
+        if (dominatorSlots[slot] != -1) {
+            bound += slotCosts[slot].load + memorySpillCost.store;
+        }
+        if (slots[slot] != -1) {
+            bound += maximumSourceLoad + slotCosts[slot].store;
+        }
+    }
+
+    return bound;
+}
+
+static void PruneStateFrontier(
+    StateFrontier *const frontier,
+    StateHistory *const history,
+    size_t const historyBase,
+    int32_t *const dominatorSlots,
+    int64_t *const dominatorCosts,
+    MLRA_RegisterCost const *const slotCosts,
+    MLRA_RegisterCost const memorySpillCost,
+    int64_t const maximumSourceLoad
+)
+{
+    size_t const width = frontier->width;
+    size_t best = 0;
+    for (size_t state = 1; state < frontier->count; ++state) {
+        if (frontier->costs[state] < frontier->costs[best]) {
+            best = state;
+        }
+    }
+
+    if (width != 0) {
+        memcpy(dominatorSlots, frontier->slots + best * width, width * sizeof(int32_t));
+    }
+    dominatorCosts[0] = frontier->costs[best];
+    size_t dominatorCount = 1;
+    size_t kept = 0;
+
+    for (size_t state = 0; state < frontier->count; ++state) {
+        int32_t const *const slots = frontier->slots + state * width;
+        int64_t const cost = frontier->costs[state];
+
+        bool dominated = false;
+        for (size_t dominator = 0; state != best && !dominated && dominator < dominatorCount; ++dominator) {
+            int64_t const bound = BoundStateByDominator(
+                slots,
+                dominatorSlots + dominator * width,
+                dominatorCosts[dominator],
+                cost,
+                width,
+                slotCosts,
+                memorySpillCost,
+                maximumSourceLoad
+            );
+            dominated = bound <= cost;
+        }
+
+        if (dominated) {
+            continue;
+        }
+
+        if (state != best && dominatorCount < StateDominatorCount) {
+            if (width != 0) {
+                memcpy(dominatorSlots + dominatorCount * width, slots, width * sizeof(int32_t));
+            }
+            dominatorCosts[dominatorCount++] = cost;
+        }
+
+        if (kept != state) {
+            if (width != 0) {
+                memmove(frontier->slots + kept * width, slots, width * sizeof(int32_t));
+            }
+            frontier->costs[kept] = cost;
+            history->steps[historyBase + kept] = history->steps[historyBase + state];
+        }
+        ++kept;
+    }
+
+    frontier->count = kept;
+    history->count = historyBase + kept;
+}
+
+[[nodiscard]]
+[[gnu::pure]]
+static size_t FindFrontierState(
+    StateFrontier const *const frontier,
+    int32_t const *const slots
+)
+{
+    size_t const width = frontier->width;
+    size_t const mask = frontier->tableSize - 1;
+
+    for (size_t slot = HashState(slots, width) & mask; (frontier->table[slot] >> 32) == frontier->generation;) {
+        size_t const index = (size_t)(frontier->table[slot] & UINT32_MAX);
+        if (memcmp(frontier->slots + index * width, slots, width * sizeof(int32_t)) == 0) {
+            return index;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return SIZE_MAX;
+}
+
+static void DestroyStateSearch(
+    StateSearch *const search
+)
+{
+    free(search->historyBases);
+    free(search->history.steps);
+    DestroyStateFrontier(&search->frontiers[1]);
+    DestroyStateFrontier(&search->frontiers[0]);
+    free(search->dominatorSlots);
+    free(search->canonical);
+    free(search->scratch);
+}
+
+[[nodiscard]]
+static bool InitializeStateSearch(
+    StateSearch *const search,
+    size_t const slotCount,
+    size_t const historyLength
+)
+{
+    size_t const width = slotCount == 0 ? 1 : slotCount;
+
+    *search = (StateSearch){};
+    search->scratch = malloc(width * sizeof(int32_t));
+    search->canonical = malloc(width * sizeof(int32_t));
+    search->dominatorSlots = malloc(width * StateDominatorCount * sizeof(int32_t));
+    search->historyBases = historyLength == 0 ? nullptr : malloc(historyLength * sizeof(size_t));
+
+    if (!InitializeStateFrontier(&search->frontiers[0], slotCount)) {
+        search->frontiers[0] = (StateFrontier){};
+    }
+    if (search->frontiers[0].table == nullptr || !InitializeStateFrontier(&search->frontiers[1], slotCount)) {
+        search->frontiers[1] = (StateFrontier){};
+    }
+
+    if (
+        search->frontiers[1].table == nullptr || search->scratch == nullptr || search->canonical == nullptr
+        || search->dominatorSlots == nullptr
+        || (historyLength != 0 && search->historyBases == nullptr)
+    ) {
+        DestroyStateSearch(search);
+        return false;
+    }
+
+    return true;
+}
+
+[[nodiscard]]
+static bool SeedStateSearch(
+    StateSearch *const search,
+    int32_t const *const entrySlots,
+    int64_t const *const entryCosts,
+    size_t const entryCount
+)
+{
+    StateFrontier *const current = &search->frontiers[0];
+    size_t const width = current->width;
+
+    ClearStateFrontier(current);
+    search->current = current;
+    search->history.count = 0;
+
+    bool succeeded = true;
+    for (size_t state = 0; succeeded && state < entryCount; ++state) {
+        succeeded = RelaxState(
+            current,
+            &search->history,
+            0,
+            entrySlots + state * width,
+            entryCosts[state],
+            0,
+            MLRA_SolutionLocation_Memory
+        );
+    }
+    search->history.count = 0;
+
+    return succeeded;
+}
+
+[[nodiscard]]
+static bool AdvanceStateSearch(
+    StateSearch *const search,
+    StateModel const *const model,
+    size_t const historyOrigin,
+    size_t const begin,
+    size_t const end
+)
+{
+    bool const keepHistory = search->historyBases != nullptr;
+    StateFrontier *current = search->current;
+    StateFrontier *next = current == &search->frontiers[0] ? &search->frontiers[1] : &search->frontiers[0];
+    bool succeeded = true;
+
+    for (size_t index = begin; succeeded && index < end; ++index) {
+        ClearStateFrontier(next);
+        if (!keepHistory) {
+            search->history.count = 0;
+        }
+        size_t const historyBase = search->history.count;
+        if (keepHistory) {
+            search->historyBases[index - historyOrigin] = historyBase;
+        }
+
+        for (size_t state = 0; succeeded && state < current->count; ++state) {
+            succeeded = ExpandState(
+                next,
+                &search->history,
+                historyBase,
+                search->scratch,
+                search->canonical,
+                model->symmetry,
+                current->slots + state * model->slotCount,
+                current->costs[state],
+                state,
+                model->slotCosts,
+                model->memorySpillCost,
+                model->values[index],
+                model->isStore[index],
+                model->liveAfter[index]
+            );
+        }
+
+        if (succeeded) {
+            PruneStateFrontier(
+                next,
+                &search->history,
+                historyBase,
+                search->dominatorSlots,
+                search->dominatorCosts,
+                model->slotCosts,
+                model->memorySpillCost,
+                model->maximumSourceLoad
+            );
+        }
+
+        StateFrontier *swap = current;
+        current = next;
+        next = swap;
+    }
+
+    search->current = current;
+
+    return succeeded;
+}
+
+[[nodiscard]]
+static bool RunStateSearch(
+    StateSearch *const search,
+    StateModel const *const model,
+    int32_t const *const entrySlots,
+    size_t const begin,
+    size_t const end
+)
+{
+    int64_t const entryCost = 0;
+
+    return SeedStateSearch(search, entrySlots, &entryCost, 1) && AdvanceStateSearch(search, model, begin, begin, end);
+}
+
+[[gnu::pure]]
+static size_t FindCheapestState(
+    StateFrontier const *const frontier
+)
+{
+    size_t best = 0;
+    for (size_t state = 1; state < frontier->count; ++state) {
+        if (frontier->costs[state] < frontier->costs[best]) {
+            best = state;
+        }
+    }
+
+    return best;
+}
+
+static void TraceStateSearch(
+    StateSearch const *const search,
+    MLRA_Solution *const solution,
+    size_t const begin,
+    size_t const end,
+    size_t state
+)
+{
+    for (size_t index = end; index-- > begin;) {
+        StateStep const step = search->history.steps[search->historyBases[index - begin] + state];
+        MLRA_SetInstructionLocationInSolution(solution, index, step.location);
+        state = step.parent;
+    }
+}
+
+/*
+ * Returns the most values registers hold at once during any instruction: the values live across it and the one it
+ * references, which may pass through a register even when it is not loaded again. No class ever needs more registers.
+ * The live flags of every value must start out cleared.
+ */
+static size_t CountMaximumHeldValues(
+    int32_t const *const values,
+    bool const *const liveAfter,
+    size_t const instructionCount,
+    uint8_t *const live
+)
+{
+    size_t liveCount = 0;
+    size_t maximum = 0;
+    for (size_t index = 0; index < instructionCount; ++index) {
+        int32_t const value = values[index];
+        liveCount -= live[value];
+        if (liveCount + 1 > maximum) {
+            maximum = liveCount + 1;
+        }
+        live[value] = liveAfter[index];
+        liveCount += liveAfter[index];
+    }
+
+    return maximum;
+}
+
+[[gnu::pure]]
+static int CompareRegisterCosts(
+    void const *const left,
+    void const *const right
+)
+{
+    MLRA_RegisterCost const *const a = left;
+    MLRA_RegisterCost const *const b = right;
+
+    if (a->load != b->load) {
+        return a->load < b->load ? -1 : 1;
+    }
+    return a->store < b->store ? -1 : (a->store > b->store ? 1 : 0);
+}
+
+/*
+ * Keeps the classes with at least slotLimit registers whose costs no other such class undercuts in both load and
+ * store, ordered by rising load and therefore falling store cost. Returns how many there are.
+ */
+static size_t FindUndercuttingClasses(
+    MLRA_Scenario const *const scenario,
+    size_t const slotLimit,
+    MLRA_RegisterCost *const front
+)
+{
+    size_t const costClassCount = MLRA_GetRegisterCostClassCountInScenario(scenario);
+    size_t count = 0;
+    for (size_t costClass = 0; costClass < costClassCount; ++costClass) {
+        size_t const memberCount = MLRA_GetRegisterCountInCostClassOfScenario(scenario, costClass);
+        if (memberCount != 0 && memberCount >= slotLimit) {
+            front[count++] = MLRA_GetRegisterCostOfCostClassInScenario(scenario, costClass);
+        }
+    }
+
+    qsort(front, count, sizeof(MLRA_RegisterCost), CompareRegisterCosts);
+
+    size_t kept = 0;
+    for (size_t candidate = 0; candidate < count; ++candidate) {
+        if (kept == 0 || front[candidate].store < front[kept - 1].store) {
+            front[kept++] = front[candidate];
+        }
+    }
+
+    return kept;
+}
+
+/*
+ * A class is left out when a class from the front has at most its load and store costs: that class alone has room for
+ * every value held at once, so moving all values of both classes into it never costs more.
+ */
+[[gnu::pure]]
+static bool IsRegisterCostUndercut(
+    MLRA_RegisterCost const *const front,
+    size_t const frontCount,
+    MLRA_RegisterCost const cost
+)
+{
+    size_t lower = 0;
+    size_t upper = frontCount;
+    while (lower < upper) {
+        size_t const middle = lower + (upper - lower) / 2;
+        if (front[middle].load <= cost.load) {
+            lower = middle + 1;
+        }
+        else {
+            upper = middle;
+        }
+    }
+
+    if (lower == 0) {
+        return false;
+    }
+
+    MLRA_RegisterCost const best = front[lower - 1];
+    return best.store <= cost.store && (best.load != cost.load || best.store != cost.store);
+}
+
+static void DestroyStateLayout(
+    StateLayout *const layout
+)
+{
+    free(layout->classStarts);
+    free(layout->previousSlots);
+    free(layout->slotRegisters);
+    free(layout->slotCosts);
+    *layout = (StateLayout){};
+}
+
+/*
+ * Lays out the slots from the run table of the register costs, taking one step per run and class rather than per
+ * register, so the layout stays small however many registers there are.
+ */
+[[nodiscard]]
+static bool InitializeStateLayout(
+    StateLayout *const layout,
+    MLRA_Scenario const *const scenario,
+    size_t const slotLimit
+)
+{
+    size_t const registerCount = MLRA_GetRegisterCountInScenario(scenario);
+    size_t const costClassCount = MLRA_GetRegisterCostClassCountInScenario(scenario);
+    size_t const classAllocation = costClassCount == 0 ? 1 : costClassCount;
+
+    *layout = (StateLayout){};
+    size_t *const cursors = malloc(classAllocation * sizeof(size_t));
+    size_t *const ends = malloc(classAllocation * sizeof(size_t));
+    MLRA_RegisterCost *const front = malloc(classAllocation * sizeof(MLRA_RegisterCost));
+    if (cursors == nullptr || ends == nullptr || front == nullptr) {
+        free(front);
+        free(ends);
+        free(cursors);
+        return false;
+    }
+
+    size_t const frontCount = FindUndercuttingClasses(scenario, slotLimit, front);
+    size_t slotCount = 0;
+    size_t classCount = 0;
+    for (size_t costClass = 0; costClass < costClassCount; ++costClass) {
+        size_t const classRegisterCount = MLRA_GetRegisterCountInCostClassOfScenario(scenario, costClass);
+        MLRA_RegisterCost const cost = MLRA_GetRegisterCostOfCostClassInScenario(scenario, costClass);
+        size_t slots = classRegisterCount < slotLimit ? classRegisterCount : slotLimit;
+        if (IsRegisterCostUndercut(front, frontCount, cost)) {
+            slots = 0;
+        }
+
+        cursors[costClass] = slotCount;
+        ends[costClass] = slotCount + slots;
+        slotCount += slots;
+        classCount += slots != 0;
+    }
+
+    size_t const width = slotCount == 0 ? 1 : slotCount;
+    layout->slotCosts = malloc(width * sizeof(MLRA_RegisterCost));
+    layout->slotRegisters = malloc(width * sizeof(int32_t));
+    layout->previousSlots = malloc(width * sizeof(uint32_t));
+    layout->classStarts = malloc((classCount + 1) * sizeof(uint32_t));
+    bool const succeeded = layout->slotCosts != nullptr && layout->slotRegisters != nullptr
+        && layout->previousSlots != nullptr && layout->classStarts != nullptr;
+
+    for (size_t costClass = 0; succeeded && costClass < costClassCount; ++costClass) {
+        size_t const begin = cursors[costClass];
+        size_t const end = ends[costClass];
+        if (begin == end) {
+            continue;
+        }
+
+        MLRA_RegisterCost const cost = MLRA_GetRegisterCostOfCostClassInScenario(scenario, costClass);
+        layout->classStarts[layout->classCount++] = (uint32_t)begin;
+        layout->symmetric |= end - begin > 1;
+        for (size_t slot = begin; slot < end; ++slot) {
+            layout->slotCosts[slot] = cost;
+            layout->previousSlots[slot] = slot == begin ? UINT32_MAX : (uint32_t)(slot - 1);
+        }
+    }
+
+    size_t remaining = slotCount;
+    for (size_t reg = 0, length = 0; succeeded && remaining != 0 && reg < registerCount; reg += length) {
+        size_t const costClass = MLRA_GetRegisterCostClassSpanInScenario(scenario, reg, &length);
+        for (size_t offset = 0; offset < length && cursors[costClass] < ends[costClass]; ++offset) {
+            layout->slotRegisters[cursors[costClass]++] = (int32_t)(reg + offset);
+            --remaining;
+        }
+    }
+
+    free(front);
+    free(ends);
+    free(cursors);
+
+    if (!succeeded) {
+        DestroyStateLayout(layout);
+        return false;
+    }
+
+    layout->classStarts[layout->classCount] = (uint32_t)slotCount;
+    layout->slotCount = slotCount;
+
+    return true;
+}
+
+static void InitializeStateModel(
+    StateModel *const model,
+    StateLayout const *const layout,
+    MLRA_RegisterCost const memorySpillCost,
+    int32_t const *const values,
+    bool const *const isStore,
+    bool const *const liveAfter
+)
+{
+    int64_t maximumSourceLoad = memorySpillCost.load;
+    for (size_t slot = 0; slot < layout->slotCount; ++slot) {
+        if (layout->slotCosts[slot].load > maximumSourceLoad) {
+            maximumSourceLoad = layout->slotCosts[slot].load;
+        }
+    }
+
+    *model = (StateModel){
+        .values = values,
+        .isStore = isStore,
+        .liveAfter = liveAfter,
+        .symmetry = layout->symmetric ? layout : nullptr,
+        .slotCosts = layout->slotCosts,
+        .memorySpillCost = memorySpillCost,
+        .maximumSourceLoad = maximumSourceLoad,
+        .slotCount = layout->slotCount
+    };
+}
+
+/*
+ * The search records slots as locations, and canonical states permute the slots of a class. Replaying the solution
+ * from the start recovers which register every slot stands for at each instruction.
+ */
+[[nodiscard]]
+static bool UnfoldStateSlots(
+    StateLayout const *const layout,
+    int32_t const *const values,
+    bool const *const liveAfter,
+    MLRA_Solution *const solution,
+    size_t const instructionCount
+)
+{
+    if (!layout->symmetric) {
+        for (size_t index = 0; index < instructionCount; ++index) {
+            int32_t const location = MLRA_GetInstructionLocationInSolution(solution, index);
+            if (location != MLRA_SolutionLocation_Memory) {
+                MLRA_SetInstructionLocationInSolution(solution, index, layout->slotRegisters[location]);
+            }
+        }
+        return true;
+    }
+
+    size_t const width = layout->slotCount == 0 ? 1 : layout->slotCount;
+    int32_t *const slots = malloc(width * sizeof(int32_t));
+    int32_t *const registers = malloc(width * sizeof(int32_t));
+
+    if (slots == nullptr || registers == nullptr) {
+        free(registers);
+        free(slots);
+        return false;
+    }
+
+    for (size_t slot = 0; slot < layout->slotCount; ++slot) {
+        slots[slot] = -1;
+        registers[slot] = layout->slotRegisters[slot];
+    }
+
+    for (size_t index = 0; index < instructionCount; ++index) {
+        int32_t const value = values[index];
+        for (size_t slot = 0; slot < layout->slotCount; ++slot) {
+            if (slots[slot] == value) {
+                slots[slot] = -1;
+                break;
+            }
+        }
+
+        int32_t const location = MLRA_GetInstructionLocationInSolution(solution, index);
+        if (location != MLRA_SolutionLocation_Memory) {
+            slots[location] = liveAfter[index] ? value : -1;
+            MLRA_SetInstructionLocationInSolution(solution, index, registers[location]);
+        }
+
+        CanonicalizeStateSlots(layout, slots, registers);
+    }
+
+    free(registers);
+    free(slots);
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_Solution *MLRA_SolveScenarioExactly(
+    MLRA_Scenario const *const scenario
+)
+{
+    if (MLRA_GetRegisterCountInScenario(scenario) > INT32_MAX) {
+        return nullptr;
+    }
+
+    MLRA_SolverTrace *trace = MLRA_CreateSolverTrace(scenario);
+    if (trace == nullptr) {
+        return nullptr;
+    }
+
+    size_t const instructionCount = MLRA_GetInstructionCountInSolverTrace(trace);
+    size_t const valueCount = MLRA_GetValueCountInSolverTrace(trace);
+    uint8_t *live = calloc(valueCount == 0 ? 1 : valueCount, sizeof(uint8_t));
+    MLRA_Solution *solution = MLRA_CreateSolution(instructionCount);
+    StateLayout layout;
+    StateModel model;
+    StateSearch search;
+
+    bool const layoutReady = live != nullptr
+        && InitializeStateLayout(
+            &layout,
+            scenario,
+            CountMaximumHeldValues(
+                MLRA_GetValuesInSolverTrace(trace),
+                MLRA_GetLiveAfterFlagsInSolverTrace(trace),
+                instructionCount,
+                live
+            )
+        );
+    bool const searchReady = layoutReady && InitializeStateSearch(&search, layout.slotCount, instructionCount + 1);
+    bool succeeded = solution != nullptr && searchReady;
+
+    if (succeeded) {
+        InitializeStateModel(
+            &model,
+            &layout,
+            MLRA_GetMemorySpillCostInScenario(scenario),
+            MLRA_GetValuesInSolverTrace(trace),
+            MLRA_GetStoreFlagsInSolverTrace(trace),
+            MLRA_GetLiveAfterFlagsInSolverTrace(trace)
+        );
+        for (size_t slot = 0; slot < layout.slotCount; ++slot) {
+            search.scratch[slot] = -1;
+        }
+        succeeded = RunStateSearch(&search, &model, search.scratch, 0, instructionCount);
+    }
+
+    if (succeeded) {
+        size_t const best = FindCheapestState(search.current);
+        MLRA_SetSolutionCost(solution, search.current->costs[best]);
+        TraceStateSearch(&search, solution, 0, instructionCount, best);
+        succeeded = UnfoldStateSlots(&layout, model.values, model.liveAfter, solution, instructionCount);
+    }
+
+    if (searchReady) {
+        DestroyStateSearch(&search);
+    }
+    if (layoutReady) {
+        DestroyStateLayout(&layout);
+    }
+    free(live);
+    MLRA_DestroySolverTrace(trace);
+
+    if (!succeeded) {
+        MLRA_DestroySolution(solution);
+        return nullptr;
+    }
+
+    return solution;
+}
+
+/*
+ * Counts the canonical states of liveCount values, each of which stays in memory or takes a slot of a class with room
+ * left, the order within a class not mattering. Stops at SIZE_MAX. Ways needs room for liveCount + 1 counts.
+ */
+static size_t CountBoundaryStates(
+    StateLayout const *const layout,
+    size_t const liveCount,
+    size_t *const ways
+)
+{
+    /* Ways counts the choices of which values, and how, the classes so far took, by the number of values taken. */
+    ways[0] = 1;
+    for (size_t taken = 1; taken <= liveCount; ++taken) {
+        ways[taken] = 0;
+    }
+
+    for (size_t costClass = 0; costClass < layout->classCount; ++costClass) {
+        size_t const slots = layout->classStarts[costClass + 1] - layout->classStarts[costClass];
+        for (size_t taken = liveCount + 1; taken-- > 0;) {
+            size_t term = ways[taken];
+            for (size_t added = 1; term != 0 && added <= slots && taken + added <= liveCount; ++added) {
+                if (
+                    __builtin_mul_overflow(term, liveCount - taken - added + 1, &term)
+                    || __builtin_add_overflow(ways[taken + added], term / added, &ways[taken + added])
+                ) {
+                    return SIZE_MAX;
+                }
+                term /= added;
+            }
+        }
+    }
+
+    size_t count = 0;
+    for (size_t taken = 0; taken <= liveCount; ++taken) {
+        if (__builtin_add_overflow(count, ways[taken], &count)) {
+            return SIZE_MAX;
+        }
+    }
+
+    return count;
+}
+
+/*
+ * Every live value in turn stays in memory or takes the first empty slot of a class, so each canonical state comes up
+ * once, just not yet sorted.
+ */
+[[nodiscard]]
+static bool EnumerateBoundaryStates(
+    StateFrontier *const boundary,
+    StateHistory *const history,
+    StateLayout const *const layout,
+    int32_t *const slots,
+    int32_t *const canonical,
+    int32_t const *const liveValues,
+    size_t const liveCount
+)
+{
+    if (liveCount == 0) {
+        history->count = boundary->count;
+        return RelaxState(
+            boundary,
+            history,
+            0,
+            CanonicalizeExpandedState(layout->symmetric ? layout : nullptr, canonical, slots, boundary->width),
+            0,
+            0,
+            MLRA_SolutionLocation_Memory
+        );
+    }
+
+    if (!EnumerateBoundaryStates(boundary, history, layout, slots, canonical, liveValues + 1, liveCount - 1)) {
+        return false;
+    }
+
+    for (size_t costClass = 0; costClass < layout->classCount; ++costClass) {
+        size_t slot = layout->classStarts[costClass];
+        while (slot < layout->classStarts[costClass + 1] && slots[slot] != -1) {
+            ++slot;
+        }
+        if (slot == layout->classStarts[costClass + 1]) {
+            continue;
+        }
+
+        slots[slot] = liveValues[0];
+        bool const enumerated = EnumerateBoundaryStates(
+            boundary, history, layout, slots, canonical, liveValues + 1, liveCount - 1
+        );
+        slots[slot] = -1;
+        if (!enumerated) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+[[nodiscard]]
+static size_t ChooseSegmentCuts(
+    StateModel const *const model,
+    StateLayout const *const layout,
+    uint32_t const *const nextReferences,
+    size_t const instructionCount,
+    size_t const segmentCount,
+    size_t *const cuts
+)
+{
+    size_t const boundaryCount = instructionCount + 1;
+    uint32_t *liveCounts = calloc(boundaryCount + 1, sizeof(uint32_t));
+    if (liveCounts == nullptr) {
+        return 0;
+    }
+
+    for (size_t index = 0; index < instructionCount; ++index) {
+        if (model->liveAfter[index]) {
+            ++liveCounts[index + 1];
+            --liveCounts[(size_t)nextReferences[index] + 1];
+        }
+    }
+    size_t maximumLiveCount = 0;
+    for (size_t boundary = 1; boundary <= boundaryCount; ++boundary) {
+        liveCounts[boundary] += liveCounts[boundary - 1];
+        if (liveCounts[boundary] > maximumLiveCount) {
+            maximumLiveCount = liveCounts[boundary];
+        }
+    }
+
+    /* The state count only depends on the live count and grows with it, so it is worked out once per live count. */
+    size_t *boundaryStates = malloc((maximumLiveCount + 1) * sizeof(size_t));
+    size_t *ways = malloc((maximumLiveCount + 1) * sizeof(size_t));
+    if (boundaryStates == nullptr || ways == nullptr) {
+        free(ways);
+        free(boundaryStates);
+        free(liveCounts);
+        return 0;
+    }
+
+    for (size_t liveCount = 0; liveCount <= maximumLiveCount; ++liveCount) {
+        boundaryStates[liveCount] = liveCount != 0 && boundaryStates[liveCount - 1] > MaximumBoundaryStateCount
+            ? SIZE_MAX
+            : CountBoundaryStates(layout, liveCount, ways);
+    }
+
+    size_t const window = instructionCount / (segmentCount * 4);
+    size_t cutCount = 0;
+    cuts[cutCount++] = 0;
+
+    for (size_t segment = 1; segment < segmentCount; ++segment) {
+        size_t const ideal = instructionCount / segmentCount * segment;
+        size_t const low = ideal - window > cuts[cutCount - 1] + MinimumSegmentLength
+            ? ideal - window
+            : cuts[cutCount - 1] + MinimumSegmentLength;
+        size_t const high = ideal + window < instructionCount - MinimumSegmentLength
+            ? ideal + window
+            : instructionCount - MinimumSegmentLength;
+
+        size_t best = SIZE_MAX;
+        size_t bestStates = SIZE_MAX;
+        for (size_t boundary = low; boundary <= high && boundary < instructionCount; ++boundary) {
+            size_t const states = boundaryStates[liveCounts[boundary]];
+            if (states < bestStates) {
+                best = boundary;
+                bestStates = states;
+            }
+        }
+
+        if (best != SIZE_MAX && bestStates <= MaximumBoundaryStateCount) {
+            cuts[cutCount++] = best;
+        }
+    }
+
+    cuts[cutCount] = instructionCount;
+    free(ways);
+    free(boundaryStates);
+    free(liveCounts);
+
+    return cutCount;
+}
+
+[[nodiscard]]
+static bool BuildBoundaryStates(
+    SegmentSolve *const solve,
+    size_t const instructionCount,
+    size_t const valueCount
+)
+{
+    StateModel const *const model = solve->model;
+    size_t *livePositions = malloc((valueCount == 0 ? 1 : valueCount) * sizeof(size_t));
+    int32_t *liveValues = malloc((valueCount == 0 ? 1 : valueCount) * sizeof(int32_t));
+    int32_t *slots = malloc((model->slotCount == 0 ? 1 : model->slotCount) * sizeof(int32_t));
+    int32_t *canonical = malloc((model->slotCount == 0 ? 1 : model->slotCount) * sizeof(int32_t));
+    StateHistory history = {nullptr, 0, 0};
+    bool succeeded = livePositions != nullptr && liveValues != nullptr && slots != nullptr && canonical != nullptr;
+
+    for (size_t value = 0; succeeded && value < valueCount; ++value) {
+        livePositions[value] = SIZE_MAX;
+    }
+    for (size_t slot = 0; succeeded && slot < model->slotCount; ++slot) {
+        slots[slot] = -1;
+    }
+
+    size_t liveCount = 0;
+    size_t segment = 0;
+    for (size_t index = 0; succeeded && index <= instructionCount && segment < solve->segmentCount; ++index) {
+        if (index == solve->cuts[segment]) {
+            succeeded = InitializeStateFrontier(&solve->boundaries[segment], model->slotCount);
+            if (succeeded) {
+                succeeded = EnumerateBoundaryStates(
+                    &solve->boundaries[segment], &history, solve->layout, slots, canonical, liveValues, liveCount
+                );
+                if (!succeeded) {
+                    DestroyStateFrontier(&solve->boundaries[segment]);
+                }
+            }
+            segment += succeeded;
+        }
+        if (index == instructionCount) {
+            break;
+        }
+
+        int32_t const value = model->values[index];
+        size_t const position = livePositions[value];
+        if (position != SIZE_MAX) {
+            int32_t const last = liveValues[--liveCount];
+            liveValues[position] = last;
+            livePositions[last] = position;
+            livePositions[value] = SIZE_MAX;
+        }
+        if (model->liveAfter[index]) {
+            livePositions[value] = liveCount;
+            liveValues[liveCount++] = value;
+        }
+    }
+
+    for (size_t built = segment; built < solve->segmentCount; ++built) {
+        solve->boundaries[built] = (StateFrontier){};
+    }
+
+    free(history.steps);
+    free(canonical);
+    free(slots);
+    free(liveValues);
+    free(livePositions);
+
+    return succeeded && segment == solve->segmentCount;
+}
+
+static void RunTransferJob(
+    void *const context,
+    size_t const worker,
+    size_t const job
+)
+{
+    SegmentSolve *const solve = context;
+    if (atomic_load_explicit(&solve->failed, memory_order_relaxed)) {
+        return;
+    }
+
+    size_t segment = 0;
+    while (solve->jobOffsets[segment + 1] <= job) {
+        ++segment;
+    }
+
+    size_t const row = job - solve->jobOffsets[segment];
+    StateFrontier const *const entry = &solve->boundaries[segment];
+    StateSearch *const search = &solve->searches[worker];
+    TransferNode *const node = &solve->nodes[segment];
+    int64_t *const costs = node->costs + row * node->columns;
+    bool const last = segment + 1 == solve->segmentCount;
+
+    if (!RunStateSearch(
+        search,
+        solve->model,
+        entry->slots + row * entry->width,
+        solve->cuts[segment],
+        solve->cuts[segment + 1]
+    )) {
+        atomic_store_explicit(&solve->failed, true, memory_order_relaxed);
+        return;
+    }
+
+    StateFrontier const *const exit = search->current;
+    for (size_t state = 0; state < exit->count; ++state) {
+        size_t const column = last ? 0 : FindFrontierState(&solve->boundaries[segment + 1], exit->slots + state * exit->width);
+        if (column == SIZE_MAX) {
+            atomic_store_explicit(&solve->failed, true, memory_order_relaxed);
+            return;
+        }
+        if (exit->costs[state] < costs[column]) {
+            costs[column] = exit->costs[state];
+        }
+    }
+}
+
+static void RunProductJob(
+    void *const context,
+    [[maybe_unused]] size_t const worker,
+    size_t const job
+)
+{
+    SegmentSolve *const solve = context;
+
+    size_t product = 0;
+    while (solve->rowOffsets[product + 1] <= job) {
+        ++product;
+    }
+
+    TransferNode *const node = &solve->nodes[solve->levelNodes[product]];
+    TransferNode const *const left = &solve->nodes[node->left];
+    TransferNode const *const right = &solve->nodes[node->right];
+    size_t const row = job - solve->rowOffsets[product];
+
+    for (size_t column = 0; column < node->columns; ++column) {
+        int64_t best = UnreachableCost;
+        uint32_t middle = 0;
+        for (size_t inner = 0; inner < left->columns; ++inner) {
+            int64_t const first = left->costs[row * left->columns + inner];
+            int64_t const second = right->costs[inner * right->columns + column];
+            if (first == UnreachableCost || second == UnreachableCost) {
+                continue;
+            }
+            if (first + second < best) {
+                best = first + second;
+                middle = (uint32_t)inner;
+            }
+        }
+
+        node->costs[row * node->columns + column] = best;
+        node->middles[row * node->columns + column] = middle;
+    }
+}
+
+static void SelectSegmentStates(
+    SegmentSolve *const solve,
+    size_t const nodeIndex,
+    size_t const row,
+    size_t const column
+)
+{
+    TransferNode const *const node = &solve->nodes[nodeIndex];
+    if (node->left == SIZE_MAX) {
+        solve->entryRows[node->segment] = row;
+        solve->exitColumns[node->segment] = column;
+        return;
+    }
+
+    size_t const middle = node->middles[row * node->columns + column];
+    SelectSegmentStates(solve, node->left, row, middle);
+    SelectSegmentStates(solve, node->right, middle, column);
+}
+
+static void RunReconstructionJob(
+    void *const context,
+    [[maybe_unused]] size_t const worker,
+    size_t const segment
+)
+{
+    SegmentSolve *const solve = context;
+    size_t const begin = solve->cuts[segment];
+    size_t const end = solve->cuts[segment + 1];
+    StateFrontier const *const entry = &solve->boundaries[segment];
+
+    StateSearch search;
+    if (!InitializeStateSearch(&search, solve->model->slotCount, end - begin + 1)) {
+        atomic_store_explicit(&solve->failed, true, memory_order_relaxed);
+        return;
+    }
+
+    bool succeeded = RunStateSearch(
+        &search,
+        solve->model,
+        entry->slots + solve->entryRows[segment] * entry->width,
+        begin,
+        end
+    );
+
+    size_t state = SIZE_MAX;
+    if (succeeded && segment + 1 == solve->segmentCount) {
+        state = FindCheapestState(search.current);
+    }
+    else if (succeeded) {
+        StateFrontier const *const exit = &solve->boundaries[segment + 1];
+        int32_t const *const exitSlots = exit->slots + solve->exitColumns[segment] * exit->width;
+        for (size_t candidate = 0; candidate < search.current->count && state == SIZE_MAX; ++candidate) {
+            if (memcmp(search.current->slots + candidate * exit->width, exitSlots, exit->width * sizeof(int32_t)) == 0) {
+                state = candidate;
+            }
+        }
+    }
+
+    if (state == SIZE_MAX) {
+        atomic_store_explicit(&solve->failed, true, memory_order_relaxed);
+    }
+    else {
+        TraceStateSearch(&search, solve->solution, begin, end, state);
+    }
+
+    DestroyStateSearch(&search);
+}
+
+[[nodiscard]]
+static bool AllocateTransferNode(
+    TransferNode *const node,
+    size_t const rows,
+    size_t const columns,
+    bool const withMiddles
+)
+{
+    size_t cellCount;
+    if (__builtin_mul_overflow(rows, columns, &cellCount)) {
+        return false;
+    }
+
+    node->rows = rows;
+    node->columns = columns;
+    node->costs = malloc(cellCount * sizeof(int64_t));
+    node->middles = withMiddles ? malloc(cellCount * sizeof(uint32_t)) : nullptr;
+    if (node->costs == nullptr || (withMiddles && node->middles == nullptr)) {
+        return false;
+    }
+
+    for (size_t cell = 0; cell < cellCount; ++cell) {
+        node->costs[cell] = UnreachableCost;
+    }
+
+    return true;
+}
+
+[[nodiscard]]
+static bool ReduceTransferNodes(
+    SegmentSolve *const solve,
+    size_t const workerCount,
+    size_t *const root
+)
+{
+    size_t const segmentCount = solve->segmentCount;
+    size_t levelCount = segmentCount;
+    size_t nodeCount = segmentCount;
+    size_t *level = malloc(segmentCount * sizeof(size_t));
+    solve->levelNodes = malloc(segmentCount * sizeof(size_t));
+    solve->rowOffsets = malloc((segmentCount + 1) * sizeof(size_t));
+    if (level == nullptr || solve->levelNodes == nullptr || solve->rowOffsets == nullptr) {
+        free(level);
+        return false;
+    }
+
+    for (size_t segment = 0; segment < segmentCount; ++segment) {
+        level[segment] = segment;
+    }
+
+    bool succeeded = true;
+    while (succeeded && levelCount > 1) {
+        size_t productCount = 0;
+        size_t rowCount = 0;
+        size_t nextCount = 0;
+
+        for (size_t index = 0; succeeded && index < levelCount; index += 2) {
+            if (index + 1 == levelCount) {
+                level[nextCount++] = level[index];
+                continue;
+            }
+
+            TransferNode const *const left = &solve->nodes[level[index]];
+            TransferNode const *const right = &solve->nodes[level[index + 1]];
+            TransferNode *const node = &solve->nodes[nodeCount];
+            *node = (TransferNode){.left = level[index], .right = level[index + 1], .segment = SIZE_MAX};
+            succeeded = AllocateTransferNode(node, left->rows, right->columns, true);
+
+            solve->levelNodes[productCount] = nodeCount;
+            solve->rowOffsets[productCount++] = rowCount;
+            rowCount += node->rows;
+            level[nextCount++] = nodeCount++;
+        }
+        solve->rowOffsets[productCount] = rowCount;
+
+        if (succeeded) {
+            MLRA_RunParallelJobs(rowCount, workerCount, RunProductJob, solve);
+        }
+        levelCount = nextCount;
+    }
+
+    *root = level[0];
+    free(level);
+
+    return succeeded;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_Solution *MLRA_SolveScenarioExactlyInParallel(
+    MLRA_Scenario const *const scenario,
+    size_t const threadCount
+)
+{
+    size_t const workerCount = threadCount == 0 ? MLRA_GetHardwareThreadCount() : threadCount;
+    size_t const registerCount = MLRA_GetRegisterCountInScenario(scenario);
+    size_t const instructionCount = MLRA_GetRegisterInstructionCountInScenario(scenario);
+    size_t segmentCount = workerCount * SegmentsPerThread;
+    if (segmentCount > instructionCount / MinimumSegmentLength) {
+        segmentCount = instructionCount / MinimumSegmentLength;
+    }
+    if (registerCount > INT32_MAX || segmentCount < 2 || instructionCount >= UINT32_MAX) {
+        return MLRA_SolveScenarioExactly(scenario);
+    }
+
+    MLRA_SolverTrace *trace = MLRA_CreateSolverTrace(scenario);
+    if (trace == nullptr) {
+        return nullptr;
+    }
+
+    size_t const valueCount = MLRA_GetValueCountInSolverTrace(trace);
+    uint8_t *live = calloc(valueCount == 0 ? 1 : valueCount, sizeof(uint8_t));
+    size_t *cuts = malloc((segmentCount + 1) * sizeof(size_t));
+    StateLayout layout;
+    StateModel model;
+    if (
+        live == nullptr || cuts == nullptr
+        || !InitializeStateLayout(
+            &layout,
+            scenario,
+            CountMaximumHeldValues(
+                MLRA_GetValuesInSolverTrace(trace),
+                MLRA_GetLiveAfterFlagsInSolverTrace(trace),
+                instructionCount,
+                live
+            )
+        )
+    ) {
+        free(cuts);
+        free(live);
+        MLRA_DestroySolverTrace(trace);
+        return nullptr;
+    }
+    free(live);
+    InitializeStateModel(
+        &model,
+        &layout,
+        MLRA_GetMemorySpillCostInScenario(scenario),
+        MLRA_GetValuesInSolverTrace(trace),
+        MLRA_GetStoreFlagsInSolverTrace(trace),
+        MLRA_GetLiveAfterFlagsInSolverTrace(trace)
+    );
+
+    segmentCount = ChooseSegmentCuts(
+        &model,
+        &layout,
+        MLRA_GetNextReferencesInSolverTrace(trace),
+        instructionCount,
+        segmentCount,
+        cuts
+    );
+    if (segmentCount < 2) {
+        free(cuts);
+        DestroyStateLayout(&layout);
+        MLRA_DestroySolverTrace(trace);
+        return MLRA_SolveScenarioExactly(scenario);
+    }
+
+    SegmentSolve solve = {
+        .model = &model,
+        .layout = &layout,
+        .boundaries = calloc(segmentCount, sizeof(StateFrontier)),
+        .cuts = cuts,
+        .segmentCount = segmentCount,
+        .jobOffsets = malloc((segmentCount + 1) * sizeof(size_t)),
+        .searches = calloc(workerCount, sizeof(StateSearch)),
+        .nodes = calloc(segmentCount * 2, sizeof(TransferNode)),
+        .entryRows = malloc(segmentCount * sizeof(size_t)),
+        .exitColumns = malloc(segmentCount * sizeof(size_t)),
+        .solution = MLRA_CreateSolution(instructionCount)
+    };
+    atomic_init(&solve.failed, false);
+
+    size_t searchCount = 0;
+    bool succeeded = solve.boundaries != nullptr && solve.jobOffsets != nullptr && solve.searches != nullptr
+        && solve.nodes != nullptr && solve.entryRows != nullptr && solve.exitColumns != nullptr
+        && solve.solution != nullptr && BuildBoundaryStates(&solve, instructionCount, valueCount);
+
+    while (succeeded && searchCount < workerCount) {
+        succeeded = InitializeStateSearch(&solve.searches[searchCount], layout.slotCount, 0);
+        searchCount += succeeded;
+    }
+
+    size_t jobCount = 0;
+    for (size_t segment = 0; succeeded && segment < segmentCount; ++segment) {
+        size_t const rows = solve.boundaries[segment].count;
+        size_t const columns = segment + 1 == segmentCount ? 1 : solve.boundaries[segment + 1].count;
+        solve.nodes[segment] = (TransferNode){.left = SIZE_MAX, .right = SIZE_MAX, .segment = segment};
+        succeeded = AllocateTransferNode(&solve.nodes[segment], rows, columns, false);
+        solve.jobOffsets[segment] = jobCount;
+        jobCount += rows;
+    }
+
+    size_t root = 0;
+    if (succeeded) {
+        solve.jobOffsets[segmentCount] = jobCount;
+        MLRA_RunParallelJobs(jobCount, workerCount, RunTransferJob, &solve);
+        succeeded = !atomic_load(&solve.failed) && ReduceTransferNodes(&solve, workerCount, &root);
+    }
+
+    if (succeeded && solve.nodes[root].costs[0] != UnreachableCost) {
+        SelectSegmentStates(&solve, root, 0, 0);
+        MLRA_RunParallelJobs(segmentCount, workerCount, RunReconstructionJob, &solve);
+        MLRA_SetSolutionCost(solve.solution, solve.nodes[root].costs[0]);
+        succeeded = !atomic_load(&solve.failed)
+            && UnfoldStateSlots(&layout, model.values, model.liveAfter, solve.solution, instructionCount);
+    }
+    else {
+        succeeded = false;
+    }
+
+    for (size_t node = 0; solve.nodes != nullptr && node < segmentCount * 2; ++node) {
+        free(solve.nodes[node].middles);
+        free(solve.nodes[node].costs);
+    }
+    for (size_t search = 0; search < searchCount; ++search) {
+        DestroyStateSearch(&solve.searches[search]);
+    }
+    for (size_t segment = 0; solve.boundaries != nullptr && segment < segmentCount; ++segment) {
+        if (solve.boundaries[segment].slots != nullptr) {
+            DestroyStateFrontier(&solve.boundaries[segment]);
+        }
+    }
+    free(solve.rowOffsets);
+    free(solve.levelNodes);
+    free(solve.exitColumns);
+    free(solve.entryRows);
+    free(solve.nodes);
+    free(solve.searches);
+    free(solve.jobOffsets);
+    free(solve.boundaries);
+    free(cuts);
+    DestroyStateLayout(&layout);
+    MLRA_DestroySolverTrace(trace);
+
+    if (!succeeded) {
+        MLRA_DestroySolution(solve.solution);
+        return nullptr;
+    }
+
+    return solve.solution;
+}
+
+static void DestroyCheckpointSegment(
+    CheckpointSegment *const segment
+)
+{
+    free(segment->entrySlots);
+    free(segment->entryCosts);
+    free(segment->steps);
+    free(segment->stepBases);
+    *segment = (CheckpointSegment){};
+}
+
+[[nodiscard]]
+static bool CaptureCheckpointEntry(
+    CheckpointSegment *const segment,
+    StateFrontier const *const frontier
+)
+{
+    size_t const width = frontier->width == 0 ? 1 : frontier->width;
+    segment->entryCount = frontier->count;
+    segment->entryState = SIZE_MAX;
+    segment->entrySlots = malloc(frontier->count * width * sizeof(int32_t));
+    segment->entryCosts = malloc(frontier->count * sizeof(int64_t));
+    if (segment->entrySlots == nullptr || segment->entryCosts == nullptr) {
+        return false;
+    }
+
+    memcpy(segment->entrySlots, frontier->slots, frontier->count * frontier->width * sizeof(int32_t));
+    memcpy(segment->entryCosts, frontier->costs, frontier->count * sizeof(int64_t));
+
+    return true;
+}
+
+[[nodiscard]]
+static bool CloseCheckpointSegment(
+    CheckpointSegment *const segment,
+    StateSearch const *const search,
+    size_t const length
+)
+{
+    size_t const stepCount = search->history.count;
+    segment->length = length;
+    segment->steps = malloc((stepCount == 0 ? 1 : stepCount) * sizeof(StateStep));
+    segment->stepBases = malloc(length * sizeof(size_t));
+    if (segment->steps == nullptr || segment->stepBases == nullptr) {
+        return false;
+    }
+
+    memcpy(segment->steps, search->history.steps, stepCount * sizeof(StateStep));
+    memcpy(segment->stepBases, search->historyBases, length * sizeof(size_t));
+
+    return true;
+}
+
+static size_t TraceCheckpointSegment(
+    CheckpointSegment const *const segment,
+    int32_t *const locations,
+    size_t state
+)
+{
+    for (size_t offset = segment->length; offset-- > 0;) {
+        StateStep const step = segment->steps[segment->stepBases[offset] + state];
+        locations[segment->begin + offset] = step.location;
+        state = step.parent;
+    }
+
+    return state;
+}
+
+/*
+ * The recomputed frontier may list the cached states in a different order. Any order works for the rest of the
+ * search, so a match only needs the same states with every cost shifted by the same amount.
+ */
+[[nodiscard]]
+static bool MatchCheckpointSegment(
+    StateFrontier *const frontier,
+    CheckpointSegment const *const segment,
+    uint32_t *const permutation,
+    int64_t *const delta
+)
+{
+    size_t const width = frontier->width;
+    if (frontier->count != segment->entryCount) {
+        return false;
+    }
+
+    if (memcmp(frontier->slots, segment->entrySlots, frontier->count * width * sizeof(int32_t)) == 0) {
+        for (size_t state = 0; state < segment->entryCount; ++state) {
+            permutation[state] = (uint32_t)state;
+        }
+    }
+    else {
+        ReindexStateFrontier(frontier);
+        for (size_t state = 0; state < segment->entryCount; ++state) {
+            size_t const match = FindFrontierState(frontier, segment->entrySlots + state * width);
+            if (match == SIZE_MAX) {
+                return false;
+            }
+            permutation[state] = (uint32_t)match;
+        }
+    }
+
+    *delta = frontier->costs[permutation[0]] - segment->entryCosts[0];
+    for (size_t state = 1; state < segment->entryCount; ++state) {
+        if (frontier->costs[permutation[state]] - segment->entryCosts[state] != *delta) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void ResetIncrementalSolver(
+    MLRA_IncrementalSolver *const solver
+)
+{
+    for (size_t segment = 0; segment < solver->segmentCount; ++segment) {
+        DestroyCheckpointSegment(&solver->segments[segment]);
+    }
+    for (size_t segment = 0; segment < solver->pendingCount; ++segment) {
+        DestroyCheckpointSegment(&solver->pendingSegments[segment]);
+    }
+
+    solver->segmentCount = 0;
+    solver->pendingCount = 0;
+    solver->solved = false;
+    solver->solvedEnd = 0;
+}
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroyIncrementalSolver(
+    MLRA_IncrementalSolver *const solver
+)
+{
+    if (solver == nullptr) {
+        return;
+    }
+
+    ResetIncrementalSolver(solver);
+    if (solver->searchReady) {
+        DestroyStateSearch(&solver->search);
+    }
+    MLRA_DestroyVirtualRegisterMap(solver->map);
+    free(solver->values);
+    free(solver->isStore);
+    free(solver->liveAfter);
+    free(solver->locations);
+    free(solver->nextReferenceKinds);
+    free(solver->segments);
+    free(solver->pendingSegments);
+    free(solver->permutation);
+    free(solver->permutedSteps);
+    DestroyStateLayout(&solver->layout);
+    free(solver);
+}
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyIncrementalSolver, 1)]]
+MLRA_IncrementalSolver *MLRA_CreateIncrementalSolver(
+    size_t const checkpointInterval
+)
+{
+    MLRA_IncrementalSolver *solver = malloc(sizeof(MLRA_IncrementalSolver));
+    if (solver == nullptr) {
+        return nullptr;
+    }
+
+    *solver = (MLRA_IncrementalSolver){
+        .checkpointInterval = checkpointInterval == 0 ? DefaultCheckpointInterval : checkpointInterval
+    };
+
+    solver->map = MLRA_CreateVirtualRegisterMap();
+    if (solver->map == nullptr) {
+        free(solver);
+        return nullptr;
+    }
+
+    return solver;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void MLRA_SetIncrementalSolverProgress(
+    MLRA_IncrementalSolver *const solver,
+    MLRA_SolverProgress const progress,
+    void *const context
+)
+{
+    solver->progress = progress;
+    solver->progressContext = context;
+}
+
+[[nodiscard]]
+static bool GrowIncrementalArray(
+    void **const array,
+    size_t *const capacity,
+    size_t const count,
+    size_t const elementSize
+)
+{
+    if (count <= *capacity) {
+        return true;
+    }
+
+    size_t newCapacity = *capacity < 64 ? 64 : *capacity;
+    while (newCapacity < count) {
+        newCapacity *= 2;
+    }
+
+    size_t totalSize;
+    if (__builtin_mul_overflow(newCapacity, elementSize, &totalSize)) {
+        return false;
+    }
+
+    void *grown = realloc(*array, totalSize);
+    if (grown == nullptr) {
+        return false;
+    }
+
+    *array = grown;
+    *capacity = newCapacity;
+
+    return true;
+}
+
+[[nodiscard]]
+static bool ReserveIncrementalTrace(
+    MLRA_IncrementalSolver *const solver,
+    size_t const count
+)
+{
+    if (count <= solver->capacity) {
+        return true;
+    }
+
+    size_t newCapacity = solver->capacity < 1024 ? 1024 : solver->capacity;
+    while (newCapacity < count) {
+        if (__builtin_mul_overflow(newCapacity, 2, &newCapacity)) {
+            return false;
+        }
+    }
+
+    size_t sizes[4];
+    if (
+        __builtin_mul_overflow(newCapacity, sizeof(int32_t), &sizes[0])
+        || __builtin_mul_overflow(newCapacity, sizeof(bool), &sizes[1])
+    ) {
+        return false;
+    }
+    sizes[2] = sizes[1];
+    sizes[3] = sizes[0];
+
+    void **const arrays[4] = {
+        (void **)&solver->values,
+        (void **)&solver->isStore,
+        (void **)&solver->liveAfter,
+        (void **)&solver->locations
+    };
+    for (size_t array = 0; array < 4; ++array) {
+        void *grown = realloc(*arrays[array], sizes[array]);
+        if (grown == nullptr) {
+            return false;
+        }
+        *arrays[array] = grown;
+    }
+
+    solver->capacity = newCapacity;
+
+    return true;
+}
+
+[[nodiscard]]
+static bool FillIncrementalTrace(
+    MLRA_IncrementalSolver *const solver,
+    MLRA_Scenario const *const scenario,
+    size_t const begin,
+    size_t const end
+)
+{
+    for (size_t index = begin; index < end;) {
+        size_t idLength;
+        size_t bitLength;
+        size_t bitOffset;
+        int32_t const *const virtualRegisterIds = MLRA_GetVirtualRegisterIdSpanInScenario(scenario, index, &idLength);
+        uint64_t const *const storeBits = MLRA_GetStoreBitSpanInScenario(scenario, index, &bitLength, &bitOffset);
+        size_t length = idLength < bitLength ? idLength : bitLength;
+        length = length < end - index ? length : end - index;
+
+        for (size_t offset = 0; offset < length; ++offset) {
+            size_t const denseIndex = MLRA_AddVirtualRegisterToMap(solver->map, virtualRegisterIds[offset]);
+            if (denseIndex == SIZE_MAX || denseIndex > INT32_MAX) {
+                return false;
+            }
+
+            size_t const bit = bitOffset + offset;
+            solver->values[index + offset] = (int32_t)denseIndex;
+            solver->isStore[index + offset] = (storeBits[bit / 64] >> (bit % 64)) & 1;
+        }
+
+        index += length;
+    }
+
+    return GrowIncrementalArray(
+        (void **)&solver->nextReferenceKinds,
+        &solver->valueCapacity,
+        MLRA_GetVirtualRegisterCountInMap(solver->map),
+        sizeof(uint8_t)
+    );
+}
+
+/*
+ * Recomputes the liveness flags and returns the first position below unchangedEnd whose flag changed, or
+ * unchangedEnd if none did.
+ */
+static size_t LinkIncrementalTrace(
+    MLRA_IncrementalSolver *const solver,
+    size_t const unchangedEnd
+)
+{
+    memset(solver->nextReferenceKinds, ReferenceKind_None, MLRA_GetVirtualRegisterCountInMap(solver->map));
+
+    size_t firstChanged = unchangedEnd;
+    for (size_t index = solver->count; index-- > 0;) {
+        int32_t const value = solver->values[index];
+        bool const liveAfter = solver->nextReferenceKinds[value] == ReferenceKind_Load;
+        if (index < unchangedEnd && liveAfter != solver->liveAfter[index]) {
+            firstChanged = index;
+        }
+        solver->liveAfter[index] = liveAfter;
+        solver->nextReferenceKinds[value] = solver->isStore[index] ? ReferenceKind_Store : ReferenceKind_Load;
+    }
+
+    return firstChanged;
+}
+
+/*
+ * Lays out the slots for the scenario's costs and reports whether the slot costs differ from the ones the cached
+ * search was run with. The layout of the same scenario is only built again once its cost generations or the slot
+ * limit moved.
+ */
+[[nodiscard]]
+static bool LoadIncrementalLayout(
+    MLRA_IncrementalSolver *const solver,
+    MLRA_Scenario const *const scenario,
+    size_t const slotLimit,
+    bool *const unchanged
+)
+{
+    uint64_t const identity = MLRA_GetScenarioIdentity(scenario);
+    uint64_t const registerCostGeneration = MLRA_GetRegisterCostGenerationInScenario(scenario);
+    uint64_t const memorySpillCostGeneration = MLRA_GetMemorySpillCostGenerationInScenario(scenario);
+    if (
+        solver->searchReady
+        && solver->costIdentity == identity
+        && solver->registerCostGeneration == registerCostGeneration
+        && solver->memorySpillCostGeneration == memorySpillCostGeneration
+        && solver->slotLimit == slotLimit
+    ) {
+        *unchanged = true;
+        return true;
+    }
+
+    StateLayout layout;
+    if (!InitializeStateLayout(&layout, scenario, slotLimit)) {
+        return false;
+    }
+
+    MLRA_RegisterCost const memorySpillCost = MLRA_GetMemorySpillCostInScenario(scenario);
+    *unchanged = solver->searchReady
+        && layout.slotCount == solver->layout.slotCount
+        && memorySpillCost.load == solver->memorySpillCost.load
+        && memorySpillCost.store == solver->memorySpillCost.store
+        && memcmp(layout.slotCosts, solver->layout.slotCosts, layout.slotCount * sizeof(MLRA_RegisterCost)) == 0;
+
+    if (solver->searchReady && layout.slotCount != solver->layout.slotCount) {
+        DestroyStateSearch(&solver->search);
+        solver->searchReady = false;
+    }
+
+    DestroyStateLayout(&solver->layout);
+    solver->layout = layout;
+    solver->memorySpillCost = memorySpillCost;
+
+    if (!solver->searchReady) {
+        if (!InitializeStateSearch(&solver->search, layout.slotCount, solver->checkpointInterval)) {
+            return false;
+        }
+        solver->searchReady = true;
+    }
+
+    solver->slotLimit = slotLimit;
+    solver->costIdentity = identity;
+    solver->registerCostGeneration = registerCostGeneration;
+    solver->memorySpillCostGeneration = memorySpillCostGeneration;
+
+    return true;
+}
+
+[[nodiscard]]
+static CheckpointSegment *AppendPendingSegment(
+    MLRA_IncrementalSolver *const solver,
+    size_t const begin
+)
+{
+    if (!GrowIncrementalArray(
+        (void **)&solver->pendingSegments,
+        &solver->pendingCapacity,
+        solver->pendingCount + 1,
+        sizeof(CheckpointSegment)
+    )) {
+        return nullptr;
+    }
+
+    CheckpointSegment *const segment = &solver->pendingSegments[solver->pendingCount++];
+    *segment = (CheckpointSegment){.begin = begin, .entryState = SIZE_MAX};
+
+    return segment;
+}
+
+/*
+ * Runs the search from the checkpoint at segment index first until the end of the trace, or until the frontier
+ * reaches a cached checkpoint behind the edits that it matches. Stores the index of that checkpoint in stop, or the
+ * segment count if none matched. A search cancelled by the progress callback returns false with cancelled set once
+ * the segment it just finished is closed, so that the segments searched so far can be kept. The callback is not asked
+ * at the end of the trace, since a kept segment reaching it would pass for a finished solve that was never traced.
+ */
+[[nodiscard]]
+static bool RunIncrementalSearch(
+    MLRA_IncrementalSolver *const solver,
+    StateModel const *const model,
+    size_t const first,
+    size_t const editEnd,
+    ptrdiff_t const shift,
+    size_t *const stop,
+    int64_t *const delta,
+    bool *const cancelled
+)
+{
+    StateSearch *const search = &solver->search;
+    CheckpointSegment *segment = &solver->pendingSegments[0];
+    if (!SeedStateSearch(search, segment->entrySlots, segment->entryCosts, segment->entryCount)) {
+        return false;
+    }
+
+    size_t candidate = first + 1;
+    while (
+        candidate < solver->segmentCount
+        && (
+            solver->segments[candidate].begin < editEnd
+            || (size_t)((ptrdiff_t)solver->segments[candidate].begin + shift) <= segment->begin
+        )
+    ) {
+        ++candidate;
+    }
+
+    size_t position = segment->begin;
+    while (position < solver->count) {
+        size_t const segmentEnd = segment->begin + solver->checkpointInterval;
+        size_t const candidatePosition = candidate < solver->segmentCount
+            ? (size_t)((ptrdiff_t)solver->segments[candidate].begin + shift)
+            : SIZE_MAX;
+
+        size_t target = segmentEnd < solver->count ? segmentEnd : solver->count;
+        target = candidatePosition < target ? candidatePosition : target;
+
+        if (!AdvanceStateSearch(search, model, segment->begin, position, target)) {
+            return false;
+        }
+        position = target;
+
+        if (
+            solver->progress != nullptr
+            && position == segmentEnd
+            && position < solver->count
+            && !solver->progress(solver->progressContext, position, solver->count)
+        ) {
+            *cancelled = CloseCheckpointSegment(segment, search, position - segment->begin);
+            return false;
+        }
+
+        bool stopped = false;
+        if (position == candidatePosition) {
+            CheckpointSegment const *const cached = &solver->segments[candidate];
+            if (
+                !GrowIncrementalArray(
+                    (void **)&solver->permutation, &solver->permutationCapacity, cached->entryCount, sizeof(uint32_t)
+                )
+            ) {
+                return false;
+            }
+            stopped = MatchCheckpointSegment(search->current, cached, solver->permutation, delta);
+            if (!stopped) {
+                ++candidate;
+            }
+        }
+
+        if (!stopped && position != segmentEnd && position != solver->count) {
+            continue;
+        }
+
+        if (!CloseCheckpointSegment(segment, search, position - segment->begin)) {
+            return false;
+        }
+
+        if (stopped) {
+            *stop = candidate;
+            return true;
+        }
+
+        if (position < solver->count) {
+            segment = AppendPendingSegment(solver, position);
+            if (segment == nullptr || !CaptureCheckpointEntry(segment, search->current)) {
+                return false;
+            }
+            search->history.count = 0;
+        }
+    }
+
+    *stop = solver->segmentCount;
+
+    return true;
+}
+
+/*
+ * The cached steps behind a matched checkpoint refer to its states in cached order, so the last step of the
+ * recomputed segment in front of it is rearranged into that order.
+ */
+[[nodiscard]]
+static bool PermuteCheckpointSegmentExit(
+    MLRA_IncrementalSolver *const solver,
+    CheckpointSegment *const segment,
+    size_t const stateCount
+)
+{
+    bool identity = true;
+    for (size_t state = 0; state < stateCount && identity; ++state) {
+        identity = solver->permutation[state] == state;
+    }
+    if (identity) {
+        return true;
+    }
+
+    StateStep *permutedSteps = realloc(solver->permutedSteps, solver->permutationCapacity * sizeof(StateStep));
+    if (permutedSteps == nullptr) {
+        return false;
+    }
+    solver->permutedSteps = permutedSteps;
+
+    StateStep *const exitSteps = segment->steps + segment->stepBases[segment->length - 1];
+    for (size_t state = 0; state < stateCount; ++state) {
+        permutedSteps[state] = exitSteps[solver->permutation[state]];
+    }
+    memcpy(exitSteps, permutedSteps, stateCount * sizeof(StateStep));
+
+    return true;
+}
+
+/*
+ * Replaces the cached segments from first up to stop with the recomputed ones, and moves the cached segments behind
+ * them by the shift and cost delta of the edits.
+ */
+[[nodiscard]]
+static bool ReplaceCheckpointSegments(
+    MLRA_IncrementalSolver *const solver,
+    size_t const first,
+    size_t const stop,
+    ptrdiff_t const shift,
+    int64_t const delta
+)
+{
+    size_t const tailCount = solver->segmentCount - stop;
+    size_t const segmentCount = first + solver->pendingCount + tailCount;
+    if (
+        !GrowIncrementalArray(
+            (void **)&solver->segments, &solver->segmentCapacity, segmentCount, sizeof(CheckpointSegment)
+        )
+    ) {
+        return false;
+    }
+
+    for (size_t segment = first; segment < stop; ++segment) {
+        DestroyCheckpointSegment(&solver->segments[segment]);
+    }
+    memmove(
+        solver->segments + first + solver->pendingCount,
+        solver->segments + stop,
+        tailCount * sizeof(CheckpointSegment)
+    );
+    memcpy(solver->segments + first, solver->pendingSegments, solver->pendingCount * sizeof(CheckpointSegment));
+    solver->pendingCount = 0;
+    solver->segmentCount = segmentCount;
+
+    size_t const tailBegin = segmentCount - tailCount;
+    for (size_t segment = tailBegin; segment < segmentCount; ++segment) {
+        CheckpointSegment *const cached = &solver->segments[segment];
+        cached->begin = (size_t)((ptrdiff_t)cached->begin + shift);
+        for (size_t state = 0; state < cached->entryCount; ++state) {
+            cached->entryCosts[state] += delta;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Splices the recomputed segments in with ReplaceCheckpointSegments, then rewrites the locations along the new optimal
+ * path until it rejoins the cached one.
+ */
+[[nodiscard]]
+static bool SpliceCheckpointSegments(
+    MLRA_IncrementalSolver *const solver,
+    size_t const first,
+    size_t const stop,
+    ptrdiff_t const shift,
+    int64_t const delta
+)
+{
+    size_t const tailCount = solver->segmentCount - stop;
+    if (!ReplaceCheckpointSegments(solver, first, stop, shift, delta)) {
+        return false;
+    }
+
+    size_t const segmentCount = solver->segmentCount;
+    size_t const tailBegin = segmentCount - tailCount;
+    size_t state;
+    if (tailCount != 0) {
+        state = solver->segments[tailBegin].entryState;
+        solver->cost += delta;
+    }
+    else {
+        state = FindCheapestState(solver->search.current);
+        solver->cost = solver->search.current->costs[state];
+    }
+
+    size_t cachedState = SIZE_MAX;
+    for (size_t segment = tailBegin; segment-- > 0;) {
+        if (segment < first && state == cachedState) {
+            break;
+        }
+
+        CheckpointSegment *const cached = &solver->segments[segment];
+        state = TraceCheckpointSegment(cached, solver->locations, state);
+        cachedState = cached->entryState;
+        cached->entryState = state;
+    }
+
+    return true;
+}
+
+[[nodiscard]]
+static MLRA_Solution *CreateIncrementalSolution(
+    MLRA_IncrementalSolver const *const solver
+)
+{
+    MLRA_Solution *solution = MLRA_CreateSolution(solver->count);
+    if (solution == nullptr) {
+        return nullptr;
+    }
+
+    MLRA_SetSolutionCost(solution, solver->cost);
+    for (size_t index = 0; index < solver->count; ++index) {
+        MLRA_SetInstructionLocationInSolution(solution, index, solver->locations[index]);
+    }
+
+    if (!UnfoldStateSlots(&solver->layout, solver->values, solver->liveAfter, solution, solver->count)) {
+        MLRA_DestroySolution(solution);
+        return nullptr;
+    }
+
+    return solution;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(read_only, 2)]]
+MLRA_Solution *MLRA_SolveScenarioIncrementally(
+    MLRA_IncrementalSolver *const solver,
+    MLRA_Scenario const *const scenario
+)
+{
+    size_t const count = MLRA_GetRegisterInstructionCountInScenario(scenario);
+    if (MLRA_GetRegisterCountInScenario(scenario) > INT32_MAX || count > PTRDIFF_MAX) {
+        return nullptr;
+    }
+
+    MLRA_ScenarioDirtyRange range;
+    bool const reuse = solver->solved
+        && solver->scenarioIdentity == MLRA_GetScenarioIdentity(scenario)
+        && MLRA_GetInstructionDirtyRangeInScenario(scenario, solver->generation, &range)
+        && (ptrdiff_t)solver->count + range.shift == (ptrdiff_t)count;
+    bool const edited = solver->generation != MLRA_GetInstructionGenerationInScenario(scenario);
+    size_t const solvedEnd = solver->solvedEnd;
+    bool const complete = solvedEnd == solver->count;
+
+    if (
+        reuse
+        && complete
+        && !edited
+        && solver->costIdentity == MLRA_GetScenarioIdentity(scenario)
+        && solver->registerCostGeneration == MLRA_GetRegisterCostGenerationInScenario(scenario)
+        && solver->memorySpillCostGeneration == MLRA_GetMemorySpillCostGenerationInScenario(scenario)
+    ) {
+        return CreateIncrementalSolution(solver);
+    }
+
+    bool succeeded = ReserveIncrementalTrace(solver, count > solver->count ? count : solver->count);
+    size_t resume = 0;
+    size_t editEnd = 0;
+
+    if (succeeded && reuse) {
+        size_t const tailBegin = (size_t)((ptrdiff_t)range.end - range.shift);
+        size_t const tailLength = solver->count - tailBegin;
+        memmove(solver->values + range.end, solver->values + tailBegin, tailLength * sizeof(int32_t));
+        memmove(solver->isStore + range.end, solver->isStore + tailBegin, tailLength * sizeof(bool));
+        memmove(solver->liveAfter + range.end, solver->liveAfter + tailBegin, tailLength * sizeof(bool));
+        memmove(solver->locations + range.end, solver->locations + tailBegin, tailLength * sizeof(int32_t));
+        solver->count = count;
+
+        succeeded = FillIncrementalTrace(solver, scenario, range.begin, range.end);
+        if (succeeded) {
+            resume = LinkIncrementalTrace(solver, range.begin);
+            editEnd = tailBegin;
+        }
+
+        /*
+         * A cancelled solve only cached the segments in front of solvedEnd. The search resumes there at the latest,
+         * and does not match checkpoints, since no cached segment reaches the end of the trace.
+         */
+        if (succeeded && !complete) {
+            resume = edited && resume < solvedEnd ? resume : solvedEnd;
+            editEnd = SIZE_MAX;
+        }
+    }
+    else if (succeeded) {
+        ResetIncrementalSolver(solver);
+        MLRA_ClearVirtualRegisterMap(solver->map);
+        solver->count = count;
+
+        succeeded = FillIncrementalTrace(solver, scenario, 0, count);
+        if (succeeded) {
+            (void)LinkIncrementalTrace(solver, 0);
+        }
+    }
+
+    /* The slot limit only moves when the most values held at once cross a power of two, so few edits drop the cache. */
+    if (succeeded) {
+        memset(solver->nextReferenceKinds, 0, MLRA_GetVirtualRegisterCountInMap(solver->map));
+        size_t const heldCount = CountMaximumHeldValues(
+            solver->values, solver->liveAfter, count, solver->nextReferenceKinds
+        );
+        size_t slotLimit = 1;
+        while (slotLimit < heldCount) {
+            slotLimit *= 2;
+        }
+
+        bool layoutUnchanged;
+        succeeded = LoadIncrementalLayout(solver, scenario, slotLimit, &layoutUnchanged);
+        if (succeeded && !layoutUnchanged) {
+            ResetIncrementalSolver(solver);
+        }
+    }
+
+    if (succeeded && count == 0) {
+        ResetIncrementalSolver(solver);
+        solver->cost = 0;
+    }
+    else if (succeeded) {
+        size_t const resumeLimit = resume < count ? resume : count - 1;
+        size_t first = 0;
+        for (size_t lower = 0, upper = solver->segmentCount; lower < upper;) {
+            size_t const middle = lower + (upper - lower) / 2;
+            if (solver->segments[middle].begin <= resumeLimit) {
+                first = middle;
+                lower = middle + 1;
+            }
+            else {
+                upper = middle;
+            }
+        }
+
+        CheckpointSegment *const entry = AppendPendingSegment(solver, 0);
+        succeeded = entry != nullptr;
+        if (succeeded && solver->segmentCount != 0) {
+            CheckpointSegment *const cached = &solver->segments[first];
+            entry->begin = cached->begin;
+            entry->entryCount = cached->entryCount;
+            entry->entryState = cached->entryState;
+            entry->entrySlots = cached->entrySlots;
+            entry->entryCosts = cached->entryCosts;
+            cached->entrySlots = nullptr;
+            cached->entryCosts = nullptr;
+        }
+        else if (succeeded) {
+            size_t const width = solver->layout.slotCount == 0 ? 1 : solver->layout.slotCount;
+            entry->entryCount = 1;
+            entry->entrySlots = malloc(width * sizeof(int32_t));
+            entry->entryCosts = malloc(sizeof(int64_t));
+            succeeded = entry->entrySlots != nullptr && entry->entryCosts != nullptr;
+            if (succeeded) {
+                for (size_t slot = 0; slot < width; ++slot) {
+                    entry->entrySlots[slot] = -1;
+                }
+                entry->entryCosts[0] = 0;
+            }
+        }
+
+        StateModel model;
+        InitializeStateModel(
+            &model, &solver->layout, solver->memorySpillCost, solver->values, solver->isStore, solver->liveAfter
+        );
+
+        size_t stop = solver->segmentCount;
+        int64_t delta = 0;
+        bool cancelled = false;
+        ptrdiff_t const shift = reuse ? range.shift : 0;
+        succeeded = succeeded && RunIncrementalSearch(solver, &model, first, editEnd, shift, &stop, &delta, &cancelled);
+
+        /* A cancelled solve keeps the segments it completed, and the next solve resumes behind them. */
+        if (cancelled && ReplaceCheckpointSegments(solver, first, solver->segmentCount, 0, 0)) {
+            CheckpointSegment const *const last = &solver->segments[solver->segmentCount - 1];
+            solver->solved = true;
+            solver->solvedEnd = last->begin + last->length;
+            solver->scenarioIdentity = MLRA_GetScenarioIdentity(scenario);
+            solver->generation = MLRA_GetInstructionGenerationInScenario(scenario);
+            return nullptr;
+        }
+
+        if (succeeded && stop < solver->segmentCount) {
+            succeeded = PermuteCheckpointSegmentExit(
+                solver,
+                &solver->pendingSegments[solver->pendingCount - 1],
+                solver->segments[stop].entryCount
+            );
+        }
+
+        succeeded = succeeded && SpliceCheckpointSegments(solver, first, stop, shift, delta);
+    }
+
+    if (!succeeded) {
+        ResetIncrementalSolver(solver);
+        return nullptr;
+    }
+
+    solver->solved = true;
+    solver->solvedEnd = count;
+    solver->scenarioIdentity = MLRA_GetScenarioIdentity(scenario);
+    solver->generation = MLRA_GetInstructionGenerationInScenario(scenario);
+
+    return CreateIncrementalSolution(solver);
+}
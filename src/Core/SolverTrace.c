@@ -0,0 +1,355 @@
+#include "MLRA/Core/SolverTrace.h"
+#include "MLRA/Core/NextUseIndex.h"
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/SolverWorkspace.h"
+#include "MLRA/Core/VirtualRegisterMap.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+struct MLRA_SolverTrace_
+{
+    int32_t *values;
+    uint32_t *nextReferences;
+    bool *isStore;
+    bool *liveAfter;
+    size_t valueCount;
+    size_t count;
+    bool ownsArrays;
+};
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void ReleaseSolverTraceArrays(
+    MLRA_SolverTrace *const trace
+)
+{
+    if (!trace->ownsArrays) {
+        return;
+    }
+
+    free(trace->values);
+    free(trace->nextReferences);
+    free(trace->isStore);
+    free(trace->liveAfter);
+}
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroySolverTrace(
+    MLRA_SolverTrace *const trace
+)
+{
+    if (trace == nullptr) {
+        return;
+    }
+
+    ReleaseSolverTraceArrays(trace);
+    free(trace);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2, 3), gnu::access(read_write, 1), gnu::access(read_only, 2), gnu::access(read_write, 3)]]
+static bool FillSolverTraceValues(
+    MLRA_SolverTrace *const trace,
+    MLRA_Scenario const *const scenario,
+    MLRA_VirtualRegisterMap *const map
+)
+{
+    for (size_t index = 0; index < trace->count;) {
+        size_t idLength;
+        size_t bitLength;
+        size_t bitOffset;
+        int32_t const *const virtualRegisterIds = MLRA_GetVirtualRegisterIdSpanInScenario(scenario, index, &idLength);
+        uint64_t const *const storeBits = MLRA_GetStoreBitSpanInScenario(scenario, index, &bitLength, &bitOffset);
+        size_t const length = idLength < bitLength ? idLength : bitLength;
+
+        for (size_t offset = 0; offset < length; ++offset) {
+            size_t const denseIndex = MLRA_AddVirtualRegisterToMap(map, virtualRegisterIds[offset]);
+            if (denseIndex == SIZE_MAX || denseIndex > INT32_MAX) {
+                return false;
+            }
+
+            size_t const bit = bitOffset + offset;
+            trace->values[index + offset] = (int32_t)denseIndex;
+            trace->isStore[index + offset] = (storeBits[bit / 64] >> (bit % 64)) & 1;
+        }
+
+        index += length;
+    }
+
+    trace->valueCount = MLRA_GetVirtualRegisterCountInMap(map);
+
+    return true;
+}
+
+/*
+ * Returns the next-use index of the scenario when it has one that matches its instructions.
+ */
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static MLRA_NextUseIndex const *GetSolverTraceNextUseIndex(
+    MLRA_Scenario const *const scenario
+)
+{
+    MLRA_NextUseIndex const *const nextUseIndex = MLRA_GetNextUseIndexInScenario(scenario);
+    if (
+        nextUseIndex == nullptr
+        || MLRA_GetPositionCountInNextUseIndex(nextUseIndex) != MLRA_GetRegisterInstructionCountInScenario(scenario)
+    ) {
+        return nullptr;
+    }
+
+    return nextUseIndex;
+}
+
+/*
+ * Numbers the values like FillSolverTraceValues, in order of first use, but from the dense values the next-use index of
+ * the scenario already keeps, so no virtual register is hashed. numbers needs room for every value of the index.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 2, 3, 4), gnu::access(read_write, 1), gnu::access(read_only, 2), gnu::access(read_only, 3)]]
+static bool FillSolverTraceValuesFromIndex(
+    MLRA_SolverTrace *const trace,
+    MLRA_Scenario const *const scenario,
+    MLRA_NextUseIndex const *const nextUseIndex,
+    uint32_t *const numbers
+)
+{
+    size_t const indexValueCount = MLRA_GetValueCountInNextUseIndex(nextUseIndex);
+    for (size_t value = 0; value < indexValueCount; ++value) {
+        numbers[value] = MLRA_SolverTrace_NoReference;
+    }
+
+    trace->valueCount = 0;
+    for (size_t index = 0; index < trace->count;) {
+        size_t valueLength;
+        size_t bitLength;
+        size_t bitOffset;
+        size_t const *const values = MLRA_GetValueSpanInNextUseIndex(nextUseIndex, index, &valueLength);
+        uint64_t const *const storeBits = MLRA_GetStoreBitSpanInScenario(scenario, index, &bitLength, &bitOffset);
+        size_t const length = valueLength < bitLength ? valueLength : bitLength;
+
+        for (size_t offset = 0; offset < length; ++offset) {
+            uint32_t *const number = &numbers[values[offset]];
+            if (*number == MLRA_SolverTrace_NoReference) {
+                if (trace->valueCount > INT32_MAX) {
+                    return false;
+                }
+                *number = (uint32_t)trace->valueCount++;
+            }
+
+            size_t const bit = bitOffset + offset;
+            trace->values[index + offset] = (int32_t)*number;
+            trace->isStore[index + offset] = (storeBits[bit / 64] >> (bit % 64)) & 1;
+        }
+
+        index += length;
+    }
+
+    return true;
+}
+
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(write_only, 2)]]
+static void LinkSolverTraceReferences(
+    MLRA_SolverTrace *const trace,
+    uint32_t *const lastReferences
+)
+{
+    for (size_t value = 0; value < trace->valueCount; ++value) {
+        lastReferences[value] = MLRA_SolverTrace_NoReference;
+    }
+
+    for (size_t index = trace->count; index-- > 0;) {
+        int32_t const value = trace->values[index];
+        uint32_t const next = lastReferences[value];
+        trace->nextReferences[index] = next;
+        trace->liveAfter[index] = next != MLRA_SolverTrace_NoReference && !trace->isStore[next];
+        lastReferences[value] = (uint32_t)index;
+    }
+}
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroySolverTrace, 1)]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_SolverTrace *MLRA_CreateSolverTrace(
+    MLRA_Scenario const *const scenario
+)
+{
+    size_t const count = MLRA_GetRegisterInstructionCountInScenario(scenario);
+    if (count >= MLRA_SolverTrace_NoReference) {
+        return nullptr;
+    }
+
+    MLRA_SolverTrace *trace = malloc(sizeof(MLRA_SolverTrace));
+    if (trace == nullptr) {
+        return nullptr;
+    }
+
+    size_t const allocationCount = count == 0 ? 1 : count;
+    trace->count = count;
+    trace->valueCount = 0;
+    trace->ownsArrays = true;
+    trace->values = malloc(allocationCount * sizeof(int32_t));
+    trace->nextReferences = malloc(allocationCount * sizeof(uint32_t));
+    trace->isStore = malloc(allocationCount * sizeof(bool));
+    trace->liveAfter = malloc(allocationCount * sizeof(bool));
+
+    MLRA_NextUseIndex const *const nextUseIndex = GetSolverTraceNextUseIndex(scenario);
+    size_t const numberCount = nextUseIndex == nullptr ? 0 : MLRA_GetValueCountInNextUseIndex(nextUseIndex);
+    uint32_t *numbers = nextUseIndex == nullptr ? nullptr : malloc((numberCount == 0 ? 1 : numberCount) * sizeof(uint32_t));
+    MLRA_VirtualRegisterMap *map = nextUseIndex == nullptr ? MLRA_CreateVirtualRegisterMap() : nullptr;
+    bool const filled = trace->values != nullptr && trace->nextReferences != nullptr && trace->isStore != nullptr
+        && trace->liveAfter != nullptr
+        && (
+            nextUseIndex == nullptr
+                ? map != nullptr && FillSolverTraceValues(trace, scenario, map)
+                : numbers != nullptr && FillSolverTraceValuesFromIndex(trace, scenario, nextUseIndex, numbers)
+        );
+    MLRA_DestroyVirtualRegisterMap(map);
+    if (!filled) {
+        free(numbers);
+        ReleaseSolverTraceArrays(trace);
+        free(trace);
+        return nullptr;
+    }
+
+    /* The numbers of the index cover at least every value of the trace, so they make room for the linking too. */
+    uint32_t *lastReferences = numbers != nullptr
+        ? numbers
+        : malloc((trace->valueCount == 0 ? 1 : trace->valueCount) * sizeof(uint32_t));
+    if (lastReferences == nullptr) {
+        ReleaseSolverTraceArrays(trace);
+        free(trace);
+        return nullptr;
+    }
+
+    LinkSolverTraceReferences(trace, lastReferences);
+    free(lastReferences);
+
+    return trace;
+}
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroySolverTrace, 1)]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_write, 2)]]
+MLRA_SolverTrace *MLRA_CreateSolverTraceInWorkspace(
+    MLRA_Scenario const *const scenario,
+    MLRA_SolverWorkspace *const workspace
+)
+{
+    size_t const count = MLRA_GetRegisterInstructionCountInScenario(scenario);
+    if (count >= MLRA_SolverTrace_NoReference) {
+        return nullptr;
+    }
+
+    MLRA_SolverTrace *trace = malloc(sizeof(MLRA_SolverTrace));
+    if (trace == nullptr) {
+        return nullptr;
+    }
+
+    size_t const allocationCount = count == 0 ? 1 : count;
+    trace->count = count;
+    trace->valueCount = 0;
+    trace->ownsArrays = false;
+    trace->values = MLRA_ReserveBufferInSolverWorkspace(
+        workspace, MLRA_SolverWorkspaceBuffer_TraceValues, allocationCount * sizeof(int32_t)
+    );
+    trace->nextReferences = MLRA_ReserveBufferInSolverWorkspace(
+        workspace, MLRA_SolverWorkspaceBuffer_TraceNextReferences, allocationCount * sizeof(uint32_t)
+    );
+    trace->isStore = MLRA_ReserveBufferInSolverWorkspace(
+        workspace, MLRA_SolverWorkspaceBuffer_TraceStoreFlags, allocationCount * sizeof(bool)
+    );
+    trace->liveAfter = MLRA_ReserveBufferInSolverWorkspace(
+        workspace, MLRA_SolverWorkspaceBuffer_TraceLiveAfterFlags, allocationCount * sizeof(bool)
+    );
+
+    MLRA_NextUseIndex const *const nextUseIndex = GetSolverTraceNextUseIndex(scenario);
+    bool filled = trace->values != nullptr && trace->nextReferences != nullptr && trace->isStore != nullptr
+        && trace->liveAfter != nullptr;
+    if (filled && nextUseIndex != nullptr) {
+        size_t const numberCount = MLRA_GetValueCountInNextUseIndex(nextUseIndex);
+        uint32_t *const numbers = MLRA_ReserveBufferInSolverWorkspace(
+            workspace,
+            MLRA_SolverWorkspaceBuffer_TraceLastReferences,
+            (numberCount == 0 ? 1 : numberCount) * sizeof(uint32_t)
+        );
+        filled = numbers != nullptr && FillSolverTraceValuesFromIndex(trace, scenario, nextUseIndex, numbers);
+    }
+    else if (filled) {
+        MLRA_VirtualRegisterMap *const map = MLRA_GetVirtualRegisterMapInSolverWorkspace(workspace);
+        filled = map != nullptr && FillSolverTraceValues(trace, scenario, map);
+    }
+    if (!filled) {
+        free(trace);
+        return nullptr;
+    }
+
+    uint32_t *lastReferences = MLRA_ReserveBufferInSolverWorkspace(
+        workspace,
+        MLRA_SolverWorkspaceBuffer_TraceLastReferences,
+        (trace->valueCount == 0 ? 1 : trace->valueCount) * sizeof(uint32_t)
+    );
+    if (lastReferences == nullptr) {
+        free(trace);
+        return nullptr;
+    }
+
+    LinkSolverTraceReferences(trace, lastReferences);
+
+    return trace;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetInstructionCountInSolverTrace(
+    MLRA_SolverTrace const *const trace
+)
+{
+    return trace->count;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetValueCountInSolverTrace(
+    MLRA_SolverTrace const *const trace
+)
+{
+    return trace->valueCount;
+}
+
+[[nodiscard, gnu::pure, gnu::returns_nonnull]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+int32_t const *MLRA_GetValuesInSolverTrace(
+    MLRA_SolverTrace const *const trace
+)
+{
+    return trace->values;
+}
+
+[[nodiscard, gnu::pure, gnu::returns_nonnull]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+uint32_t const *MLRA_GetNextReferencesInSolverTrace(
+    MLRA_SolverTrace const *const trace
+)
+{
+    return trace->nextReferences;
+}
+
+[[nodiscard, gnu::pure, gnu::returns_nonnull]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+bool const *MLRA_GetStoreFlagsInSolverTrace(
+    MLRA_SolverTrace const *const trace
+)
+{
+    return trace->isStore;
+}
+
+[[nodiscard, gnu::pure, gnu::returns_nonnull]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+bool const *MLRA_GetLiveAfterFlagsInSolverTrace(
+    MLRA_SolverTrace const *const trace
+)
+{
+    return trace->liveAfter;
+}
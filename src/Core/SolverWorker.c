@@ -0,0 +1,375 @@
+#include "MLRA/Core/SolverWorker.h"
+#include "MLRA/Core/BeladySolver.h"
+#include "MLRA/Core/LowerBound.h"
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/Solution.h"
+#include "MLRA/Core/SolutionSummary.h"
+#include "MLRA/Core/Solver.h"
+#include "MLRA/Core/SolverWorkspace.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+ * The status word packs the job number, its state and its progress, so that readers always see the three of them
+ * from the same update.
+ */
+static constexpr uint64_t StatusProgressMask = 0xFFFF;
+static constexpr uint64_t StatusStateShift = 16;
+static constexpr uint64_t StatusStateMask = 0x3;
+static constexpr uint64_t StatusJobShift = 18;
+
+typedef struct
+{
+    uint64_t job;
+    MLRA_SolverWorkerSolution content;
+} PublishedSolution;
+
+struct MLRA_SolverWorker_
+{
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;
+    MLRA_ScenarioSnapshot *pending;
+    uint64_t pendingJob;
+    bool stopping;
+    _Atomic uint64_t latestJob;
+    _Atomic uint64_t status;
+    _Atomic(PublishedSolution *) published;
+    MLRA_IncrementalSolver *solver;
+    MLRA_SolverWorkspace *workspace;
+    uint64_t runningJob;
+};
+
+[[gnu::const]]
+static uint64_t PackSolverWorkerStatus(
+    uint64_t const job,
+    MLRA_SolverWorkerState const state,
+    double const progress
+)
+{
+    double const clamped = progress < 0.0 ? 0.0 : progress > 1.0 ? 1.0 : progress;
+    uint64_t const scaled = (uint64_t)(clamped * (double)StatusProgressMask + 0.5);
+
+    return (job << StatusJobShift) | ((uint64_t)state << StatusStateShift) | scaled;
+}
+
+/*
+ * Updates the status of job unless a newer job has been submitted or the worker was cancelled in the meantime.
+ */
+[[gnu::nonnull(1)]]
+static void PublishSolverWorkerStatus(
+    MLRA_SolverWorker *const worker,
+    uint64_t const job,
+    MLRA_SolverWorkerState const state,
+    double const progress
+)
+{
+    uint64_t const desired = PackSolverWorkerStatus(job, state, progress);
+    uint64_t expected = atomic_load_explicit(&worker->status, memory_order_relaxed);
+    while (
+        expected >> StatusJobShift == job
+        && !atomic_compare_exchange_weak_explicit(
+            &worker->status, &expected, desired, memory_order_release, memory_order_relaxed
+        )
+    ) {
+    }
+}
+
+static void DestroyPublishedSolution(
+    PublishedSolution *const published
+)
+{
+    if (published == nullptr) {
+        return;
+    }
+
+    MLRA_DestroySolutionSummary(published->content.summary);
+    MLRA_DestroySolution(published->content.solution);
+    free(published);
+}
+
+/*
+ * Summarizes the solution of content off the UI thread and replaces the solution waiting to be taken with it. Taking
+ * ownership of the node through the exchange is what makes the channel safe without a lock: each node belongs either to
+ * the slot, or to the single thread that removed it.
+ */
+[[gnu::nonnull(1, 3)]]
+static void PublishSolverWorkerSolution(
+    MLRA_SolverWorker *const worker,
+    uint64_t const job,
+    MLRA_SolverWorkerSolution const *const content
+)
+{
+    PublishedSolution *const published = malloc(sizeof(PublishedSolution));
+    if (published == nullptr || atomic_load_explicit(&worker->latestJob, memory_order_relaxed) != job) {
+        free(published);
+        MLRA_DestroySolution(content->solution);
+        return;
+    }
+
+    *published = (PublishedSolution){
+        .job = job,
+        .content = *content
+    };
+    published->content.summary = MLRA_CreateSolutionSummary(content->solution);
+    DestroyPublishedSolution(atomic_exchange_explicit(&worker->published, published, memory_order_acq_rel));
+}
+
+/*
+ * Cancels the Belady solve of a job that was superseded or cancelled, without reporting its progress.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1)]]
+static bool CheckSolverWorkerJob(
+    void *const context,
+    [[maybe_unused]] size_t const completed,
+    [[maybe_unused]] size_t const total
+)
+{
+    MLRA_SolverWorker const *const worker = context;
+
+    return atomic_load_explicit(&worker->latestJob, memory_order_relaxed) == worker->runningJob;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1)]]
+static bool ReportSolverWorkerProgress(
+    void *const context,
+    size_t const completed,
+    size_t const total
+)
+{
+    MLRA_SolverWorker *const worker = context;
+    if (atomic_load_explicit(&worker->latestJob, memory_order_relaxed) != worker->runningJob) {
+        return false;
+    }
+
+    PublishSolverWorkerStatus(
+        worker,
+        worker->runningJob,
+        MLRA_SolverWorkerState_Running,
+        total == 0 ? 1.0 : (double)completed / (double)total
+    );
+
+    return true;
+}
+
+[[gnu::nonnull(1, 2)]]
+static void RunSolverWorkerJob(
+    MLRA_SolverWorker *const worker,
+    MLRA_ScenarioSnapshot const *const snapshot,
+    uint64_t const job
+)
+{
+    MLRA_Scenario const *const scenario = MLRA_GetScenarioInSnapshot(snapshot);
+    worker->runningJob = job;
+
+    MLRA_SolverWorkerSolution content = {0};
+    content.lowerBoundKnown = MLRA_ComputeLowerBoundOfScenario(scenario, &content.lowerBound);
+
+    content.solution = MLRA_SolveScenarioWithBeladyInWorkspace(scenario, worker->workspace);
+    if (content.solution != nullptr) {
+        PublishSolverWorkerSolution(worker, job, &content);
+    }
+
+    if (atomic_load_explicit(&worker->latestJob, memory_order_relaxed) != job) {
+        return;
+    }
+
+    content.solution = MLRA_SolveScenarioIncrementally(worker->solver, scenario);
+    if (content.solution == nullptr) {
+        PublishSolverWorkerStatus(worker, job, MLRA_SolverWorkerState_Failed, 0.0);
+        return;
+    }
+
+    content.final = true;
+    PublishSolverWorkerSolution(worker, job, &content);
+    PublishSolverWorkerStatus(worker, job, MLRA_SolverWorkerState_Finished, 1.0);
+}
+
+[[gnu::nonnull(1)]]
+static void *RunSolverWorker(
+    void *const argument
+)
+{
+    MLRA_SolverWorker *const worker = argument;
+
+    for (;;) {
+        pthread_mutex_lock(&worker->mutex);
+        while (!worker->stopping && worker->pending == nullptr) {
+            pthread_cond_wait(&worker->wake, &worker->mutex);
+        }
+        if (worker->stopping) {
+            pthread_mutex_unlock(&worker->mutex);
+            return nullptr;
+        }
+
+        MLRA_ScenarioSnapshot *const snapshot = worker->pending;
+        uint64_t const job = worker->pendingJob;
+        worker->pending = nullptr;
+        pthread_mutex_unlock(&worker->mutex);
+
+        RunSolverWorkerJob(worker, snapshot, job);
+        MLRA_DestroyScenarioSnapshot(snapshot);
+    }
+}
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroySolverWorker(
+    MLRA_SolverWorker *const worker
+)
+{
+    if (worker == nullptr) {
+        return;
+    }
+
+    pthread_mutex_lock(&worker->mutex);
+    worker->stopping = true;
+    atomic_fetch_add_explicit(&worker->latestJob, 1, memory_order_relaxed);
+    pthread_cond_signal(&worker->wake);
+    pthread_mutex_unlock(&worker->mutex);
+    pthread_join(worker->thread, nullptr);
+
+    MLRA_DestroyScenarioSnapshot(worker->pending);
+    DestroyPublishedSolution(atomic_load_explicit(&worker->published, memory_order_acquire));
+    MLRA_DestroySolverWorkspace(worker->workspace);
+    MLRA_DestroyIncrementalSolver(worker->solver);
+    pthread_cond_destroy(&worker->wake);
+    pthread_mutex_destroy(&worker->mutex);
+    free(worker);
+}
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroySolverWorker, 1)]]
+MLRA_SolverWorker *MLRA_CreateSolverWorker(void)
+{
+    MLRA_SolverWorker *const worker = malloc(sizeof(MLRA_SolverWorker));
+    if (worker == nullptr) {
+        return nullptr;
+    }
+
+    *worker = (MLRA_SolverWorker){
+        .solver = MLRA_CreateIncrementalSolver(0),
+        .workspace = MLRA_CreateSolverWorkspace()
+    };
+    atomic_init(&worker->latestJob, 0);
+    atomic_init(&worker->status, PackSolverWorkerStatus(0, MLRA_SolverWorkerState_Idle, 0.0));
+    atomic_init(&worker->published, nullptr);
+
+    if (worker->solver == nullptr || worker->workspace == nullptr) {
+        MLRA_DestroySolverWorkspace(worker->workspace);
+        MLRA_DestroyIncrementalSolver(worker->solver);
+        free(worker);
+        return nullptr;
+    }
+    MLRA_SetIncrementalSolverProgress(worker->solver, ReportSolverWorkerProgress, worker);
+    MLRA_SetSolverWorkspaceProgress(worker->workspace, CheckSolverWorkerJob, worker);
+
+    if (pthread_mutex_init(&worker->mutex, nullptr) != 0) {
+        MLRA_DestroySolverWorkspace(worker->workspace);
+        MLRA_DestroyIncrementalSolver(worker->solver);
+        free(worker);
+        return nullptr;
+    }
+    if (pthread_cond_init(&worker->wake, nullptr) != 0) {
+        pthread_mutex_destroy(&worker->mutex);
+        MLRA_DestroySolverWorkspace(worker->workspace);
+        MLRA_DestroyIncrementalSolver(worker->solver);
+        free(worker);
+        return nullptr;
+    }
+    if (pthread_create(&worker->thread, nullptr, RunSolverWorker, worker) != 0) {
+        pthread_cond_destroy(&worker->wake);
+        pthread_mutex_destroy(&worker->mutex);
+        MLRA_DestroySolverWorkspace(worker->workspace);
+        MLRA_DestroyIncrementalSolver(worker->solver);
+        free(worker);
+        return nullptr;
+    }
+
+    return worker;
+}
+
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(read_write, 2)]]
+uint64_t MLRA_SubmitScenarioToSolverWorker(
+    MLRA_SolverWorker *const worker,
+    MLRA_ScenarioSnapshot *const snapshot
+)
+{
+    pthread_mutex_lock(&worker->mutex);
+    MLRA_ScenarioSnapshot *const replaced = worker->pending;
+    uint64_t const job = atomic_load_explicit(&worker->latestJob, memory_order_relaxed) + 1;
+    worker->pending = snapshot;
+    worker->pendingJob = job;
+    atomic_store_explicit(&worker->latestJob, job, memory_order_relaxed);
+    atomic_store_explicit(
+        &worker->status, PackSolverWorkerStatus(job, MLRA_SolverWorkerState_Running, 0.0), memory_order_release
+    );
+    pthread_cond_signal(&worker->wake);
+    pthread_mutex_unlock(&worker->mutex);
+
+    MLRA_DestroyScenarioSnapshot(replaced);
+
+    return job;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void MLRA_CancelSolverWorker(
+    MLRA_SolverWorker *const worker
+)
+{
+    pthread_mutex_lock(&worker->mutex);
+    MLRA_ScenarioSnapshot *const replaced = worker->pending;
+    uint64_t const job = atomic_load_explicit(&worker->latestJob, memory_order_relaxed) + 1;
+    worker->pending = nullptr;
+    atomic_store_explicit(&worker->latestJob, job, memory_order_relaxed);
+    atomic_store_explicit(
+        &worker->status, PackSolverWorkerStatus(job, MLRA_SolverWorkerState_Idle, 0.0), memory_order_release
+    );
+    pthread_mutex_unlock(&worker->mutex);
+
+    MLRA_DestroyScenarioSnapshot(replaced);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+MLRA_SolverWorkerProgress MLRA_GetProgressInSolverWorker(
+    MLRA_SolverWorker const *const worker
+)
+{
+    uint64_t const status = atomic_load_explicit(&worker->status, memory_order_acquire);
+
+    return (MLRA_SolverWorkerProgress){
+        .job = status >> StatusJobShift,
+        .state = (MLRA_SolverWorkerState)((status >> StatusStateShift) & StatusStateMask),
+        .progress = (double)(status & StatusProgressMask) / (double)StatusProgressMask
+    };
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(write_only, 2)]]
+bool MLRA_TakeSolutionFromSolverWorker(
+    MLRA_SolverWorker *const worker,
+    MLRA_SolverWorkerSolution *const taken
+)
+{
+    *taken = (MLRA_SolverWorkerSolution){0};
+
+    PublishedSolution *const published = atomic_exchange_explicit(&worker->published, nullptr, memory_order_acq_rel);
+    if (published == nullptr) {
+        return false;
+    }
+    if (published->job != atomic_load_explicit(&worker->latestJob, memory_order_relaxed)) {
+        DestroyPublishedSolution(published);
+        return false;
+    }
+
+    *taken = published->content;
+    free(published);
+
+    return true;
+}
@@ -0,0 +1,136 @@
+#include "MLRA/Core/SolverWorkspace.h"
+#include "MLRA/Core/Solver.h"
+#include "MLRA/Core/VirtualRegisterMap.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+typedef struct
+{
+    void *data;
+    size_t size;
+} WorkspaceBuffer;
+
+struct MLRA_SolverWorkspace_
+{
+    WorkspaceBuffer buffers[MLRA_SolverWorkspaceBuffer_Count];
+    MLRA_VirtualRegisterMap *map;
+    MLRA_SolverProgress progress;
+    void *progressContext;
+};
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroySolverWorkspace(
+    MLRA_SolverWorkspace *const workspace
+)
+{
+    if (workspace == nullptr) {
+        return;
+    }
+
+    for (size_t index = 0; index < MLRA_SolverWorkspaceBuffer_Count; ++index) {
+        free(workspace->buffers[index].data);
+    }
+    MLRA_DestroyVirtualRegisterMap(workspace->map);
+    free(workspace);
+}
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroySolverWorkspace, 1)]]
+MLRA_SolverWorkspace *MLRA_CreateSolverWorkspace(void)
+{
+    MLRA_SolverWorkspace *workspace = calloc(1, sizeof(MLRA_SolverWorkspace));
+    if (workspace == nullptr) {
+        return nullptr;
+    }
+
+    return workspace;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void MLRA_SetSolverWorkspaceProgress(
+    MLRA_SolverWorkspace *const workspace,
+    MLRA_SolverProgress const progress,
+    void *const context
+)
+{
+    workspace->progress = progress;
+    workspace->progressContext = context;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+bool MLRA_ReportProgressInSolverWorkspace(
+    MLRA_SolverWorkspace const *const workspace,
+    size_t const completed,
+    size_t const total
+)
+{
+    return workspace->progress == nullptr || workspace->progress(workspace->progressContext, completed, total);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void *MLRA_ReserveBufferInSolverWorkspace(
+    MLRA_SolverWorkspace *const workspace,
+    size_t const buffer,
+    size_t const size
+)
+{
+    assert(buffer < MLRA_SolverWorkspaceBuffer_Count);
+
+    WorkspaceBuffer *const entry = &workspace->buffers[buffer];
+    if (size <= entry->size && entry->data != nullptr) {
+        return entry->data;
+    }
+
+    size_t newSize = entry->size == 0 ? 64 : entry->size;
+    while (newSize < size) {
+        if (__builtin_mul_overflow(newSize, 2, &newSize)) {
+            newSize = size;
+            break;
+        }
+    }
+
+    void *data = malloc(newSize);
+    if (data == nullptr) {
+        return nullptr;
+    }
+
+    free(entry->data);
+    entry->data = data;
+    entry->size = newSize;
+
+    return data;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+MLRA_VirtualRegisterMap *MLRA_GetVirtualRegisterMapInSolverWorkspace(
+    MLRA_SolverWorkspace *const workspace
+)
+{
+    if (workspace->map == nullptr) {
+        workspace->map = MLRA_CreateVirtualRegisterMap();
+        return workspace->map;
+    }
+
+    MLRA_ClearVirtualRegisterMap(workspace->map);
+
+    return workspace->map;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetReservedSizeInSolverWorkspace(
+    MLRA_SolverWorkspace const *const workspace
+)
+{
+    size_t size = 0;
+    for (size_t index = 0; index < MLRA_SolverWorkspaceBuffer_Count; ++index) {
+        size += workspace->buffers[index].size;
+    }
+
+    return size;
+}
@@ -0,0 +1,356 @@
+#include "MLRA/Core/TraceParser.h"
+#include "MLRA/Core/FileMapping.h"
+#include "MLRA/Core/Platform.h"
+#include "MLRA/Core/RegisterInstruction.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__);
+
+static constexpr size_t TraceChunkMinimumSize = 1 << 20;
+static constexpr uint64_t TraceDigitBias = UINT64_C(0x3030303030303030);
+static constexpr uint64_t TraceHighNibbles = UINT64_C(0xF0F0F0F0F0F0F0F0);
+static constexpr uint64_t TraceDigitCeiling = UINT64_C(0x0606060606060606);
+static constexpr uint64_t TraceBlankWord = UINT64_C(0x2020202020202020);
+static constexpr uint64_t TracePowersOfTen[9] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+
+typedef struct
+{
+    char const *begin;
+    char const *end;
+    int32_t *virtualRegisterIds;
+    uint64_t *storeBits;
+    size_t count;
+    size_t lineCount;
+    size_t errorLine;
+    bool allocated;
+} TraceChunk;
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1, 2)]]
+static uint64_t LoadTraceWord(
+    char const *const cursor,
+    char const *const end
+)
+{
+    uint64_t word = TraceBlankWord;
+    size_t const available = (size_t)(end - cursor);
+    if (available >= 8) {
+        memcpy(&word, cursor, 8);
+    }
+    else {
+        memcpy(&word, cursor, available);
+    }
+
+    return word;
+}
+
+[[gnu::const]]
+static size_t CountLeadingTraceDigits(
+    uint64_t const word
+)
+{
+    uint64_t const high = (word & TraceHighNibbles) ^ TraceDigitBias;
+    uint64_t const low = ((word + TraceDigitCeiling) & TraceHighNibbles) ^ TraceDigitBias;
+    uint64_t const nonDigits = high | low;
+
+    return nonDigits == 0 ? 8 : (size_t)__builtin_ctzll(nonDigits) / 8;
+}
+
+[[gnu::const]]
+static uint64_t ConvertTraceDigits(
+    uint64_t const word,
+    size_t const digitCount
+)
+{
+    assert(digitCount > 0 && digitCount <= 8);
+
+    uint64_t value = (word - TraceDigitBias) << (8 * (8 - digitCount));
+    value = value * 10 + (value >> 8);
+    value = (
+        (value & UINT64_C(0x000000FF000000FF)) * (100 + (UINT64_C(1000000) << 32))
+        + ((value >> 16) & UINT64_C(0x000000FF000000FF)) * (1 + (UINT64_C(10000) << 32))
+    ) >> 32;
+
+    return value;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2, 3), gnu::access(read_write, 1), gnu::access(write_only, 3)]]
+static bool ParseTraceNumber(
+    char const **const cursor,
+    char const *const end,
+    int32_t *const number
+)
+{
+    uint64_t value = 0;
+    size_t totalDigits = 0;
+
+    while (*cursor < end) {
+        uint64_t const word = LoadTraceWord(*cursor, end);
+        size_t const digitCount = CountLeadingTraceDigits(word);
+        if (digitCount == 0) {
+            break;
+        }
+
+        value = value * TracePowersOfTen[digitCount] + ConvertTraceDigits(word, digitCount);
+        totalDigits += digitCount;
+        *cursor += digitCount;
+        if (value > INT32_MAX) {
+            return false;
+        }
+        if (digitCount < 8) {
+            break;
+        }
+    }
+
+    *number = (int32_t)value;
+
+    return totalDigits > 0;
+}
+
+[[gnu::const]]
+static bool IsTraceBlank(
+    char const character
+)
+{
+    return character == ' ' || character == '\t' || character == '\r';
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void ParseTraceChunk(
+    TraceChunk *const chunk
+)
+{
+    char const *cursor = chunk->begin;
+    char const *const end = chunk->end;
+    size_t line = 0;
+
+    while (cursor < end) {
+        char const character = *cursor;
+        if (character == '\n') {
+            ++line;
+            ++cursor;
+            continue;
+        }
+        if (IsTraceBlank(character)) {
+            ++cursor;
+            continue;
+        }
+        if (character == '#') {
+            char const *const newline = memchr(cursor, '\n', (size_t)(end - cursor));
+            cursor = newline == nullptr ? end : newline;
+            continue;
+        }
+
+        bool isStore;
+        if (character == 'L' || character == 'l') {
+            isStore = false;
+        }
+        else if (character == 'S' || character == 's') {
+            isStore = true;
+        }
+        else {
+            chunk->errorLine = line + 1;
+            return;
+        }
+
+        ++cursor;
+        if (cursor == end || !IsTraceBlank(*cursor)) {
+            chunk->errorLine = line + 1;
+            return;
+        }
+        while (cursor < end && IsTraceBlank(*cursor)) {
+            ++cursor;
+        }
+        if (cursor < end && (*cursor == 'v' || *cursor == 'V')) {
+            ++cursor;
+        }
+
+        int32_t virtualRegisterId;
+        if (!ParseTraceNumber(&cursor, end, &virtualRegisterId)) {
+            chunk->errorLine = line + 1;
+            return;
+        }
+
+        while (cursor < end && IsTraceBlank(*cursor)) {
+            ++cursor;
+        }
+        if (cursor < end && *cursor != '\n' && *cursor != '#') {
+            chunk->errorLine = line + 1;
+            return;
+        }
+
+        size_t const index = chunk->count++;
+        uint64_t const mask = UINT64_C(1) << (index % 64);
+        if (index % 64 == 0) {
+            chunk->storeBits[index / 64] = 0;
+        }
+        if (isStore) {
+            chunk->storeBits[index / 64] |= mask;
+        }
+        chunk->virtualRegisterIds[index] = virtualRegisterId;
+    }
+
+    chunk->lineCount = line;
+}
+
+[[gnu::nonnull(1)]]
+static void *RunTraceChunk(
+    void *const argument
+)
+{
+    TraceChunk *const chunk = argument;
+    size_t const capacity = (size_t)(chunk->end - chunk->begin) / 4 + 1;
+
+    chunk->virtualRegisterIds = malloc(capacity * sizeof(int32_t));
+    chunk->storeBits = malloc((capacity / 64 + 1) * sizeof(uint64_t));
+    chunk->allocated = chunk->virtualRegisterIds != nullptr && chunk->storeBits != nullptr;
+    if (chunk->allocated) {
+        ParseTraceChunk(chunk);
+    }
+
+    return nullptr;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(read_only, 2, 3)]]
+bool MLRA_ParseTraceTextIntoList(
+    MLRA_RegisterInstructionList *const list,
+    char const *const text,
+    size_t const length,
+    size_t const threadCount,
+    MLRA_TraceParseReport *const report
+)
+{
+    double const startTime = MLRA_GetMonotonicTime();
+    char const *const end = text + length;
+
+    size_t chunkCount = threadCount == 0 ? MLRA_GetHardwareThreadCount() : threadCount;
+    if (chunkCount > length / TraceChunkMinimumSize) {
+        chunkCount = length / TraceChunkMinimumSize;
+    }
+    if (chunkCount == 0) {
+        chunkCount = 1;
+    }
+
+    TraceChunk *chunks = calloc(chunkCount, sizeof(TraceChunk));
+    pthread_t *threads = malloc(chunkCount * sizeof(pthread_t));
+    bool *started = calloc(chunkCount, sizeof(bool));
+    if (chunks == nullptr || threads == nullptr || started == nullptr) {
+        free(started);
+        free(threads);
+        free(chunks);
+        return false;
+    }
+
+    char const *begin = text;
+    for (size_t index = 0; index < chunkCount; ++index) {
+        char const *chunkEnd = end;
+        if (index + 1 < chunkCount) {
+            char const *const target = text + length / chunkCount * (index + 1);
+            char const *const newline = target < begin ? nullptr : memchr(target, '\n', (size_t)(end - target));
+            chunkEnd = target < begin ? begin : (newline == nullptr ? end : newline + 1);
+        }
+
+        chunks[index].begin = begin;
+        chunks[index].end = chunkEnd;
+        begin = chunkEnd;
+    }
+
+    for (size_t index = 1; index < chunkCount; ++index) {
+        started[index] = pthread_create(&threads[index], nullptr, RunTraceChunk, &chunks[index]) == 0;
+    }
+    RunTraceChunk(&chunks[0]);
+    for (size_t index = 1; index < chunkCount; ++index) {
+        if (started[index]) {
+            pthread_join(threads[index], nullptr);
+        }
+        else {
+            RunTraceChunk(&chunks[index]);
+        }
+    }
+
+    bool succeeded = true;
+    size_t errorLine = 0;
+    size_t lineOffset = 0;
+    size_t instructionCount = 0;
+    for (size_t index = 0; index < chunkCount && succeeded; ++index) {
+        if (!chunks[index].allocated) {
+            succeeded = false;
+        }
+        else if (chunks[index].errorLine != 0) {
+            errorLine = lineOffset + chunks[index].errorLine;
+            succeeded = false;
+        }
+
+        lineOffset += chunks[index].lineCount;
+        instructionCount += chunks[index].count;
+    }
+
+    succeeded = succeeded && MLRA_ReserveRegisterInstructionsInList(
+        list,
+        MLRA_GetRegisterInstructionCountInList(list) + instructionCount
+    );
+    for (size_t index = 0; index < chunkCount && succeeded; ++index) {
+        succeeded = MLRA_AppendRegisterInstructionSpanToList(
+            list,
+            chunks[index].virtualRegisterIds,
+            chunks[index].storeBits,
+            chunks[index].count
+        );
+    }
+
+    for (size_t index = 0; index < chunkCount; ++index) {
+        free(chunks[index].virtualRegisterIds);
+        free(chunks[index].storeBits);
+    }
+    free(started);
+    free(threads);
+    free(chunks);
+
+    if (report != nullptr) {
+        double const seconds = MLRA_GetMonotonicTime() - startTime;
+        report->byteCount = length;
+        report->instructionCount = succeeded ? instructionCount : 0;
+        report->threadCount = chunkCount;
+        report->errorLine = errorLine;
+        report->seconds = seconds;
+        report->megabytesPerSecond = seconds > 0.0 ? (double)length / seconds / 1e6 : 0.0;
+    }
+
+    return succeeded;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(read_only, 2)]]
+bool MLRA_ParseTraceFileIntoList(
+    MLRA_RegisterInstructionList *const list,
+    char const *const path,
+    size_t const threadCount,
+    MLRA_TraceParseReport *const report
+)
+{
+    MLRA_FileMapping *mapping = MLRA_CreateFileMapping(path);
+    if (mapping == nullptr) {
+        return false;
+    }
+
+    char const *const text = MLRA_GetFileMappingData(mapping);
+    bool const succeeded = MLRA_ParseTraceTextIntoList(
+        list,
+        text == nullptr ? "" : text,
+        MLRA_GetFileMappingSize(mapping),
+        threadCount,
+        report
+    );
+
+    MLRA_DestroyFileMapping(mapping);
+
+    return succeeded;
+}
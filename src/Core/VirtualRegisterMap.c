@@ -0,0 +1,200 @@
+#include "MLRA/Core/VirtualRegisterMap.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct MLRA_VirtualRegisterMap_
+{
+    int *virtualRegisterIds;
+    size_t *slots;
+    size_t count;
+    size_t capacity;
+    size_t slotCount;
+};
+
+[[gnu::const]]
+static size_t HashVirtualRegisterId(int const virtualRegisterId)
+{
+    uint64_t hash = (uint64_t)(uint32_t)virtualRegisterId;
+    hash *= 0x9E3779B97F4A7C15ULL;
+    hash ^= hash >> 29;
+
+    return (size_t)hash;
+}
+
+[[gnu::access(read_write, 1)]]
+void MLRA_DestroyVirtualRegisterMap(
+    MLRA_VirtualRegisterMap *const map
+)
+{
+    if (map == nullptr) {
+        return;
+    }
+
+    free(map->virtualRegisterIds);
+    free(map->slots);
+    free(map);
+}
+
+[[nodiscard]]
+[[gnu::malloc, gnu::malloc(MLRA_DestroyVirtualRegisterMap, 1)]]
+MLRA_VirtualRegisterMap *MLRA_CreateVirtualRegisterMap(void)
+{
+    MLRA_VirtualRegisterMap *map = malloc(sizeof(MLRA_VirtualRegisterMap));
+    if (map == nullptr) {
+        return nullptr;
+    }
+
+    map->virtualRegisterIds = nullptr;
+    map->slots = nullptr;
+    map->count = 0;
+    map->capacity = 0;
+    map->slotCount = 0;
+
+    return map;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+void MLRA_ClearVirtualRegisterMap(
+    MLRA_VirtualRegisterMap *const map
+)
+{
+    if (map->count == 0) {
+        return;
+    }
+
+    if (map->count * 4 >= map->slotCount) {
+        memset(map->slots, 0, map->slotCount * sizeof(size_t));
+        map->count = 0;
+        return;
+    }
+
+    size_t const mask = map->slotCount - 1;
+    for (size_t index = 0; index < map->count; ++index) {
+        size_t slot = HashVirtualRegisterId(map->virtualRegisterIds[index]) & mask;
+        while (map->slots[slot] != index + 1) {
+            slot = (slot + 1) & mask;
+        }
+        map->slots[slot] = 0;
+    }
+    map->count = 0;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_GetVirtualRegisterCountInMap(
+    MLRA_VirtualRegisterMap const *const map
+)
+{
+    return map->count;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+size_t MLRA_FindVirtualRegisterInMap(
+    MLRA_VirtualRegisterMap const *const map,
+    int const virtualRegisterId
+)
+{
+    if (map->slotCount == 0) {
+        return SIZE_MAX;
+    }
+
+    size_t const mask = map->slotCount - 1;
+    for (size_t slot = HashVirtualRegisterId(virtualRegisterId) & mask;; slot = (slot + 1) & mask) {
+        size_t const entry = map->slots[slot];
+        if (entry == 0) {
+            return SIZE_MAX;
+        }
+        if (map->virtualRegisterIds[entry - 1] == virtualRegisterId) {
+            return entry - 1;
+        }
+    }
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static bool GrowVirtualRegisterMap(
+    MLRA_VirtualRegisterMap *const map
+)
+{
+    size_t newCapacity = map->capacity == 0 ? 64 : map->capacity * 2;
+    size_t idsSize;
+    size_t slotsSize;
+    if (
+        __builtin_mul_overflow(newCapacity, sizeof(int), &idsSize)
+        || __builtin_mul_overflow(newCapacity * 2, sizeof(size_t), &slotsSize)
+    ) {
+        return false;
+    }
+
+    int *virtualRegisterIds = realloc(map->virtualRegisterIds, idsSize);
+    if (virtualRegisterIds == nullptr) {
+        return false;
+    }
+    map->virtualRegisterIds = virtualRegisterIds;
+
+    size_t *slots = calloc(newCapacity * 2, sizeof(size_t));
+    if (slots == nullptr) {
+        return false;
+    }
+
+    size_t const mask = newCapacity * 2 - 1;
+    for (size_t index = 0; index < map->count; ++index) {
+        size_t slot = HashVirtualRegisterId(map->virtualRegisterIds[index]) & mask;
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = index + 1;
+    }
+
+    free(map->slots);
+    map->slots = slots;
+    map->slotCount = newCapacity * 2;
+    map->capacity = newCapacity;
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+size_t MLRA_AddVirtualRegisterToMap(
+    MLRA_VirtualRegisterMap *const map,
+    int const virtualRegisterId
+)
+{
+    size_t const existing = MLRA_FindVirtualRegisterInMap(map, virtualRegisterId);
+    if (existing != SIZE_MAX) {
+        return existing;
+    }
+
+    if (map->count == map->capacity && !GrowVirtualRegisterMap(map)) {
+        return SIZE_MAX;
+    }
+
+    size_t const mask = map->slotCount - 1;
+    size_t slot = HashVirtualRegisterId(virtualRegisterId) & mask;
+    while (map->slots[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+
+    map->virtualRegisterIds[map->count] = virtualRegisterId;
+    map->slots[slot] = ++map->count;
+
+    return map->count - 1;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+int MLRA_GetVirtualRegisterInMap(
+    MLRA_VirtualRegisterMap const *const map,
+    size_t const denseIndex
+)
+{
+    assert(denseIndex < map->count);
+
+    return map->virtualRegisterIds[denseIndex];
+}
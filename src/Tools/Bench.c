@@ -0,0 +1,951 @@
+#include "MLRA/Core/BeladySolver.h"
+#include "MLRA/Core/FlowSolver.h"
+#include "MLRA/Core/Platform.h"
+#include "MLRA/Core/RegisterCost.h"
+#include "MLRA/Core/RegisterInstruction.h"
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/Solution.h"
+#include "MLRA/Core/Solver.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef MLRA_Solution *(*SolveFunction)(MLRA_Scenario const *scenario);
+
+typedef struct
+{
+    uint64_t state;
+} BenchRandom;
+
+typedef struct
+{
+    int32_t *virtualRegisterIds;
+    uint64_t *storeBits;
+    size_t count;
+    size_t capacity;
+} TraceChunk;
+
+typedef struct
+{
+    double *cumulativeWeights;
+    size_t count;
+} ZipfTable;
+
+typedef bool (*GenerateFunction)(
+    MLRA_RegisterInstructionList *list,
+    size_t count,
+    BenchRandom *random
+);
+
+typedef struct
+{
+    char const *name;
+    GenerateFunction generate;
+} GeneratorEntry;
+
+typedef struct
+{
+    char const *name;
+    SolveFunction solve;
+    size_t maxRegisterCount;
+} SolverEntry;
+
+typedef struct
+{
+    char const *generatorName;
+    SolverEntry const *solver;
+    size_t maxInstructionCount;
+    size_t maxRegisterCount;
+    uint64_t seed;
+    double minimumSeconds;
+    bool runListBenchmarks;
+} BenchOptions;
+
+static constexpr size_t TraceChunkCapacity = 1 << 16;
+static constexpr size_t ZipfValueCount = 1 << 16;
+static constexpr double ZipfExponent = 1.1;
+static constexpr size_t LoopBodyLength = 64;
+static constexpr size_t LoopValueCount = 40;
+static constexpr size_t LoopIterationsPerNest = 256;
+static constexpr size_t StreamingReuseDistance = 4;
+static constexpr size_t PhaseCount = 8;
+static constexpr size_t EditSpanLength = 64;
+static constexpr size_t DefaultMaxInstructionCount = 1000000;
+static constexpr size_t DefaultMaxRegisterCount = 256;
+static constexpr size_t ExactMaxRegisterCount = 2;
+static constexpr size_t MaxRepetitionCount = 1000;
+static constexpr double DefaultMinimumSeconds = 0.05;
+static constexpr MLRA_RegisterCost BenchMemorySpillCost = {5, 5};
+
+static size_t const InstructionCounts[] = {
+    1000, 10000, 100000, 1000000, 10000000, 100000000
+};
+
+static size_t const RegisterCounts[] = {
+    2, 8, 32, 256
+};
+
+static size_t const PhaseWorkingSetSizes[] = {
+    4, 64, 16, 512, 8, 2048, 32, 128
+};
+
+static constexpr size_t PhaseWorkingSetSizeCount = sizeof(PhaseWorkingSetSizes) / sizeof(PhaseWorkingSetSizes[0]);
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static uint64_t NextBenchRandom(
+    BenchRandom *const random
+)
+{
+    uint64_t value = (random->state += 0x9E3779B97F4A7C15u);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9u;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBu;
+    return value ^ (value >> 31);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static size_t NextBenchRandomBelow(
+    BenchRandom *const random,
+    size_t const bound
+)
+{
+    /* Rejecting the lowest 2^64 mod bound values leaves a range that bound divides evenly. */
+    uint64_t const threshold = -(uint64_t)bound % bound;
+    uint64_t value;
+    do {
+        value = NextBenchRandom(random);
+    } while (value < threshold);
+
+    return (size_t)(value % bound);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static double NextBenchRandomUnit(
+    BenchRandom *const random
+)
+{
+    return (double)(NextBenchRandom(random) >> 11) * 0x1.0p-53;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void ReleaseTraceChunk(
+    TraceChunk *const chunk
+)
+{
+    free(chunk->virtualRegisterIds);
+    free(chunk->storeBits);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(write_only, 1)]]
+static bool InitializeTraceChunk(
+    TraceChunk *const chunk
+)
+{
+    *chunk = (TraceChunk){
+        .virtualRegisterIds = malloc(TraceChunkCapacity * sizeof(int32_t)),
+        .storeBits = malloc(TraceChunkCapacity / 64 * sizeof(uint64_t)),
+        .capacity = TraceChunkCapacity
+    };
+    if (chunk->virtualRegisterIds == nullptr || chunk->storeBits == nullptr) {
+        ReleaseTraceChunk(chunk);
+        return false;
+    }
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(read_write, 2)]]
+static bool FlushTraceChunk(
+    MLRA_RegisterInstructionList *const list,
+    TraceChunk *const chunk
+)
+{
+    bool const appended = MLRA_AppendRegisterInstructionSpanToList(
+        list,
+        chunk->virtualRegisterIds,
+        chunk->storeBits,
+        chunk->count
+    );
+    chunk->count = 0;
+
+    return appended;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(read_write, 2)]]
+static bool PushTraceInstruction(
+    MLRA_RegisterInstructionList *const list,
+    TraceChunk *const chunk,
+    int32_t const virtualRegisterId,
+    bool const isStore
+)
+{
+    size_t const index = chunk->count++;
+    uint64_t const bit = (uint64_t)1 << (index % 64);
+
+    chunk->virtualRegisterIds[index] = virtualRegisterId;
+    if (index % 64 == 0) {
+        chunk->storeBits[index / 64] = 0;
+    }
+    if (isStore) {
+        chunk->storeBits[index / 64] |= bit;
+    }
+
+    return chunk->count < chunk->capacity || FlushTraceChunk(list, chunk);
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void ReleaseZipfTable(
+    ZipfTable *const table
+)
+{
+    free(table->cumulativeWeights);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(write_only, 1)]]
+static bool InitializeZipfTable(
+    ZipfTable *const table,
+    size_t const count,
+    double const exponent
+)
+{
+    table->count = count;
+    table->cumulativeWeights = malloc(count * sizeof(double));
+    if (table->cumulativeWeights == nullptr) {
+        return false;
+    }
+
+    double total = 0.0;
+    for (size_t index = 0; index < count; ++index) {
+        total += 1.0 / pow((double)(index + 1), exponent);
+        table->cumulativeWeights[index] = total;
+    }
+    for (size_t index = 0; index < count; ++index) {
+        table->cumulativeWeights[index] /= total;
+    }
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_write, 2)]]
+static size_t SampleZipfTable(
+    ZipfTable const *const table,
+    BenchRandom *const random
+)
+{
+    double const target = NextBenchRandomUnit(random);
+    size_t low = 0;
+    size_t high = table->count - 1;
+
+    while (low < high) {
+        size_t const middle = low + (high - low) / 2;
+        if (table->cumulativeWeights[middle] < target) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_write, 1), gnu::access(read_write, 3)]]
+static bool GenerateZipfTrace(
+    MLRA_RegisterInstructionList *const list,
+    size_t const count,
+    BenchRandom *const random
+)
+{
+    ZipfTable table;
+    if (!InitializeZipfTable(&table, ZipfValueCount, ZipfExponent)) {
+        return false;
+    }
+
+    TraceChunk chunk;
+    if (!InitializeTraceChunk(&chunk)) {
+        ReleaseZipfTable(&table);
+        return false;
+    }
+
+    bool generated = true;
+    for (size_t index = 0; generated && index < count; ++index) {
+        int32_t const virtualRegisterId = (int32_t)SampleZipfTable(&table, random);
+        bool const isStore = NextBenchRandomBelow(random, 4) == 0;
+        generated = PushTraceInstruction(list, &chunk, virtualRegisterId, isStore);
+    }
+    generated = generated && FlushTraceChunk(list, &chunk);
+
+    ReleaseTraceChunk(&chunk);
+    ReleaseZipfTable(&table);
+
+    return generated;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_write, 1), gnu::access(read_write, 3)]]
+static bool GenerateLoopTrace(
+    MLRA_RegisterInstructionList *const list,
+    size_t const count,
+    BenchRandom *const random
+)
+{
+    TraceChunk chunk;
+    if (!InitializeTraceChunk(&chunk)) {
+        return false;
+    }
+
+    int32_t body[LoopBodyLength];
+    bool stores[LoopBodyLength];
+    int32_t base = 0;
+    bool generated = true;
+
+    for (size_t index = 0; generated && index < count; ++index) {
+        size_t const position = index % LoopBodyLength;
+        if (index % (LoopBodyLength * LoopIterationsPerNest) == 0) {
+            for (size_t slot = 0; slot < LoopBodyLength; ++slot) {
+                body[slot] = base + (int32_t)NextBenchRandomBelow(random, LoopValueCount);
+                stores[slot] = NextBenchRandomBelow(random, 8) == 0;
+            }
+            base += (int32_t)LoopValueCount;
+        }
+        generated = PushTraceInstruction(list, &chunk, body[position], stores[position]);
+    }
+    generated = generated && FlushTraceChunk(list, &chunk);
+
+    ReleaseTraceChunk(&chunk);
+
+    return generated;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_write, 1), gnu::access(read_write, 3)]]
+static bool GenerateStreamingTrace(
+    MLRA_RegisterInstructionList *const list,
+    size_t const count,
+    BenchRandom *const random
+)
+{
+    TraceChunk chunk;
+    if (!InitializeTraceChunk(&chunk)) {
+        return false;
+    }
+
+    int32_t nextVirtualRegisterId = 0;
+    bool generated = true;
+
+    for (size_t index = 0; generated && index < count; ++index) {
+        if (index % 2 == 0) {
+            generated = PushTraceInstruction(list, &chunk, nextVirtualRegisterId++, true);
+        }
+        else {
+            int32_t const distance = 1 + (int32_t)NextBenchRandomBelow(random, StreamingReuseDistance);
+            int32_t const virtualRegisterId = nextVirtualRegisterId > distance ? nextVirtualRegisterId - distance : 0;
+            generated = PushTraceInstruction(list, &chunk, virtualRegisterId, false);
+        }
+    }
+    generated = generated && FlushTraceChunk(list, &chunk);
+
+    ReleaseTraceChunk(&chunk);
+
+    return generated;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_write, 1), gnu::access(read_write, 3)]]
+static bool GeneratePhaseTrace(
+    MLRA_RegisterInstructionList *const list,
+    size_t const count,
+    BenchRandom *const random
+)
+{
+    TraceChunk chunk;
+    if (!InitializeTraceChunk(&chunk)) {
+        return false;
+    }
+
+    size_t const phaseLength = count / PhaseCount > LoopBodyLength ? count / PhaseCount : LoopBodyLength;
+    int32_t base = 0;
+    size_t workingSetSize = PhaseWorkingSetSizes[0];
+    bool generated = true;
+
+    for (size_t index = 0; generated && index < count; ++index) {
+        if (index % phaseLength == 0) {
+            size_t const phase = index / phaseLength;
+            base += (int32_t)workingSetSize;
+            workingSetSize = PhaseWorkingSetSizes[phase % PhaseWorkingSetSizeCount];
+        }
+        int32_t const virtualRegisterId = base + (int32_t)NextBenchRandomBelow(random, workingSetSize);
+        bool const isStore = NextBenchRandomBelow(random, 4) == 0;
+        generated = PushTraceInstruction(list, &chunk, virtualRegisterId, isStore);
+    }
+    generated = generated && FlushTraceChunk(list, &chunk);
+
+    ReleaseTraceChunk(&chunk);
+
+    return generated;
+}
+
+static GeneratorEntry const Generators[] = {
+    {"zipf", GenerateZipfTrace},
+    {"loops", GenerateLoopTrace},
+    {"streaming", GenerateStreamingTrace},
+    {"phases", GeneratePhaseTrace}
+};
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static MLRA_Solution *SolveScenarioExactlyOnAllThreads(
+    MLRA_Scenario const *const scenario
+)
+{
+    return MLRA_SolveScenarioExactlyInParallel(scenario, 0);
+}
+
+/*
+ * The states of the exact solvers grow exponentially with the register count. At 8 registers a single row of 1000
+ * zipf instructions runs for minutes, so they stop at 2 registers, where a row of a million instructions takes
+ * seconds to about a minute.
+ */
+static SolverEntry const Solvers[] = {
+    {"exact", MLRA_SolveScenarioExactly, ExactMaxRegisterCount},
+    {"exact-parallel", SolveScenarioExactlyOnAllThreads, ExactMaxRegisterCount},
+    {"flow", MLRA_SolveScenarioWithMinCostFlow, SIZE_MAX},
+    {"belady", MLRA_SolveScenarioWithBelady, SIZE_MAX}
+};
+
+static constexpr size_t GeneratorCount = sizeof(Generators) / sizeof(Generators[0]);
+static constexpr size_t SolverCount = sizeof(Solvers) / sizeof(Solvers[0]);
+static constexpr size_t InstructionCountCount = sizeof(InstructionCounts) / sizeof(InstructionCounts[0]);
+static constexpr size_t RegisterCountCount = sizeof(RegisterCounts) / sizeof(RegisterCounts[0]);
+
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static void PrintUsage(
+    char const *const program
+)
+{
+    fprintf(
+        stderr,
+        "Usage: %s [options]\n"
+        "\n"
+        "Options:\n"
+        "  --solver <name>            Solver to run: exact, exact-parallel, flow or belady (default: belady).\n"
+        "                             flow and belady are heuristics; flow is optimal only when every register\n"
+        "                             has the same costs\n"
+        "  --generator <name>         Only run zipf, loops, streaming or phases\n"
+        "  --max-instructions <n>     Largest trace size to run (default: %zu)\n"
+        "  --max-registers <n>        Largest register count to run (default: %zu; at most %zu for exact and\n"
+        "                             exact-parallel, whose run time grows exponentially with it)\n"
+        "  --seed <n>                 Generator seed (default: 1)\n"
+        "  --min-time <seconds>       Minimum time per measurement (default: %.2f)\n"
+        "  --no-list                  Skip the instruction list micro-benchmarks\n",
+        program,
+        DefaultMaxInstructionCount,
+        DefaultMaxRegisterCount,
+        ExactMaxRegisterCount,
+        DefaultMinimumSeconds
+    );
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(write_only, 2)]]
+static bool ParseSizeArgument(
+    char const *const text,
+    size_t *const value
+)
+{
+    char *end;
+    errno = 0;
+    unsigned long long const result = strtoull(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0' || text[0] == '-' || result > SIZE_MAX) {
+        return false;
+    }
+
+    *value = (size_t)result;
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(write_only, 2)]]
+static bool ParseSecondsArgument(
+    char const *const text,
+    double *const value
+)
+{
+    char *end;
+    errno = 0;
+    double const result = strtod(text, &end);
+    if (errno != 0 || end == text || *end != '\0' || !(result >= 0.0)) {
+        return false;
+    }
+
+    *value = result;
+
+    return true;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static SolverEntry const *FindSolver(
+    char const *const name
+)
+{
+    for (size_t index = 0; index < SolverCount; ++index) {
+        if (strcmp(Solvers[index].name, name) == 0) {
+            return &Solvers[index];
+        }
+    }
+
+    return nullptr;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static bool HasGenerator(
+    char const *const name
+)
+{
+    for (size_t index = 0; index < GeneratorCount; ++index) {
+        if (strcmp(Generators[index].name, name) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(2, 3), gnu::access(read_only, 2, 1), gnu::access(write_only, 3)]]
+static bool ParseBenchOptions(
+    int const argumentCount,
+    char **const arguments,
+    BenchOptions *const options
+)
+{
+    *options = (BenchOptions){
+        .solver = FindSolver("belady"),
+        .maxInstructionCount = DefaultMaxInstructionCount,
+        .maxRegisterCount = DefaultMaxRegisterCount,
+        .seed = 1,
+        .minimumSeconds = DefaultMinimumSeconds,
+        .runListBenchmarks = true
+    };
+
+    for (int index = 1; index < argumentCount; ++index) {
+        char const *const argument = arguments[index];
+        char const *const value = index + 1 < argumentCount ? arguments[index + 1] : nullptr;
+        bool valid = true;
+        size_t seed = 0;
+
+        if (strcmp(argument, "--no-list") == 0) {
+            options->runListBenchmarks = false;
+            continue;
+        }
+        if (value == nullptr) {
+            valid = false;
+        }
+        else if (strcmp(argument, "--solver") == 0) {
+            options->solver = FindSolver(value);
+            valid = options->solver != nullptr;
+        }
+        else if (strcmp(argument, "--generator") == 0) {
+            options->generatorName = value;
+            valid = HasGenerator(value);
+        }
+        else if (strcmp(argument, "--max-instructions") == 0) {
+            valid = ParseSizeArgument(value, &options->maxInstructionCount);
+        }
+        else if (strcmp(argument, "--max-registers") == 0) {
+            valid = ParseSizeArgument(value, &options->maxRegisterCount);
+        }
+        else if (strcmp(argument, "--seed") == 0) {
+            valid = ParseSizeArgument(value, &seed);
+            options->seed = seed;
+        }
+        else if (strcmp(argument, "--min-time") == 0) {
+            valid = ParseSecondsArgument(value, &options->minimumSeconds);
+        }
+        else {
+            valid = false;
+        }
+
+        if (!valid) {
+            fprintf(stderr, "Invalid argument: %s\n", argument);
+            return false;
+        }
+        ++index;
+    }
+
+    if (options->maxRegisterCount > options->solver->maxRegisterCount) {
+        fprintf(
+            stderr,
+            "Note: %s only runs up to %zu registers\n",
+            options->solver->name,
+            options->solver->maxRegisterCount
+        );
+        options->maxRegisterCount = options->solver->maxRegisterCount;
+    }
+
+    return true;
+}
+
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static void PrintJsonSeparator(
+    bool *const first
+)
+{
+    fputs(*first ? "\n" : ",\n", stdout);
+    *first = false;
+}
+
+/*
+ * Prints the peak resident memory since the reset that measured is the result of. Where the platform cannot reset the
+ * peak, it prints null rather than the peak of the whole process, which would only repeat the largest row so far.
+ */
+static void PrintPeakResidentMemory(
+    bool const measured
+)
+{
+    if (measured) {
+        printf("%zu", MLRA_GetPeakResidentMemory());
+    }
+    else {
+        fputs("null", stdout);
+    }
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2, 3), gnu::access(read_only, 1), gnu::access(read_only, 2), gnu::access(read_write, 4)]]
+static bool RunSolverBenchmark(
+    BenchOptions const *const options,
+    GeneratorEntry const *const generator,
+    MLRA_Scenario *const scenario,
+    bool *const first
+)
+{
+    size_t const instructionCount = MLRA_GetRegisterInstructionCountInScenario(scenario);
+
+    for (size_t registerIndex = 0; registerIndex < RegisterCountCount; ++registerIndex) {
+        size_t const registerCount = RegisterCounts[registerIndex];
+        if (registerCount > options->maxRegisterCount) {
+            break;
+        }
+
+        MLRA_SetRegisterCountInScenario(scenario, registerCount);
+
+        double bestSeconds = INFINITY;
+        double totalSeconds = 0.0;
+        int64_t cost = 0;
+        size_t repetitionCount = 0;
+        bool const peakMeasured = MLRA_ResetPeakResidentMemory();
+
+        do {
+            double const startTime = MLRA_GetMonotonicTime();
+            MLRA_Solution *solution = options->solver->solve(scenario);
+            double const seconds = MLRA_GetMonotonicTime() - startTime;
+            if (solution == nullptr) {
+                return false;
+            }
+
+            cost = MLRA_GetSolutionCost(solution);
+            MLRA_DestroySolution(solution);
+
+            bestSeconds = seconds < bestSeconds ? seconds : bestSeconds;
+            totalSeconds += seconds;
+            ++repetitionCount;
+        } while (totalSeconds < options->minimumSeconds && repetitionCount < MaxRepetitionCount);
+
+        double const nanosecondsPerInstruction = instructionCount == 0 ? 0.0 : bestSeconds * 1e9 / (double)instructionCount;
+
+        PrintJsonSeparator(first);
+        printf(
+            "    {\"generator\": \"%s\", \"solver\": \"%s\", \"instructions\": %zu, \"registers\": %zu, "
+            "\"cost\": %" PRId64 ", \"seconds\": %.9f, \"nsPerInstruction\": %.3f, \"repetitions\": %zu, "
+            "\"peakResidentBytes\": ",
+            generator->name,
+            options->solver->name,
+            instructionCount,
+            registerCount,
+            cost,
+            bestSeconds,
+            nanosecondsPerInstruction,
+            repetitionCount
+        );
+        PrintPeakResidentMemory(peakMeasured);
+        fputs("}", stdout);
+        fflush(stdout);
+    }
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_write, 2)]]
+static bool RunSolverBenchmarks(
+    BenchOptions const *const options,
+    bool *const first
+)
+{
+    for (size_t generatorIndex = 0; generatorIndex < GeneratorCount; ++generatorIndex) {
+        GeneratorEntry const *const generator = &Generators[generatorIndex];
+        if (options->generatorName != nullptr && strcmp(options->generatorName, generator->name) != 0) {
+            continue;
+        }
+
+        for (size_t countIndex = 0; countIndex < InstructionCountCount; ++countIndex) {
+            size_t const instructionCount = InstructionCounts[countIndex];
+            if (instructionCount > options->maxInstructionCount) {
+                break;
+            }
+
+            MLRA_RegisterInstructionList *list = MLRA_CreateRegisterInstructionList();
+            if (list == nullptr) {
+                return false;
+            }
+
+            BenchRandom random = {options->seed};
+            if (
+                !MLRA_ReserveRegisterInstructionsInList(list, instructionCount)
+                || !generator->generate(list, instructionCount, &random)
+            ) {
+                MLRA_DestroyRegisterInstructionList(list);
+                return false;
+            }
+
+            MLRA_Scenario *scenario = MLRA_CreateScenarioWithRegisterInstructionList(
+                RegisterCounts[0],
+                BenchMemorySpillCost,
+                list
+            );
+            if (scenario == nullptr) {
+                MLRA_DestroyRegisterInstructionList(list);
+                return false;
+            }
+
+            bool const completed = RunSolverBenchmark(options, generator, scenario, first);
+            MLRA_DestroyScenario(scenario);
+            if (!completed) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Prints an operation timed from startTime until now. Resets the peak resident memory after printing it, so that the
+ * next operation measures its own.
+ */
+[[gnu::nonnull(1, 2, 5, 6), gnu::access(read_only, 1), gnu::access(read_only, 2), gnu::access(read_write, 5)]]
+[[gnu::access(read_write, 6)]]
+static void PrintListBenchmark(
+    char const *const backend,
+    char const *const operation,
+    size_t const operationCount,
+    double const startTime,
+    bool *const first,
+    bool *const peakMeasured
+)
+{
+    double const seconds = MLRA_GetMonotonicTime() - startTime;
+    PrintJsonSeparator(first);
+    printf(
+        "    {\"backend\": \"%s\", \"operation\": \"%s\", \"operations\": %zu, \"seconds\": %.9f, "
+        "\"nsPerOperation\": %.3f, \"peakResidentBytes\": ",
+        backend,
+        operation,
+        operationCount,
+        seconds,
+        seconds * 1e9 / (double)operationCount
+    );
+    PrintPeakResidentMemory(*peakMeasured);
+    fputs("}", stdout);
+    *peakMeasured = MLRA_ResetPeakResidentMemory();
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_only, 1), gnu::access(read_write, 3)]]
+static bool RunListBenchmarks(
+    BenchOptions const *const options,
+    bool const chunked,
+    bool *const first
+)
+{
+    char const *const backend = chunked ? "chunked" : "array";
+    size_t const appendCount = options->maxInstructionCount;
+    size_t const editCount = appendCount / 100 > 1000 ? 1000 : appendCount / 100 > 0 ? appendCount / 100 : 1;
+
+    MLRA_RegisterInstructionList *list = chunked
+        ? MLRA_CreateChunkedRegisterInstructionList()
+        : MLRA_CreateRegisterInstructionList();
+    if (list == nullptr) {
+        return false;
+    }
+
+    BenchRandom random = {options->seed};
+    bool peakMeasured = MLRA_ResetPeakResidentMemory();
+
+    double startTime = MLRA_GetMonotonicTime();
+    for (size_t index = 0; index < appendCount; ++index) {
+        MLRA_RegisterInstruction const instruction = {
+            .type = index % 4 == 0 ? MLRA_RegisterInstructionType_Store : MLRA_RegisterInstructionType_Load,
+            .virtualRegisterId = (int)(index % 1024)
+        };
+        MLRA_AppendRegisterInstructionToList(list, instruction);
+    }
+    PrintListBenchmark(backend, "append", appendCount, startTime, first, &peakMeasured);
+    if (MLRA_GetRegisterInstructionCountInList(list) != appendCount) {
+        MLRA_DestroyRegisterInstructionList(list);
+        return false;
+    }
+
+    MLRA_RegisterInstructionList *spanList = chunked
+        ? MLRA_CreateChunkedRegisterInstructionList()
+        : MLRA_CreateRegisterInstructionList();
+    TraceChunk chunk;
+    if (spanList == nullptr || !InitializeTraceChunk(&chunk)) {
+        MLRA_DestroyRegisterInstructionList(spanList);
+        MLRA_DestroyRegisterInstructionList(list);
+        return false;
+    }
+
+    bool appended = true;
+    startTime = MLRA_GetMonotonicTime();
+    for (size_t index = 0; appended && index < appendCount; ++index) {
+        appended = PushTraceInstruction(spanList, &chunk, (int32_t)(index % 1024), index % 4 == 0);
+    }
+    appended = appended && FlushTraceChunk(spanList, &chunk);
+    PrintListBenchmark(backend, "appendSpan", appendCount, startTime, first, &peakMeasured);
+    ReleaseTraceChunk(&chunk);
+    MLRA_DestroyRegisterInstructionList(spanList);
+    if (!appended) {
+        MLRA_DestroyRegisterInstructionList(list);
+        return false;
+    }
+
+    startTime = MLRA_GetMonotonicTime();
+    for (size_t index = 0; index < editCount; ++index) {
+        size_t const position = NextBenchRandomBelow(&random, MLRA_GetRegisterInstructionCountInList(list) + 1);
+        MLRA_RegisterInstruction const instruction = {
+            .type = MLRA_RegisterInstructionType_Load,
+            .virtualRegisterId = (int)(index % 1024)
+        };
+        MLRA_InsertRegisterInstructionAtList(list, position, instruction);
+    }
+    PrintListBenchmark(backend, "insertRandom", editCount, startTime, first, &peakMeasured);
+
+    startTime = MLRA_GetMonotonicTime();
+    for (size_t index = 0; index < editCount; ++index) {
+        size_t const position = NextBenchRandomBelow(&random, MLRA_GetRegisterInstructionCountInList(list));
+        MLRA_RemoveRegisterInstructionAtList(list, position);
+    }
+    PrintListBenchmark(backend, "removeRandom", editCount, startTime, first, &peakMeasured);
+
+    if (!MLRA_BuildNextUseIndexInList(list)) {
+        MLRA_DestroyRegisterInstructionList(list);
+        return false;
+    }
+    startTime = MLRA_GetMonotonicTime();
+    for (size_t index = 0; index < editCount; ++index) {
+        size_t const position = NextBenchRandomBelow(&random, MLRA_GetRegisterInstructionCountInList(list) + 1);
+        MLRA_RegisterInstruction const instruction = {
+            .type = MLRA_RegisterInstructionType_Load,
+            .virtualRegisterId = (int)(index % 1024)
+        };
+        MLRA_InsertRegisterInstructionAtList(list, position, instruction);
+    }
+    PrintListBenchmark(backend, "insertRandomIndexed", editCount, startTime, first, &peakMeasured);
+
+    startTime = MLRA_GetMonotonicTime();
+    for (size_t index = 0; index < editCount; ++index) {
+        size_t const position = NextBenchRandomBelow(&random, MLRA_GetRegisterInstructionCountInList(list));
+        MLRA_RemoveRegisterInstructionAtList(list, position);
+    }
+    PrintListBenchmark(backend, "removeRandomIndexed", editCount, startTime, first, &peakMeasured);
+
+    int32_t spanIds[EditSpanLength];
+    uint64_t spanStoreBits[EditSpanLength / 64] = {};
+    for (size_t index = 0; index < EditSpanLength; ++index) {
+        spanIds[index] = (int32_t)(index % 1024);
+        spanStoreBits[index / 64] |= (uint64_t)(index % 4 == 0) << (index % 64);
+    }
+
+    bool inserted = true;
+    startTime = MLRA_GetMonotonicTime();
+    for (size_t index = 0; inserted && index < editCount; ++index) {
+        size_t const position = NextBenchRandomBelow(&random, MLRA_GetRegisterInstructionCountInList(list) + 1);
+        inserted = MLRA_InsertRegisterInstructionSpanAtList(list, position, spanIds, spanStoreBits, EditSpanLength);
+    }
+    PrintListBenchmark(backend, "insertSpanRandom", editCount, startTime, first, &peakMeasured);
+    if (!inserted) {
+        MLRA_DestroyRegisterInstructionList(list);
+        return false;
+    }
+
+    startTime = MLRA_GetMonotonicTime();
+    for (size_t index = 0; index < editCount; ++index) {
+        size_t const position = NextBenchRandomBelow(
+            &random,
+            MLRA_GetRegisterInstructionCountInList(list) - EditSpanLength + 1
+        );
+        MLRA_RemoveRegisterInstructionRangeAtList(list, position, EditSpanLength);
+    }
+    PrintListBenchmark(backend, "removeRangeRandom", editCount, startTime, first, &peakMeasured);
+
+    size_t const removeCount = MLRA_GetRegisterInstructionCountInList(list);
+    startTime = MLRA_GetMonotonicTime();
+    while (MLRA_GetRegisterInstructionCountInList(list) > 0) {
+        MLRA_RemoveRegisterInstructionBehindList(list);
+    }
+    PrintListBenchmark(backend, "removeBehind", removeCount, startTime, first, &peakMeasured);
+
+    MLRA_DestroyRegisterInstructionList(list);
+
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    BenchOptions options;
+    if (!ParseBenchOptions(argc, argv, &options)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    bool first = true;
+    fputs("{\n  \"solverBenchmarks\": [", stdout);
+    if (!RunSolverBenchmarks(&options, &first)) {
+        fputs("\n  ]\n}\n", stdout);
+        fprintf(stderr, "Solver benchmark failed\n");
+        return 3;
+    }
+    fputs("\n  ],\n  \"listBenchmarks\": [", stdout);
+
+    first = true;
+    bool const listBenchmarksRan = !options.runListBenchmarks || options.maxInstructionCount == 0 || (
+        RunListBenchmarks(&options, false, &first) && RunListBenchmarks(&options, true, &first)
+    );
+    if (!listBenchmarksRan) {
+        fputs("\n  ]\n}\n", stdout);
+        fprintf(stderr, "List benchmark failed\n");
+        return 3;
+    }
+    fputs("\n  ]\n}\n", stdout);
+
+    return 0;
+}
@@ -0,0 +1,814 @@
+#include "MLRA/Core/BatchSolver.h"
+#include "MLRA/Core/BeladySolver.h"
+#include "MLRA/Core/BranchAndBoundSolver.h"
+#include "MLRA/Core/FlowSolver.h"
+#include "MLRA/Core/LowerBound.h"
+#include "MLRA/Core/Platform.h"
+#include "MLRA/Core/RegisterCost.h"
+#include "MLRA/Core/RegisterInstruction.h"
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/ScenarioFile.h"
+#include "MLRA/Core/Solution.h"
+#include "MLRA/Core/Solver.h"
+#include "MLRA/Core/SolverWorkspace.h"
+#include "MLRA/Core/TraceParser.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+typedef MLRA_Solution *(*SolveFunction)(MLRA_Scenario const *scenario);
+
+typedef struct
+{
+    char const *name;
+    SolveFunction solve;
+    MLRA_BatchSolveFunction batchSolve;
+} SolverEntry;
+
+typedef struct
+{
+    char **paths;
+    size_t count;
+    size_t capacity;
+} PathList;
+
+typedef struct
+{
+    char const *path;
+    SolverEntry const *solver;
+    size_t registerCount;
+    MLRA_RegisterCost memorySpillCost;
+    size_t threadCount;
+    double timeLimit;
+    bool hasRegisterCount;
+    bool hasMemorySpillLoad;
+    bool hasMemorySpillStore;
+    bool printAssignment;
+    bool batch;
+} SolveOptions;
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static MLRA_Solution *SolveScenarioExactlyInWorkspace(
+    MLRA_Scenario const *const scenario,
+    [[maybe_unused]] MLRA_SolverWorkspace *const workspace,
+    [[maybe_unused]] void *const context
+)
+{
+    return MLRA_SolveScenarioExactly(scenario);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static MLRA_Solution *SolveScenarioExactlyOnAllThreads(
+    MLRA_Scenario const *const scenario
+)
+{
+    return MLRA_SolveScenarioExactlyInParallel(scenario, 0);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static MLRA_Solution *SolveScenarioWithMinCostFlowInWorkspace(
+    MLRA_Scenario const *const scenario,
+    [[maybe_unused]] MLRA_SolverWorkspace *const workspace,
+    [[maybe_unused]] void *const context
+)
+{
+    return MLRA_SolveScenarioWithMinCostFlow(scenario);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1)]]
+static MLRA_Solution *SolveScenarioWithBeladyInWorkspace(
+    MLRA_Scenario const *const scenario,
+    MLRA_SolverWorkspace *const workspace,
+    [[maybe_unused]] void *const context
+)
+{
+    return MLRA_SolveScenarioWithBeladyInWorkspace(scenario, workspace);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static MLRA_Solution *SolveScenarioWithBranchAndBound(
+    MLRA_Scenario const *const scenario
+)
+{
+    return MLRA_SolveScenarioWithBranchAndBound(scenario, &(MLRA_BranchAndBoundOptions){}, nullptr);
+}
+
+/*
+ * Batches already keep every thread busy with a scenario each, so every search runs on one thread. The context holds
+ * the SolveOptions of the batch, which carry the time limit.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_only, 1), gnu::access(read_only, 3)]]
+static MLRA_Solution *SolveScenarioWithBranchAndBoundInWorkspace(
+    MLRA_Scenario const *const scenario,
+    [[maybe_unused]] MLRA_SolverWorkspace *const workspace,
+    void *const context
+)
+{
+    SolveOptions const *const options = context;
+
+    return MLRA_SolveScenarioWithBranchAndBound(
+        scenario,
+        &(MLRA_BranchAndBoundOptions){.threadCount = 1, .timeLimit = options->timeLimit},
+        nullptr
+    );
+}
+
+static SolverEntry const Solvers[] = {
+    {"exact", MLRA_SolveScenarioExactly, SolveScenarioExactlyInWorkspace},
+    {"exact-parallel", SolveScenarioExactlyOnAllThreads, SolveScenarioExactlyInWorkspace},
+    {"flow", MLRA_SolveScenarioWithMinCostFlow, SolveScenarioWithMinCostFlowInWorkspace},
+    {"belady", MLRA_SolveScenarioWithBelady, SolveScenarioWithBeladyInWorkspace},
+    {"branch-and-bound", SolveScenarioWithBranchAndBound, SolveScenarioWithBranchAndBoundInWorkspace}
+};
+
+static constexpr size_t SolverCount = sizeof(Solvers) / sizeof(Solvers[0]);
+static constexpr size_t DefaultRegisterCount = 16;
+static constexpr MLRA_RegisterCost DefaultMemorySpillCost = {5, 5};
+static constexpr size_t BatchWindowSize = 4096;
+
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static void PrintUsage(
+    char const *const program
+)
+{
+    fprintf(
+        stderr,
+        "Usage: %s [options] <scenario.mlra | trace.txt>\n"
+        "       %s [options] --batch <directory | list.txt>\n"
+        "\n"
+        "Options:\n"
+        "  --solver <name>         Solver to run: exact, exact-parallel, flow, belady or branch-and-bound\n"
+        "                          (default: belady). flow and belady are heuristics; flow is optimal only\n"
+        "                          when every register has the same costs\n"
+        "  --registers <count>     Register count (default for text traces: %zu)\n"
+        "  --spill-load <cost>     Memory load cost (default for text traces: %d)\n"
+        "  --spill-store <cost>    Memory store cost (default for text traces: %d)\n"
+        "  --threads <count>       Parser, batch or search worker threads (default: all cores)\n"
+        "  --time-limit <seconds>  Stop each branch-and-bound search after this long with its best solution\n"
+        "                          (default: none)\n"
+        "  --no-assignment         Print only the summary\n"
+        "  --batch                 Solve every scenario in a directory or listed in a file\n",
+        program,
+        program,
+        DefaultRegisterCount,
+        DefaultMemorySpillCost.load,
+        DefaultMemorySpillCost.store
+    );
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(write_only, 2)]]
+static bool ParseSizeArgument(
+    char const *const text,
+    size_t *const value
+)
+{
+    char *end;
+    errno = 0;
+    unsigned long long const result = strtoull(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0' || text[0] == '-' || result > SIZE_MAX) {
+        return false;
+    }
+
+    *value = (size_t)result;
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(write_only, 2)]]
+static bool ParseCostArgument(
+    char const *const text,
+    int *const value
+)
+{
+    char *end;
+    errno = 0;
+    long const result = strtol(text, &end, 10);
+    if (errno != 0 || end == text || *end != '\0' || result <= 0 || result > INT_MAX) {
+        return false;
+    }
+
+    *value = (int)result;
+
+    return true;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(write_only, 2)]]
+static bool ParseSecondsArgument(
+    char const *const text,
+    double *const value
+)
+{
+    char *end;
+    errno = 0;
+    double const result = strtod(text, &end);
+    if (errno != 0 || end == text || *end != '\0' || !(result >= 0.0)) {
+        return false;
+    }
+
+    *value = result;
+
+    return true;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static SolverEntry const *FindSolver(
+    char const *const name
+)
+{
+    for (size_t index = 0; index < SolverCount; ++index) {
+        if (strcmp(Solvers[index].name, name) == 0) {
+            return &Solvers[index];
+        }
+    }
+
+    return nullptr;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(2, 3), gnu::access(read_only, 2, 1), gnu::access(write_only, 3)]]
+static bool ParseSolveOptions(
+    int const argumentCount,
+    char **const arguments,
+    SolveOptions *const options
+)
+{
+    *options = (SolveOptions){
+        .solver = FindSolver("belady"),
+        .registerCount = DefaultRegisterCount,
+        .memorySpillCost = DefaultMemorySpillCost,
+        .printAssignment = true
+    };
+
+    for (int index = 1; index < argumentCount; ++index) {
+        char const *const argument = arguments[index];
+        char const *const value = index + 1 < argumentCount ? arguments[index + 1] : nullptr;
+        bool valid = true;
+
+        if (strcmp(argument, "--no-assignment") == 0) {
+            options->printAssignment = false;
+            continue;
+        }
+        if (strcmp(argument, "--batch") == 0) {
+            options->batch = true;
+            continue;
+        }
+        if (argument[0] != '-') {
+            valid = options->path == nullptr;
+            options->path = argument;
+        }
+        else if (value == nullptr) {
+            valid = false;
+        }
+        else if (strcmp(argument, "--solver") == 0) {
+            options->solver = FindSolver(value);
+            valid = options->solver != nullptr;
+            ++index;
+        }
+        else if (strcmp(argument, "--registers") == 0) {
+            valid = ParseSizeArgument(value, &options->registerCount);
+            options->hasRegisterCount = true;
+            ++index;
+        }
+        else if (strcmp(argument, "--spill-load") == 0) {
+            valid = ParseCostArgument(value, &options->memorySpillCost.load);
+            options->hasMemorySpillLoad = true;
+            ++index;
+        }
+        else if (strcmp(argument, "--spill-store") == 0) {
+            valid = ParseCostArgument(value, &options->memorySpillCost.store);
+            options->hasMemorySpillStore = true;
+            ++index;
+        }
+        else if (strcmp(argument, "--threads") == 0) {
+            valid = ParseSizeArgument(value, &options->threadCount);
+            ++index;
+        }
+        else if (strcmp(argument, "--time-limit") == 0) {
+            valid = ParseSecondsArgument(value, &options->timeLimit);
+            ++index;
+        }
+        else {
+            valid = false;
+        }
+
+        if (!valid) {
+            fprintf(stderr, "Invalid argument: %s\n", argument);
+            return false;
+        }
+    }
+
+    return options->path != nullptr;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static bool IsScenarioFilePath(
+    char const *const path
+)
+{
+    size_t const length = strlen(path);
+
+    return length >= 5 && strcmp(path + length - 5, ".mlra") == 0;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_only, 2)]]
+static MLRA_Scenario *LoadSolveScenario(
+    SolveOptions const *const options,
+    char const *const path,
+    size_t const threadCount,
+    bool const printReport
+)
+{
+    if (IsScenarioFilePath(path)) {
+        MLRA_Scenario *scenario = MLRA_LoadScenarioFromFile(path);
+        if (scenario == nullptr) {
+            fprintf(stderr, "Failed to load scenario file: %s\n", path);
+            return nullptr;
+        }
+
+        if (options->hasRegisterCount) {
+            MLRA_SetRegisterCountInScenario(scenario, options->registerCount);
+        }
+        MLRA_RegisterCost memorySpillCost = MLRA_GetMemorySpillCostInScenario(scenario);
+        if (options->hasMemorySpillLoad) {
+            memorySpillCost.load = options->memorySpillCost.load;
+        }
+        if (options->hasMemorySpillStore) {
+            memorySpillCost.store = options->memorySpillCost.store;
+        }
+        MLRA_SetMemorySpillCostInScenario(scenario, memorySpillCost);
+
+        return scenario;
+    }
+
+    MLRA_RegisterInstructionList *registerInstructions = MLRA_CreateRegisterInstructionList();
+    if (registerInstructions == nullptr) {
+        return nullptr;
+    }
+
+    MLRA_TraceParseReport report;
+    if (!MLRA_ParseTraceFileIntoList(registerInstructions, path, threadCount, &report)) {
+        if (report.errorLine != 0) {
+            fprintf(stderr, "%s:%zu: malformed instruction\n", path, report.errorLine);
+        }
+        else {
+            fprintf(stderr, "Failed to read trace file: %s\n", path);
+        }
+        MLRA_DestroyRegisterInstructionList(registerInstructions);
+        return nullptr;
+    }
+
+    if (printReport) {
+        printf(
+            "parse: %zu bytes in %.6f s (%.1f MB/s, %zu threads)\n",
+            report.byteCount,
+            report.seconds,
+            report.megabytesPerSecond,
+            report.threadCount
+        );
+    }
+
+    MLRA_Scenario *scenario = MLRA_CreateScenarioWithRegisterInstructionList(
+        options->registerCount,
+        options->memorySpillCost,
+        registerInstructions
+    );
+    if (scenario == nullptr) {
+        MLRA_DestroyRegisterInstructionList(registerInstructions);
+        return nullptr;
+    }
+
+    return scenario;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void ReleasePathList(
+    PathList *const list
+)
+{
+    for (size_t index = 0; index < list->count; ++index) {
+        free(list->paths[index]);
+    }
+    free(list->paths);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 3), gnu::access(read_write, 1), gnu::access(read_only, 3)]]
+static bool AppendPathToList(
+    PathList *const list,
+    char const *const directory,
+    char const *const name
+)
+{
+    if (list->count == list->capacity) {
+        size_t const capacity = list->capacity == 0 ? 64 : list->capacity * 2;
+        char **paths = realloc(list->paths, capacity * sizeof(char *));
+        if (paths == nullptr) {
+            return false;
+        }
+        list->paths = paths;
+        list->capacity = capacity;
+    }
+
+    size_t const directoryLength = directory == nullptr ? 0 : strlen(directory);
+    size_t const nameLength = strlen(name);
+    char *path = malloc(directoryLength + nameLength + 2);
+    if (path == nullptr) {
+        return false;
+    }
+
+    if (directory == nullptr) {
+        memcpy(path, name, nameLength + 1);
+    }
+    else {
+        memcpy(path, directory, directoryLength);
+        path[directoryLength] = '/';
+        memcpy(path + directoryLength + 1, name, nameLength + 1);
+    }
+    list->paths[list->count++] = path;
+
+    return true;
+}
+
+[[nodiscard, gnu::pure]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_only, 2)]]
+static int ComparePaths(
+    void const *const left,
+    void const *const right
+)
+{
+    return strcmp(*(char *const *)left, *(char *const *)right);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_write, 2)]]
+static bool CollectDirectoryPaths(
+    char const *const directory,
+    PathList *const list
+)
+{
+#ifdef _WIN32
+    size_t const length = strlen(directory);
+    char *pattern = malloc(length + 3);
+    if (pattern == nullptr) {
+        return false;
+    }
+    memcpy(pattern, directory, length);
+    memcpy(pattern + length, "/*", 3);
+
+    WIN32_FIND_DATAA entry;
+    HANDLE handle = FindFirstFileA(pattern, &entry);
+    free(pattern);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    bool collected = true;
+    do {
+        if (entry.cFileName[0] != '.' && !(entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+            collected = AppendPathToList(list, directory, entry.cFileName);
+        }
+    } while (collected && FindNextFileA(handle, &entry));
+    FindClose(handle);
+#else
+    DIR *handle = opendir(directory);
+    if (handle == nullptr) {
+        return false;
+    }
+
+    bool collected = true;
+    for (struct dirent *entry = readdir(handle); collected && entry != nullptr; entry = readdir(handle)) {
+        if (entry->d_name[0] != '.') {
+            collected = AppendPathToList(list, directory, entry->d_name);
+        }
+    }
+    closedir(handle);
+#endif
+
+    if (collected) {
+        qsort(list->paths, list->count, sizeof(char *), ComparePaths);
+    }
+
+    return collected;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_write, 2)]]
+static bool CollectListedPaths(
+    char const *const path,
+    PathList *const list
+)
+{
+    FILE *file = fopen(path, "r");
+    if (file == nullptr) {
+        return false;
+    }
+
+    bool collected = true;
+    char line[4096];
+    while (collected && fgets(line, sizeof(line), file) != nullptr) {
+        size_t length = strcspn(line, "\r\n");
+        line[length] = '\0';
+        if (length > 0 && line[0] != '#') {
+            collected = AppendPathToList(list, nullptr, line);
+        }
+    }
+    collected = collected && !ferror(file);
+    fclose(file);
+
+    return collected;
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_write, 2)]]
+static bool CollectBatchPaths(
+    char const *const path,
+    PathList *const list
+)
+{
+#ifdef _WIN32
+    DWORD const attributes = GetFileAttributesA(path);
+    if (attributes == INVALID_FILE_ATTRIBUTES) {
+        return false;
+    }
+    bool const isDirectory = attributes & FILE_ATTRIBUTE_DIRECTORY;
+#else
+    struct stat status;
+    if (stat(path, &status) != 0) {
+        return false;
+    }
+    bool const isDirectory = S_ISDIR(status.st_mode);
+#endif
+
+    return isDirectory ? CollectDirectoryPaths(path, list) : CollectListedPaths(path, list);
+}
+
+typedef struct
+{
+    SolveOptions const *options;
+    char *const *paths;
+    MLRA_Scenario **scenarios;
+} BatchLoad;
+
+[[gnu::nonnull(1)]]
+static void LoadBatchScenario(
+    void *const context,
+    [[maybe_unused]] size_t const worker,
+    size_t const index
+)
+{
+    BatchLoad const *const load = context;
+    load->scenarios[index] = LoadSolveScenario(load->options, load->paths[index], 1, false);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static int RunBatch(
+    SolveOptions const *const options
+)
+{
+    PathList paths = {};
+    if (!CollectBatchPaths(options->path, &paths)) {
+        fprintf(stderr, "Failed to read batch: %s\n", options->path);
+        ReleasePathList(&paths);
+        return 2;
+    }
+
+    /*
+     * Scenario files stay mapped while they are loaded, so the batch is loaded and solved a window at a time to keep
+     * the mapping count well below the limit of the system, and each window is printed before the next one loads.
+     */
+    size_t const count = paths.count;
+    size_t const windowSize = count < BatchWindowSize ? (count == 0 ? 1 : count) : BatchWindowSize;
+    MLRA_Scenario **scenarios = calloc(windowSize, sizeof(MLRA_Scenario *));
+    MLRA_Solution **solutions = calloc(windowSize, sizeof(MLRA_Solution *));
+    if (scenarios == nullptr || solutions == nullptr) {
+        free(solutions);
+        free(scenarios);
+        ReleasePathList(&paths);
+        return 2;
+    }
+
+    size_t const threadCount = options->threadCount == 0 ? MLRA_GetHardwareThreadCount() : options->threadCount;
+    int result = 0;
+    double loadSeconds = 0.0;
+    MLRA_BatchSolveReport report = {};
+    int64_t totalCost = 0;
+    int64_t totalLowerBound = 0;
+    bool lowerBoundKnown = true;
+    size_t totalInstructionCount = 0;
+    for (size_t begin = 0; begin < count && result != 2; begin += windowSize) {
+        size_t const windowCount = count - begin < windowSize ? count - begin : windowSize;
+
+        double const loadStartTime = MLRA_GetMonotonicTime();
+        BatchLoad load = {options, paths.paths + begin, scenarios};
+        MLRA_RunParallelJobs(windowCount, threadCount, LoadBatchScenario, &load);
+        loadSeconds += MLRA_GetMonotonicTime() - loadStartTime;
+
+        for (size_t index = 0; index < windowCount; ++index) {
+            if (scenarios[index] == nullptr) {
+                result = 2;
+            }
+        }
+
+        MLRA_BatchSolveReport windowReport = {};
+        if (result != 2 && !MLRA_SolveScenarioBatch(
+            (MLRA_Scenario const *const *)scenarios,
+            windowCount,
+            options->solver->batchSolve,
+            (void *)options,
+            options->threadCount,
+            solutions,
+            &windowReport
+        )) {
+            result = 3;
+        }
+        report.scenarioCount += windowReport.scenarioCount;
+        report.solvedCount += windowReport.solvedCount;
+        report.stealCount += windowReport.stealCount;
+        report.seconds += windowReport.seconds;
+        if (windowReport.threadCount > report.threadCount) {
+            report.threadCount = windowReport.threadCount;
+        }
+
+        for (size_t index = 0; index < windowCount && result != 2; ++index) {
+            char const *const path = paths.paths[begin + index];
+            size_t const instructionCount = MLRA_GetRegisterInstructionCountInScenario(scenarios[index]);
+            totalInstructionCount += instructionCount;
+            if (solutions[index] == nullptr) {
+                printf("%s %zu failed\n", path, instructionCount);
+                continue;
+            }
+
+            int64_t const cost = MLRA_GetSolutionCost(solutions[index]);
+            totalCost += cost;
+            printf("%s %zu %" PRId64 "\n", path, instructionCount, cost);
+
+            MLRA_LowerBound lowerBound;
+            lowerBoundKnown = lowerBoundKnown && MLRA_ComputeLowerBoundOfScenario(scenarios[index], &lowerBound);
+            totalLowerBound += lowerBoundKnown ? lowerBound.cost : 0;
+        }
+
+        for (size_t index = 0; index < windowCount; ++index) {
+            MLRA_DestroySolution(solutions[index]);
+            MLRA_DestroyScenario(scenarios[index]);
+            solutions[index] = nullptr;
+            scenarios[index] = nullptr;
+        }
+    }
+
+    if (result != 2) {
+        printf(
+            "batch: %zu scenarios, %zu solved, %zu instructions, cost %" PRId64 ", solver %s\n",
+            report.scenarioCount,
+            report.solvedCount,
+            totalInstructionCount,
+            totalCost,
+            options->solver->name
+        );
+        if (lowerBoundKnown && report.solvedCount == report.scenarioCount) {
+            printf(
+                "lower bound: %" PRId64 ", gap %.2f%%\n",
+                totalLowerBound,
+                100.0 * MLRA_GetOptimalityGap(totalCost, totalLowerBound)
+            );
+        }
+        printf(
+            "time: load %.6f s, solve %.6f s (%zu threads, %zu steals)\n",
+            loadSeconds,
+            report.seconds,
+            report.threadCount,
+            report.stealCount
+        );
+    }
+
+    free(solutions);
+    free(scenarios);
+    ReleasePathList(&paths);
+
+    return result;
+}
+
+[[gnu::nonnull(1, 2), gnu::access(read_only, 1), gnu::access(read_only, 2)]]
+static void PrintAssignment(
+    MLRA_Scenario const *const scenario,
+    MLRA_Solution const *const solution
+)
+{
+    size_t const count = MLRA_GetInstructionCountInSolution(solution);
+
+    puts("assignment:");
+    for (size_t index = 0; index < count; ++index) {
+        MLRA_RegisterInstruction const instruction = MLRA_GetRegisterInstructionInScenario(scenario, index);
+        int32_t const location = MLRA_GetInstructionLocationInSolution(solution, index);
+        char const type = instruction.type == MLRA_RegisterInstructionType_Store ? 'S' : 'L';
+
+        if (location == MLRA_SolutionLocation_Memory) {
+            printf("%zu %c v%d memory\n", index, type, instruction.virtualRegisterId);
+        }
+        else {
+            printf("%zu %c v%d r%" PRId32 "\n", index, type, instruction.virtualRegisterId, location);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    SolveOptions options;
+    if (!ParseSolveOptions(argc, argv, &options)) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    static char outputBuffer[1 << 16];
+    setvbuf(stdout, outputBuffer, _IOFBF, sizeof(outputBuffer));
+
+    if (options.batch) {
+        return RunBatch(&options);
+    }
+
+    MLRA_Scenario *scenario = LoadSolveScenario(&options, options.path, options.threadCount, true);
+    if (scenario == nullptr) {
+        return 2;
+    }
+
+    /* The branch-and-bound search takes the thread count and time limit, and reports how far it got. */
+    bool const searched = options.solver->solve == SolveScenarioWithBranchAndBound;
+    MLRA_BranchAndBoundReport searchReport = {};
+    double const startTime = MLRA_GetMonotonicTime();
+    MLRA_Solution *solution = searched
+        ? MLRA_SolveScenarioWithBranchAndBound(
+            scenario,
+            &(MLRA_BranchAndBoundOptions){options.threadCount, options.timeLimit},
+            &searchReport
+        )
+        : options.solver->solve(scenario);
+    double const seconds = MLRA_GetMonotonicTime() - startTime;
+    if (solution == nullptr) {
+        fprintf(stderr, "Solver %s failed\n", options.solver->name);
+        MLRA_DestroyScenario(scenario);
+        return 3;
+    }
+
+    printf("scenario: %s\n", options.path);
+    printf("solver: %s\n", options.solver->name);
+    printf("instructions: %zu\n", MLRA_GetRegisterInstructionCountInScenario(scenario));
+    printf("registers: %zu\n", MLRA_GetRegisterCountInScenario(scenario));
+    printf("cost: %" PRId64 "\n", MLRA_GetSolutionCost(solution));
+
+    MLRA_LowerBound lowerBound;
+    if (MLRA_ComputeLowerBoundOfScenario(scenario, &lowerBound)) {
+        printf(
+            "lower bound: %" PRId64 " (first load %" PRId64 ", relaxed %" PRId64 ", interval %" PRId64 ")\n",
+            lowerBound.cost,
+            lowerBound.firstLoadCost,
+            lowerBound.relaxedCost,
+            lowerBound.intervalCost
+        );
+        printf("gap: %.2f%%\n", 100.0 * MLRA_GetOptimalityGap(MLRA_GetSolutionCost(solution), lowerBound.cost));
+    }
+    if (searched) {
+        printf(
+            "search: %s, proven lower bound %" PRId64 ", gap %.2f%% (%zu nodes, %zu threads, %zu steals)\n",
+            searchReport.optimal ? "optimal" : "time limit reached",
+            searchReport.lowerBound,
+            100.0 * searchReport.gap,
+            searchReport.nodeCount,
+            searchReport.threadCount,
+            searchReport.stealCount
+        );
+    }
+    printf("time: %.6f s\n", seconds);
+    if (options.printAssignment) {
+        PrintAssignment(scenario, solution);
+    }
+
+    MLRA_DestroySolution(solution);
+    MLRA_DestroyScenario(scenario);
+
+    return 0;
+}
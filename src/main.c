@@ -1,22 +1,46 @@
+#include "MLRA/Core/LowerBound.h"
 #include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/ScenarioFile.h"
+#include "MLRA/Core/Solution.h"
+#include "MLRA/Core/SolutionSummary.h"
+#include "MLRA/Core/SolverWorker.h"
 
 #include <raylib.h>
 #include <raygui.h>
 
+#include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+/*
+ * Text that only changes with the scenario is rendered once into a texture and redrawn from there every frame. The
+ * texture is created on the first render, sized to the measured text.
+ */
+typedef struct
+{
+    RenderTexture2D texture;
+    bool valid;
+} CachedPanel;
+
+typedef struct
+{
+    double firstInstruction;
+    double instructionsPerColumn;
+} TimelineView;
+
 [[gnu::nonnull(1), gnu::access(read_write, 1)]]
 [[gnu::nonnull(2), gnu::access(read_write, 2)]]
-static void DrawEditRegisterCountDialogBox(bool *visible, MLRA_Scenario *scenario)
+static bool DrawEditRegisterCountDialogBox(bool *visible, MLRA_Scenario *scenario)
 {
     static bool lastVisible = false;
     static char buffer[16];
+    bool applied = false;
 
     if (!(*visible)) {
         lastVisible = false;    
-        return;
+        return applied;
     }
 
     if (!lastVisible) {
@@ -37,6 +61,7 @@ static void DrawEditRegisterCountDialogBox(bool *visible, MLRA_Scenario *scenari
         size_t result = strtoull(buffer, nullptr, 10);
         if (result > 0) {
             MLRA_SetRegisterCountInScenario(scenario, result);
+            applied = true;
         }
     }
 
@@ -45,38 +70,113 @@ static void DrawEditRegisterCountDialogBox(bool *visible, MLRA_Scenario *scenari
     }
 
     lastVisible = true;
+
+    return applied;
+}
+
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static bool IsCachedPanelOutdated(CachedPanel const *panel, bool changed)
+{
+    return !panel->valid || changed;
+}
+
+/*
+ * Starts rendering into the panel texture, or returns false if no texture could be created. The texture is recreated
+ * when the content outgrows it, and never shrinks, so text alternating between two widths does not reallocate it on
+ * every change. Panels are cleared to the background colour, so they are drawn before any dialog that may overlap them.
+ */
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static bool BeginCachedPanel(CachedPanel *panel, int width, int height)
+{
+    Texture2D current = panel->texture.texture;
+    if (panel->texture.id == 0 || width > current.width || height > current.height) {
+        UnloadRenderTexture(panel->texture);
+        panel->texture = LoadRenderTexture(
+            width > current.width ? width : current.width,
+            height > current.height ? height : current.height
+        );
+        panel->valid = false;
+        if (panel->texture.id == 0) {
+            return false;
+        }
+    }
+
+    BeginTextureMode(panel->texture);
+    ClearBackground(GetColor((unsigned int)GuiGetStyle(DEFAULT, BACKGROUND_COLOR)));
+
+    return true;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void EndCachedPanel(CachedPanel *panel)
+{
+    EndTextureMode();
+    panel->valid = true;
+}
+
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static void DrawCachedPanel(CachedPanel const *panel, int posX, int posY)
+{
+    /* Render textures are stored bottom up, so the source rectangle flips them back. */
+    DrawTextureRec(
+        panel->texture.texture,
+        (Rectangle){0, 0, (float)panel->texture.texture.width, -(float)panel->texture.texture.height},
+        (Vector2){(float)posX, (float)posY},
+        WHITE
+    );
 }
 
-[[gnu::nonnull(3), gnu::access(read_write, 3)]]
-static void DrawRegisterCount(size_t registerCount, bool showEditButton, bool *editRegisterCount)
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+[[gnu::nonnull(4), gnu::access(read_write, 4)]]
+static void DrawRegisterCount(CachedPanel *panel, size_t registerCount, bool showEditButton, bool *editRegisterCount)
 {
     static int posX = 20;
     static int posY = 70;
-    DrawText(
-        "Number of Registers: ",
-        posX,
-        posY,
-        20,
-        GetColor((unsigned int)GuiGetStyle(DEFAULT, TEXT_COLOR_NORMAL))
-    );
-    DrawText(
-        TextFormat("%zu", registerCount),
-        posX + 224,
-        posY,
-        20,
-        GetColor((unsigned int)GuiGetStyle(DEFAULT, *editRegisterCount ? TEXT_COLOR_FOCUSED : TEXT_COLOR_NORMAL))
-    );
+    static int countPosX = 224;
+    static size_t lastRegisterCount = 0;
+    static bool lastEditRegisterCount = false;
+
+    bool changed = registerCount != lastRegisterCount || *editRegisterCount != lastEditRegisterCount;
+    if (IsCachedPanelOutdated(panel, changed)) {
+        char const *label = "Number of Registers: ";
+        char const *count = TextFormat("%zu", registerCount);
+        int labelWidth = MeasureText(label, 20);
+        int countWidth = countPosX + MeasureText(count, 20);
+        if (BeginCachedPanel(panel, labelWidth > countWidth ? labelWidth : countWidth, 20)) {
+            DrawText(
+                label,
+                0,
+                0,
+                20,
+                GetColor((unsigned int)GuiGetStyle(DEFAULT, TEXT_COLOR_NORMAL))
+            );
+            DrawText(
+                count,
+                countPosX,
+                0,
+                20,
+                GetColor((unsigned int)GuiGetStyle(DEFAULT, *editRegisterCount ? TEXT_COLOR_FOCUSED : TEXT_COLOR_NORMAL))
+            );
+            EndCachedPanel(panel);
+        }
+        lastRegisterCount = registerCount;
+        lastEditRegisterCount = *editRegisterCount;
+    }
+    DrawCachedPanel(panel, posX, posY);
+
     if (showEditButton) {
         *editRegisterCount = GuiButton(
-            (Rectangle){(float)posX + 274.0F, (float)posY, 40, 20},
+            (Rectangle){(float)(posX + panel->texture.texture.width + 4), (float)posY, 40, 20},
             "Edit"
         );
     }
 }
 
-[[gnu::nonnull(3), gnu::access(read_write, 3)]]
-[[gnu::nonnull(5), gnu::access(read_write, 5)]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+[[gnu::nonnull(4), gnu::access(read_write, 4)]]
+[[gnu::nonnull(6), gnu::access(read_write, 6)]]
 static void DrawMemorySpillCost(
+    CachedPanel *panel,
     MLRA_RegisterCost memorySpillCost,
     bool showLoadEditButton,
     bool *editMemorySpillLoadCost,
@@ -87,34 +187,58 @@ static void DrawMemorySpillCost(
     static int posX = 20;
     static int posY = 100;
     static int storePosXOffset = 120;
+    static MLRA_RegisterCost lastMemorySpillCost = {0};
+    static bool lastEditMemorySpillLoadCost = false;
+    static bool lastEditMemorySpillStoreCost = false;
+
+    bool changed = memorySpillCost.load != lastMemorySpillCost.load
+        || memorySpillCost.store != lastMemorySpillCost.store
+        || *editMemorySpillLoadCost != lastEditMemorySpillLoadCost
+        || *editMemorySpillStoreCost != lastEditMemorySpillStoreCost;
+    if (IsCachedPanelOutdated(panel, changed)) {
+        char const *title = "Memory Spill Cost: ";
+        char const *load = TextFormat("Load: %d", memorySpillCost.load);
+        char const *store = TextFormat("Store: %d", memorySpillCost.store);
+        int titleWidth = MeasureText(title, 20);
+        int loadWidth = MeasureText(load, 20);
+        int storeWidth = storePosXOffset + MeasureText(store, 20);
+        int width = titleWidth > storeWidth ? titleWidth : storeWidth;
+        if (BeginCachedPanel(panel, loadWidth > width ? loadWidth : width, 45)) {
+            DrawText(
+                title,
+                0,
+                0,
+                20,
+                GetColor((unsigned int)GuiGetStyle(DEFAULT, TEXT_COLOR_NORMAL))
+            );
+            DrawText(
+                load,
+                0,
+                25,
+                20,
+                GetColor((unsigned int)GuiGetStyle(DEFAULT, *editMemorySpillLoadCost ? TEXT_COLOR_FOCUSED : TEXT_COLOR_NORMAL))
+            );
+            DrawText(
+                store,
+                storePosXOffset,
+                25,
+                20,
+                GetColor((unsigned int)GuiGetStyle(DEFAULT, *editMemorySpillStoreCost ? TEXT_COLOR_FOCUSED : TEXT_COLOR_NORMAL))
+            );
+            EndCachedPanel(panel);
+        }
+        lastMemorySpillCost = memorySpillCost;
+        lastEditMemorySpillLoadCost = *editMemorySpillLoadCost;
+        lastEditMemorySpillStoreCost = *editMemorySpillStoreCost;
+    }
+    DrawCachedPanel(panel, posX, posY);
 
-    DrawText(
-        "Memory Spill Cost: ",
-        posX,
-        posY,
-        20,
-        GetColor((unsigned int)GuiGetStyle(DEFAULT, TEXT_COLOR_NORMAL))
-    );
-    DrawText(
-        TextFormat("Load: %d", memorySpillCost.load),
-        posX,
-        posY + 25,
-        20,
-        GetColor((unsigned int)GuiGetStyle(DEFAULT, *editMemorySpillLoadCost ? TEXT_COLOR_FOCUSED : TEXT_COLOR_NORMAL))
-    );
     if (showLoadEditButton) {
         *editMemorySpillLoadCost = GuiButton(
             (Rectangle){(float)posX, (float)posY + 50.0F, 40, 20},
             "Edit"
         );
     }
-    DrawText(
-        TextFormat("Store: %d", memorySpillCost.store),
-        posX + storePosXOffset,
-        posY + 25,
-        20,
-        GetColor((unsigned int)GuiGetStyle(DEFAULT, *editMemorySpillStoreCost ? TEXT_COLOR_FOCUSED : TEXT_COLOR_NORMAL))
-    );
     if (showStoreEditButton) {
         *editMemorySpillStoreCost = GuiButton(
             (Rectangle){(float)(posX + storePosXOffset), (float)posY + 50.0F, 40, 20},
@@ -125,17 +249,18 @@ static void DrawMemorySpillCost(
 
 [[gnu::nonnull(1), gnu::access(read_write, 1)]]
 [[gnu::nonnull(2), gnu::access(read_write, 2)]]
-static void DrawEditMemorySpillLoadCostDialogBox(
+static bool DrawEditMemorySpillLoadCostDialogBox(
     bool *visible,
     MLRA_Scenario *scenario
 )
 {
     static bool lastVisible = false;
     static char buffer[16];
+    bool applied = false;
 
     if (!(*visible)) {
         lastVisible = false;
-        return;
+        return applied;
     }
 
     if (!lastVisible) {
@@ -158,6 +283,7 @@ static void DrawEditMemorySpillLoadCostDialogBox(
             MLRA_RegisterCost memorySpillCost = MLRA_GetMemorySpillCostInScenario(scenario);
             memorySpillCost.load = result;
             MLRA_SetMemorySpillCostInScenario(scenario, memorySpillCost);
+            applied = true;
         }
     }
 
@@ -166,21 +292,24 @@ static void DrawEditMemorySpillLoadCostDialogBox(
     }
 
     lastVisible = true;
+
+    return applied;
 }
 
 [[gnu::nonnull(1), gnu::access(read_write, 1)]]
 [[gnu::nonnull(2), gnu::access(read_write, 2)]]
-static void DrawEditMemorySpillStoreCostDialogBox(
+static bool DrawEditMemorySpillStoreCostDialogBox(
     bool *visible,
     MLRA_Scenario *scenario
 )
 {
     static bool lastVisible = false;
     static char buffer[16];
+    bool applied = false;
 
     if (!(*visible)) {
         lastVisible = false;
-        return;
+        return applied;
     }
 
     if (!lastVisible) {
@@ -203,6 +332,7 @@ static void DrawEditMemorySpillStoreCostDialogBox(
             MLRA_RegisterCost memorySpillCost = MLRA_GetMemorySpillCostInScenario(scenario);
             memorySpillCost.store = result;
             MLRA_SetMemorySpillCostInScenario(scenario, memorySpillCost);
+            applied = true;
         }
     }
 
@@ -211,9 +341,216 @@ static void DrawEditMemorySpillStoreCostDialogBox(
     }
 
     lastVisible = true;
+
+    return applied;
+}
+
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+[[gnu::nonnull(2), gnu::access(read_write, 2)]]
+static void SubmitScenarioToSolve(
+    MLRA_SolverWorker *worker,
+    MLRA_Scenario *scenario
+)
+{
+    MLRA_ScenarioSnapshot *snapshot = MLRA_CreateScenarioSnapshot(scenario);
+    if (snapshot == nullptr) {
+        MLRA_CancelSolverWorker(worker);
+        return;
+    }
+
+    (void)MLRA_SubmitScenarioToSolverWorker(worker, snapshot);
+}
+
+static void DrawSolverProgress(
+    MLRA_SolverWorkerProgress progress,
+    MLRA_Solution const *solution,
+    bool solutionFinal,
+    MLRA_LowerBound const *lowerBound
+)
+{
+    static int posX = 500;
+    static int posY = 70;
+
+    char const *stateText = "Idle";
+    switch (progress.state) {
+        case MLRA_SolverWorkerState_Running:
+            stateText = "Solving";
+            break;
+        case MLRA_SolverWorkerState_Finished:
+            stateText = "Solved";
+            break;
+        case MLRA_SolverWorkerState_Failed:
+            stateText = "Failed";
+            break;
+        case MLRA_SolverWorkerState_Idle:
+        default:
+            break;
+    }
+
+    DrawText(
+        TextFormat("Solver: %s", stateText),
+        posX,
+        posY,
+        20,
+        GetColor((unsigned int)GuiGetStyle(DEFAULT, TEXT_COLOR_NORMAL))
+    );
+
+    float value = (float)progress.progress;
+    GuiProgressBar(
+        (Rectangle){(float)posX, (float)posY + 25.0F, 300, 20},
+        nullptr,
+        TextFormat("%d%%", (int)(value * 100.0F)),
+        &value,
+        0.0F,
+        1.0F
+    );
+
+    if (solution != nullptr && lowerBound != nullptr) {
+        DrawText(
+            TextFormat(
+                "%s Cost: %lld (gap %.1f%%)",
+                solutionFinal ? "Optimal" : "Best",
+                (long long)MLRA_GetSolutionCost(solution),
+                100.0 * MLRA_GetOptimalityGap(MLRA_GetSolutionCost(solution), lowerBound->cost)
+            ),
+            posX,
+            posY + 55,
+            20,
+            GetColor((unsigned int)GuiGetStyle(DEFAULT, TEXT_COLOR_NORMAL))
+        );
+    }
+    else if (solution != nullptr) {
+        DrawText(
+            TextFormat("%s Cost: %lld", solutionFinal ? "Optimal" : "Best", (long long)MLRA_GetSolutionCost(solution)),
+            posX,
+            posY + 55,
+            20,
+            GetColor((unsigned int)GuiGetStyle(DEFAULT, TEXT_COLOR_NORMAL))
+        );
+    }
+}
+
+/*
+ * Zooms around the mouse with the wheel and pans by dragging. The view never zooms out past the whole trace, and never
+ * in past a few pixels per instruction.
+ */
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static void UpdateTimelineView(
+    TimelineView *view,
+    Rectangle bounds,
+    size_t instructionCount,
+    bool interactive
+)
+{
+    constexpr double minimumInstructionsPerColumn = 1.0 / 16.0;
+    constexpr double zoomStep = 1.25;
+
+    double maximumInstructionsPerColumn = (double)instructionCount / (double)bounds.width;
+    maximumInstructionsPerColumn = maximumInstructionsPerColumn > minimumInstructionsPerColumn
+        ? maximumInstructionsPerColumn
+        : minimumInstructionsPerColumn;
+
+    if (!(view->instructionsPerColumn > 0.0)) {
+        view->firstInstruction = 0.0;
+        view->instructionsPerColumn = maximumInstructionsPerColumn;
+    }
+
+    Vector2 mouse = GetMousePosition();
+    if (interactive && CheckCollisionPointRec(mouse, bounds)) {
+        float wheel = GetMouseWheelMove();
+        if (wheel != 0.0F) {
+            double anchor = view->firstInstruction + (double)(mouse.x - bounds.x) * view->instructionsPerColumn;
+            view->instructionsPerColumn *= pow(zoomStep, -(double)wheel);
+            view->firstInstruction = anchor - (double)(mouse.x - bounds.x) * view->instructionsPerColumn;
+        }
+        if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
+            view->firstInstruction -= (double)GetMouseDelta().x * view->instructionsPerColumn;
+        }
+    }
+
+    view->instructionsPerColumn = view->instructionsPerColumn < minimumInstructionsPerColumn
+        ? minimumInstructionsPerColumn
+        : view->instructionsPerColumn > maximumInstructionsPerColumn
+            ? maximumInstructionsPerColumn
+            : view->instructionsPerColumn;
+
+    double lastFirstInstruction = (double)instructionCount - (double)bounds.width * view->instructionsPerColumn;
+    lastFirstInstruction = lastFirstInstruction > 0.0 ? lastFirstInstruction : 0.0;
+    view->firstInstruction = view->firstInstruction < 0.0
+        ? 0.0
+        : view->firstInstruction > lastFirstInstruction
+            ? lastFirstInstruction
+            : view->firstInstruction;
+}
+
+/*
+ * Draws one pixel column per summary column: a bar spanning the registers in use, faded by the share of instructions
+ * kept in registers, over a memory strip faded by the share of spilled instructions.
+ */
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static void DrawTimeline(
+    TimelineView const *view,
+    Rectangle bounds,
+    MLRA_SolutionSummary const *summary,
+    size_t registerCount
+)
+{
+    constexpr size_t maximumColumnCount = 960;
+    constexpr float memoryStripHeight = 16.0F;
+    static MLRA_SolutionSummaryColumn columns[maximumColumnCount];
+
+    Color textColor = GetColor((unsigned int)GuiGetStyle(DEFAULT, TEXT_COLOR_NORMAL));
+    Color registerColor = GetColor((unsigned int)GuiGetStyle(DEFAULT, TEXT_COLOR_FOCUSED));
+    Color memoryColor = GetColor((unsigned int)GuiGetStyle(DEFAULT, TEXT_COLOR_PRESSED));
+
+    double lastInstruction = view->firstInstruction + (double)bounds.width * view->instructionsPerColumn;
+    DrawText(
+        TextFormat("Timeline: Instructions %.0f - %.0f", view->firstInstruction, lastInstruction),
+        (int)bounds.x,
+        (int)bounds.y - 24,
+        20,
+        textColor
+    );
+    DrawRectangleLinesEx(bounds, 1.0F, GetColor((unsigned int)GuiGetStyle(DEFAULT, BORDER_COLOR_NORMAL)));
+
+    if (summary == nullptr || registerCount == 0) {
+        return;
+    }
+
+    size_t columnCount = (size_t)bounds.width < maximumColumnCount ? (size_t)bounds.width : maximumColumnCount;
+    MLRA_SummarizeSolutionColumns(summary, view->firstInstruction, view->instructionsPerColumn, columns, columnCount);
+
+    float registerHeight = bounds.height - memoryStripHeight;
+    float rowHeight = registerHeight / (float)registerCount;
+    for (size_t i = 0; i < columnCount; i++) {
+        MLRA_SolutionSummaryColumn const *column = &columns[i];
+        if (column->instructionCount == 0) {
+            continue;
+        }
+
+        int x = (int)bounds.x + (int)i;
+        if (column->minimumRegister <= column->maximumRegister) {
+            float occupancy = (float)(column->instructionCount - column->spilledCount) / (float)column->instructionCount;
+            int top = (int)(bounds.y + (float)column->minimumRegister * rowHeight);
+            int bottom = (int)(bounds.y + (float)(column->maximumRegister + 1) * rowHeight);
+            DrawLine(x, top, x, bottom > top ? bottom : top + 1, Fade(registerColor, 0.25F + 0.75F * occupancy));
+        }
+        if (column->spilledCount > 0) {
+            float spilled = (float)column->spilledCount / (float)column->instructionCount;
+            DrawLine(
+                x,
+                (int)(bounds.y + registerHeight),
+                x,
+                (int)(bounds.y + bounds.height),
+                Fade(memoryColor, 0.25F + 0.75F * spilled)
+            );
+        }
+    }
 }
 
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
 static void DrawRegisterCosts(
+    CachedPanel *panel,
     MLRA_Scenario const *scenario,
     size_t *displayedRegisterPage,
     size_t registerCostsPerPage
@@ -222,6 +559,8 @@ static void DrawRegisterCosts(
     constexpr int registerCostTextPosX = 20;
     constexpr int registerCostTextPosY = 200;
     constexpr int registerCostTextSpacing = 24;
+    static size_t lastDisplayedRegisterPage = 0;
+    static uint64_t lastRegisterCostGeneration = 0;
 
     size_t registerCount = MLRA_GetRegisterCountInScenario(scenario);
     size_t maxDisplayedRegisterPage = (registerCount / registerCostsPerPage) + 1;
@@ -230,27 +569,53 @@ static void DrawRegisterCosts(
         *displayedRegisterPage = maxDisplayedRegisterPage - 1;
     }
 
-    DrawText(
-        "Register Costs",
-        registerCostTextPosX,
-        registerCostTextPosY,
-        20,
-        GetColor((unsigned int)GuiGetStyle(DEFAULT, TEXT_COLOR_NORMAL))
-    );
+    uint64_t registerCostGeneration = MLRA_GetRegisterCostGenerationInScenario(scenario);
+    bool changed = *displayedRegisterPage != lastDisplayedRegisterPage
+        || registerCostGeneration != lastRegisterCostGeneration;
+    if (IsCachedPanelOutdated(panel, changed)) {
+        size_t firstRegisterIndex = *displayedRegisterPage * registerCostsPerPage;
+        size_t lineCount = registerCount > firstRegisterIndex ? registerCount - firstRegisterIndex : 0;
+        if (lineCount > registerCostsPerPage) {
+            lineCount = registerCostsPerPage;
+        }
 
-    for (size_t i = 0; i < registerCostsPerPage; i++) {
-        size_t currentRegisterIndex = i + (*displayedRegisterPage * registerCostsPerPage);
-        if (currentRegisterIndex < registerCount) {
-            MLRA_RegisterCost registerCost = MLRA_GetRegisterCostInScenario(scenario, currentRegisterIndex);
+        int width = MeasureText("Register Costs", 20);
+        for (size_t i = 0; i < lineCount; i++) {
+            MLRA_RegisterCost registerCost = MLRA_GetRegisterCostInScenario(scenario, firstRegisterIndex + i);
+            int lineWidth = 20 + MeasureText(
+                TextFormat("Register %zu: Load: %d; Store: %d", firstRegisterIndex + i, registerCost.load, registerCost.store),
+                20
+            );
+            if (lineWidth > width) {
+                width = lineWidth;
+            }
+        }
+
+        if (BeginCachedPanel(panel, width, (int)registerCostsPerPage * registerCostTextSpacing + 52)) {
             DrawText(
-                TextFormat("Register %zu: Load: %d; Store: %d", currentRegisterIndex, registerCost.load, registerCost.store),
-                registerCostTextPosX + 20,
-                registerCostTextPosY + ((int)(i + 1) * registerCostTextSpacing + 32),
+                "Register Costs",
+                0,
+                0,
                 20,
                 GetColor((unsigned int)GuiGetStyle(DEFAULT, TEXT_COLOR_NORMAL))
             );
+
+            for (size_t i = 0; i < lineCount; i++) {
+                MLRA_RegisterCost registerCost = MLRA_GetRegisterCostInScenario(scenario, firstRegisterIndex + i);
+                DrawText(
+                    TextFormat("Register %zu: Load: %d; Store: %d", firstRegisterIndex + i, registerCost.load, registerCost.store),
+                    20,
+                    (int)(i + 1) * registerCostTextSpacing + 32,
+                    20,
+                    GetColor((unsigned int)GuiGetStyle(DEFAULT, TEXT_COLOR_NORMAL))
+                );
+            }
+            EndCachedPanel(panel);
         }
+        lastDisplayedRegisterPage = *displayedRegisterPage;
+        lastRegisterCostGeneration = registerCostGeneration;
     }
+    DrawCachedPanel(panel, registerCostTextPosX, registerCostTextPosY);
 }
 
 static void DrawRegisterCostsPageSelector(
@@ -322,16 +687,24 @@ static void DrawRegisterCostsPageSelector(
     }
 }
 
-int main(void)
+int main(int argc, char **argv)
 {
     const int screenWidth = 960;
     const int screenHeight = 720;
 
-    MLRA_Scenario *scenario = MLRA_CreateScenario(200, (MLRA_RegisterCost){5, 5});
+    MLRA_Scenario *scenario = argc > 1
+        ? MLRA_LoadScenarioFromFile(argv[1])
+        : MLRA_CreateScenario(200, (MLRA_RegisterCost){5, 5});
     if (scenario == nullptr) {
         return 1;
     }
 
+    MLRA_SolverWorker *solverWorker = MLRA_CreateSolverWorker();
+    if (solverWorker == nullptr) {
+        MLRA_DestroyScenario(scenario);
+        return 1;
+    }
+
     SetConfigFlags(FLAG_VSYNC_HINT);
     InitWindow(screenWidth, screenHeight, "Minimum Local Register Allocation Visualizer");
     GuiLoadStyle("assets/styles/cyber/style_cyber.rgs");
@@ -339,6 +712,10 @@ int main(void)
     size_t currentRegisterPage = 0;
     constexpr size_t registerCostsPerPage = 10;
 
+    CachedPanel registerCountPanel = {0};
+    CachedPanel memorySpillCostPanel = {0};
+    CachedPanel registerCostsPanel = {0};
+
     bool showEditRegisterCountButton = true;
     bool editRegisterCount = false;
 
@@ -347,6 +724,15 @@ int main(void)
     bool showEditMemorySpillStoreCostButton = true;
     bool editMemorySpillStoreCost = false;
 
+    MLRA_Solution *solution = nullptr;
+    MLRA_SolutionSummary *solutionSummary = nullptr;
+    bool solutionFinal = false;
+    TimelineView timelineView = {0};
+    const Rectangle timelineBounds = {20, 540, 920, 160};
+    MLRA_LowerBound lowerBound = {0};
+    bool lowerBoundKnown = false;
+    SubmitScenarioToSolve(solverWorker, scenario);
+
     while (!WindowShouldClose()) {
         if (editRegisterCount || editMemorySpillLoadCost || editMemorySpillStoreCost) {
             showEditRegisterCountButton = false;
@@ -359,23 +745,73 @@ int main(void)
             showEditMemorySpillStoreCostButton = true;
         }
 
+        MLRA_SolverWorkerSolution published;
+        if (MLRA_TakeSolutionFromSolverWorker(solverWorker, &published)) {
+            MLRA_DestroySolutionSummary(solutionSummary);
+            MLRA_DestroySolution(solution);
+            solution = published.solution;
+            solutionSummary = published.summary;
+            solutionFinal = published.final;
+            lowerBound = published.lowerBound;
+            lowerBoundKnown = published.lowerBoundKnown;
+        }
+
+        UpdateTimelineView(
+            &timelineView,
+            timelineBounds,
+            MLRA_GetRegisterInstructionCountInScenario(scenario),
+            showEditRegisterCountButton
+        );
+
         BeginDrawing();
         ClearBackground(GetColor((unsigned int)GuiGetStyle(DEFAULT, BACKGROUND_COLOR)));
 
-        DrawRegisterCount(MLRA_GetRegisterCountInScenario(scenario), showEditRegisterCountButton, &editRegisterCount);
-        DrawEditRegisterCountDialogBox(&editRegisterCount, scenario);
+        DrawRegisterCount(
+            &registerCountPanel,
+            MLRA_GetRegisterCountInScenario(scenario),
+            showEditRegisterCountButton,
+            &editRegisterCount
+        );
         DrawMemorySpillCost(
+            &memorySpillCostPanel,
             MLRA_GetMemorySpillCostInScenario(scenario),
             showEditMemorySpillLoadCostButton,
             &editMemorySpillLoadCost,
             showEditMemorySpillStoreCostButton,
             &editMemorySpillStoreCost
         );
-        DrawEditMemorySpillLoadCostDialogBox(&editMemorySpillLoadCost, scenario);
-        DrawEditMemorySpillStoreCostDialogBox(&editMemorySpillStoreCost, scenario);
-        DrawRegisterCosts(scenario, &currentRegisterPage, registerCostsPerPage);
+        DrawSolverProgress(
+            MLRA_GetProgressInSolverWorker(solverWorker),
+            solution,
+            solutionFinal,
+            lowerBoundKnown ? &lowerBound : nullptr
+        );
+        DrawRegisterCosts(&registerCostsPanel, scenario, &currentRegisterPage, registerCostsPerPage);
         DrawRegisterCostsPageSelector(&currentRegisterPage, ( MLRA_GetRegisterCountInScenario(scenario) - 1) / registerCostsPerPage);
+        DrawTimeline(&timelineView, timelineBounds, solutionSummary, MLRA_GetRegisterCountInScenario(scenario));
+
+        bool edited = DrawEditRegisterCountDialogBox(&editRegisterCount, scenario);
+        edited |= DrawEditMemorySpillLoadCostDialogBox(&editMemorySpillLoadCost, scenario);
+        edited |= DrawEditMemorySpillStoreCostDialogBox(&editMemorySpillStoreCost, scenario);
 
         EndDrawing();
+
+        if (edited) {
+            MLRA_DestroySolutionSummary(solutionSummary);
+            solutionSummary = nullptr;
+            MLRA_DestroySolution(solution);
+            solution = nullptr;
+            lowerBoundKnown = false;
+            SubmitScenarioToSolve(solverWorker, scenario);
+        }
     }
+
+    MLRA_DestroySolverWorker(solverWorker);
+    MLRA_DestroySolutionSummary(solutionSummary);
+    MLRA_DestroySolution(solution);
+    UnloadRenderTexture(registerCostsPanel.texture);
+    UnloadRenderTexture(memorySpillCostPanel.texture);
+    UnloadRenderTexture(registerCountPanel.texture);
+    CloseWindow();
+    MLRA_DestroyScenario(scenario);
 }
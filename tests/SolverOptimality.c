@@ -0,0 +1,437 @@
+#include "MLRA/Core/AllocationEvaluator.h"
+#include "MLRA/Core/BranchAndBoundSolver.h"
+#include "MLRA/Core/LowerBound.h"
+#include "MLRA/Core/RegisterCost.h"
+#include "MLRA/Core/RegisterInstruction.h"
+#include "MLRA/Core/Scenario.h"
+#include "MLRA/Core/Solution.h"
+#include "MLRA/Core/Solver.h"
+
+#include <inttypes.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Every solver claiming optimality is checked against an exhaustive search over all allocations of small random
+ * scenarios, scored by the allocation evaluator. The scenarios are kept small enough for the exhaustive search to
+ * visit (registers + 1)^instructions allocations.
+ */
+static constexpr size_t ScenarioCount = 400;
+static constexpr size_t MaximumInstructionCount = 7;
+static constexpr size_t MaximumRegisterCount = 3;
+static constexpr size_t MaximumValueCount = 4;
+static constexpr int MaximumSpillCost = 6;
+
+/*
+ * Small scenarios rarely leave a value waiting across several stores, so a second pass checks the other solvers
+ * against the exact solver on longer traces over a few more values, with spills up to several times dearer than the
+ * registers.
+ */
+static constexpr size_t ExactScenarioCount = 300;
+static constexpr size_t MinimumExactInstructionCount = 20;
+static constexpr size_t MaximumExactInstructionCount = 40;
+static constexpr size_t MinimumExactValueCount = 3;
+static constexpr size_t MaximumExactValueCount = 5;
+static constexpr int MaximumExactSpillCost = 9;
+static constexpr size_t CostVariantCount = 2;
+static constexpr size_t CheckpointInterval = 2;
+static constexpr uint64_t Seed = 0x4D4C5241;
+
+/*
+ * With one register, the dead store at instruction 13 pays off in the register, evicting v3 ahead of the store to v11
+ * at instruction 15 that would evict it anyway. Branch and bound once kept dead values out of occupied registers.
+ */
+static MLRA_RegisterInstruction const DeadStoreEvictionTrace[] = {
+    {MLRA_RegisterInstructionType_Store, 11}, {MLRA_RegisterInstructionType_Load, 11},
+    {MLRA_RegisterInstructionType_Load, 4}, {MLRA_RegisterInstructionType_Load, 4},
+    {MLRA_RegisterInstructionType_Load, 11}, {MLRA_RegisterInstructionType_Load, 11},
+    {MLRA_RegisterInstructionType_Load, 3}, {MLRA_RegisterInstructionType_Load, 11},
+    {MLRA_RegisterInstructionType_Store, 3}, {MLRA_RegisterInstructionType_Load, 3},
+    {MLRA_RegisterInstructionType_Load, 4}, {MLRA_RegisterInstructionType_Load, 4},
+    {MLRA_RegisterInstructionType_Load, 3}, {MLRA_RegisterInstructionType_Store, 11},
+    {MLRA_RegisterInstructionType_Load, 4}, {MLRA_RegisterInstructionType_Store, 11},
+    {MLRA_RegisterInstructionType_Load, 4}, {MLRA_RegisterInstructionType_Load, 4},
+    {MLRA_RegisterInstructionType_Load, 11}, {MLRA_RegisterInstructionType_Load, 4},
+    {MLRA_RegisterInstructionType_Load, 11}, {MLRA_RegisterInstructionType_Load, 3}
+};
+static constexpr MLRA_RegisterCost DeadStoreEvictionSpillCost = {4, 6};
+
+typedef struct
+{
+    uint64_t state;
+} TestRandom;
+
+typedef struct
+{
+    size_t scenario;
+    size_t failures;
+} TestContext;
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static uint64_t NextTestRandom(
+    TestRandom *const random
+)
+{
+    uint64_t value = (random->state += 0x9E3779B97F4A7C15u);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9u;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBu;
+    return value ^ (value >> 31);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static size_t NextTestRandomBelow(
+    TestRandom *const random,
+    size_t const bound
+)
+{
+    return (size_t)(NextTestRandom(random) % bound);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static MLRA_RegisterInstruction NextTestInstruction(
+    TestRandom *const random,
+    size_t const valueCount
+)
+{
+    bool const load = NextTestRandomBelow(random, 2) == 0;
+    return (MLRA_RegisterInstruction){
+        .type = load ? MLRA_RegisterInstructionType_Load : MLRA_RegisterInstructionType_Store,
+        .virtualRegisterId = (int)NextTestRandomBelow(random, valueCount)
+    };
+}
+
+/*
+ * Registers draw their cost from a few variants, so that scenarios mix registers of the same cost class with cheaper
+ * and dearer ones.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static MLRA_Scenario *CreateTestScenario(
+    TestRandom *const random,
+    size_t const instructionCount,
+    size_t const registerCount,
+    size_t const valueCount,
+    int const maximumSpillCost
+)
+{
+    MLRA_RegisterCost const memorySpillCost = {
+        1 + (int)NextTestRandomBelow(random, (size_t)maximumSpillCost),
+        1 + (int)NextTestRandomBelow(random, (size_t)maximumSpillCost)
+    };
+    MLRA_Scenario *const scenario = MLRA_CreateScenario(registerCount, memorySpillCost);
+    if (scenario == nullptr) {
+        return nullptr;
+    }
+
+    MLRA_RegisterCost variants[CostVariantCount];
+    for (size_t variant = 0; variant < CostVariantCount; ++variant) {
+        variants[variant] = (MLRA_RegisterCost){
+            1 + (int)NextTestRandomBelow(random, 3),
+            1 + (int)NextTestRandomBelow(random, 3)
+        };
+    }
+    for (size_t reg = 0; reg < registerCount; ++reg) {
+        MLRA_SetRegisterCostInScenario(scenario, reg, variants[NextTestRandomBelow(random, CostVariantCount)]);
+    }
+
+    for (size_t index = 0; index < instructionCount; ++index) {
+        MLRA_AppendRegisterInstructionToScenario(scenario, NextTestInstruction(random, valueCount));
+    }
+
+    return scenario;
+}
+
+/*
+ * Returns the cheapest cost over every allocation, counting the locations up like the digits of a number in base
+ * registers + 1, or -1 if the evaluator failed.
+ */
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_only, 1)]]
+static int64_t SolveScenarioByEnumeration(
+    MLRA_Scenario const *const scenario
+)
+{
+    size_t const count = MLRA_GetRegisterInstructionCountInScenario(scenario);
+    int32_t const lastRegister = (int32_t)MLRA_GetRegisterCountInScenario(scenario) - 1;
+    int32_t locations[MaximumInstructionCount + 1];
+    for (size_t index = 0; index < count; ++index) {
+        locations[index] = MLRA_SolutionLocation_Memory;
+    }
+
+    int64_t best = INT64_MAX;
+    for (;;) {
+        MLRA_AllocationEvaluation const evaluation = MLRA_EvaluateAllocation(scenario, locations, count);
+        if (evaluation.error != MLRA_AllocationError_None) {
+            return -1;
+        }
+        best = evaluation.cost < best ? evaluation.cost : best;
+
+        size_t index = 0;
+        while (index < count && locations[index] == lastRegister) {
+            locations[index++] = MLRA_SolutionLocation_Memory;
+        }
+        if (index == count) {
+            return best;
+        }
+        ++locations[index];
+    }
+}
+
+[[gnu::nonnull(1, 2, 3), gnu::access(read_write, 1), gnu::access(read_only, 2), gnu::access(read_only, 3)]]
+static void ExpectOptimalSolution(
+    TestContext *const context,
+    MLRA_Scenario const *const scenario,
+    char const *const solver,
+    MLRA_Solution *const solution,
+    int64_t const optimum
+)
+{
+    if (solution == nullptr) {
+        fprintf(stderr, "scenario %zu: %s returned no solution\n", context->scenario, solver);
+        ++context->failures;
+        return;
+    }
+
+    MLRA_AllocationEvaluation const evaluation = MLRA_EvaluateSolution(scenario, solution);
+    int64_t const cost = MLRA_GetSolutionCost(solution);
+    if (evaluation.error != MLRA_AllocationError_None || evaluation.cost != cost || cost != optimum) {
+        fprintf(
+            stderr,
+            "scenario %zu: %s reports cost %" PRId64 ", evaluates to %" PRId64 " (error %d), optimum is %" PRId64 "\n",
+            context->scenario,
+            solver,
+            cost,
+            evaluation.cost,
+            (int)evaluation.error,
+            optimum
+        );
+        ++context->failures;
+    }
+
+    MLRA_DestroySolution(solution);
+}
+
+[[nodiscard]]
+static bool CancelSolve(
+    [[maybe_unused]] void *const context,
+    [[maybe_unused]] size_t const completed,
+    [[maybe_unused]] size_t const total
+)
+{
+    return false;
+}
+
+/*
+ * Runs every solver that claims optimality on the scenario, and checks that the lower bound does not exceed the
+ * optimum. The incremental solver carries over between calls, so a call after an edit covers its resumed search.
+ */
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(read_only, 2)]]
+static void CheckScenario(
+    TestContext *const context,
+    MLRA_Scenario const *const scenario,
+    MLRA_IncrementalSolver *const incremental
+)
+{
+    int64_t const optimum = SolveScenarioByEnumeration(scenario);
+    if (optimum < 0) {
+        fprintf(stderr, "scenario %zu: enumeration failed\n", context->scenario);
+        ++context->failures;
+        return;
+    }
+
+    ExpectOptimalSolution(context, scenario, "exact", MLRA_SolveScenarioExactly(scenario), optimum);
+    ExpectOptimalSolution(context, scenario, "parallel", MLRA_SolveScenarioExactlyInParallel(scenario, 2), optimum);
+    ExpectOptimalSolution(
+        context, scenario, "incremental", MLRA_SolveScenarioIncrementally(incremental, scenario), optimum
+    );
+
+    MLRA_BranchAndBoundOptions const options = {.threadCount = 2, .timeLimit = 0.0};
+    MLRA_BranchAndBoundReport report;
+    MLRA_Solution *const solution = MLRA_SolveScenarioWithBranchAndBound(scenario, &options, &report);
+    ExpectOptimalSolution(context, scenario, "branch and bound", solution, optimum);
+    if (!report.optimal || report.lowerBound != optimum) {
+        fprintf(
+            stderr,
+            "scenario %zu: branch and bound proves %" PRId64 " (optimal %d), optimum is %" PRId64 "\n",
+            context->scenario,
+            report.lowerBound,
+            (int)report.optimal,
+            optimum
+        );
+        ++context->failures;
+    }
+
+    MLRA_LowerBound bound;
+    if (!MLRA_ComputeLowerBoundOfScenario(scenario, &bound) || bound.cost > optimum) {
+        fprintf(
+            stderr, "scenario %zu: lower bound %" PRId64 " exceeds optimum %" PRId64 "\n",
+            context->scenario,
+            bound.cost,
+            optimum
+        );
+        ++context->failures;
+    }
+}
+
+/*
+ * A solve cancelled at its first checkpoint keeps the segments it completed; the next solve must still be optimal.
+ */
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(read_only, 2)]]
+static void CheckCancelledScenario(
+    TestContext *const context,
+    MLRA_Scenario const *const scenario
+)
+{
+    MLRA_IncrementalSolver *const incremental = MLRA_CreateIncrementalSolver(CheckpointInterval);
+    if (incremental == nullptr) {
+        ++context->failures;
+        return;
+    }
+
+    MLRA_SetIncrementalSolverProgress(incremental, CancelSolve, nullptr);
+    MLRA_DestroySolution(MLRA_SolveScenarioIncrementally(incremental, scenario));
+    MLRA_SetIncrementalSolverProgress(incremental, nullptr, nullptr);
+
+    int64_t const optimum = SolveScenarioByEnumeration(scenario);
+    ExpectOptimalSolution(
+        context, scenario, "incremental after cancel", MLRA_SolveScenarioIncrementally(incremental, scenario), optimum
+    );
+    MLRA_DestroyIncrementalSolver(incremental);
+}
+
+/*
+ * Checks the parallel exact, incremental and branch and bound solvers against the exact solver on scenarios too
+ * large to enumerate.
+ */
+[[gnu::nonnull(1, 2), gnu::access(read_write, 1), gnu::access(read_only, 2)]]
+static void CheckScenarioAgainstExactSolver(
+    TestContext *const context,
+    MLRA_Scenario const *const scenario
+)
+{
+    MLRA_Solution *const exact = MLRA_SolveScenarioExactly(scenario);
+    if (exact == nullptr) {
+        fprintf(stderr, "scenario %zu: exact returned no solution\n", context->scenario);
+        ++context->failures;
+        return;
+    }
+    int64_t const optimum = MLRA_GetSolutionCost(exact);
+    MLRA_DestroySolution(exact);
+
+    ExpectOptimalSolution(context, scenario, "parallel", MLRA_SolveScenarioExactlyInParallel(scenario, 2), optimum);
+
+    MLRA_IncrementalSolver *const incremental = MLRA_CreateIncrementalSolver(CheckpointInterval);
+    if (incremental == nullptr) {
+        fprintf(stderr, "scenario %zu: out of memory\n", context->scenario);
+        ++context->failures;
+        return;
+    }
+    ExpectOptimalSolution(
+        context, scenario, "incremental", MLRA_SolveScenarioIncrementally(incremental, scenario), optimum
+    );
+    MLRA_DestroyIncrementalSolver(incremental);
+
+    MLRA_BranchAndBoundOptions const options = {.threadCount = 2, .timeLimit = 0.0};
+    MLRA_Solution *const solution = MLRA_SolveScenarioWithBranchAndBound(scenario, &options, nullptr);
+    ExpectOptimalSolution(context, scenario, "branch and bound", solution, optimum);
+}
+
+[[nodiscard]]
+[[gnu::nonnull(1), gnu::access(read_write, 1)]]
+static bool CheckRegressionScenarios(
+    TestContext *const context
+)
+{
+    MLRA_Scenario *const scenario = MLRA_CreateScenario(1, DeadStoreEvictionSpillCost);
+    if (scenario == nullptr) {
+        return false;
+    }
+
+    size_t const count = sizeof(DeadStoreEvictionTrace) / sizeof(DeadStoreEvictionTrace[0]);
+    for (size_t index = 0; index < count; ++index) {
+        MLRA_AppendRegisterInstructionToScenario(scenario, DeadStoreEvictionTrace[index]);
+    }
+    CheckScenarioAgainstExactSolver(context, scenario);
+    MLRA_DestroyScenario(scenario);
+    ++context->scenario;
+
+    return true;
+}
+
+int main(void)
+{
+    TestRandom random = {Seed};
+    TestContext context = {0};
+
+    for (; context.scenario < ScenarioCount; ++context.scenario) {
+        MLRA_Scenario *const scenario = CreateTestScenario(
+            &random,
+            1 + NextTestRandomBelow(&random, MaximumInstructionCount),
+            1 + NextTestRandomBelow(&random, MaximumRegisterCount),
+            1 + NextTestRandomBelow(&random, MaximumValueCount),
+            MaximumSpillCost
+        );
+        MLRA_IncrementalSolver *const incremental = MLRA_CreateIncrementalSolver(CheckpointInterval);
+        if (scenario == nullptr || incremental == nullptr) {
+            fprintf(stderr, "scenario %zu: out of memory\n", context.scenario);
+            MLRA_DestroyIncrementalSolver(incremental);
+            MLRA_DestroyScenario(scenario);
+            return EXIT_FAILURE;
+        }
+
+        CheckScenario(&context, scenario, incremental);
+
+        /* Edits within the instruction limit exercise the incremental solver's resumed search. */
+        size_t const count = MLRA_GetRegisterInstructionCountInScenario(scenario);
+        size_t const index = NextTestRandomBelow(&random, count + 1);
+        if (count < MaximumInstructionCount && NextTestRandomBelow(&random, 2) == 0) {
+            MLRA_InsertRegisterInstructionToScenario(scenario, index, NextTestInstruction(&random, MaximumValueCount));
+        }
+        else if (count > 1) {
+            MLRA_RemoveRegisterInstructionAtScenario(scenario, index < count ? index : count - 1);
+        }
+        CheckScenario(&context, scenario, incremental);
+        CheckCancelledScenario(&context, scenario);
+
+        MLRA_DestroyIncrementalSolver(incremental);
+        MLRA_DestroyScenario(scenario);
+    }
+
+    for (size_t scenarioIndex = 0; scenarioIndex < ExactScenarioCount; ++scenarioIndex, ++context.scenario) {
+        size_t const instructionRange = MaximumExactInstructionCount - MinimumExactInstructionCount + 1;
+        size_t const valueRange = MaximumExactValueCount - MinimumExactValueCount + 1;
+        MLRA_Scenario *const scenario = CreateTestScenario(
+            &random,
+            MinimumExactInstructionCount + NextTestRandomBelow(&random, instructionRange),
+            1 + NextTestRandomBelow(&random, MaximumRegisterCount),
+            MinimumExactValueCount + NextTestRandomBelow(&random, valueRange),
+            MaximumExactSpillCost
+        );
+        if (scenario == nullptr) {
+            fprintf(stderr, "scenario %zu: out of memory\n", context.scenario);
+            return EXIT_FAILURE;
+        }
+
+        CheckScenarioAgainstExactSolver(&context, scenario);
+        MLRA_DestroyScenario(scenario);
+    }
+
+    if (!CheckRegressionScenarios(&context)) {
+        fprintf(stderr, "regression scenarios: out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    if (context.failures != 0) {
+        fprintf(stderr, "%zu failures over %zu scenarios\n", context.failures, context.scenario);
+        return EXIT_FAILURE;
+    }
+
+    printf("%zu scenarios solved optimally\n", context.scenario);
+
+    return EXIT_SUCCESS;
+}